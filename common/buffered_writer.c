@@ -0,0 +1,251 @@
+/*
+ ==============================================================================
+ Name        : buffered_writer.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Module include
+#include "buffered_writer.h"
+
+// Implementation
+
+bool buffered_writer_init(pbuffered_writer_t p_writer, FILE *p_file,
+		size_t buffer_size)
+{
+	memset(p_writer, 0, sizeof(*p_writer));
+
+	if ((NULL == p_file) || (0 == buffer_size))
+	{
+		return (false);
+	}
+
+	p_writer->p_buffer = (char *) malloc(buffer_size);
+	if (NULL == p_writer->p_buffer)
+	{
+		return (false);
+	}
+
+	p_writer->p_file = p_file;
+	p_writer->buffer_size = buffer_size;
+
+	return (true);
+}
+
+bool buffered_writer_init_memory(pbuffered_writer_t p_writer,
+		size_t buffer_size)
+{
+	memset(p_writer, 0, sizeof(*p_writer));
+
+	if (0 == buffer_size)
+	{
+		return (false);
+	}
+
+	p_writer->p_buffer = (char *) malloc(buffer_size);
+	if (NULL == p_writer->p_buffer)
+	{
+		return (false);
+	}
+
+	p_writer->buffer_size = buffer_size;
+
+	return (true);
+}
+
+bool buffered_writer_flush(pbuffered_writer_t p_writer)
+{
+	// Without a stream a full buffer grows rather than being handed off
+	if (NULL == p_writer->p_file)
+	{
+		if ((!p_writer->is_error)
+				&& (p_writer->length == p_writer->buffer_size))
+		{
+			char *p_buffer = (char *) realloc(p_writer->p_buffer,
+					2 * p_writer->buffer_size);
+
+			if (NULL == p_buffer)
+			{
+				p_writer->is_error = true;
+			}
+			else
+			{
+				p_writer->p_buffer = p_buffer;
+				p_writer->buffer_size *= 2;
+			}
+		}
+
+		return (!p_writer->is_error);
+	}
+
+	if ((!p_writer->is_error) && (p_writer->length > 0))
+	{
+		if (p_writer->length
+				!= fwrite(p_writer->p_buffer, 1, p_writer->length,
+						p_writer->p_file))
+		{
+			p_writer->is_error = true;
+		}
+		else if (0 != fflush(p_writer->p_file))
+		{
+			p_writer->is_error = true;
+		}
+	}
+
+	p_writer->length = 0;
+
+	return (!p_writer->is_error);
+}
+
+void buffered_writer_free(pbuffered_writer_t p_writer)
+{
+	if (NULL != p_writer->p_buffer)
+	{
+		buffered_writer_flush(p_writer);
+		free(p_writer->p_buffer);
+	}
+
+	memset(p_writer, 0, sizeof(*p_writer));
+}
+
+void buffered_writer_write(pbuffered_writer_t p_writer, void const * p_data,
+		size_t length)
+{
+	char const *p_bytes = (char const *) p_data;
+
+	while ((length > 0) && (!p_writer->is_error))
+	{
+		size_t chunk = p_writer->buffer_size - p_writer->length;
+
+		if (0 == chunk)
+		{
+			buffered_writer_flush(p_writer);
+			continue;
+		}
+
+		if (chunk > length)
+		{
+			chunk = length;
+		}
+
+		memcpy(&p_writer->p_buffer[p_writer->length], p_bytes, chunk);
+		p_writer->length += chunk;
+		p_bytes += chunk;
+		length -= chunk;
+	}
+}
+
+void buffered_writer_puts(pbuffered_writer_t p_writer, char const * p_text)
+{
+	buffered_writer_write(p_writer, p_text, strlen(p_text));
+}
+
+void buffered_writer_putc(pbuffered_writer_t p_writer, char c)
+{
+	if (p_writer->length == p_writer->buffer_size)
+	{
+		buffered_writer_flush(p_writer);
+	}
+
+	if (!p_writer->is_error)
+	{
+		p_writer->p_buffer[p_writer->length++] = c;
+	}
+}
+
+void buffered_writer_put_uint(pbuffered_writer_t p_writer, uint64_t value)
+{
+	char digits[20]; // UINT64_MAX has 20 decimal digits
+	size_t index = sizeof(digits);
+
+	// Build the digits from the least significant end
+	do
+	{
+		digits[--index] = (char) ('0' + (value % 10));
+		value /= 10;
+	} while (0 != value);
+
+	buffered_writer_write(p_writer, &digits[index], sizeof(digits) - index);
+}
+
+void buffered_writer_put_int(pbuffered_writer_t p_writer, int64_t value)
+{
+	if (value < 0)
+	{
+		buffered_writer_putc(p_writer, '-');
+
+		// Negate as unsigned so INT64_MIN does not overflow
+		buffered_writer_put_uint(p_writer, 0 - (uint64_t) value);
+	}
+	else
+	{
+		buffered_writer_put_uint(p_writer, (uint64_t) value);
+	}
+}
+
+void buffered_writer_put_hex(pbuffered_writer_t p_writer, uint32_t value,
+		unsigned int digits)
+{
+	static char const hex[] = "0123456789abcdef";
+	char text[8];
+	unsigned int index;
+
+	if (digits > sizeof(text))
+	{
+		digits = sizeof(text);
+	}
+
+	for (index = digits; index > 0; index--)
+	{
+		text[index - 1] = hex[value & 0xF];
+		value >>= 4;
+	}
+
+	buffered_writer_write(p_writer, text, digits);
+}
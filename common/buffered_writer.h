@@ -0,0 +1,110 @@
+/*
+ ==============================================================================
+ Name        : buffered_writer.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef BUFFERED_WRITER_H_
+#define BUFFERED_WRITER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+
+ A buffered writer accumulates output in a fixed buffer allocated once and
+ hands it to the stream only when the buffer fills or is flushed, so callers
+ may emit many small pieces (e.g. a field at a time) without a library call
+ or allocation for each of them.
+
+ Errors are sticky: once a write to the stream fails every later call is a
+ no-op and buffered_writer_flush() reports the failure.
+
+ A writer initialised without a stream (buffered_writer_init_memory())
+ keeps everything written in p_buffer, doubling it whenever it fills.
+
+ */
+
+#define BUFFERED_WRITER_DEFAULT_SIZE	(64 * 1024)
+
+typedef struct _buffered_writer_t
+{
+	FILE *p_file; // The stream written to (NULL to grow p_buffer instead)
+	char *p_buffer;
+	size_t buffer_size;
+	size_t length; // Number of bytes pending in p_buffer
+	bool is_error; // A write to p_file failed
+
+} buffered_writer_t, *pbuffered_writer_t;
+
+bool buffered_writer_init(pbuffered_writer_t p_writer, FILE *p_file,
+		size_t buffer_size);
+
+bool buffered_writer_init_memory(pbuffered_writer_t p_writer,
+		size_t buffer_size);
+
+bool buffered_writer_flush(pbuffered_writer_t p_writer);
+
+void buffered_writer_free(pbuffered_writer_t p_writer);
+
+void buffered_writer_write(pbuffered_writer_t p_writer, void const * p_data,
+		size_t length);
+
+void buffered_writer_puts(pbuffered_writer_t p_writer, char const * p_text);
+
+void buffered_writer_putc(pbuffered_writer_t p_writer, char c);
+
+void buffered_writer_put_uint(pbuffered_writer_t p_writer, uint64_t value);
+
+void buffered_writer_put_int(pbuffered_writer_t p_writer, int64_t value);
+
+void buffered_writer_put_hex(pbuffered_writer_t p_writer, uint32_t value,
+		unsigned int digits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BUFFERED_WRITER_H_ */
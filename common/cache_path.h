@@ -0,0 +1,72 @@
+/*
+ ==============================================================================
+ Name        : cache_path.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef CACHE_PATH_H_
+#define CACHE_PATH_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+
+ Cache files live in %HIDDUMP_CACHE_DIR% if set, otherwise in
+ %LOCALAPPDATA%\hiddump (created as needed) and failing that in the working
+ directory.
+
+ cache_path_get() returns false if the path of p_file_name does not fit
+ path_size bytes.
+
+ */
+
+bool cache_path_get(char const * p_file_name, char * p_path, size_t path_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_PATH_H_ */
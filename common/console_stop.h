@@ -1,7 +1,7 @@
 /*
  ==============================================================================
- Name        : usb_hid_reader.h
- Date        : Aug 26, 2011
+ Name        : console_stop.h
+ Date        : Oct 18, 2026
  ==============================================================================
 
  BSD License
@@ -44,35 +44,33 @@
  ==============================================================================
  */
 
-#ifndef USB_HID_READER_H_
-#define USB_HID_READER_H_
+#ifndef CONSOLE_STOP_H_
+#define CONSOLE_STOP_H_
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-/* ************************************************************************* */
-/*!
- \defgroup usb_hid_reader
-
- \brief These APIs are used to read HID reports via a thread.
- */
-/* ************************************************************************* */
+/*
 
-#define WM_DISPLAY_READ_DATA    			 WM_USER+1
-#define WM_READ_THREAD_TERMINATED            WM_USER+2
+ Loops running until the user presses Ctrl+C (or Ctrl+Break, or closes the
+ console) wait on the event console_stop_create() returns, which is set when
+ the user does. console_stop_destroy() stops watching the console and closes
+ the event.
 
-HANDLE usb_hid_create_reader(HWND h_wnd, phid_device_t p_hid_device);
+ The console control handler takes no context, so only one such event
+ exists at a time. console_stop_create() returns NULL if the event cannot be
+ created or another one exists.
 
-void usb_hid_stop_reader(HANDLE h_reader);
+ */
 
-void usb_hid_destroy_reader(HANDLE h_reader);
+HANDLE console_stop_create(void);
 
-void usb_hid_read_handled(HANDLE h_reader);
+void console_stop_destroy(HANDLE h_stop_event);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* USB_HID_READER_H_ */
+#endif /* CONSOLE_STOP_H_ */
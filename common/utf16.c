@@ -0,0 +1,198 @@
+/*
+ ==============================================================================
+ Name        : utf16.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define UTF16_SSE2
+#include <emmintrin.h>
+#endif
+
+// Module include
+#include "utf16.h"
+
+// Units handled at once by the ASCII fast path
+#define ASCII_BLOCK_UNITS			(8)
+
+#define REPLACEMENT_CHARACTER		(0xFFFD)
+
+// Local declarations
+#ifdef UTF16_SSE2
+static bool convert_ascii_block(uint8_t const * p_units, char * p_utf8);
+#endif
+
+// Implementation
+
+#ifdef UTF16_SSE2
+// Converts 8 units if all of them are ASCII other than zero
+static bool convert_ascii_block(uint8_t const * p_units, char * p_utf8)
+{
+	__m128i units = _mm_loadu_si128((__m128i const *) p_units);
+	__m128i zero = _mm_setzero_si128();
+	__m128i high = _mm_and_si128(units, _mm_set1_epi16((short) 0xFF80));
+
+	if ((0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)))
+			|| (0 != _mm_movemask_epi8(_mm_cmpeq_epi16(units, zero))))
+	{
+		return (false);
+	}
+
+	// Every unit fits a byte, narrow them
+	_mm_storel_epi64((__m128i *) p_utf8, _mm_packus_epi16(units, units));
+
+	return (true);
+}
+#endif
+
+size_t utf16le_to_utf8(void const * p_utf16, size_t unit_count, char * p_utf8,
+		size_t utf8_size)
+{
+	uint8_t const *p_units = (uint8_t const *) p_utf16;
+	size_t index = 0;
+	size_t written = 0;
+
+	if ((NULL == p_utf8) || (0 == utf8_size))
+	{
+		return (0);
+	}
+
+	// Room for the terminator
+	utf8_size--;
+
+	while (index < unit_count)
+	{
+		uint32_t code_point;
+		size_t length;
+
+#ifdef UTF16_SSE2
+		if ((unit_count - index >= ASCII_BLOCK_UNITS)
+				&& (utf8_size - written >= ASCII_BLOCK_UNITS)
+				&& convert_ascii_block(&p_units[2 * index], &p_utf8[written]))
+		{
+			index += ASCII_BLOCK_UNITS;
+			written += ASCII_BLOCK_UNITS;
+			continue;
+		}
+#endif
+
+		code_point = p_units[2 * index] | (p_units[2 * index + 1] << 8);
+		if (0 == code_point)
+		{
+			break;
+		}
+
+		length = 1;
+		if ((code_point >= 0xD800) && (code_point <= 0xDFFF))
+		{
+			uint32_t low = 0;
+
+			if (index + 1 < unit_count)
+			{
+				low = p_units[2 * index + 2] | (p_units[2 * index + 3] << 8);
+			}
+
+			if ((code_point <= 0xDBFF) && (low >= 0xDC00) && (low <= 0xDFFF))
+			{
+				code_point = 0x10000 + ((code_point - 0xD800) << 10)
+						+ (low - 0xDC00);
+				length = 2;
+			}
+			else
+			{
+				code_point = REPLACEMENT_CHARACTER;
+			}
+		}
+
+		if (code_point < 0x80)
+		{
+			if (utf8_size - written < 1)
+			{
+				break;
+			}
+			p_utf8[written++] = (char) code_point;
+		}
+		else if (code_point < 0x800)
+		{
+			if (utf8_size - written < 2)
+			{
+				break;
+			}
+			p_utf8[written++] = (char) (0xC0 | (code_point >> 6));
+			p_utf8[written++] = (char) (0x80 | (code_point & 0x3F));
+		}
+		else if (code_point < 0x10000)
+		{
+			if (utf8_size - written < 3)
+			{
+				break;
+			}
+			p_utf8[written++] = (char) (0xE0 | (code_point >> 12));
+			p_utf8[written++] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+			p_utf8[written++] = (char) (0x80 | (code_point & 0x3F));
+		}
+		else
+		{
+			if (utf8_size - written < 4)
+			{
+				break;
+			}
+			p_utf8[written++] = (char) (0xF0 | (code_point >> 18));
+			p_utf8[written++] = (char) (0x80 | ((code_point >> 12) & 0x3F));
+			p_utf8[written++] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+			p_utf8[written++] = (char) (0x80 | (code_point & 0x3F));
+		}
+
+		index += length;
+	}
+
+	p_utf8[written] = '\0';
+
+	return (written);
+}
@@ -0,0 +1,84 @@
+/*
+ ==============================================================================
+ Name        : utf16.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef UTF16_H_
+#define UTF16_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+
+ utf16le_to_utf8() converts up to unit_count little-endian UTF-16 code units,
+ such as the bString of a USB string descriptor, to UTF-8. The units need not
+ be aligned. Conversion stops early at a zero unit, so fixed size buffers
+ filled by the HidD_Get*String functions need no length of their own.
+
+ Unpaired surrogates become U+FFFD. The output is always zero terminated and
+ never ends in a partial sequence; the number of bytes written before the
+ terminator is returned. A utf8_size of UTF16_UTF8_SIZE(unit_count) always
+ holds the whole conversion.
+
+ Runs of ASCII are converted 8 units at a time where SSE2 is available.
+
+ */
+
+// Most UTF-8 bytes a code unit converts to (a surrogate pair takes 4 for 2)
+#define UTF16_UTF8_MAX_PER_UNIT		(3)
+
+#define UTF16_UTF8_SIZE(unit_count)	\
+	((unit_count) * UTF16_UTF8_MAX_PER_UNIT + 1)
+
+size_t utf16le_to_utf8(void const * p_utf16, size_t unit_count, char * p_utf8,
+		size_t utf8_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UTF16_H_ */
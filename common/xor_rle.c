@@ -0,0 +1,197 @@
+/*
+ ==============================================================================
+ Name        : xor_rle.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Module include
+#include "xor_rle.h"
+
+// Local declarations
+
+// Literal runs are cut at this length to keep their run header a single byte
+#define MAX_LITERAL_RUN		(63)
+
+static size_t put_run(uint8_t * p_output, size_t output_capacity,
+		size_t position, size_t run_length, bool is_zero);
+
+// Implementation
+
+static size_t put_run(uint8_t * p_output, size_t output_capacity,
+		size_t position, size_t run_length, bool is_zero)
+{
+	uint64_t value = ((uint64_t) run_length << 1) | (is_zero ? 1 : 0);
+
+	do
+	{
+		if (position >= output_capacity)
+		{
+			return (0);
+		}
+
+		p_output[position++] = (uint8_t) ((value & 0x7F)
+				| ((value >= 0x80) ? 0x80 : 0));
+		value >>= 7;
+	} while (0 != value);
+
+	return (position);
+}
+
+size_t xor_rle_encode(uint8_t const * p_input, size_t input_length,
+		size_t stride, uint8_t * p_output, size_t output_capacity)
+{
+	size_t position = 0;
+	size_t index = 0;
+
+	while (index < input_length)
+	{
+		size_t run_length = 0;
+		bool is_zero;
+
+		// Bytes of the first record have nothing to be XORed with
+		is_zero = (0
+				== (p_input[index]
+						^ ((index >= stride) ? p_input[index - stride] : 0)));
+
+		while ((index + run_length) < input_length)
+		{
+			size_t at = index + run_length;
+			uint8_t delta = p_input[at]
+					^ ((at >= stride) ? p_input[at - stride] : 0);
+
+			if ((0 == delta) != is_zero)
+			{
+				break;
+			}
+
+			run_length++;
+
+			if ((!is_zero) && (MAX_LITERAL_RUN == run_length))
+			{
+				break;
+			}
+		}
+
+		position = put_run(p_output, output_capacity, position, run_length,
+				is_zero);
+		if (0 == position)
+		{
+			return (0); // Does not fit
+		}
+
+		if (!is_zero)
+		{
+			size_t at;
+
+			if ((position + run_length) > output_capacity)
+			{
+				return (0); // Does not fit
+			}
+
+			for (at = index; at < (index + run_length); at++)
+			{
+				p_output[position++] = p_input[at]
+						^ ((at >= stride) ? p_input[at - stride] : 0);
+			}
+		}
+
+		index += run_length;
+	}
+
+	return (position);
+}
+
+bool xor_rle_decode(uint8_t const * p_input, size_t input_length,
+		size_t stride, uint8_t * p_output, size_t output_length)
+{
+	size_t position = 0;
+	size_t index = 0;
+
+	while (position < input_length)
+	{
+		uint64_t value = 0;
+		unsigned int shift = 0;
+		size_t run_length;
+		bool is_zero;
+		uint8_t byte;
+
+		do
+		{
+			if ((position >= input_length) || (shift > 63))
+			{
+				return (false);
+			}
+
+			byte = p_input[position++];
+			value |= (uint64_t) (byte & 0x7F) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+
+		is_zero = (0 != (value & 1));
+		run_length = (size_t) (value >> 1);
+
+		if ((run_length > (output_length - index))
+				|| ((!is_zero) && (run_length > (input_length - position))))
+		{
+			return (false);
+		}
+
+		while (run_length-- > 0)
+		{
+			uint8_t delta = is_zero ? 0 : p_input[position++];
+
+			p_output[index] = delta
+					^ ((index >= stride) ? p_output[index - stride] : 0);
+			index++;
+		}
+	}
+
+	return (index == output_length);
+}
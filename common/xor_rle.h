@@ -0,0 +1,89 @@
+/*
+ ==============================================================================
+ Name        : xor_rle.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef XOR_RLE_H_
+#define XOR_RLE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+
+ A tiny codec for streams of similar fixed size records such as HID reports.
+
+ Every byte is first XORed with the byte one stride (i.e. one record) before
+ it, so bytes which did not change from the previous record become zero.
+ The result is then stored as a sequence of runs, each introduced by a
+ varint (unsigned LEB128) holding the run length shifted left by one with
+ the low bit set for a run of zeros. A run of zeros carries no data, any
+ other run is followed by its bytes.
+
+ */
+
+/*
+
+ xor_rle_encode() returns the number of bytes written to p_output, or 0 if
+ the encoded data does not fit output_capacity (e.g. for data which does not
+ repeat, where the caller is better off storing the input as is).
+
+ xor_rle_decode() returns true only if exactly output_length bytes were
+ decoded from well formed input.
+
+ */
+
+size_t xor_rle_encode(uint8_t const * p_input, size_t input_length,
+		size_t stride, uint8_t * p_output, size_t output_capacity);
+
+bool xor_rle_decode(uint8_t const * p_input, size_t input_length,
+		size_t stride, uint8_t * p_output, size_t output_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XOR_RLE_H_ */
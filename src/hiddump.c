@@ -65,8 +65,21 @@
 #include "win_msg_hdlr.h"
 #include "usb_defs.h"
 #include "usb_hid.h"
+#include "usb_hid_plan.h"
+#include "usb_hid_strings.h"
+#include "usb_string_cache.h"
+#include "usb_enum.h"
+#include "usb_enum_synthetic.h"
+#include "usb_enum_sysfs.h"
+#include "usb_enum_snapshot.h"
+#include "usb_enum_diff.h"
 #include "usb_debug.h"
+#include "usb_hid_capture.h"
+#include "usb_hid_export.h"
+#include "usb_hid_columns.h"
+#include "usb_hid_decode.h"
 #include "usb_hid_msg_hdlr.h"
+#include "usb_hid_event_loop.h"
 
 // Module include
 #include "hiddump.h"
@@ -74,33 +87,243 @@
 #define LINE_WIDTH      (80)
 
 // Local declarations
+static bool enumerate(USB_ENUM_PROVIDER provider, HANDLE h_provider);
 
 // Global declarations
 cmd_line_params_t g_cmd_line_params =
-{ 0, 0, false, false };
+{ 0 };
 
 // Implementation
+
+// Prints (-e) and/or records (-n) what a provider enumerates
+static bool enumerate(USB_ENUM_PROVIDER provider, HANDLE h_provider)
+{
+	bool is_print = g_cmd_line_params.enumerate
+			|| (NULL == g_cmd_line_params.p_snapshot_save_path);
+	bool success = true;
+
+	if (NULL != g_cmd_line_params.p_snapshot_save_path)
+	{
+		bool is_json = (HID_EXPORT_FORMAT_JSON
+				== g_cmd_line_params.export_format);
+
+		success = usb_enum_snapshot_save(
+				g_cmd_line_params.p_snapshot_save_path,
+				is_json ? USB_ENUM_SNAPSHOT_FORMAT_JSON :
+						USB_ENUM_SNAPSHOT_FORMAT_BINARY, provider, h_provider);
+
+		// Print what was just recorded rather than enumerating again
+		if (success && is_print && !is_json)
+		{
+			HANDLE h_snapshot = usb_enum_snapshot_load(
+					g_cmd_line_params.p_snapshot_save_path);
+
+			if (NULL != h_snapshot)
+			{
+				usb_print_enumeration(g_cmd_line_params.show_descriptors,
+						usb_enum_snapshot_run, h_snapshot);
+				usb_enum_snapshot_destroy(h_snapshot);
+				is_print = false;
+			}
+		}
+	}
+
+	if (is_print)
+	{
+		usb_print_enumeration(g_cmd_line_params.show_descriptors, provider,
+				h_provider);
+	}
+
+	return (success);
+}
+
 int hid_dump(void)
 {
 	char * p_device_path;
+	hid_filter_t filter;
 	hid_device_t hid_device;
+	int result = EXIT_SUCCESS;
 	bool success;
 
+	// Converting a capture needs no HID at all
+	if (NULL != g_cmd_line_params.p_columns_path)
+	{
+		success = hid_columns_export(g_cmd_line_params.p_convert_capture_path,
+				g_cmd_line_params.p_columns_path,
+				g_cmd_line_params.convert_from_us,
+				g_cmd_line_params.convert_to_us);
+
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Neither does decoding one
+	if (NULL != g_cmd_line_params.p_decode_capture_path)
+	{
+		FILE *p_decode_file = stdout;
+
+		if (NULL != g_cmd_line_params.p_export_path)
+		{
+			p_decode_file = fopen(g_cmd_line_params.p_export_path, "wb");
+			if (NULL == p_decode_file)
+			{
+				fprintf(stderr, "Cannot open output file '%s'\n",
+						g_cmd_line_params.p_export_path);
+				return (EXIT_FAILURE);
+			}
+		}
+
+		success = hid_decode_capture(g_cmd_line_params.p_decode_capture_path,
+				p_decode_file,
+				(HID_EXPORT_FORMAT_NONE == g_cmd_line_params.export_format) ?
+						HID_EXPORT_FORMAT_JSON :
+						g_cmd_line_params.export_format, 0);
+
+		if (stdout != p_decode_file)
+		{
+			fclose(p_decode_file);
+		}
+
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Nor does enumerating a synthetic topology
+	if (NULL != g_cmd_line_params.p_topology_path)
+	{
+		HANDLE h_topology = usb_enum_synthetic_load(
+				g_cmd_line_params.p_topology_path);
+
+		if (NULL == h_topology)
+		{
+			return (EXIT_FAILURE);
+		}
+
+		success = enumerate(usb_enum_synthetic_run, h_topology);
+
+		usb_enum_synthetic_destroy(h_topology);
+
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Nor does enumerating a sysfs tree
+	if (NULL != g_cmd_line_params.p_sysfs_path)
+	{
+		HANDLE h_sysfs = usb_enum_sysfs_create(g_cmd_line_params.p_sysfs_path);
+
+		if (NULL == h_sysfs)
+		{
+			return (EXIT_FAILURE);
+		}
+
+		success = enumerate(usb_enum_sysfs_run, h_sysfs);
+
+		usb_enum_sysfs_destroy(h_sysfs);
+
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Nor does enumerating a snapshot
+	if (NULL != g_cmd_line_params.p_snapshot_load_path)
+	{
+		HANDLE h_snapshot = usb_enum_snapshot_load(
+				g_cmd_line_params.p_snapshot_load_path);
+
+		if (NULL == h_snapshot)
+		{
+			return (EXIT_FAILURE);
+		}
+
+		success = enumerate(usb_enum_snapshot_run, h_snapshot);
+
+		usb_enum_snapshot_destroy(h_snapshot);
+
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Nor does comparing two snapshots
+	if (NULL != g_cmd_line_params.p_diff_old_path)
+	{
+		HANDLE h_snapshots[2] =
+		{ usb_enum_snapshot_load(g_cmd_line_params.p_diff_old_path),
+				usb_enum_snapshot_load(g_cmd_line_params.p_diff_new_path) };
+		HANDLE h_indexes[2] =
+		{ NULL, NULL };
+		size_t index;
+
+		for (index = 0; index < 2; index++)
+		{
+			if (NULL != h_snapshots[index])
+			{
+				h_indexes[index] = usb_enum_diff_index(usb_enum_snapshot_run,
+						h_snapshots[index]);
+				usb_enum_snapshot_destroy(h_snapshots[index]);
+			}
+		}
+
+		success = (NULL != h_indexes[0]) && (NULL != h_indexes[1]);
+		if (success)
+		{
+			printf("%lu differences\n",
+					(unsigned long) usb_enum_diff_print(h_indexes[0],
+							h_indexes[1], stdout));
+		}
+
+		usb_enum_diff_destroy(h_indexes[0]);
+		usb_enum_diff_destroy(h_indexes[1]);
+
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Watching for changes replaces enumerating over and over
+	if (true == g_cmd_line_params.watch)
+	{
+		success = usb_enum_diff_watch(g_cmd_line_params.hInstance,
+				usb_enumerate_cached, NULL);
+
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
 	// Before we do anything, let's enumerate the entire USB chain.
 	// This will give us an overview of what the host has.
-	if (true == g_cmd_line_params.enumerate)
+	if ((true == g_cmd_line_params.enumerate)
+			|| (NULL != g_cmd_line_params.p_snapshot_save_path))
 	{
-		usb_print_enumeration(g_cmd_line_params.show_descriptors);
+		// Strings read in earlier runs need not be requested again
+		HANDLE h_string_cache = usb_string_cache_create();
+		char string_cache_path[MAX_PATH];
+		bool has_string_cache_path = usb_string_cache_get_default_path(
+				string_cache_path, sizeof(string_cache_path));
+
+		if (has_string_cache_path)
+		{
+			usb_string_cache_load(h_string_cache, string_cache_path);
+		}
+
+		enumerate(usb_enumerate_cached, h_string_cache);
+
+		if (has_string_cache_path
+				&& !usb_string_cache_save(h_string_cache, string_cache_path))
+		{
+			fprintf(stderr, "Cannot update string cache '%s'\n",
+					string_cache_path);
+		}
+		usb_string_cache_destroy(h_string_cache);
 	}
 
-	LINE(LINE_WIDTH, '-', true);
+	if (!g_cmd_line_params.is_stdout_structured)
+	{
+		LINE(LINE_WIDTH, '-', true);
+	}
 
 	// Simple initialization of the target HID
 	memset(&hid_device, 0, sizeof(hid_device));
 
 	// Find the HID path for this specified device
-	success = usb_get_hid_device_path(g_cmd_line_params.vid,
-			g_cmd_line_params.pid, &p_device_path);
+	memset(&filter, 0, sizeof(filter));
+	filter.vid = g_cmd_line_params.vid;
+	filter.pid = g_cmd_line_params.pid;
+	filter.p_serial_number = g_cmd_line_params.p_serial_number;
+
+	success = usb_find_hid_device_path(&filter, &p_device_path);
 	if (!success)
 	{
 		fprintf(stderr, "Cannot find HID with VID=0x%0x, PID=0x%0x\n",
@@ -111,7 +334,20 @@ int hid_dump(void)
 		// We need only read(overlapped) access
 		usb_open_options_t options = USB_READ_ACCESS | USB_OVERLAPPED;
 
-		success = usb_open_hid(p_device_path, options, &hid_device);
+		// Keep the plans so the HID needs no compiling should it return, and
+		// share them with later runs through the cache file
+		HANDLE h_plan_cache = hid_plan_cache_create();
+		char plan_cache_path[MAX_PATH];
+		bool has_plan_cache_path = hid_plan_cache_get_default_path(
+				plan_cache_path, sizeof(plan_cache_path));
+
+		if (has_plan_cache_path)
+		{
+			hid_plan_cache_load(h_plan_cache, plan_cache_path);
+		}
+
+		success = usb_open_hid_cached(p_device_path, options, &hid_device,
+				h_plan_cache);
 		if (!success)
 		{
 			fprintf(stderr, "Cannot open HID with device path '%s'\n",
@@ -123,26 +359,112 @@ int hid_dump(void)
 
 			// Load HID handler
 			hid_handler.h_device_notify = NULL;
-			hid_handler.h_reader = NULL;
+			hid_handler.h_export = NULL;
+			hid_handler.h_capture = NULL;
 			hid_handler.p_hid_device = &hid_device;
+			hid_handler.h_plan_cache = h_plan_cache;
+			hid_handler.is_arrival = false;
+
+			// Reattach to the same HID should it be removed
+			hid_handler.filter = filter;
 
 			// Print our HID information
-			usb_print_hid_device(&hid_device);
+			if (!g_cmd_line_params.is_stdout_structured)
+			{
+				usb_print_hid_device(&hid_device,
+						g_cmd_line_params.show_descriptors);
+			}
 
 			// Check if we should run the real-time HID parser
 			if (true == g_cmd_line_params.run_parser)
 			{
-				// Start message handler (never returns)
-				win_msg_hdlr_start(g_cmd_line_params.hInstance, hid_msg_hdlr,
-						&hid_handler);
+				FILE *p_export_file = stdout;
+
+				// Check if the parsed reports are to be exported
+				if (HID_EXPORT_FORMAT_NONE != g_cmd_line_params.export_format)
+				{
+					if (NULL != g_cmd_line_params.p_export_path)
+					{
+						p_export_file = fopen(g_cmd_line_params.p_export_path,
+								"wb");
+						if (NULL == p_export_file)
+						{
+							fprintf(stderr, "Cannot open output file '%s'\n",
+									g_cmd_line_params.p_export_path);
+							result = EXIT_FAILURE;
+						}
+					}
+
+					if (NULL != p_export_file)
+					{
+						hid_handler.h_export = hid_export_create(p_export_file,
+								g_cmd_line_params.export_format,
+								g_cmd_line_params.export_metadata, &hid_device,
+								HID_REPORT_TYPE_INPUT);
+						if (NULL == hid_handler.h_export)
+						{
+							fprintf(stderr, "Cannot export the reports\n");
+							result = EXIT_FAILURE;
+						}
+					}
+				}
+
+				// Check if the raw reports are to be captured
+				if ((EXIT_SUCCESS == result)
+						&& (NULL != g_cmd_line_params.p_capture_path))
+				{
+					hid_handler.h_capture = hid_capture_create_writer(
+							g_cmd_line_params.p_capture_path, &hid_device,
+							HID_REPORT_TYPE_INPUT);
+					if (NULL == hid_handler.h_capture)
+					{
+						fprintf(stderr, "Cannot create capture '%s'\n",
+								g_cmd_line_params.p_capture_path);
+						result = EXIT_FAILURE;
+					}
+				}
+
+				// Service the reports until we are stopped, unless what was
+				// asked for cannot be written
+				if (EXIT_SUCCESS == result)
+				{
+					hid_event_loop_run(g_cmd_line_params.hInstance,
+							&hid_handler);
+				}
+
+				if ((NULL != hid_handler.h_capture)
+						&& !hid_capture_destroy_writer(hid_handler.h_capture))
+				{
+					fprintf(stderr, "Cannot complete capture '%s'\n",
+							g_cmd_line_params.p_capture_path);
+					result = EXIT_FAILURE;
+				}
+				hid_export_destroy(hid_handler.h_export);
+				if ((NULL != p_export_file) && (stdout != p_export_file))
+				{
+					fclose(p_export_file);
+				}
 			}
 
 			// We are now done with the HID
 			usb_close_hid(&hid_device);
 		}
+
+		if (has_plan_cache_path
+				&& !hid_plan_cache_save(h_plan_cache, plan_cache_path))
+		{
+			fprintf(stderr, "Cannot update plan cache '%s'\n",
+					plan_cache_path);
+		}
+		hid_plan_cache_destroy(h_plan_cache);
 	}
 
-	LINE(LINE_WIDTH, '-', true);
+	hid_strings_free();
+
+	if (!g_cmd_line_params.is_stdout_structured)
+	{
+		LINE(LINE_WIDTH, '-', true);
+	}
 
-	return EXIT_SUCCESS;
+	return (result);
 }
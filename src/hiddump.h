@@ -56,10 +56,48 @@ typedef struct _cmd_line_params_t
 {
 	usb_vid_t vid;
 	usb_pid_t pid;
+	char *p_serial_number; // NULL for any
 	bool enumerate;
 	bool show_descriptors;
 	bool run_parser;
 
+	// Structured output of the real-time HID report parser
+	hid_export_format_t export_format;
+	char *p_export_path; // NULL for stdout
+	bool export_metadata; // Precede the records with a metadata line
+
+	// Records go to stdout, so the banner, the HID's description and other
+	// text is left out
+	bool is_stdout_structured;
+
+	// Raw report capture of the real-time HID report parser
+	char *p_capture_path; // NULL for none
+
+	// Offline conversion of a capture into a columns file
+	char *p_convert_capture_path;
+	char *p_columns_path;
+	uint64_t convert_from_us; // Window to convert (usec since 1970)
+	uint64_t convert_to_us; // 0 for no limit
+
+	// Offline decode of a capture into the -o format
+	char *p_decode_capture_path;
+
+	// Enumeration of a synthetic topology file instead of the system
+	char *p_topology_path;
+
+	// Enumeration of a (copied or fake) Linux sysfs tree instead of the system
+	char *p_sysfs_path;
+
+	// Enumeration snapshots, recorded (in the -o json format if given)
+	// and enumerated instead of the system
+	char *p_snapshot_save_path;
+	char *p_snapshot_load_path;
+
+	// Comparison of two snapshots, and of the system as devices come and go
+	char *p_diff_old_path;
+	char *p_diff_new_path;
+	bool watch;
+
 	// Windows stuff
 	HINSTANCE hInstance;
 
@@ -47,7 +47,7 @@
  C:\MinGW\lib
 
  setupapi.a - Contains the APIs needed for device detection. These are
- the SetupDi_API functions.
+ the SetupDi_API functions, and the CM_ functions walking the device tree.
  hid.a -
 
  Compiler definitions
@@ -68,8 +68,15 @@
 #include "output.h"
 #include "version.h"
 
+// WDDK includes
+#include <hidsdi.h>
+
 // Project includes
+#include "utils.h"
 #include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_hid_capture.h"
+#include "usb_hid_export.h"
 #include "hiddump.h"
 
 #define LINE_WIDTH      (80)
@@ -120,13 +127,39 @@ static void title(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "usage: hiddump [-vid #] [-pid #] [-e] [-d] [-r] [-v]\n");
+	fprintf(stderr, "usage: hiddump [-vid #] [-pid #] [-sn serial] [-e] [-d] "
+			"[-r] [-o json|csv] [-meta] [-f file] [-w capture] "
+			"[-x capture columns] [-t from to] [-y capture] [-s topology] "
+			"[-u sysfs] "
+			"[-n snapshot] [-l snapshot] [-c old new] [-m] [-v]\n");
 	fprintf(stderr, "Where:\n");
 	fprintf(stderr, "\t-vid The vendor-id of a USB device.\n");
 	fprintf(stderr, "\t-pid The product-id of a USB device.\n");
+	fprintf(stderr, "\t-sn The serial number of a USB device.\n");
 	fprintf(stderr, "\t-e Enumerate all USB hcs, hubs and devices.\n");
 	fprintf(stderr, "\t-d Descriptors for specified device id is output.\n");
 	fprintf(stderr, "\t-r Real-time HID report parser.\n");
+	fprintf(stderr, "\t-o Output parsed reports as JSON Lines or CSV.\n");
+	fprintf(stderr, "\t-meta Precede the -o output with the HID's product "
+			"string and serial number.\n");
+	fprintf(stderr, "\t-f File to write the -o output to (default stdout).\n");
+	fprintf(stderr, "\t-w Capture the raw reports parsed by -r to a file.\n");
+	fprintf(stderr, "\t-x Convert a capture into a columns file and exit.\n");
+	fprintf(stderr, "\t-t Only convert the reports -x finds between two "
+			"timestamps (usec).\n");
+	fprintf(stderr, "\t-y Decode a capture as -o (default json) to -f "
+			"and exit.\n");
+	fprintf(stderr, "\t-s Enumerate a synthetic topology file like -e "
+			"and exit.\n");
+	fprintf(stderr, "\t-u Enumerate a Linux sysfs tree (e.g. "
+			"/sys/bus/usb/devices) like -e and exit.\n");
+	fprintf(stderr, "\t-n Record the enumeration (-o json for JSON Lines) "
+			"to a snapshot.\n");
+	fprintf(stderr, "\t-l Enumerate a snapshot like -e and exit.\n");
+	fprintf(stderr, "\t-c Print the devices added, removed or changed "
+			"between two snapshots.\n");
+	fprintf(stderr, "\t-m Print the devices added, removed or changed "
+			"as they come and go.\n");
 	fprintf(stderr, "\t-v Version information.\n");
 	fprintf(stderr, "\n");
 
@@ -136,11 +169,10 @@ static void usage(void)
 int local_main(int argc, char **argv)
 {
 	int i, result;
+	bool is_export;
 
 	InitializeOutput();
 
-	title();
-
 	// Parse command line args...
 	for (i = 1; i < argc; i++) /* Skip argv[0] (program name). */
 	{
@@ -194,6 +226,20 @@ int local_main(int argc, char **argv)
 				break;
 			}
 		}
+		else if (strcmp(argv[i], "-sn") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_serial_number = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
 		else if (strcmp(argv[i], "-e") == 0) /* Optional argument. */
 		{
 			g_cmd_line_params.enumerate = true;
@@ -206,8 +252,179 @@ int local_main(int argc, char **argv)
 		{
 			g_cmd_line_params.run_parser = true;
 		}
+		else if (strcmp(argv[i], "-o") == 0) /* Optional argument. */
+		{
+			i++;
+			if ((i <= cArgs) && (strcmp(argv[i], "json") == 0))
+			{
+				g_cmd_line_params.export_format = HID_EXPORT_FORMAT_JSON;
+			}
+			else if ((i <= cArgs) && (strcmp(argv[i], "csv") == 0))
+			{
+				g_cmd_line_params.export_format = HID_EXPORT_FORMAT_CSV;
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-meta") == 0) /* Optional argument. */
+		{
+			g_cmd_line_params.export_metadata = true;
+		}
+		else if (strcmp(argv[i], "-f") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_export_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-w") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_capture_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-x") == 0) /* Optional argument. */
+		{
+			i += 2;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_convert_capture_path = argv[i - 1];
+				g_cmd_line_params.p_columns_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-t") == 0) /* Optional argument. */
+		{
+			i += 2;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.convert_from_us = _strtoui64(argv[i - 1],
+						NULL, 10);
+				g_cmd_line_params.convert_to_us = _strtoui64(argv[i], NULL, 10);
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-y") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_decode_capture_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-s") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_topology_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-u") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_sysfs_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-n") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_snapshot_save_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-l") == 0) /* Optional argument. */
+		{
+			i++;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_snapshot_load_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-c") == 0) /* Optional argument. */
+		{
+			i += 2;
+			if (i <= cArgs) /* There are enough arguments in argv. */
+			{
+				g_cmd_line_params.p_diff_old_path = argv[i - 1];
+				g_cmd_line_params.p_diff_new_path = argv[i];
+			}
+			else
+			{
+				/* Print usage statement and exit (see below). */
+				usage();
+				break;
+			}
+		}
+		else if (strcmp(argv[i], "-m") == 0) /* Optional argument. */
+		{
+			g_cmd_line_params.watch = true;
+		}
 		else if (strcmp(argv[i], "-v") == 0) /* Optional argument. */
 		{
+			title();
 			credits();
 			usage();
 			return EXIT_SUCCESS;
@@ -218,13 +435,29 @@ int local_main(int argc, char **argv)
 		}
 	}
 
-	printf("Using: VID=0x%0x, PID=0x%0x\n", g_cmd_line_params.vid,
-			g_cmd_line_params.pid);
+	// Records written to stdout must not be mixed with anything else
+	is_export = g_cmd_line_params.run_parser
+			&& (HID_EXPORT_FORMAT_NONE != g_cmd_line_params.export_format);
+	g_cmd_line_params.is_stdout_structured =
+			(NULL == g_cmd_line_params.p_export_path)
+					&& (is_export
+							|| (NULL != g_cmd_line_params.p_decode_capture_path));
+
+	if (!g_cmd_line_params.is_stdout_structured)
+	{
+		title();
+
+		printf("Using: VID=0x%0x, PID=0x%0x\n", g_cmd_line_params.vid,
+				g_cmd_line_params.pid);
+	}
 
 	// Run application
 	result = hid_dump();
 
-	puts("Done.");
+	if (!g_cmd_line_params.is_stdout_structured)
+	{
+		puts("Done.");
+	}
 	return result;
 }
 
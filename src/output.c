@@ -116,6 +116,10 @@ void InitializeOutput(void)
 	FILE *hf;
 
 	AllocConsole();
+
+	// Strings are printed as UTF-8, see utf16le_to_utf8()
+	SetConsoleOutputCP(CP_UTF8);
+
 	hCrt = _open_osfhandle((long) GetStdHandle(STD_OUTPUT_HANDLE), _O_TEXT);
 	hf = _fdopen(hCrt, "w");
 	*stdout = *hf;
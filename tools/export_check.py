@@ -0,0 +1,135 @@
+# ==============================================================================
+# Name        : export_check.py
+# Date        : Oct 18, 2026
+# ==============================================================================
+#
+# BSD License
+# -----------
+#
+# Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# - Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# - Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# - Neither the name of Kevin Fodor nor the names of
+# its contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+# NOTICE:
+# SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+# IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+# IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+# LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+#
+# ==============================================================================
+
+"""Checks that hiddump's offline decode (-y) of a capture matches the live
+export (-o) of the same reports.
+
+Usage:
+    python export_check.py <hiddump> <capture> <export>
+
+The capture and the export are recorded by a single run, e.g.
+
+    hiddump -vid 0x046d -pid 0xc077 -r -w mouse.hcap -o json -f mouse.json
+
+The capture is then decoded in the export's format (JSON Lines or CSV) and
+both are compared: the CSV header, the keys of every JSON record and the
+records themselves must be the same.
+"""
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+def read_records(path):
+    """Returns the export's format and its lines (metadata left out)."""
+    with open(path) as f:
+        lines = [line.rstrip("\r\n") for line in f]
+    lines = [line for line in lines if line and not line.startswith("#")
+             and not line.startswith('{"metadata":')]
+    is_json = (len(lines) > 0) and lines[0].startswith("{")
+    return ("json" if is_json else "csv"), lines
+
+
+def json_keys(record):
+    return sorted(record.keys()), list(record.get("fields", {}).keys())
+
+
+def compare(live, decoded, is_json):
+    failures = 0
+    if (not is_json) and (live[:1] != decoded[:1]):
+        print("header: live %r, decoded %r" % (live[:1], decoded[:1]))
+        return 1
+
+    for index in range(max(len(live), len(decoded))):
+        want = live[index] if index < len(live) else None
+        got = decoded[index] if index < len(decoded) else None
+        if want == got:
+            continue
+        if is_json and (want is not None) and (got is not None):
+            want_keys = json_keys(json.loads(want))
+            got_keys = json_keys(json.loads(got))
+            if want_keys != got_keys:
+                print("record %d keys: live %r, decoded %r"
+                      % (index, want_keys, got_keys))
+                failures += 1
+                continue
+        print("record %d: live %r, decoded %r" % (index, want, got))
+        failures += 1
+
+    return failures
+
+
+def check(hiddump, capture, export):
+    export_format, live = read_records(export)
+
+    root = tempfile.mkdtemp()
+    try:
+        decoded_path = os.path.join(root, "decoded." + export_format)
+        subprocess.check_call([hiddump, "-y", capture, "-o", export_format,
+                               "-f", decoded_path])
+        decoded = read_records(decoded_path)[1]
+    finally:
+        shutil.rmtree(root)
+
+    failures = compare(live, decoded, export_format == "json")
+
+    print("%s" % ("FAILED" if failures else "OK"))
+
+    return 1 if failures else 0
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.stderr.write(__doc__)
+        return 2
+
+    return check(sys.argv[1], sys.argv[2], sys.argv[3])
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,443 @@
+# ==============================================================================
+# Name        : hid_columns.py
+# Date        : Oct 18, 2026
+# ==============================================================================
+#
+# BSD License
+# -----------
+#
+# Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# - Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# - Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# - Neither the name of Kevin Fodor nor the names of
+# its contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+# NOTICE:
+# SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+# IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+# IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+# LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+#
+# ==============================================================================
+
+"""Reads the columns files written by hiddump -x (see usb/usb_hid_columns.h).
+
+Usage:
+    python hid_columns.py <columns> [-r report_id] [-c name,...] > out.csv
+    python hid_columns.py <columns> -l
+    python hid_columns.py --self-test
+
+The first form writes the rows of one report ID (the lowest one by default)
+as CSV, the second lists the columns and --self-test writes a columns file
+from known values, reads it back and compares them. It also reads
+hid_columns_sample.hcol, written by hiddump -x from a capture of 20 reports
+of two report IDs, checks its values and that writing them again gives the
+same bytes, so the reader and writer stay in step with hiddump.
+
+Only the chunks of the wanted columns are read, so a few columns of a large
+file are quick to get. The module may also be imported, read_columns()
+returns the columns as lists of integers for use with e.g. pandas.
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+import tempfile
+
+SAMPLE_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           "hid_columns_sample.hcol")
+
+MAGIC = b"HIDCOL"
+TRAILER_MAGIC = b"HCOL"
+VERSION = 2
+
+ROWS_PER_CHUNK = 64 * 1024
+MAX_DICTIONARY = 256
+
+KIND_TIMESTAMP = 0
+KIND_VALUE = 1
+KIND_BUTTONS = 2
+
+ENCODING_DELTA = 0
+ENCODING_DICTIONARY = 1
+
+NAME_SIZE = 56
+
+HEADER = struct.Struct("<8sHHHH")
+COLUMN = struct.Struct("<%dsBBHHH" % NAME_SIZE)
+CHUNK = struct.Struct("<IIB7xQQ")
+TRAILER = struct.Struct("<QI4s")
+
+
+class Column(object):
+    """A column as described in the file, with its values once read."""
+
+    def __init__(self, index, name, report_id, kind, usage_page, usage,
+                 bit_count):
+        self.index = index
+        self.name = name
+        self.report_id = report_id
+        self.kind = kind
+        self.usage_page = usage_page
+        self.usage = usage
+        self.bit_count = bit_count
+        self.values = []
+
+
+def get_varint(data, position):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[position]
+        position += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, position
+
+
+def put_varint(out, value):
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def zigzag(value):
+    return ((value << 1) ^ (value >> 63)) & 0xFFFFFFFFFFFFFFFF
+
+
+def to_signed(value):
+    return value - (1 << 64) if value >= (1 << 63) else value
+
+
+def decode_chunk(data, encoding, count):
+    values = []
+    position = 0
+
+    if ENCODING_DELTA == encoding:
+        # Differences wrap around as unsigned 64 bit values
+        previous = 0
+        for _ in range(count):
+            delta, position = get_varint(data, position)
+            previous = (previous + unzigzag(delta)) & 0xFFFFFFFFFFFFFFFF
+            values.append(to_signed(previous))
+    elif ENCODING_DICTIONARY == encoding:
+        dictionary_count, position = get_varint(data, position)
+        dictionary = []
+        for _ in range(dictionary_count):
+            value, position = get_varint(data, position)
+            dictionary.append(unzigzag(value))
+        while len(values) < count:
+            index, position = get_varint(data, position)
+            run_length, position = get_varint(data, position)
+            values.extend([dictionary[index]] * run_length)
+    else:
+        raise ValueError("unknown chunk encoding %d" % encoding)
+
+    if len(values) != count:
+        raise ValueError("chunk holds %d values, expected %d"
+                         % (len(values), count))
+
+    return values
+
+
+def read_columns(path, names=None, report_id=None):
+    """Returns the file's header fields and its columns.
+
+    Only the columns named in names (all when None) of report_id (every
+    report ID when None) have their values read.
+    """
+    with open(path, "rb") as f:
+        data = f.read(HEADER.size)
+        if len(data) != HEADER.size:
+            raise ValueError("'%s' is too short" % path)
+        magic, version, column_count, vendor_id, product_id = \
+            HEADER.unpack(data)
+        if (magic.rstrip(b"\0") != MAGIC) or (version != VERSION):
+            raise ValueError("'%s' is not a supported columns file" % path)
+
+        columns = []
+        for index in range(column_count):
+            name, rid, kind, usage_page, usage, bit_count = \
+                COLUMN.unpack(f.read(COLUMN.size))
+            columns.append(Column(index,
+                                  name.split(b"\0", 1)[0].decode("ascii"),
+                                  rid, kind, usage_page, usage, bit_count))
+
+        f.seek(-TRAILER.size, os.SEEK_END)
+        index_offset, chunk_count, magic = TRAILER.unpack(f.read(TRAILER.size))
+        if magic != TRAILER_MAGIC:
+            raise ValueError("'%s' has no chunk index" % path)
+
+        f.seek(index_offset)
+        chunks = [CHUNK.unpack(f.read(CHUNK.size))
+                  for _ in range(chunk_count)]
+
+        # The index is in file order, so each column's chunks are in row order
+        for column_index, value_count, encoding, offset, length in chunks:
+            if column_index >= column_count:
+                raise ValueError("chunk of unknown column %d" % column_index)
+            column = columns[column_index]
+            if (names is not None) and (column.name not in names):
+                continue
+            if (report_id is not None) and (column.report_id != report_id):
+                continue
+            f.seek(offset)
+            column.values.extend(decode_chunk(f.read(length), encoding,
+                                              value_count))
+
+    header = {"version": version, "vendor_id": vendor_id,
+              "product_id": product_id}
+
+    return header, columns
+
+
+def write_columns(path, vendor_id, product_id, columns):
+    """Writes columns (lists of values sharing a report ID and row count)
+    the way hiddump does, for checking the reader."""
+    index = bytearray()
+    chunk_count = 0
+
+    with open(path, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(columns), vendor_id,
+                            product_id))
+        for column in columns:
+            f.write(COLUMN.pack(column.name.encode("ascii"), column.report_id,
+                                column.kind, column.usage_page, column.usage,
+                                column.bit_count))
+
+        rows = max([len(column.values) for column in columns] + [0])
+        for first in range(0, rows, ROWS_PER_CHUNK):
+            for column in columns:
+                values = column.values[first:first + ROWS_PER_CHUNK]
+                if not values:
+                    continue
+                data, encoding = encode_chunk(values,
+                                              KIND_TIMESTAMP != column.kind)
+                index += CHUNK.pack(column.index, len(values), encoding,
+                                    f.tell(), len(data))
+                f.write(data)
+                chunk_count += 1
+
+        index_offset = f.tell()
+        f.write(index)
+        f.write(TRAILER.pack(index_offset, chunk_count, TRAILER_MAGIC))
+
+
+def encode_chunk(values, try_dictionary):
+    out = bytearray()
+
+    # The dictionary is in order of first appearance, as hiddump writes it
+    lookup = {}
+    distinct = []
+    for value in values:
+        if value not in lookup:
+            lookup[value] = len(distinct)
+            distinct.append(value)
+            if len(distinct) > MAX_DICTIONARY:
+                break
+
+    if try_dictionary and (len(distinct) <= MAX_DICTIONARY):
+        put_varint(out, len(distinct))
+        for value in distinct:
+            put_varint(out, zigzag(value))
+        index = 0
+        while index < len(values):
+            run_length = 1
+            while ((index + run_length) < len(values)) \
+                    and (values[index + run_length] == values[index]):
+                run_length += 1
+            put_varint(out, lookup[values[index]])
+            put_varint(out, run_length)
+            index += run_length
+        return bytes(out), ENCODING_DICTIONARY
+
+    previous = 0
+    for value in values:
+        delta = to_signed((value - previous) & 0xFFFFFFFFFFFFFFFF)
+        put_varint(out, zigzag(delta))
+        previous = value
+    return bytes(out), ENCODING_DELTA
+
+
+def self_test():
+    rows = ROWS_PER_CHUNK + 1000  # More than one chunk per column
+    columns = [
+        Column(0, "timestamp_us", 1, KIND_TIMESTAMP, 0, 0, 64),
+        Column(1, "button_1_32", 1, KIND_BUTTONS, 0x09, 1, 32),
+        Column(2, "x", 1, KIND_VALUE, 0x01, 0x30, 12),
+        Column(3, "y", 1, KIND_VALUE, 0x01, 0x31, 32),
+    ]
+    columns[0].values = [1700000000000000 + (row * 997) for row in range(rows)]
+    columns[1].values = [(row // 5000) & 0xFFFFFFFF for row in range(rows)]
+    columns[2].values = [max(-2047, min(2047, (row % 5000) - 2500))
+                         for row in range(rows)]
+    columns[3].values = [((row * 7919) % 4000000) - 2000000
+                         for row in range(rows)]
+
+    handle, path = tempfile.mkstemp(suffix=".hcol")
+    os.close(handle)
+    try:
+        write_columns(path, 0x046D, 0xC077, columns)
+        header, read = read_columns(path)
+        _, some = read_columns(path, names=["x"])
+    finally:
+        os.remove(path)
+
+    failures = 0
+    if (header["vendor_id"] != 0x046D) or (header["product_id"] != 0xC077):
+        print("header mismatch: %r" % header)
+        failures += 1
+    for expected, column in zip(columns, read):
+        if (expected.name != column.name) \
+                or (expected.values != column.values):
+            print("column '%s' does not round trip" % expected.name)
+            failures += 1
+    if (some[2].values != columns[2].values) or some[0].values:
+        print("reading one column read the wrong columns")
+        failures += 1
+
+    failures += check_sample()
+
+    print("%s" % ("FAILED" if failures else "OK"))
+
+    return 1 if failures else 0
+
+
+def check_sample():
+    """Checks the file hiddump -x wrote for the sample capture, whose report
+    i (of 20) is ID 1 + (i & 1) holding bytes i * 7, i - 10 and 10 - i.
+    Only the buttons are unsigned."""
+    def signed(byte):
+        return ((byte & 0xFF) ^ 0x80) - 0x80
+
+    rows = range(20)
+    expected = {
+        (1, "timestamp_us"): [1700000000000000 + (i * 1000)
+                              for i in rows if not (i & 1)],
+        (1, "button_1_8"): [i * 7 for i in rows if not (i & 1)],
+        (1, "x_2"): [i - 10 for i in rows if not (i & 1)],
+        (1, "x_3"): [10 - i for i in rows if not (i & 1)],
+        (2, "timestamp_us"): [1700000000000000 + (i * 1000)
+                              for i in rows if i & 1],
+        (2, "x"): [signed(i * 7) for i in rows if i & 1],
+        (2, "y"): [i - 10 for i in rows if i & 1],
+    }
+    failures = 0
+
+    header, columns = read_columns(SAMPLE_PATH)
+    if (header["vendor_id"] != 0x046D) or (header["product_id"] != 0xC077):
+        print("sample header mismatch: %r" % header)
+        failures += 1
+    if sorted(expected) != sorted((column.report_id, column.name)
+                                  for column in columns):
+        print("sample columns mismatch")
+        return failures + 1
+    for column in columns:
+        if expected[(column.report_id, column.name)] != column.values:
+            print("sample column '%s' of report ID %u mismatch"
+                  % (column.name, column.report_id))
+            failures += 1
+
+    handle, path = tempfile.mkstemp(suffix=".hcol")
+    os.close(handle)
+    try:
+        write_columns(path, header["vendor_id"], header["product_id"],
+                      columns)
+        with open(path, "rb") as f:
+            written = f.read()
+    finally:
+        os.remove(path)
+    with open(SAMPLE_PATH, "rb") as f:
+        if f.read() != written:
+            print("the sample is written differently than hiddump wrote it")
+            failures += 1
+
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Converts a hiddump columns file to CSV.")
+    parser.add_argument("path", nargs="?", help="the columns file")
+    parser.add_argument("-r", "--report-id", type=int,
+                        help="the report ID to write (default: lowest)")
+    parser.add_argument("-c", "--columns",
+                        help="comma separated names of the columns to write")
+    parser.add_argument("-l", "--list", action="store_true",
+                        help="list the columns instead")
+    parser.add_argument("--self-test", action="store_true",
+                        help="check the reader against known values")
+    args = parser.parse_args()
+
+    if args.self_test:
+        return self_test()
+    if args.path is None:
+        parser.error("a columns file is required")
+
+    names = None
+    if args.columns:
+        names = ["timestamp_us"] + args.columns.split(",")
+
+    if args.list:
+        header, columns = read_columns(args.path, names=[])
+        print("vendor 0x%04x product 0x%04x" % (header["vendor_id"],
+                                                header["product_id"]))
+        for column in columns:
+            print("%3u %-40s page 0x%04x usage 0x%04x bits %u"
+                  % (column.report_id, column.name, column.usage_page,
+                     column.usage, column.bit_count))
+        return 0
+
+    header, columns = read_columns(args.path, names=names)
+    report_ids = sorted(set(column.report_id for column in columns))
+    report_id = args.report_id
+    if report_id is None and report_ids:
+        report_id = report_ids[0]
+
+    columns = [column for column in columns
+               if (column.report_id == report_id)
+               and ((names is None) or (column.name in names))]
+    if not columns:
+        sys.stderr.write("No columns for report ID %s\n" % report_id)
+        return 1
+
+    writer = csv.writer(sys.stdout, lineterminator="\n")
+    writer.writerow([column.name for column in columns])
+    for row in zip(*[column.values for column in columns]):
+        writer.writerow(row)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,203 @@
+# ==============================================================================
+# Name        : sysfs_check.py
+# Date        : Oct 18, 2026
+# ==============================================================================
+#
+# BSD License
+# -----------
+#
+# Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# - Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# - Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# - Neither the name of Kevin Fodor nor the names of
+# its contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+# NOTICE:
+# SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+# IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+# IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+# LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+#
+# ==============================================================================
+
+"""Checks hiddump's sysfs enumeration (-u) against a fake sysfs tree.
+
+Usage:
+    python sysfs_check.py <hiddump>
+    python sysfs_check.py --make-tree <directory>
+
+The first form writes a fake /sys/bus/usb/devices tree to a temporary
+directory, has hiddump record what it enumerates there as a JSON snapshot
+(-u <tree> -n <snapshot> -o json) and compares that with the topology the
+tree describes. The second form only writes the tree, e.g. to try -u -e.
+"""
+
+import json
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+HUB_CLASS = 0x09
+
+
+def device_descriptor(vid, pid, device_class=0, num_configurations=1):
+    return struct.pack("<BBHBBBBHHHBBBB", 18, 1, 0x0200, device_class, 0, 0,
+                       64, vid, pid, 0x0100, 1, 2, 0, num_configurations)
+
+
+def mouse_configuration():
+    interface = struct.pack("<BBBBBBBBB", 9, 4, 0, 0, 1, 3, 1, 2, 0)
+    hid = struct.pack("<BBHBBBH", 9, 0x21, 0x0111, 0, 1, 0x22, 52)
+    endpoint = struct.pack("<BBBBHB", 7, 5, 0x81, 3, 4, 10)
+    body = interface + hid + endpoint
+    return struct.pack("<BBHBBBBB", 9, 2, 9 + len(body), 1, 1, 0, 0xA0,
+                       50) + body
+
+
+def hub_configuration():
+    interface = struct.pack("<BBBBBBBBB", 9, 4, 0, 0, 1, HUB_CLASS, 0, 0, 0)
+    endpoint = struct.pack("<BBBBHB", 7, 5, 0x81, 3, 1, 12)
+    body = interface + endpoint
+    return struct.pack("<BBHBBBBB", 9, 2, 9 + len(body), 1, 1, 0, 0xE0,
+                       0) + body
+
+
+def write_device(root, name, attributes, descriptors=None):
+    path = os.path.join(root, name)
+    os.makedirs(path)
+    for attribute, value in attributes.items():
+        with open(os.path.join(path, attribute), "w") as f:
+            f.write("%s\n" % value)
+    if descriptors is not None:
+        with open(os.path.join(path, "descriptors"), "wb") as f:
+            f.write(descriptors)
+
+
+def make_tree(root):
+    """Writes the fake tree and returns the items expected from it."""
+    write_device(root, "usb1", {"devnum": 1, "maxchild": 4, "speed": 480},
+                 device_descriptor(0x1D6B, 0x0002, HUB_CLASS)
+                 + hub_configuration())
+    write_device(root, "1-1", {"devnum": 2, "speed": "1.5",
+                               "bConfigurationValue": 1},
+                 device_descriptor(0x046D, 0xC077) + mouse_configuration())
+    write_device(root, "1-2", {"devnum": 3, "maxchild": 4, "speed": 480,
+                               "bConfigurationValue": 1},
+                 device_descriptor(0x05E3, 0x0610, HUB_CLASS)
+                 + hub_configuration())
+
+    # Without descriptors the IDs are taken from their attributes
+    write_device(root, "1-2.3", {"devnum": 4, "speed": 12,
+                                 "idVendor": "1234", "idProduct": "5678",
+                                 "bDeviceClass": "00"})
+    write_device(root, "usb2", {"devnum": 1, "maxchild": 2, "speed": 5000},
+                 device_descriptor(0x1D6B, 0x0003, HUB_CLASS))
+
+    # Entries that are neither buses nor devices are ignored
+    write_device(root, "usbfoo", {"devnum": 9, "maxchild": 1})
+    if os.name != "nt":
+        write_device(root, "1-1:1.0", {"bInterfaceClass": "03"})
+
+    # (type, depth, name or port, vid, pid, configurations)
+    return [
+        ("host_controller", 0, "SYSFS#HC#1", None, None, None),
+        ("root_hub", 1, "usb1", None, None, None),
+        ("device", 2, 1, 0x046D, 0xC077, [mouse_configuration()]),
+        ("device", 2, 2, 0x05E3, 0x0610, [hub_configuration()]),
+        ("external_hub", 3, "1-2", 0x05E3, 0x0610, [hub_configuration()]),
+        ("device", 4, 1, None, None, None),
+        ("device", 4, 2, None, None, None),
+        ("device", 4, 3, 0x1234, 0x5678, []),
+        ("device", 4, 4, None, None, None),
+        ("device", 2, 3, None, None, None),
+        ("device", 2, 4, None, None, None),
+        ("host_controller", 0, "SYSFS#HC#2", None, None, None),
+        ("root_hub", 1, "usb2", None, None, None),
+        ("device", 2, 1, None, None, None),
+        ("device", 2, 2, None, None, None),
+    ]
+
+
+def summarize(item):
+    if item["type"] in ("host_controller", "root_hub"):
+        key = item["name"]
+    elif item["type"] == "external_hub":
+        key = item["name"]
+    else:
+        key = item["port"]
+
+    configurations = None
+    if item.get("connected"):
+        configurations = [bytes(bytearray.fromhex(c["descriptor"]))
+                          for c in item["configurations"]]
+
+    return (item["type"], item["depth"], key, item.get("vid"),
+            item.get("pid"), configurations)
+
+
+def check(hiddump):
+    root = tempfile.mkdtemp()
+    try:
+        tree = os.path.join(root, "devices")
+        snapshot = os.path.join(root, "snapshot.json")
+        os.makedirs(tree)
+        expected = make_tree(tree)
+
+        subprocess.check_call([hiddump, "-u", tree, "-n", snapshot, "-o",
+                               "json"])
+        with open(snapshot) as f:
+            items = [summarize(json.loads(line)) for line in f if line.strip()]
+    finally:
+        shutil.rmtree(root)
+
+    failures = 0
+    for index in range(max(len(items), len(expected))):
+        want = expected[index] if index < len(expected) else None
+        got = items[index] if index < len(items) else None
+        if want != got:
+            print("item %d: expected %r, got %r" % (index, want, got))
+            failures += 1
+
+    print("%s" % ("FAILED" if failures else "OK"))
+
+    return 1 if failures else 0
+
+
+def main():
+    if (len(sys.argv) == 3) and (sys.argv[1] == "--make-tree"):
+        make_tree(sys.argv[2])
+        return 0
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        return 2
+
+    return check(sys.argv[1])
+
+
+if __name__ == "__main__":
+    sys.exit(main())
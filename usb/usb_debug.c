@@ -66,23 +66,24 @@
 #include "utils.h"
 #include "output.h"
 #include "hexdump.h"
+#include "utf16.h"
 #include "usb_defs.h"
 #include "usb_enum.h"
 #include "usb_hid.h"
+#include "usb_hid_plan.h"
+#include "usb_hid_strings.h"
+#include "usb_hid_descriptor.h"
+#include "usb_hid_usages.h"
+#include "usb_descriptor.h"
 
 // Module include
 #include "usb_debug.h"
 
-// The maximum number of hubs that can be daisy chained is five. The USB root
-// hub which is part of the USB controller will count as one, so you can
-// connect a chain of a maximum of four external hubs to a USB port.
-#define USB_MAX_NUM_HUBS    (1 + 4)
-
 // Step level for each Hub/Port
 #define STEP (2)
 
-// Macro to determine the print level of a hub
-#define LEVEL(hub_index) (((hub_index) + 1) * (2 * STEP) - STEP)
+// Macro to determine the print level of an enumerated item
+#define LEVEL(depth) ((int) ((depth) * STEP))
 
 typedef struct _enum_print_struct
 {
@@ -90,13 +91,9 @@ typedef struct _enum_print_struct
 	bool show_descriptors;
 
 	// Statistics
-	uint_least8_t num_host_controllers;
-	uint_least8_t num_hubs, num_hubs_connected;
-	uint_least8_t num_ports, num_ports_connected;
-
-	// Print level control
-	uint_least8_t hub_index; // Current hub index
-	uint_least8_t hub_num_ports[USB_MAX_NUM_HUBS]; // Num ports on a hub
+	size_t num_host_controllers;
+	size_t num_hubs, num_hubs_connected;
+	size_t num_ports, num_ports_connected;
 
 } enum_print_info_t, *penum_print_info_t;
 
@@ -112,7 +109,7 @@ static void print_hidp_button_caps(PHIDP_BUTTON_CAPS const p_hidp_button_caps,
 static void print_hidp_value_caps(PHIDP_VALUE_CAPS const p_hidp_value_caps,
 		uint32_t idx, uint32_t total);
 
-static void print_hid_strings(HANDLE h_device);
+static void print_hid_strings(char const * p_device_path);
 
 static void print_hidp_caps(PHIDP_CAPS const p_hidp_caps);
 
@@ -121,6 +118,15 @@ static void print_hidd_attributes(PHIDD_ATTRIBUTES const p_phidd_attributes);
 static bool print_enum_callback(pusb_enum_info_t const p_usb_enum_info,
 		void *pvArg);
 
+static void print_hid_plan(phid_plan_t const p_plan);
+
+static void print_hid_device_report_descriptor(char const * p_device_path);
+
+static char const * get_item_name(hid_item_t const * p_item);
+
+static void print_item_data(hid_item_t const * p_item,
+		phid_descriptor_parser_t const p_parser);
+
 static void print_hid_report_descriptor(
 		pusb_hid_report_descriptor_t const p_descriptor);
 
@@ -169,9 +175,44 @@ static const char * get_report_type_as_string(hid_report_type_t hid_report_type)
 	return p_string;
 }
 
+static void print_hid_plan(phid_plan_t const p_plan)
+{
+	size_t index;
+
+	HEADER_INDEX("HID_PLAN", p_plan->report_id);
+
+	printf("Report Length: %u\n", p_plan->report_length);
+
+	for (index = 0; index < p_plan->field_count; index++)
+	{
+		phid_plan_field_t p_field = &p_plan->p_fields[index];
+
+		if (HID_PLAN_FIELD_LIBRARY == p_field->type)
+		{
+			printf("Page 0x%04x Usage 0x%04x: packed by the HID library\n",
+					p_field->usage_page, p_field->usage);
+		}
+		else
+		{
+			// Same bit offsets as the report descriptor layout
+			printf("Page 0x%04x Usage 0x%04x-0x%04x: bits %u-%u (%u x %u)\n",
+					p_field->usage_page, p_field->usage,
+					(HID_PLAN_FIELD_BUTTONS == p_field->type) ?
+							p_field->usage_max : p_field->usage,
+					p_field->bit_offset,
+					p_field->bit_offset + (p_field->bit_size * p_field->count)
+							- 1, p_field->bit_size, p_field->count);
+		}
+	}
+
+	return;
+}
+
 static void print_hid_data(phid_data_t const p_hid_data, uint32_t idx,
 		uint32_t total)
 {
+	char name[64];
+
 	HEADER_ARRAY("HID_DATA", idx, total);
 
 	printf("Usage Page: 0x%x\n", p_hid_data->usage_page);
@@ -188,7 +229,10 @@ static void print_hid_data(phid_data_t const p_hid_data, uint32_t idx,
 	else
 	{
 		puts("A Value:");
-		printf("Usage: %u\n", p_hid_data->value.usage);
+		hid_usage_format(p_hid_data->usage_page, p_hid_data->value.usage,
+				name, sizeof(name));
+		name[sizeof(name) - 1] = '\0';
+		printf("Usage: %u (%s)\n", p_hid_data->value.usage, name);
 		printf("Value: %u (0x%x)\n", p_hid_data->value.value,
 				p_hid_data->value.value);
 		printf("Scaled Value: %d\n", p_hid_data->value.scaled_value);
@@ -280,52 +324,24 @@ static void print_hidp_value_caps(PHIDP_VALUE_CAPS const p_hidp_value_caps,
 	return;
 }
 
-static void print_hid_strings(HANDLE h_device)
+static void print_hid_strings(char const * p_device_path)
 {
-	WCHAR wc_buffer[MAXIMUM_USB_STRING_LENGTH];
-	char mbc_buffer[MAXIMUM_USB_STRING_LENGTH];
-	int num_written;
-	BOOL success;
+	// Names the HID's strings are printed under
+	static char const * const string_names[HID_STRING_SIZE] =
+	{ "HidD_GetManufacturerString", "HidD_GetProductString",
+			"HidD_GetPhysicalDescriptor", "HidD_GetSerialNumberString" };
+	char text[HID_STRINGS_TEXT_SIZE];
+	hid_string_t string;
 
 	HEADER("HID_STRINGS");
 
-	success = HidD_GetManufacturerString(h_device, wc_buffer,
-			sizeof(wc_buffer));
-	if (success == TRUE)
+	// Each string is requested from the HID only the first time around
+	for (string = 0; string < HID_STRING_SIZE; string++)
 	{
-		num_written = WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK, wc_buffer,
-				wcslen(wc_buffer), mbc_buffer, sizeof(mbc_buffer), NULL, NULL);
-		mbc_buffer[num_written] = '\0';
-		printf("HidD_GetManufacturerString: '%s'\n", mbc_buffer);
-	}
-
-	success = HidD_GetProductString(h_device, wc_buffer, sizeof(wc_buffer));
-	if (success == TRUE)
-	{
-		num_written = WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK, wc_buffer,
-				wcslen(wc_buffer), mbc_buffer, sizeof(mbc_buffer), NULL, NULL);
-		mbc_buffer[num_written] = '\0';
-		printf("HidD_GetProductString: '%s'\n", mbc_buffer);
-	}
-
-	success = HidD_GetPhysicalDescriptor(h_device, wc_buffer,
-			sizeof(wc_buffer));
-	if (success == TRUE)
-	{
-		num_written = WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK, wc_buffer,
-				wcslen(wc_buffer), mbc_buffer, sizeof(mbc_buffer), NULL, NULL);
-		mbc_buffer[num_written] = '\0';
-		printf("HidD_GetPhysicalDescriptor: '%s'\n", mbc_buffer);
-	}
-
-	success = HidD_GetSerialNumberString(h_device, wc_buffer,
-			sizeof(wc_buffer));
-	if (success == TRUE)
-	{
-		num_written = WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK, wc_buffer,
-				wcslen(wc_buffer), mbc_buffer, sizeof(mbc_buffer), NULL, NULL);
-		mbc_buffer[num_written] = '\0';
-		printf("HidD_GetSerialNumberString: '%s'\n", mbc_buffer);
+		if (hid_strings_get(p_device_path, string, text, sizeof(text)))
+		{
+			printf("%s: '%s'\n", string_names[string], text);
+		}
 	}
 
 	return;
@@ -401,14 +417,10 @@ static bool print_enum_callback(pusb_enum_info_t const p_usb_enum_info,
 		// Increment statistics
 		p_enum_print_info->num_host_controllers++;
 
-		// Initialize output values
-		p_enum_print_info->hub_index = 0;
-		memset(p_enum_print_info->hub_num_ports, 0,
-				sizeof(p_enum_print_info->hub_num_ports));
-
 		puts("");
-		printf("%*sHost Controller(#%u): %s\n", 0, "",
-				p_enum_print_info->num_host_controllers,
+		printf("%*sHost Controller(#%lu): %s\n",
+				LEVEL(p_usb_enum_info->depth), "",
+				(unsigned long) p_enum_print_info->num_host_controllers,
 				p_host_controller->p_driver_key);
 	}
 		break;
@@ -420,18 +432,9 @@ static bool print_enum_callback(pusb_enum_info_t const p_usb_enum_info,
 		p_enum_print_info->num_hubs++;
 		p_enum_print_info->num_hubs_connected++;
 
-		// Initialize output values
-		p_enum_print_info->hub_index = 0;
-		memset(p_enum_print_info->hub_num_ports, 0,
-				sizeof(p_enum_print_info->hub_num_ports));
-
-		// Save number of ports off this hub
-		p_enum_print_info->hub_num_ports[p_enum_print_info->hub_index] =
-				p_root_hub->node_info.u.HubInformation.HubDescriptor.bNumberOfPorts;
-
 		printf(
 				"%*sRoot Hub(%u ports): %s\n",
-				LEVEL(p_enum_print_info->hub_index),
+				LEVEL(p_usb_enum_info->depth),
 				"",
 				p_root_hub->node_info.u.HubInformation.HubDescriptor.bNumberOfPorts,
 				p_root_hub->p_hub_name);
@@ -445,19 +448,9 @@ static bool print_enum_callback(pusb_enum_info_t const p_usb_enum_info,
 		// Increment statistics
 		p_enum_print_info->num_hubs++;
 
-		// Increment hub index(next hub)
-		if (p_enum_print_info->hub_index < (USB_MAX_NUM_HUBS - 1))
-		{
-			p_enum_print_info->hub_index++;
-		}
-
-		// Save number of ports off this external hub.
-		p_enum_print_info->hub_num_ports[p_enum_print_info->hub_index] =
-				p_ext_hub->hub.node_info.u.HubInformation.HubDescriptor.bNumberOfPorts;
-
 		printf(
 				"%*sExternal Hub(%u ports): %s\n",
-				LEVEL(p_enum_print_info->hub_index),
+				LEVEL(p_usb_enum_info->depth),
 				"",
 				p_ext_hub->hub.node_info.u.HubInformation.HubDescriptor.bNumberOfPorts,
 				p_ext_hub->hub.p_hub_name);
@@ -471,41 +464,12 @@ static bool print_enum_callback(pusb_enum_info_t const p_usb_enum_info,
 	case USB_DEVICE:
 	{
 		pusb_device_info_t p_device = &p_usb_enum_info->u.device;
-		int level;
 
 		// Increment statistics
 		p_enum_print_info->num_ports++;
 
-		// Find hub this port is on
-		do
-		{
-			// Have we printed all ports part of the current hub?
-			if (p_enum_print_info->hub_num_ports[p_enum_print_info->hub_index]
-					== 0)
-			{
-				// Go back to previous hub
-				if (p_enum_print_info->hub_index > 0)
-				{
-					p_enum_print_info->hub_index--;
-				}
-			}
-			else
-			{
-				// Still on this hub, decrement the number of ports remaining
-				if (p_enum_print_info->hub_num_ports[p_enum_print_info->hub_index]
-						> 0)
-				{
-					p_enum_print_info->hub_num_ports[p_enum_print_info->hub_index]--;
-				}
-				break;
-			}
-
-		} while (true);
-
-		// Current hub
-		level = LEVEL(p_enum_print_info->hub_index) + STEP;
-
-		printf("%*sPort(#%lu): ", level, "",
+		// Ports are reported at their depth, no need to track the hubs
+		printf("%*sPort(#%lu): ", LEVEL(p_usb_enum_info->depth), "",
 				p_device->connection_info.ConnectionIndex);
 
 		if (p_device->connection_info.ConnectionStatus == DeviceConnected)
@@ -518,16 +482,22 @@ static bool print_enum_callback(pusb_enum_info_t const p_usb_enum_info,
 			// Show descriptors?
 			if (true == p_enum_print_info->show_descriptors)
 			{
+				PUSB_DEVICE_DESCRIPTOR p_device_descriptor =
+						usb_enum_get_device_descriptor(p_device);
+				pusb_configuration_descriptor_entry_t p_config_node =
+						usb_enum_get_configuration_descriptors(p_device);
+
 				// If we have descriptors, print them
-				usb_print_descriptors(
-						(const unsigned char *) &p_device->device_descriptor,
-						p_device->device_descriptor.bLength);
+				if (p_device_descriptor != NULL)
+				{
+					usb_print_descriptors(
+							(const unsigned char *) p_device_descriptor,
+							p_device_descriptor->bLength);
+				}
 
 				// Now we can print any configuration descriptors we may have acquired
-				if (p_device->p_configuration_descriptors != NULL)
+				if (p_config_node != NULL)
 				{
-					pusb_configuration_descriptor_entry_t p_config_node =
-							p_device->p_configuration_descriptors;
 
 					do
 					{
@@ -573,18 +543,234 @@ static bool print_enum_callback(pusb_enum_info_t const p_usb_enum_info,
 	return continue_enumerating;
 }
 
+static char const * get_item_name(hid_item_t const * p_item)
+{
+	static char const * const main_names[] =
+	{ "Input", "Output", "Collection", "Feature", "End Collection" };
+	static char const * const global_names[] =
+	{ "Usage Page", "Logical Minimum", "Logical Maximum", "Physical Minimum",
+			"Physical Maximum", "Unit Exponent", "Unit", "Report Size",
+			"Report ID", "Report Count", "Push", "Pop" };
+	static char const * const local_names[] =
+	{ "Usage", "Usage Minimum", "Usage Maximum", "Designator Index",
+			"Designator Minimum", "Designator Maximum", NULL, "String Index",
+			"String Minimum", "String Maximum", "Delimiter" };
+	char const * p_name = NULL;
+
+	switch (p_item->type)
+	{
+	case HID_ITEM_TYPE_MAIN:
+		if ((p_item->tag >= HID_MAIN_INPUT)
+				&& (p_item->tag <= HID_MAIN_END_COLLECTION))
+		{
+			p_name = main_names[p_item->tag - HID_MAIN_INPUT];
+		}
+		break;
+	case HID_ITEM_TYPE_GLOBAL:
+		if (p_item->tag < (sizeof(global_names) / sizeof(global_names[0])))
+		{
+			p_name = global_names[p_item->tag];
+		}
+		break;
+	case HID_ITEM_TYPE_LOCAL:
+		if (p_item->tag < (sizeof(local_names) / sizeof(local_names[0])))
+		{
+			p_name = local_names[p_item->tag];
+		}
+		break;
+	default:
+		p_name = "Long Item";
+		break;
+	}
+
+	return ((NULL == p_name) ? "Reserved" : p_name);
+}
+
+static void print_item_data(hid_item_t const * p_item,
+		phid_descriptor_parser_t const p_parser)
+{
+	static char const * const collection_names[] =
+	{ "Physical", "Application", "Logical", "Report", "Named Array",
+			"Usage Switch", "Usage Modifier" };
+	char const * p_name = NULL;
+
+	switch (p_item->type)
+	{
+	case HID_ITEM_TYPE_MAIN:
+		if (HID_MAIN_COLLECTION == p_item->tag)
+		{
+			if (p_item->data
+					< (sizeof(collection_names) / sizeof(collection_names[0])))
+			{
+				p_name = collection_names[p_item->data];
+			}
+			printf(" (%s)", (NULL == p_name) ? "Vendor Defined" : p_name);
+		}
+		else if (HID_MAIN_END_COLLECTION != p_item->tag)
+		{
+			printf(" (%s,%s,%s)",
+					(p_item->data & HID_MAIN_FLAG_CONSTANT) ? "Cnst" : "Data",
+					(p_item->data & HID_MAIN_FLAG_VARIABLE) ? "Var" : "Ary",
+					(p_item->data & HID_MAIN_FLAG_RELATIVE) ? "Rel" : "Abs");
+		}
+		break;
+	case HID_ITEM_TYPE_GLOBAL:
+		if (HID_GLOBAL_USAGE_PAGE == p_item->tag)
+		{
+			p_name = hid_usage_page_name((uint16_t) p_item->data);
+		}
+
+		if (NULL != p_name)
+		{
+			printf(" (%s)", p_name);
+		}
+		else if ((HID_GLOBAL_LOGICAL_MIN == p_item->tag)
+				|| (HID_GLOBAL_PHYSICAL_MIN == p_item->tag)
+				|| (HID_GLOBAL_UNIT_EXPONENT == p_item->tag))
+		{
+			printf(" (%ld)", (long) p_item->signed_data);
+		}
+		else if ((HID_GLOBAL_LOGICAL_MAX == p_item->tag)
+				|| (HID_GLOBAL_PHYSICAL_MAX == p_item->tag))
+		{
+			// The parser has already applied the item
+			printf(" (%ld)",
+					(long) ((HID_GLOBAL_LOGICAL_MAX == p_item->tag) ?
+							p_parser->globals.logical_max :
+							p_parser->globals.physical_max));
+		}
+		else if ((HID_GLOBAL_PUSH != p_item->tag)
+				&& (HID_GLOBAL_POP != p_item->tag))
+		{
+			printf(" (%lu)", (unsigned long) p_item->data);
+		}
+		break;
+	case HID_ITEM_TYPE_LOCAL:
+		if ((HID_LOCAL_USAGE == p_item->tag)
+				|| (HID_LOCAL_USAGE_MIN == p_item->tag)
+				|| (HID_LOCAL_USAGE_MAX == p_item->tag))
+		{
+			char name[64];
+			uint16_t usage_page =
+					(4 == p_item->size) ?
+							(uint16_t) (p_item->data >> 16) :
+							p_parser->globals.usage_page;
+
+			hid_usage_format(usage_page, (uint16_t) p_item->data, name,
+					sizeof(name));
+			name[sizeof(name) - 1] = '\0';
+			printf(" (%s)", name);
+		}
+		else if (HID_LOCAL_DELIMITER != p_item->tag)
+		{
+			printf(" (0x%lx)", (unsigned long) p_item->data);
+		}
+		break;
+	default:
+		break;
+	}
+
+	return;
+}
+
+void usb_print_hid_report_items(uint8_t const * p_data, size_t data_length)
+{
+	hid_descriptor_parser_t parser;
+	hid_report_type_t hid_report_type;
+	hid_item_t item;
+	size_t offset = 0;
+	uint32_t report_id;
+
+	hid_descriptor_parser_init(&parser);
+
+	while (hid_descriptor_next_item(p_data, data_length, &offset, &item))
+	{
+		size_t depth = parser.collection_depth;
+		bool is_valid;
+		size_t index;
+
+		is_valid = hid_descriptor_parse_item(&parser, &item);
+
+		// End collection is shown at the depth of its collection
+		if ((HID_ITEM_TYPE_MAIN == item.type)
+				&& (HID_MAIN_END_COLLECTION == item.tag) && (depth > 0))
+		{
+			depth--;
+		}
+
+		printf("0x%04lx:", (unsigned long) item.offset);
+		for (index = 0; index < 5; index++)
+		{
+			if (index < item.length)
+			{
+				printf(" %02x", p_data[item.offset + index]);
+			}
+			else
+			{
+				printf("   ");
+			}
+		}
+
+		printf("  %*s%s", (int) (depth * STEP), "", get_item_name(&item));
+		print_item_data(&item, &parser);
+
+		if (!is_valid)
+		{
+			printf(" <- Invalid");
+		}
+		printf("\n");
+
+		if (parser.is_field)
+		{
+			phid_descriptor_field_t p_field = &parser.field;
+
+			printf("%*s-> Report %u bits %lu-%lu (%lu x %lu)\n",
+					(int) (24 + (depth * STEP)), "", p_field->report_id,
+					(unsigned long) p_field->bit_offset,
+					(unsigned long) (p_field->bit_offset
+							+ (p_field->bit_size * p_field->count)) - 1,
+					(unsigned long) p_field->bit_size,
+					(unsigned long) p_field->count);
+		}
+	}
+
+	if (offset < data_length)
+	{
+		printf("Error! Item at 0x%04lx runs past the descriptor.\n",
+				(unsigned long) offset);
+	}
+
+	// Summarise the length of every report declared
+	puts("Report layout (bits, report ID byte excluded):");
+	for (report_id = 0; report_id < HID_DESCRIPTOR_REPORT_IDS; report_id++)
+	{
+		for (hid_report_type = HID_REPORT_TYPE_FIRST;
+				hid_report_type < HID_REPORT_TYPE_SIZE; hid_report_type++)
+		{
+			uint32_t bits = parser.report_bits[hid_report_type][report_id];
+
+			if (bits > 0)
+			{
+				printf("  Report %u %s: %lu bits (%lu bytes)\n", report_id,
+						get_report_type_as_string(hid_report_type),
+						(unsigned long) bits, (unsigned long) ((bits + 7) / 8));
+			}
+		}
+	}
+
+	return;
+}
+
 static void print_hid_report_descriptor(
 		pusb_hid_report_descriptor_t const p_descriptor)
 {
-	uint16_t row = 0;
-
 	HEADER("USB_HID_REPORT_DESCRIPTOR");
 
 	printf("bLength:          0x%02x\n", p_descriptor->bLength);
 	printf("bDescriptorType:  0x%02x\n", p_descriptor->bDescriptorType);
 
-	hex_dump(stdout, &row, (uint8_t const *) p_descriptor,
-			p_descriptor->bLength - sizeof(p_descriptor));
+	usb_print_hid_report_items(p_descriptor->data,
+			p_descriptor->bLength - sizeof(usb_hid_report_descriptor_t));
 
 	return;
 }
@@ -631,39 +817,19 @@ static void print_endpoint_descriptor(
 
 static void print_string_descriptor(PUSB_STRING_DESCRIPTOR const p_descriptor)
 {
-	size_t length;
-	char buf[MAXIMUM_USB_STRING_LENGTH + 1];
+	char buf[UTF16_UTF8_SIZE(MAXIMUM_USB_STRING_LENGTH)];
 
 	HEADER("USB_STRING_DESCRIPTOR");
 
 	printf("bLength:          0x%02x\n", p_descriptor->bLength);
 	printf("bDescriptorType:  0x%02x\n", p_descriptor->bDescriptorType);
 
-	// convert wchar string to multi-byte ascii string
-	length = p_descriptor->bLength - sizeof(USB_COMMON_DESCRIPTOR);
-	length /= sizeof(WCHAR);
-	length =
-			length > MAXIMUM_USB_STRING_LENGTH ?
-					MAXIMUM_USB_STRING_LENGTH : length;
-	length = wcstombs(buf, p_descriptor->bString, length);
-	if (((size_t) -1) == length)
-	{
-		strcpy(buf, "Error!");
-	}
-	else
-	{
-		buf[length] = '\0';
-	}
+	// bString is UTF-16LE, at most 126 units fit a descriptor
+	utf16le_to_utf8(p_descriptor->bString,
+			(p_descriptor->bLength - sizeof(USB_COMMON_DESCRIPTOR))
+					/ sizeof(WCHAR), buf, sizeof(buf));
 	printf("bString:          %s\n", buf);
 
-	if (((size_t) -1) == length)
-	{
-		uint16_t row = 0;
-
-		// display raw-hex dump of string
-		hex_dump(stdout, &row, (uint8_t const *) p_descriptor->bString,
-				p_descriptor->bLength - sizeof(USB_COMMON_DESCRIPTOR));
-	}
 	return;
 }
 
@@ -676,8 +842,10 @@ static void print_unknown_descriptor(PUSB_COMMON_DESCRIPTOR const p_descriptor)
 	printf("bLength:         0x%02x\n", p_descriptor->bLength);
 	printf("bDescriptorType: 0x%02x\n", p_descriptor->bDescriptorType);
 
-	hex_dump(stdout, &row, (uint8_t const *) p_descriptor,
-			p_descriptor->bLength - sizeof(p_descriptor));
+	// What follows the header (bLength was checked to cover it)
+	hex_dump(stdout, &row,
+			(uint8_t const *) p_descriptor + sizeof(USB_COMMON_DESCRIPTOR),
+			p_descriptor->bLength - sizeof(USB_COMMON_DESCRIPTOR));
 
 	return;
 }
@@ -739,14 +907,37 @@ static void print_device_descriptor(PUSB_DEVICE_DESCRIPTOR const p_descriptor)
 	return;
 }
 
-void usb_print_hid_device(phid_device_t const p_device)
+static void print_hid_device_report_descriptor(char const * p_device_path)
+{
+	uint8_t * p_descriptor;
+	uint16_t descriptor_length;
+
+	HEADER("HID_REPORT_DESCRIPTOR");
+
+	if (!usb_enum_get_hid_report_descriptor(p_device_path, &p_descriptor,
+			&descriptor_length))
+	{
+		printf("Not returned (the HID is not on USB or refused the request)\n");
+		return;
+	}
+
+	printf("Length:           0x%04x\n", descriptor_length);
+
+	usb_print_hid_report_items(p_descriptor, descriptor_length);
+
+	free(p_descriptor);
+
+	return;
+}
+
+void usb_print_hid_device(phid_device_t const p_device, bool show_descriptors)
 {
 	uint32_t index;
 	hid_report_type_t hid_report_type;
 
 	HEADER("HID_DEVICE");
 
-	print_hid_strings(p_device->h_device);
+	print_hid_strings(p_device->p_device_path);
 	print_hidd_attributes(&p_device->attributes);
 	print_hidp_caps(&p_device->caps);
 
@@ -782,6 +973,20 @@ void usb_print_hid_device(phid_device_t const p_device)
 			print_hid_data(p_hid_data, index + 1, p_report->hid_data_length);
 			p_hid_data++;
 		}
+
+		for (index = 0; index < p_report->number_report_ids; index++)
+		{
+			if (NULL != p_report->p_report_ids[index].p_plan)
+			{
+				print_hid_plan(p_report->p_report_ids[index].p_plan);
+			}
+		}
+	}
+
+	// The items the plans were built from, as the device describes them
+	if (show_descriptors)
+	{
+		print_hid_device_report_descriptor(p_device->p_device_path);
 	}
 
 	return;
@@ -855,135 +1060,50 @@ void usb_print_hid_report(phid_data_t const pData, char * p_buffer,
 
 void usb_print_descriptors(unsigned char const * p_data, size_t data_length)
 {
-	const USB_COMMON_DESCRIPTOR *p_header =
-			(const USB_COMMON_DESCRIPTOR *) p_data;
+	usb_descriptor_t descriptor;
+	size_t offset = 0;
 
-	while (data_length)
+	while (usb_descriptor_next(p_data, data_length, &offset, &descriptor))
 	{
 		// Decode descriptor based on type
-		switch (p_header->bDescriptorType)
-		{
-		case USB_DEVICE_DESCRIPTOR_TYPE:
+		switch (descriptor.kind)
 		{
-			PUSB_DEVICE_DESCRIPTOR const p_descriptor =
-					(PUSB_DEVICE_DESCRIPTOR const) p_header;
-			size_t length = sizeof(USB_DEVICE_DESCRIPTOR);
-
-			if (p_header->bLength == length)
-			{
-				print_device_descriptor(p_descriptor);
-			}
-		}
+		case USB_DESCRIPTOR_KIND_DEVICE:
+			print_device_descriptor(descriptor.u.p_device);
 			break;
-		case USB_CONFIGURATION_DESCRIPTOR_TYPE:
-		{
-			PUSB_CONFIGURATION_DESCRIPTOR p_descriptor =
-					(PUSB_CONFIGURATION_DESCRIPTOR) p_header;
-			size_t length = sizeof(USB_CONFIGURATION_DESCRIPTOR);
-
-			if (p_header->bLength == length)
-			{
-				print_config_descriptor(p_descriptor);
-			}
-		}
+		case USB_DESCRIPTOR_KIND_CONFIGURATION:
+			print_config_descriptor(descriptor.u.p_configuration);
 			break;
-		case USB_STRING_DESCRIPTOR_TYPE:
-		{
-			PUSB_STRING_DESCRIPTOR p_descriptor =
-					(PUSB_STRING_DESCRIPTOR) p_header;
-			size_t length = sizeof(USB_COMMON_DESCRIPTOR);
-
-			if (p_header->bLength >= length)
-			{
-				print_string_descriptor(p_descriptor);
-			}
-			else
-			{
-				printf("Error! Invalid descriptor length of %u for type."
-						" %u or greater was expected.\n", p_header->bLength,
-						length);
-			}
-		}
+		case USB_DESCRIPTOR_KIND_STRING:
+			print_string_descriptor(descriptor.u.p_string);
 			break;
-		case USB_INTERFACE_DESCRIPTOR_TYPE:
-		{
-			PUSB_INTERFACE_DESCRIPTOR p_descriptor =
-					(PUSB_INTERFACE_DESCRIPTOR) p_header;
-			size_t length = sizeof(USB_INTERFACE_DESCRIPTOR);
-
-			if (p_header->bLength == length)
-			{
-				print_interface_descriptor(p_descriptor);
-			}
-		}
+		case USB_DESCRIPTOR_KIND_INTERFACE:
+			print_interface_descriptor(descriptor.u.p_interface);
 			break;
-		case USB_ENDPOINT_DESCRIPTOR_TYPE:
-		{
-			PUSB_ENDPOINT_DESCRIPTOR p_descriptor =
-					(PUSB_ENDPOINT_DESCRIPTOR) p_header;
-			size_t length = sizeof(USB_ENDPOINT_DESCRIPTOR);
-
-			if (p_header->bLength == length)
-			{
-				print_endpoint_descriptor(p_descriptor);
-			}
-		}
+		case USB_DESCRIPTOR_KIND_ENDPOINT:
+			print_endpoint_descriptor(descriptor.u.p_endpoint);
 			break;
-		case USB_HID_DESCRIPTOR_TYPE:
-		{
-			pusb_hid_descriptor_t p_descriptor =
-					(pusb_hid_descriptor_t) p_header;
-			size_t length = sizeof(usb_hid_descriptor_t);
-
-			if (p_header->bLength == length)
-			{
-				print_hid_descriptor(p_descriptor);
-			}
-			else
-			{
-				printf("Error! Invalid descriptor length of %u for type."
-						" %u was expected.\n", p_header->bLength, length);
-			}
-		}
+		case USB_DESCRIPTOR_KIND_HID:
+			print_hid_descriptor(descriptor.u.p_hid);
 			break;
-		case USB_HID_REPORT_DESCRIPTOR_TYPE:
-		{
-			pusb_hid_report_descriptor_t p_descriptor =
-					(pusb_hid_report_descriptor_t) p_header;
-			size_t length = sizeof(USB_COMMON_DESCRIPTOR);
-
-			if (p_header->bLength >= length)
-			{
-				print_hid_report_descriptor(p_descriptor);
-			}
-			else
-			{
-				printf("Error! Invalid descriptor length of %u for type."
-						" %u or greater was expected.\n", p_header->bLength,
-						length);
-			}
-		}
+		case USB_DESCRIPTOR_KIND_HID_REPORT:
+			print_hid_report_descriptor(descriptor.u.p_hid_report);
+			break;
+		case USB_DESCRIPTOR_KIND_INVALID:
+			printf("Error! Invalid descriptor length of %u for type 0x%02x.\n",
+					(unsigned int) descriptor.length,
+					descriptor.u.p_common->bDescriptorType);
 			break;
 		default:
-		{
-			PUSB_COMMON_DESCRIPTOR p_descriptor =
-					(PUSB_COMMON_DESCRIPTOR) p_header;
-			print_unknown_descriptor(p_descriptor);
-		}
+			print_unknown_descriptor(descriptor.u.p_common);
 			break;
 		}
+	}
 
-		// Move on to the next descriptor
-		if (data_length >= p_header->bLength)
-		{
-			data_length -= p_header->bLength;
-			p_header = (const USB_COMMON_DESCRIPTOR *) ((const PUCHAR) p_header
-					+ p_header->bLength);
-		}
-		else
-		{
-			break;
-		}
+	if (offset < data_length)
+	{
+		printf("Error! Malformed descriptor at offset %lu of %lu.\n",
+				(unsigned long) offset, (unsigned long) data_length);
 	}
 
 	return;
@@ -992,7 +1112,8 @@ void usb_print_descriptors(unsigned char const * p_data, size_t data_length)
 /*
  *
  */
-void usb_print_enumeration(bool show_descriptors)
+void usb_print_enumeration(bool show_descriptors, USB_ENUM_PROVIDER provider,
+		HANDLE h_provider)
 {
 	bool success;
 	enum_print_info_t enum_print_info;
@@ -1002,14 +1123,16 @@ void usb_print_enumeration(bool show_descriptors)
 
 	printf("\nEnumerating USB controllers and devices...\n");
 
-	success = usb_enumerate(print_enum_callback, &enum_print_info);
+	success = provider(print_enum_callback, &enum_print_info, h_provider);
 	if (success == true)
 	{
-		printf("\nEnumerated - Controllers %u, Hubs %u, Ports %u.\n"
-				"\tPorts Connected %u, Hubs Connected %u\n",
-				enum_print_info.num_host_controllers, enum_print_info.num_hubs,
-				enum_print_info.num_ports, enum_print_info.num_ports_connected,
-				enum_print_info.num_hubs_connected);
+		printf("\nEnumerated - Controllers %lu, Hubs %lu, Ports %lu.\n"
+				"\tPorts Connected %lu, Hubs Connected %lu\n",
+				(unsigned long) enum_print_info.num_host_controllers,
+				(unsigned long) enum_print_info.num_hubs,
+				(unsigned long) enum_print_info.num_ports,
+				(unsigned long) enum_print_info.num_ports_connected,
+				(unsigned long) enum_print_info.num_hubs_connected);
 	}
 	else
 	{
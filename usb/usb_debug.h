@@ -61,14 +61,18 @@ extern "C"
  */
 /* ************************************************************************* */
 
-void usb_print_hid_device(phid_device_t const p_device);
+void usb_print_hid_device(phid_device_t const p_device, bool show_descriptors);
 
 void usb_print_hid_report(phid_data_t const p_data, char * p_buffer,
 		size_t buffer_size);
 
 void usb_print_descriptors(unsigned char const *p_data, size_t data_length);
 
-void usb_print_enumeration(bool show_descriptors);
+void usb_print_hid_report_items(uint8_t const * p_data, size_t data_length);
+
+// Prints what a USB_ENUM_PROVIDER enumerates (see usb_enum.h)
+void usb_print_enumeration(bool show_descriptors, USB_ENUM_PROVIDER provider,
+		HANDLE h_provider);
 
 #ifdef __cplusplus
 }
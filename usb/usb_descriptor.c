@@ -0,0 +1,157 @@
+/*
+ ==============================================================================
+ Name        : usb_descriptor.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// WDK includes
+#include <usbioctl.h>
+#include <usb100.h>
+
+// Other includes
+#include "utils.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+
+// Module include
+#include "usb_descriptor.h"
+
+// Size of a HID descriptor without its descriptor list, and of each entry
+#define HID_DESCRIPTOR_HEADER_LENGTH	(6)
+#define HID_DESCRIPTOR_ENTRY_LENGTH		(3)
+
+// Local declarations
+static usb_descriptor_kind_t get_kind(PUSB_COMMON_DESCRIPTOR p_common);
+
+// Implementation
+
+static usb_descriptor_kind_t get_kind(PUSB_COMMON_DESCRIPTOR p_common)
+{
+	uint8_t length = p_common->bLength;
+
+	switch (p_common->bDescriptorType)
+	{
+	case USB_DEVICE_DESCRIPTOR_TYPE:
+		return ((sizeof(USB_DEVICE_DESCRIPTOR) == length) ?
+				USB_DESCRIPTOR_KIND_DEVICE : USB_DESCRIPTOR_KIND_INVALID);
+
+	case USB_CONFIGURATION_DESCRIPTOR_TYPE:
+		return ((sizeof(USB_CONFIGURATION_DESCRIPTOR) == length) ?
+				USB_DESCRIPTOR_KIND_CONFIGURATION :
+				USB_DESCRIPTOR_KIND_INVALID);
+
+	case USB_STRING_DESCRIPTOR_TYPE:
+		return (USB_DESCRIPTOR_KIND_STRING);
+
+	case USB_INTERFACE_DESCRIPTOR_TYPE:
+		return ((sizeof(USB_INTERFACE_DESCRIPTOR) == length) ?
+				USB_DESCRIPTOR_KIND_INTERFACE : USB_DESCRIPTOR_KIND_INVALID);
+
+	case USB_ENDPOINT_DESCRIPTOR_TYPE:
+		// Audio class endpoints carry two more bytes
+		return ((sizeof(USB_ENDPOINT_DESCRIPTOR) <= length) ?
+				USB_DESCRIPTOR_KIND_ENDPOINT : USB_DESCRIPTOR_KIND_INVALID);
+
+	case USB_HID_DESCRIPTOR_TYPE:
+	{
+		pusb_hid_descriptor_t p_hid = (pusb_hid_descriptor_t) p_common;
+
+		// Every entry of the descriptor list must be inside
+		if ((length < HID_DESCRIPTOR_HEADER_LENGTH)
+				|| (length < HID_DESCRIPTOR_HEADER_LENGTH
+						+ HID_DESCRIPTOR_ENTRY_LENGTH * p_hid->bNumDescriptors))
+		{
+			return (USB_DESCRIPTOR_KIND_INVALID);
+		}
+
+		return (USB_DESCRIPTOR_KIND_HID);
+	}
+
+	case USB_HID_REPORT_DESCRIPTOR_TYPE:
+		return (USB_DESCRIPTOR_KIND_HID_REPORT);
+
+	default:
+		return (USB_DESCRIPTOR_KIND_UNKNOWN);
+	}
+}
+
+bool usb_descriptor_next(uint8_t const * p_data, size_t length,
+		size_t * p_offset, pusb_descriptor_t p_descriptor)
+{
+	PUSB_COMMON_DESCRIPTOR p_common;
+	size_t offset = *p_offset;
+
+	if ((offset >= length)
+			|| (length - offset < sizeof(USB_COMMON_DESCRIPTOR)))
+	{
+		return (false);
+	}
+
+	p_common = (PUSB_COMMON_DESCRIPTOR) &p_data[offset];
+
+	// A zero bLength would never advance
+	if ((p_common->bLength < sizeof(USB_COMMON_DESCRIPTOR))
+			|| (p_common->bLength > length - offset))
+	{
+		return (false);
+	}
+
+	p_descriptor->kind = get_kind(p_common);
+	p_descriptor->offset = offset;
+	p_descriptor->length = p_common->bLength;
+	p_descriptor->u.p_common = p_common;
+
+	*p_offset = offset + p_common->bLength;
+
+	return (true);
+}
@@ -0,0 +1,135 @@
+/*
+ ==============================================================================
+ Name        : usb_descriptor.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_DESCRIPTOR_H_
+#define USB_DESCRIPTOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_descriptor
+
+ \brief These APIs walk a buffer of standard and HID class descriptors, such
+ as a configuration descriptor and everything following it.
+ */
+/* ************************************************************************* */
+
+typedef enum _usb_descriptor_kind_t
+{
+	USB_DESCRIPTOR_KIND_UNKNOWN, // A type without a view, see p_common
+	USB_DESCRIPTOR_KIND_INVALID, // A known type with an impossible bLength
+	USB_DESCRIPTOR_KIND_DEVICE,
+	USB_DESCRIPTOR_KIND_CONFIGURATION,
+	USB_DESCRIPTOR_KIND_STRING,
+	USB_DESCRIPTOR_KIND_INTERFACE,
+	USB_DESCRIPTOR_KIND_ENDPOINT,
+	USB_DESCRIPTOR_KIND_HID,
+	USB_DESCRIPTOR_KIND_HID_REPORT
+
+} usb_descriptor_kind_t, *pusb_descriptor_kind_t;
+
+//
+// A descriptor as found in the buffer walked. The views point into the
+// buffer, they are only valid while it is.
+//
+
+typedef struct _usb_descriptor_t
+{
+	usb_descriptor_kind_t kind; // Which view applies
+
+	size_t offset; // Offset of the descriptor within the buffer
+	size_t length; // bLength
+
+	union
+	{
+		PUSB_COMMON_DESCRIPTOR p_common; // Always valid
+		PUSB_DEVICE_DESCRIPTOR p_device;
+		PUSB_CONFIGURATION_DESCRIPTOR p_configuration;
+		PUSB_STRING_DESCRIPTOR p_string;
+		PUSB_INTERFACE_DESCRIPTOR p_interface;
+		PUSB_ENDPOINT_DESCRIPTOR p_endpoint;
+		struct _usb_hid_descriptor_t *p_hid;
+		struct _usb_hid_report_descriptor_t *p_hid_report;
+	} u;
+
+} usb_descriptor_t, *pusb_descriptor_t;
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_descriptor
+
+ \brief Retrieves the next descriptor of a buffer.
+
+ \param[in] p_data - The descriptors.
+ \param[in] length - The length of the descriptors.
+ \param[in,out] p_offset - The offset of the descriptor (advanced past it).
+ \param[out] p_descriptor - Receives the descriptor.
+
+ \return Indicates if a descriptor was retrieved (false at the end of the
+ buffer, or for a descriptor shorter than its header or running past the end,
+ in which case *p_offset is left short of length).
+
+ The bLength of known types is checked against their layout so views of kind
+ other than USB_DESCRIPTOR_KIND_UNKNOWN and USB_DESCRIPTOR_KIND_INVALID may be
+ read without further checks.
+
+ */
+/* ************************************************************************** */
+
+bool usb_descriptor_next(uint8_t const * p_data, size_t length,
+		size_t * p_offset, pusb_descriptor_t p_descriptor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_DESCRIPTOR_H_ */
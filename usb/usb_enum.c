@@ -74,7 +74,9 @@
 #include <windows.h>
 #include <initguid.h> // only include once!
 #include <setupapi.h>
+#include <cfgmgr32.h>
 #include <tchar.h>
+#include <hidsdi.h>
 
 // WDK includes
 #include <usbiodef.h>
@@ -82,9 +84,21 @@
 #include <usb.h>
 #include <usb100.h>
 
+// Other includes
+#include "utils.h"
+#include "utf16.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_string_cache.h"
+#include "usb_descriptor.h"
+
 // Module include
 #include "usb_enum.h"
 
+// Bytes of configuration descriptor requested when its length is not known,
+// enough for all but the largest composite devices
+#define CONFIG_DESCRIPTOR_GUESS		(1024)
+
 /*
  * Local helper functions
  */
@@ -99,14 +113,21 @@ static PTSTR GetRootHubName(HANDLE hHostController);
 
 static PTSTR GetHCDDriverKeyName(HANDLE hHostController);
 
-static pusb_string_descriptor_entry_t GetStringDescriptor(HANDLE hHubDevice,
-		ULONG ConnectionIndex, UCHAR DescriptorIndex, USHORT LanguageID);
+static pusb_string_descriptor_entry_t NewStringDescriptorNode(
+		UCHAR DescriptorIndex, USHORT LanguageID,
+		PUSB_STRING_DESCRIPTOR StringDesc);
 
-static pusb_string_descriptor_entry_t GetStringDescriptors(HANDLE hHubDevice,
-		ULONG ConnectionIndex, UCHAR DescriptorIndex, ULONG NumLanguageIDs,
-		USHORT *LanguageIDs, pusb_string_descriptor_entry_t StringDescNodeTail);
+static pusb_string_descriptor_entry_t GetStringDescriptor(HANDLE hStringCache,
+		uint64_t DeviceKey, HANDLE hHubDevice, ULONG ConnectionIndex,
+		UCHAR DescriptorIndex, USHORT LanguageID);
 
-static pusb_string_descriptor_entry_t GetAllStringDescriptors(HANDLE hHubDevice,
+static pusb_string_descriptor_entry_t GetStringDescriptors(HANDLE hStringCache,
+		uint64_t DeviceKey, HANDLE hHubDevice, ULONG ConnectionIndex,
+		UCHAR DescriptorIndex, ULONG NumLanguageIDs, USHORT *LanguageIDs,
+		pusb_string_descriptor_entry_t StringDescNodeTail);
+
+static pusb_string_descriptor_entry_t GetAllStringDescriptors(
+		HANDLE hStringCache, uint64_t DeviceKey, HANDLE hHubDevice,
 		ULONG ConnectionIndex, PUSB_DEVICE_DESCRIPTOR DeviceDesc,
 		PUSB_CONFIGURATION_DESCRIPTOR ConfigDesc);
 
@@ -114,43 +135,55 @@ static bool usb_get_device_descriptor(HANDLE h_hub_device,
 		size_t connection_index, uint8_t descriptor_index,
 		uint8_t ** pp_descriptor, uint16_t * p_descriptor_length);
 
+static bool usb_request_config_descriptor(HANDLE h_hub_device,
+		size_t connection_index, uint8_t descriptor_index,
+		PUSB_DESCRIPTOR_REQUEST p_config_desc_req, size_t data_length,
+		size_t * p_data_returned);
+
 static bool usb_get_config_descriptor(HANDLE h_hub_device,
 		size_t connection_index, uint8_t descriptor_index,
-		uint8_t ** pp_descriptor, uint16_t * p_descriptor_length);
+		uint16_t length_hint, PUSB_DESCRIPTOR_REQUEST p_scratch,
+		size_t scratch_size, uint8_t ** pp_descriptor,
+		uint16_t * p_descriptor_length);
 
 static void usb_free_descriptor(uint8_t * p_descriptor);
 
-static bool usb_get_descriptors_from_node(pusb_device_info_t p_device_info,
+static uint64_t usb_get_device_key(HANDLE h_string_cache, HANDLE h_hub,
+		size_t connection_index, PUSB_DEVICE_DESCRIPTOR p_device_descriptor);
+
+static bool usb_get_configurations_from_node(pusb_device_info_t p_device_info,
 		size_t connection_node);
 
+static bool usb_find_hid_connection(char const * p_device_path,
+		char ** pp_hub_path, ULONG * p_connection_index,
+		int * p_interface_number);
+
+static bool usb_request_hid_report_descriptor(HANDLE h_hub_device,
+		size_t connection_index, uint8_t interface_number,
+		uint16_t descriptor_length, uint8_t ** pp_descriptor);
+
 /*
  * Local Enumerator functions
  */
 
 static bool usb_enumerate_ports(HANDLE h_hub, uint8_t num_ports,
-		USB_ENUM_ITEM_CALLBACK enum_item_callback, void * p_enum_item_arg);
+		size_t depth, USB_ENUM_ITEM_CALLBACK enum_item_callback,
+		void * p_enum_item_arg, HANDLE h_string_cache);
 
 static bool usb_enumerate_hubs(HANDLE h_host_controller,
-		size_t connection_index, USB_ENUM_ITEM_CALLBACK enum_item_callback,
-		void * p_enum_item_arg);
+		size_t connection_index, size_t depth,
+		USB_ENUM_ITEM_CALLBACK enum_item_callback, void * p_enum_item_arg,
+		HANDLE h_string_cache);
 
 static PTSTR WideStrToMultiStr(LPCWSTR WideStr)
 {
-	ULONG nBytes;
+	size_t nUnits;
 	PTSTR MultiStr;
 
-	// Get the length of the converted string
-	//
-	nBytes = WideCharToMultiByte(CP_ACP, 0, WideStr, -1, NULL, 0, NULL, NULL);
-
-	if (nBytes == 0)
-	{
-		return NULL;
-	}
-
-	// Allocate space to hold the converted string
+	// Allocate space for the longest conversion, sparing a sizing pass
 	//
-	MultiStr = malloc(nBytes);
+	nUnits = wcslen(WideStr);
+	MultiStr = malloc(UTF16_UTF8_SIZE(nUnits));
 
 	if (MultiStr == NULL)
 	{
@@ -159,14 +192,8 @@ static PTSTR WideStrToMultiStr(LPCWSTR WideStr)
 
 	// Convert the string
 	//
-	nBytes = WideCharToMultiByte(CP_ACP, 0, WideStr, -1, MultiStr, nBytes, NULL,
-			NULL);
+	utf16le_to_utf8(WideStr, nUnits, MultiStr, UTF16_UTF8_SIZE(nUnits));
 
-	if (nBytes == 0)
-	{
-		free(MultiStr);
-		return NULL;
-	}
 	return MultiStr;
 }
 
@@ -446,8 +473,42 @@ static PTSTR GetHCDDriverKeyName(HANDLE hHostController)
 	return NULL;
 }
 
-static pusb_string_descriptor_entry_t GetStringDescriptor(HANDLE hHubDevice,
-		ULONG ConnectionIndex, UCHAR DescriptorIndex, USHORT LanguageID)
+static pusb_string_descriptor_entry_t NewStringDescriptorNode(
+		UCHAR DescriptorIndex, USHORT LanguageID,
+		PUSB_STRING_DESCRIPTOR StringDesc)
+{
+	ULONG nBytes;
+	pusb_string_descriptor_entry_t stringDescNode;
+
+	//
+	// Allocate some (zero filled) space for the string descriptor node and
+	// copy the string descriptor to it.
+	//
+
+	nBytes = sizeof(usb_string_descriptor_entry_t) + StringDesc->bLength;
+	stringDescNode = (pusb_string_descriptor_entry_t) malloc(nBytes);
+	if (stringDescNode == NULL)
+	{
+		return NULL;
+	}
+
+	// Zero initialize.
+	memset(stringDescNode, 0, nBytes);
+
+	// Initialize pointers
+	stringDescNode->p_next = NULL;
+	stringDescNode->index = DescriptorIndex;
+	stringDescNode->language_id = LanguageID;
+
+	// Copy string
+	memcpy(stringDescNode->string_descriptor, StringDesc, StringDesc->bLength);
+
+	return stringDescNode;
+}
+
+static pusb_string_descriptor_entry_t GetStringDescriptor(HANDLE hStringCache,
+		uint64_t DeviceKey, HANDLE hHubDevice, ULONG ConnectionIndex,
+		UCHAR DescriptorIndex, USHORT LanguageID)
 {
 	BOOL success;
 	ULONG nBytes;
@@ -458,7 +519,22 @@ static pusb_string_descriptor_entry_t GetStringDescriptor(HANDLE hHubDevice,
 
 	PUSB_DESCRIPTOR_REQUEST stringDescReq;
 	PUSB_STRING_DESCRIPTOR stringDesc;
-	pusb_string_descriptor_entry_t stringDescNode;
+
+	//
+	// Strings already requested from this device (in this or an earlier run)
+	// are not requested again.
+	//
+	if (usb_string_cache_find(hStringCache, DeviceKey, DescriptorIndex,
+			LanguageID, &stringDesc))
+	{
+		if (stringDesc == NULL)
+		{
+			return NULL;
+		}
+
+		return NewStringDescriptorNode(DescriptorIndex, LanguageID,
+				stringDesc);
+	}
 
 	nBytes = sizeof(stringDescReqBuf);
 
@@ -502,63 +578,40 @@ static pusb_string_descriptor_entry_t GetStringDescriptor(HANDLE hHubDevice,
 
 	//
 	// Do some sanity checks on the return from the get descriptor request.
+	// A string the device fails to return is remembered as missing so it is
+	// not requested again during this enumeration.
 	//
 
-	if (!success)
-	{
-		return NULL;
-	}
-
-	if (nBytesReturned < 2)
-	{
-		return NULL;
-	}
-
-	if (stringDesc->bDescriptorType != USB_STRING_DESCRIPTOR_TYPE)
-	{
-		return NULL;
-	}
-
-	if (stringDesc->bLength != nBytesReturned - sizeof(USB_DESCRIPTOR_REQUEST))
-	{
-		return NULL;
-	}
-
-	if (stringDesc->bLength % 2 != 0)
+	if (!success || (nBytesReturned < 2)
+			|| (stringDesc->bDescriptorType != USB_STRING_DESCRIPTOR_TYPE)
+			|| (stringDesc->bLength
+					!= nBytesReturned - sizeof(USB_DESCRIPTOR_REQUEST))
+			|| (stringDesc->bLength % 2 != 0))
 	{
+		usb_string_cache_add(hStringCache, DeviceKey, DescriptorIndex,
+				LanguageID, NULL);
 		return NULL;
 	}
 
 	//
-	// Looks good, allocate some (zero filled) space for the string descriptor
-	// node and copy the string descriptor to it.
+	// Looks good, remember it and hand out a copy.
 	//
 
-	nBytes = sizeof(usb_string_descriptor_entry_t) + stringDesc->bLength;
-	stringDescNode = (pusb_string_descriptor_entry_t) malloc(nBytes);
-	if (stringDescNode == NULL)
-	{
-		return NULL;
-	}
+	usb_string_cache_add(hStringCache, DeviceKey, DescriptorIndex, LanguageID,
+			stringDesc);
 
-	// Zero initialize.
-	memset(stringDescNode, 0, nBytes);
-
-	// Initialize pointers
-	stringDescNode->p_next = NULL;
-	stringDescNode->index = DescriptorIndex;
-	stringDescNode->language_id = LanguageID;
-
-	// Copy string
-	memcpy(stringDescNode->string_descriptor, stringDesc, stringDesc->bLength);
-
-	return stringDescNode;
+	return NewStringDescriptorNode(DescriptorIndex, LanguageID, stringDesc);
 }
 
 //*****************************************************************************
 //
 // GetStringDescriptors()
 //
+// hStringCache - String cache consulted before requesting a String Descriptor
+// (NULL for none).
+//
+// DeviceKey - Identifies the device within the string cache.
+//
 // hHubDevice - Handle of the hub device containing the port from which the
 // String Descriptor will be requested.
 //
@@ -574,16 +627,18 @@ static pusb_string_descriptor_entry_t GetStringDescriptor(HANDLE hHubDevice,
 //
 //*****************************************************************************
 
-static pusb_string_descriptor_entry_t GetStringDescriptors(HANDLE hHubDevice,
-		ULONG ConnectionIndex, UCHAR DescriptorIndex, ULONG NumLanguageIDs,
-		USHORT *LanguageIDs, pusb_string_descriptor_entry_t StringDescNodeTail)
+static pusb_string_descriptor_entry_t GetStringDescriptors(HANDLE hStringCache,
+		uint64_t DeviceKey, HANDLE hHubDevice, ULONG ConnectionIndex,
+		UCHAR DescriptorIndex, ULONG NumLanguageIDs, USHORT *LanguageIDs,
+		pusb_string_descriptor_entry_t StringDescNodeTail)
 {
 	ULONG i;
 
 	for (i = 0; i < NumLanguageIDs; i++)
 	{
-		StringDescNodeTail->p_next = GetStringDescriptor(hHubDevice,
-				ConnectionIndex, DescriptorIndex, *LanguageIDs);
+		StringDescNodeTail->p_next = GetStringDescriptor(hStringCache,
+				DeviceKey, hHubDevice, ConnectionIndex, DescriptorIndex,
+				*LanguageIDs);
 
 		if (StringDescNodeTail->p_next)
 		{
@@ -600,6 +655,11 @@ static pusb_string_descriptor_entry_t GetStringDescriptors(HANDLE hHubDevice,
 //
 // GetAllStringDescriptors()
 //
+// hStringCache - String cache consulted before requesting a String Descriptor
+// (NULL for none).
+//
+// DeviceKey - Identifies the device within the string cache.
+//
 // hHubDevice - Handle of the hub device containing the port from which the
 // String Descriptors will be requested.
 //
@@ -614,7 +674,8 @@ static pusb_string_descriptor_entry_t GetStringDescriptors(HANDLE hHubDevice,
 //
 //*****************************************************************************
 
-static pusb_string_descriptor_entry_t GetAllStringDescriptors(HANDLE hHubDevice,
+static pusb_string_descriptor_entry_t GetAllStringDescriptors(
+		HANDLE hStringCache, uint64_t DeviceKey, HANDLE hHubDevice,
 		ULONG ConnectionIndex, PUSB_DEVICE_DESCRIPTOR DeviceDesc,
 		PUSB_CONFIGURATION_DESCRIPTOR ConfigDesc)
 {
@@ -623,15 +684,15 @@ static pusb_string_descriptor_entry_t GetAllStringDescriptors(HANDLE hHubDevice,
 	ULONG numLanguageIDs;
 	USHORT *languageIDs;
 
-	PUCHAR descEnd;
-	PUSB_COMMON_DESCRIPTOR commonDesc;
+	usb_descriptor_t descriptor;
+	size_t descOffset = 0;
 
 	//
 	// Get the array of supported Language IDs, which is returned
 	// in String Descriptor 0
 	//
-	supportedLanguagesString = GetStringDescriptor(hHubDevice, ConnectionIndex,
-			0, 0);
+	supportedLanguagesString = GetStringDescriptor(hStringCache, DeviceKey,
+			hHubDevice, ConnectionIndex, 0, 0);
 
 	if (supportedLanguagesString == NULL)
 	{
@@ -651,80 +712,57 @@ static pusb_string_descriptor_entry_t GetAllStringDescriptors(HANDLE hHubDevice,
 
 	if (DeviceDesc->iManufacturer)
 	{
-		stringDescNodeTail = GetStringDescriptors(hHubDevice, ConnectionIndex,
-				DeviceDesc->iManufacturer, numLanguageIDs, languageIDs,
-				stringDescNodeTail);
+		stringDescNodeTail = GetStringDescriptors(hStringCache, DeviceKey,
+				hHubDevice, ConnectionIndex, DeviceDesc->iManufacturer,
+				numLanguageIDs, languageIDs, stringDescNodeTail);
 	}
 
 	if (DeviceDesc->iProduct)
 	{
-		stringDescNodeTail = GetStringDescriptors(hHubDevice, ConnectionIndex,
-				DeviceDesc->iProduct, numLanguageIDs, languageIDs,
-				stringDescNodeTail);
+		stringDescNodeTail = GetStringDescriptors(hStringCache, DeviceKey,
+				hHubDevice, ConnectionIndex, DeviceDesc->iProduct,
+				numLanguageIDs, languageIDs, stringDescNodeTail);
 	}
 
 	if (DeviceDesc->iSerialNumber)
 	{
-		stringDescNodeTail = GetStringDescriptors(hHubDevice, ConnectionIndex,
-				DeviceDesc->iSerialNumber, numLanguageIDs, languageIDs,
-				stringDescNodeTail);
+		stringDescNodeTail = GetStringDescriptors(hStringCache, DeviceKey,
+				hHubDevice, ConnectionIndex, DeviceDesc->iSerialNumber,
+				numLanguageIDs, languageIDs, stringDescNodeTail);
 	}
 
 	//
 	// Get the Configuration and Interface Descriptor strings
 	//
 
-	descEnd = (PUCHAR) ConfigDesc + ConfigDesc->wTotalLength;
-
-	commonDesc = (PUSB_COMMON_DESCRIPTOR) ConfigDesc;
-
-	while ((PUCHAR) commonDesc + sizeof(USB_COMMON_DESCRIPTOR) < descEnd
-			&& (PUCHAR) commonDesc + commonDesc->bLength <= descEnd)
+	while (usb_descriptor_next((uint8_t const *) ConfigDesc,
+			ConfigDesc->wTotalLength, &descOffset, &descriptor))
 	{
-		switch (commonDesc->bDescriptorType)
+		switch (descriptor.kind)
 		{
-		case USB_CONFIGURATION_DESCRIPTOR_TYPE:
-			if (commonDesc->bLength != sizeof(USB_CONFIGURATION_DESCRIPTOR))
-			{
-				break;
-			}
-			if (((PUSB_CONFIGURATION_DESCRIPTOR) commonDesc)->iConfiguration)
+		case USB_DESCRIPTOR_KIND_CONFIGURATION:
+			if (descriptor.u.p_configuration->iConfiguration)
 			{
-				stringDescNodeTail =
-						GetStringDescriptors(
-								hHubDevice,
-								ConnectionIndex,
-								((PUSB_CONFIGURATION_DESCRIPTOR) commonDesc)->iConfiguration,
-								numLanguageIDs, languageIDs,
-								stringDescNodeTail);
+				stringDescNodeTail = GetStringDescriptors(hStringCache,
+						DeviceKey, hHubDevice, ConnectionIndex,
+						descriptor.u.p_configuration->iConfiguration,
+						numLanguageIDs, languageIDs, stringDescNodeTail);
 			}
-			commonDesc = (PUSB_COMMON_DESCRIPTOR) ((PUCHAR) commonDesc
-					+ commonDesc->bLength);
-			continue;
+			break;
 
-		case USB_INTERFACE_DESCRIPTOR_TYPE:
-			if (commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR)/* &&
-			 commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR2)*/)
-			{
-				break;
-			}
-			if (((PUSB_INTERFACE_DESCRIPTOR) commonDesc)->iInterface)
+		case USB_DESCRIPTOR_KIND_INTERFACE:
+			if (descriptor.u.p_interface->iInterface)
 			{
-				stringDescNodeTail = GetStringDescriptors(hHubDevice,
-						ConnectionIndex,
-						((PUSB_INTERFACE_DESCRIPTOR) commonDesc)->iInterface,
+				stringDescNodeTail = GetStringDescriptors(hStringCache,
+						DeviceKey, hHubDevice, ConnectionIndex,
+						descriptor.u.p_interface->iInterface,
 						numLanguageIDs, languageIDs, stringDescNodeTail);
 			}
-			commonDesc = (PUSB_COMMON_DESCRIPTOR) ((PUCHAR) commonDesc
-					+ commonDesc->bLength);
-			continue;
+			break;
 
 		default:
-			commonDesc = (PUSB_COMMON_DESCRIPTOR) ((PUCHAR) commonDesc
-					+ commonDesc->bLength);
-			continue;
+			break;
 		}
-		break;
 	}
 
 	return supportedLanguagesString;
@@ -820,32 +858,20 @@ static bool usb_get_device_descriptor(HANDLE h_hub_device,
 	return true;
 }
 
-static bool usb_get_config_descriptor(HANDLE h_hub_device,
+static bool usb_request_config_descriptor(HANDLE h_hub_device,
 		size_t connection_index, uint8_t descriptor_index,
-		uint8_t ** pp_descriptor, uint16_t * p_descriptor_length)
+		PUSB_DESCRIPTOR_REQUEST p_config_desc_req, size_t data_length,
+		size_t * p_data_returned)
 {
 	bool success;
 	size_t num_bytes;
 	ULONG num_bytes_returned;
 
-	UCHAR config_desc_req_buf[sizeof(USB_DESCRIPTOR_REQUEST)
-			+ sizeof(USB_CONFIGURATION_DESCRIPTOR)];
+	num_bytes = sizeof(USB_DESCRIPTOR_REQUEST) + data_length;
 
-	PUSB_DESCRIPTOR_REQUEST p_config_desc_req;
-	PUSB_CONFIGURATION_DESCRIPTOR p_config_desc;
-
-	// Request the Configuration Descriptor the first time using our
-	// local buffer, which is just big enough for the Configuration
-	// Descriptor itself.
+	// Zero fill the request structure
 	//
-	num_bytes = sizeof(config_desc_req_buf);
-
-	p_config_desc_req = (PUSB_DESCRIPTOR_REQUEST) config_desc_req_buf;
-	p_config_desc = (PUSB_CONFIGURATION_DESCRIPTOR) (p_config_desc_req + 1);
-
-	// Zero fill the entire request structure
-	//
-	memset(p_config_desc_req, 0, num_bytes);
+	memset(p_config_desc_req, 0, sizeof(USB_DESCRIPTOR_REQUEST));
 
 	// Indicate the port from which the descriptor will be requested
 	//
@@ -867,8 +893,7 @@ static bool usb_get_config_descriptor(HANDLE h_hub_device,
 	p_config_desc_req->SetupPacket.wValue = (USB_CONFIGURATION_DESCRIPTOR_TYPE
 			<< 8) | descriptor_index;
 
-	p_config_desc_req->SetupPacket.wLength = (USHORT) (num_bytes
-			- sizeof(USB_DESCRIPTOR_REQUEST));
+	p_config_desc_req->SetupPacket.wLength = (USHORT) data_length;
 
 	// Now issue the get descriptor request.
 	//
@@ -876,99 +901,131 @@ static bool usb_get_config_descriptor(HANDLE h_hub_device,
 			IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION, p_config_desc_req,
 			num_bytes, p_config_desc_req, num_bytes, &num_bytes_returned, NULL);
 
-	if (!success)
+	if (!success || (num_bytes_returned < sizeof(USB_DESCRIPTOR_REQUEST)))
 	{
 		return false;
 	}
 
-	if (num_bytes != num_bytes_returned)
+	*p_data_returned = num_bytes_returned - sizeof(USB_DESCRIPTOR_REQUEST);
+
+	return true;
+}
+
+static bool usb_get_config_descriptor(HANDLE h_hub_device,
+		size_t connection_index, uint8_t descriptor_index,
+		uint16_t length_hint, PUSB_DESCRIPTOR_REQUEST p_scratch,
+		size_t scratch_size, uint8_t ** pp_descriptor,
+		uint16_t * p_descriptor_length)
+{
+	size_t data_length;
+	size_t data_returned;
+	uint16_t total_length;
+
+	PUSB_DESCRIPTOR_REQUEST p_config_desc_req = p_scratch;
+	PUSB_CONFIGURATION_DESCRIPTOR p_config_desc;
+
+	// Request the length last read from this device or, not knowing it,
+	// whatever fits the scratch buffer. Either way most devices return their
+	// entire Configuration Descriptor in this one request.
+	//
+	data_length = length_hint;
+	if (0 == data_length)
 	{
-		return false;
+		data_length = scratch_size - sizeof(USB_DESCRIPTOR_REQUEST);
 	}
-
-	if (p_config_desc->wTotalLength < sizeof(USB_CONFIGURATION_DESCRIPTOR))
+	if (data_length < sizeof(USB_CONFIGURATION_DESCRIPTOR))
 	{
-		return false;
+		data_length = sizeof(USB_CONFIGURATION_DESCRIPTOR);
 	}
 
-	// Now request the entire Configuration Descriptor using a dynamically
-	// allocated buffer which is sized big enough to hold the entire descriptor
-	//
-	num_bytes = sizeof(USB_DESCRIPTOR_REQUEST) + p_config_desc->wTotalLength;
-
-	p_config_desc_req = (PUSB_DESCRIPTOR_REQUEST) malloc(num_bytes);
-	if (p_config_desc_req == NULL)
+	if (sizeof(USB_DESCRIPTOR_REQUEST) + data_length > scratch_size)
 	{
-		return false;
+		p_config_desc_req = (PUSB_DESCRIPTOR_REQUEST) malloc(
+				sizeof(USB_DESCRIPTOR_REQUEST) + data_length);
+		if (p_config_desc_req == NULL)
+		{
+			return false;
+		}
 	}
 
 	p_config_desc = (PUSB_CONFIGURATION_DESCRIPTOR) (p_config_desc_req + 1);
 
-	// Indicate the port from which the descriptor will be requested
-	//
-	p_config_desc_req->ConnectionIndex = connection_index;
+	if (!usb_request_config_descriptor(h_hub_device, connection_index,
+			descriptor_index, p_config_desc_req, data_length, &data_returned)
+			|| (data_returned < sizeof(USB_CONFIGURATION_DESCRIPTOR))
+			|| (p_config_desc->wTotalLength
+					< sizeof(USB_CONFIGURATION_DESCRIPTOR)))
+	{
+		goto GetConfigDescriptorError;
+	}
 
+	total_length = p_config_desc->wTotalLength;
+
+	// Only a descriptor longer than requested takes a second request, using
+	// a buffer sized big enough to hold the entire descriptor
 	//
-	// USBHUB uses URB_FUNCTION_GET_DESCRIPTOR_FROM_DEVICE to process this
-	// IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION request.
-	//
-	// USBD will automatically initialize these fields:
-	//     bmRequest = 0x80
-	//     bRequest  = 0x06
-	//
-	// We must initialize these fields:
-	//     wValue    = Descriptor Type (high) and Descriptor Index (low byte)
-	//     wIndex    = Zero (or Language ID for String Descriptors)
-	//     wLength   = Length of descriptor buffer
-	//
-	p_config_desc_req->SetupPacket.wValue = (USB_CONFIGURATION_DESCRIPTOR_TYPE
-			<< 8) | descriptor_index;
+	if ((data_returned < total_length) && (data_returned == data_length))
+	{
+		if (p_config_desc_req != p_scratch)
+		{
+			free(p_config_desc_req);
+		}
 
-	p_config_desc_req->SetupPacket.wLength = (USHORT) (num_bytes
-			- sizeof(USB_DESCRIPTOR_REQUEST));
+		p_config_desc_req = p_scratch;
+		data_length = total_length;
 
-	// Now issue the get descriptor request.
-	//
-	success = DeviceIoControl(h_hub_device,
-			IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION, p_config_desc_req,
-			num_bytes, p_config_desc_req, num_bytes, &num_bytes_returned, NULL);
+		if (sizeof(USB_DESCRIPTOR_REQUEST) + data_length > scratch_size)
+		{
+			p_config_desc_req = (PUSB_DESCRIPTOR_REQUEST) malloc(
+					sizeof(USB_DESCRIPTOR_REQUEST) + data_length);
+			if (p_config_desc_req == NULL)
+			{
+				return false;
+			}
+		}
 
-	if (!success)
-	{
-		free(p_config_desc_req);
-		return false;
-	}
+		p_config_desc = (PUSB_CONFIGURATION_DESCRIPTOR) (p_config_desc_req + 1);
 
-	if (num_bytes != num_bytes_returned)
-	{
-		free(p_config_desc_req);
-		return false;
+		if (!usb_request_config_descriptor(h_hub_device, connection_index,
+				descriptor_index, p_config_desc_req, data_length,
+				&data_returned))
+		{
+			goto GetConfigDescriptorError;
+		}
 	}
 
-	if (p_config_desc->wTotalLength
-			!= (num_bytes - sizeof(USB_DESCRIPTOR_REQUEST)))
+	if ((data_returned != total_length)
+			|| (p_config_desc->wTotalLength != total_length))
 	{
-		free(p_config_desc_req);
-		return false;
+		goto GetConfigDescriptorError;
 	}
 
-	// Populate return values
+	// Populate return values (the caller frees the descriptor unless it is
+	// in the scratch buffer)
 	if (NULL != pp_descriptor)
 	{
 		*pp_descriptor = p_config_desc_req->Data;
 	}
-	else
+	else if (p_config_desc_req != p_scratch)
 	{
 		free(p_config_desc_req);
 	}
 
 	if (NULL != p_descriptor_length)
 	{
-		*p_descriptor_length = num_bytes_returned
-				- sizeof(USB_DESCRIPTOR_REQUEST);
+		*p_descriptor_length = total_length;
 	}
 
 	return true;
+
+	GetConfigDescriptorError:
+
+	if (p_config_desc_req != p_scratch)
+	{
+		free(p_config_desc_req);
+	}
+
+	return false;
 }
 
 static void usb_free_descriptor(uint8_t * p_descriptor)
@@ -986,89 +1043,276 @@ static void usb_free_descriptor(uint8_t * p_descriptor)
 	return;
 }
 
-static bool usb_get_descriptors_from_node(pusb_device_info_t p_device_info,
-		size_t connection_node)
+static uint64_t usb_get_device_key(HANDLE h_string_cache, HANDLE h_hub,
+		size_t connection_index, PUSB_DEVICE_DESCRIPTOR p_device_descriptor)
 {
-	bool success = FALSE;
-	uint8_t * desc = NULL;
-	uint16_t descLength = 0;
+	pusb_string_descriptor_entry_t p_languages;
+	pusb_string_descriptor_entry_t p_serial;
+	uint64_t device_key;
+
+	// Without a serial number, the same model and release share their strings
+	if ((NULL == h_string_cache) || (0 == p_device_descriptor->iSerialNumber))
+	{
+		return (usb_string_cache_get_device_key(p_device_descriptor, NULL));
+	}
 
-	// Get device descriptor from device
-	success = usb_get_device_descriptor(p_device_info->h_hub, connection_node,
-			0, &desc, &descLength);
-	if (true == success)
+	// The serial number is read in the first language the device supports,
+	// bypassing the cache which cannot be keyed before it is known
+	p_languages = GetStringDescriptor(NULL, 0, h_hub, connection_index, 0, 0);
+	if ((NULL == p_languages)
+			|| (p_languages->string_descriptor->bLength < 4))
 	{
-		pusb_configuration_descriptor_entry_t *p_configuration_node_tail =
-				&p_device_info->p_configuration_descriptors;
-		uint8_t config_num, num_configurations;
+		free(p_languages);
+		return (usb_string_cache_get_device_key(p_device_descriptor, NULL));
+	}
+
+	p_serial = GetStringDescriptor(NULL, 0, h_hub, connection_index,
+			p_device_descriptor->iSerialNumber,
+			p_languages->string_descriptor->bString[0]);
 
-		// Copy contents of retrieved device descriptor
-		p_device_info->device_descriptor = *((PUSB_DEVICE_DESCRIPTOR) desc);
+	device_key = usb_string_cache_get_device_key(p_device_descriptor,
+			(NULL != p_serial) ? p_serial->string_descriptor : NULL);
 
-		// Release device descriptor (we don't need it any more)
-		usb_free_descriptor(desc); // device
-		desc = NULL;
+	// Neither needs requesting again from this device
+	usb_string_cache_add(h_string_cache, device_key, 0, 0,
+			p_languages->string_descriptor);
+	if (NULL != p_serial)
+	{
+		usb_string_cache_add(h_string_cache, device_key,
+				p_device_descriptor->iSerialNumber,
+				p_languages->string_descriptor->bString[0],
+				p_serial->string_descriptor);
+		free(p_serial);
+	}
 
-		// Load number of configurations available
-		num_configurations =
-				p_device_info->device_descriptor.bNumConfigurations;
+	free(p_languages);
 
-		// Initialize configurations and strings
-		*p_configuration_node_tail = NULL;
+	return (device_key);
+}
 
-		// Iterate configurations
-		for (config_num = 0; config_num < num_configurations; config_num++)
+static bool usb_get_configurations_from_node(pusb_device_info_t p_device_info,
+		size_t connection_node)
+{
+	bool success = FALSE;
+	uint8_t * desc = NULL;
+	uint16_t descLength = 0;
+	uint64_t device_key;
+	pusb_configuration_descriptor_entry_t *p_configuration_node_tail =
+			&p_device_info->p_configuration_descriptors;
+	uint8_t config_num, num_configurations;
+
+	// Reused by all configurations, only larger ones are allocated
+	UCHAR scratch[sizeof(USB_DESCRIPTOR_REQUEST) + CONFIG_DESCRIPTOR_GUESS];
+	PUSB_DESCRIPTOR_REQUEST p_scratch = (PUSB_DESCRIPTOR_REQUEST) scratch;
+
+	// Load number of configurations available
+	num_configurations = p_device_info->device_descriptor.bNumConfigurations;
+
+	// Initialize configurations and strings
+	*p_configuration_node_tail = NULL;
+
+	// Identify the device to the string cache
+	device_key = usb_get_device_key(p_device_info->h_string_cache,
+			p_device_info->h_hub, connection_node,
+			&p_device_info->device_descriptor);
+
+	// Iterate configurations
+	for (config_num = 0; config_num < num_configurations; config_num++)
+	{
+		// Get configuration descriptor from device, in a single request if
+		// its length is known from an earlier enumeration
+		success = usb_get_config_descriptor(p_device_info->h_hub,
+				connection_node, config_num,
+				usb_string_cache_get_config_length(
+						p_device_info->h_string_cache, device_key, config_num),
+				p_scratch, sizeof(scratch), &desc, &descLength);
+		if (true == success)
 		{
-			// Get configuration descriptor from device
-			success = usb_get_config_descriptor(p_device_info->h_hub,
-					connection_node, config_num, &desc, &descLength);
-			if (true == success)
+			usb_string_cache_set_config_length(p_device_info->h_string_cache,
+					device_key, config_num, descLength);
+
+			// Allocate memory for it
+			*p_configuration_node_tail =
+					(pusb_configuration_descriptor_entry_t) malloc(
+							sizeof(usb_configuration_descriptor_entry_t)
+									+ descLength);
+			if (NULL != *p_configuration_node_tail)
 			{
-				// Allocate memory for it
-				*p_configuration_node_tail =
-						(pusb_configuration_descriptor_entry_t) malloc(
-								sizeof(usb_configuration_descriptor_entry_t)
-										+ descLength);
-				if (NULL != *p_configuration_node_tail)
-				{
-					pusb_configuration_descriptor_entry_t p_node =
-							*p_configuration_node_tail;
-
-					// Populate node...
-					p_node->p_next = NULL;
-					p_node->configuration_index = config_num;
-					memcpy(p_node->configuration_descriptor, desc, descLength);
-
-					// Now retrieve all the device string descriptors we can
-					p_node->p_string_descriptors = GetAllStringDescriptors(
-							p_device_info->h_hub, connection_node,
-							&p_device_info->device_descriptor,
-							(PUSB_CONFIGURATION_DESCRIPTOR) desc);
-
-					// Prepare for next p_node
-					p_configuration_node_tail = &(p_node->p_next);
-				}
+				pusb_configuration_descriptor_entry_t p_node =
+						*p_configuration_node_tail;
+
+				// Populate node...
+				p_node->p_next = NULL;
+				p_node->configuration_index = config_num;
+				memcpy(p_node->configuration_descriptor, desc, descLength);
+
+				// Now retrieve all the device string descriptors we can
+				p_node->p_string_descriptors = GetAllStringDescriptors(
+						p_device_info->h_string_cache, device_key,
+						p_device_info->h_hub, connection_node,
+						&p_device_info->device_descriptor,
+						(PUSB_CONFIGURATION_DESCRIPTOR) desc);
+
+				// Prepare for next p_node
+				p_configuration_node_tail = &(p_node->p_next);
+			}
 
-				// Release configuration descriptor (we don't need it any more)
+			// Release configuration descriptor (we don't need it any more)
+			if (desc != p_scratch->Data)
+			{
 				usb_free_descriptor(desc); // configuration
 			}
 		}
 	}
-	else
+
+	return success;
+}
+
+static bool usb_find_hid_connection(char const * p_device_path,
+		char ** pp_hub_path, ULONG * p_connection_index,
+		int * p_interface_number)
+{
+	HDEVINFO dev_info;
+	SP_DEVICE_INTERFACE_DATA interface_data;
+	SP_DEVINFO_DATA devinfo_data;
+	DEVINST dev_inst;
+	char device_id[MAX_DEVICE_ID_LEN];
+	char const * p_interface;
+	ULONG length;
+	bool success;
+
+	// Find the device node of the HID interface
+	dev_info = SetupDiCreateDeviceInfoList(NULL, NULL);
+	if (INVALID_HANDLE_VALUE == dev_info)
 	{
-		// Initialize device descriptor (nothing)
-		memset(&p_device_info->device_descriptor, 0,
-				sizeof(p_device_info->device_descriptor));
+		return false;
 	}
 
-	return success;
+	interface_data.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA);
+	devinfo_data.cbSize = sizeof(SP_DEVINFO_DATA);
+
+	// Without a buffer the detail fails, having filled in the device node
+	success = SetupDiOpenDeviceInterface(dev_info, p_device_path, 0,
+			&interface_data)
+			&& (SetupDiGetDeviceInterfaceDetail(dev_info, &interface_data, NULL,
+					0, NULL, &devinfo_data)
+					|| (ERROR_INSUFFICIENT_BUFFER == GetLastError()));
+
+	SetupDiDestroyDeviceInfoList(dev_info);
+
+	// Its parent is the interface of a composite USB device, or else the USB
+	// device itself
+	if (!success
+			|| (CR_SUCCESS != CM_Get_Parent(&dev_inst, devinfo_data.DevInst, 0))
+			|| (CR_SUCCESS != CM_Get_Device_ID(dev_inst, device_id,
+					sizeof(device_id), 0))
+			|| (0 != strncmp(device_id, "USB\\", 4)))
+	{
+		return false;
+	}
+
+	*p_interface_number = -1;
+	p_interface = strstr(device_id, "&MI_");
+	if (NULL != p_interface)
+	{
+		*p_interface_number = (int) strtoul(p_interface + 4, NULL, 16);
+		if (CR_SUCCESS != CM_Get_Parent(&dev_inst, dev_inst, 0))
+		{
+			return false;
+		}
+	}
+
+	// The address of a USB device is the hub port it is connected to
+	length = sizeof(*p_connection_index);
+	if ((CR_SUCCESS != CM_Get_DevNode_Registry_Property(dev_inst,
+			CM_DRP_ADDRESS, NULL, p_connection_index, &length, 0))
+			|| (CR_SUCCESS != CM_Get_Parent(&dev_inst, dev_inst, 0))
+			|| (CR_SUCCESS != CM_Get_Device_ID(dev_inst, device_id,
+					sizeof(device_id), 0))
+			|| (CR_SUCCESS != CM_Get_Device_Interface_List_Size(&length,
+					(LPGUID) &GUID_DEVINTERFACE_USB_HUB, device_id,
+					CM_GET_DEVICE_INTERFACE_LIST_PRESENT)) || (length < 2))
+	{
+		return false;
+	}
+
+	// The first path of the hub's interface list opens it
+	*pp_hub_path = (char *) malloc(length);
+	if (NULL == *pp_hub_path)
+	{
+		return false;
+	}
+
+	if (CR_SUCCESS != CM_Get_Device_Interface_List(
+			(LPGUID) &GUID_DEVINTERFACE_USB_HUB, device_id, *pp_hub_path,
+			length, CM_GET_DEVICE_INTERFACE_LIST_PRESENT))
+	{
+		free(*pp_hub_path);
+		*pp_hub_path = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+static bool usb_request_hid_report_descriptor(HANDLE h_hub_device,
+		size_t connection_index, uint8_t interface_number,
+		uint16_t descriptor_length, uint8_t ** pp_descriptor)
+{
+	PUSB_DESCRIPTOR_REQUEST p_desc_req;
+	size_t num_bytes;
+	ULONG num_bytes_returned;
+	bool success;
+
+	num_bytes = sizeof(USB_DESCRIPTOR_REQUEST) + descriptor_length;
+
+	p_desc_req = (PUSB_DESCRIPTOR_REQUEST) malloc(num_bytes);
+	if (NULL == p_desc_req)
+	{
+		return false;
+	}
+
+	// Zero fill the request structure
+	//
+	memset(p_desc_req, 0, sizeof(USB_DESCRIPTOR_REQUEST));
+
+	p_desc_req->ConnectionIndex = connection_index;
+
+	//
+	// USBHUB sends this as a standard request to the device (bmRequest 0x80)
+	// where the HID class addresses it to the interface (0x81). Devices
+	// generally answer either, the interface is still named by wIndex.
+	//
+	//     wValue    = Report Descriptor Type (high) and Index zero (low byte)
+	//     wIndex    = Interface Number
+	//     wLength   = Report Descriptor Length, from the HID Descriptor
+	//
+	p_desc_req->SetupPacket.wValue = (USB_HID_REPORT_DESCRIPTOR_TYPE << 8);
+	p_desc_req->SetupPacket.wIndex = interface_number;
+	p_desc_req->SetupPacket.wLength = descriptor_length;
+
+	success = DeviceIoControl(h_hub_device,
+			IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION, p_desc_req,
+			num_bytes, p_desc_req, num_bytes, &num_bytes_returned, NULL);
+
+	// Anything short of the length the HID Descriptor gives is truncated
+	if (!success || (num_bytes_returned != num_bytes))
+	{
+		free(p_desc_req);
+		return false;
+	}
+
+	*pp_descriptor = p_desc_req->Data;
+
+	return true;
 }
 
 static bool usb_enumerate_ports(HANDLE h_hub, uint8_t num_ports,
-		USB_ENUM_ITEM_CALLBACK enum_item_callback, void * p_enum_item_arg)
+		size_t depth, USB_ENUM_ITEM_CALLBACK enum_item_callback,
+		void * p_enum_item_arg, HANDLE h_string_cache)
 {
 	bool status = false;
-	uint8_t index;
+	unsigned int index; // A hub may have 255 ports
 	usb_enum_info_t info;
 	pusb_device_info_t p_device = &info.u.device;
 
@@ -1087,6 +1331,7 @@ static bool usb_enumerate_ports(HANDLE h_hub, uint8_t num_ports,
 
 		// Set device item type
 		info.type = USB_DEVICE;
+		info.depth = depth;
 
 		// Set handle
 		p_device->h_hub = h_hub;
@@ -1094,17 +1339,9 @@ static bool usb_enumerate_ports(HANDLE h_hub, uint8_t num_ports,
 		// Get this hub's connection info
 		GetConnectionInfoFromHub(p_device->h_hub, p_connection_info_ex, index);
 
-		// Check if device if connected. If so gather what descriptors
-		// we can from the device.
-		if (p_connection_info_ex->ConnectionStatus == DeviceConnected)
-		{
-			status = usb_get_descriptors_from_node(p_device, index);
-		}
-		else
-		{
-			// all is well
-			status = true;
-		}
+		// Descriptors are only requested once the callback asks for them
+		p_device->h_string_cache = h_string_cache;
+		status = true;
 
 		// Signal enumerated item call-back
 		if (NULL != enum_item_callback)
@@ -1113,50 +1350,7 @@ static bool usb_enumerate_ports(HANDLE h_hub, uint8_t num_ports,
 		}
 
 		// Now we can free any configuration descriptors we may have acquired
-		if (p_device->p_configuration_descriptors != NULL)
-		{
-			do
-			{
-				pusb_configuration_descriptor_entry_t p_next_node,
-						p_config_node;
-
-				// Point to top node
-				p_config_node = p_device->p_configuration_descriptors;
-
-				// First we can free any string descriptors we may have acquired
-				if (p_config_node->p_string_descriptors != NULL)
-				{
-					do
-					{
-						pusb_string_descriptor_entry_t p_next_node,
-								p_string_node;
-
-						// Point to top node
-						p_string_node = p_config_node->p_string_descriptors;
-
-						// Remember next node
-						p_next_node = p_string_node->p_next;
-
-						// free node
-						free(p_string_node);
-
-						// Move next node to the top
-						p_config_node->p_string_descriptors = p_next_node;
-
-					} while (p_config_node->p_string_descriptors != NULL);
-				}
-
-				// Remember next node
-				p_next_node = p_config_node->p_next;
-
-				// free node
-				free(p_config_node);
-
-				// Move next node to the top
-				p_device->p_configuration_descriptors = p_next_node;
-
-			} while (p_device->p_configuration_descriptors != NULL);
-		}
+		usb_enum_free_configuration_descriptors(p_device);
 
 		// Is the caller done?
 		if (continue_enumeration == false)
@@ -1171,8 +1365,8 @@ static bool usb_enumerate_ports(HANDLE h_hub, uint8_t num_ports,
 		{
 			// Enumerate external associated with this port
 			status = usb_enumerate_hubs(h_hub,
-					p_connection_info_ex->ConnectionIndex, enum_item_callback,
-					p_enum_item_arg);
+					p_connection_info_ex->ConnectionIndex, depth + 1,
+					enum_item_callback, p_enum_item_arg, h_string_cache);
 		}
 
 	}
@@ -1181,8 +1375,9 @@ static bool usb_enumerate_ports(HANDLE h_hub, uint8_t num_ports,
 }
 
 static bool usb_enumerate_hubs(HANDLE h_host_controller,
-		size_t connection_index, USB_ENUM_ITEM_CALLBACK enum_item_callback,
-		void * p_enum_item_arg)
+		size_t connection_index, size_t depth,
+		USB_ENUM_ITEM_CALLBACK enum_item_callback, void * p_enum_item_arg,
+		HANDLE h_string_cache)
 {
 	bool success;
 	ULONG num_bytes;
@@ -1194,6 +1389,7 @@ static bool usb_enumerate_hubs(HANDLE h_host_controller,
 
 	// initialize structure
 	memset(&info, 0, sizeof(usb_enum_info_t));
+	info.depth = depth;
 
 	// Based on type, point to appropriate structure
 	if (connection_index == 0)
@@ -1316,7 +1512,8 @@ static bool usb_enumerate_hubs(HANDLE h_host_controller,
 					usb_enumerate_ports(
 							p_hub->h_hub,
 							p_hub->node_info.u.HubInformation.HubDescriptor.bNumberOfPorts,
-							enum_item_callback, p_enum_item_arg);
+							depth + 1, enum_item_callback, p_enum_item_arg,
+							h_string_cache);
 		}
 		else
 		{
@@ -1346,6 +1543,23 @@ static bool usb_enumerate_hubs(HANDLE h_host_controller,
 
 bool usb_enumerate(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
 		void *p_usb_enum_item_callback_arg)
+{
+	HANDLE h_string_cache;
+	bool status;
+
+	// Strings shared between configurations are still only requested once
+	h_string_cache = usb_string_cache_create();
+
+	status = usb_enumerate_cached(usb_enum_item_callback,
+			p_usb_enum_item_callback_arg, h_string_cache);
+
+	usb_string_cache_destroy(h_string_cache);
+
+	return status;
+}
+
+bool usb_enumerate_cached(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_usb_enum_item_callback_arg, HANDLE h_string_cache)
 {
 	HDEVINFO dev_info;
 	bool status = false;
@@ -1448,8 +1662,8 @@ bool usb_enumerate(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
 						// Enumerate hubs associated with this controller
 						status = usb_enumerate_hubs(
 								p_hc_info->h_host_controller, 0 /*root*/,
-								usb_enum_item_callback,
-								p_usb_enum_item_callback_arg);
+								1, usb_enum_item_callback,
+								p_usb_enum_item_callback_arg, h_string_cache);
 					}
 					else
 					{
@@ -1468,3 +1682,244 @@ bool usb_enumerate(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
 
 	return status;
 }
+
+PUSB_DEVICE_DESCRIPTOR usb_enum_get_device_descriptor(
+		pusb_device_info_t p_device_info)
+{
+	if (NULL == p_device_info)
+	{
+		return NULL;
+	}
+
+	if (!p_device_info->is_device_descriptor_read
+			&& (p_device_info->connection_info.ConnectionStatus
+					== DeviceConnected))
+	{
+		PUSB_DEVICE_DESCRIPTOR p_hub_copy =
+				&p_device_info->connection_info.DeviceDescriptor;
+		uint8_t * desc = NULL;
+		uint16_t descLength = 0;
+
+		// USBHUB keeps the descriptor it read when the device was attached,
+		// taking it from there spares the device a request (and a wakeup)
+		if ((p_hub_copy->bLength == sizeof(USB_DEVICE_DESCRIPTOR))
+				&& (p_hub_copy->bDescriptorType == USB_DEVICE_DESCRIPTOR_TYPE))
+		{
+			p_device_info->device_descriptor = *p_hub_copy;
+			p_device_info->is_device_descriptor_valid = true;
+			p_device_info->is_device_descriptor_read = true;
+
+			return &p_device_info->device_descriptor;
+		}
+
+		// Otherwise get device descriptor from device
+		p_device_info->is_device_descriptor_valid = usb_get_device_descriptor(
+				p_device_info->h_hub,
+				p_device_info->connection_info.ConnectionIndex, 0, &desc,
+				&descLength);
+		if (p_device_info->is_device_descriptor_valid)
+		{
+			// Copy contents of retrieved device descriptor
+			p_device_info->device_descriptor = *((PUSB_DEVICE_DESCRIPTOR) desc);
+
+			// Release device descriptor (we don't need it any more)
+			usb_free_descriptor(desc); // device
+		}
+
+		p_device_info->is_device_descriptor_read = true;
+	}
+
+	return (p_device_info->is_device_descriptor_valid ?
+			&p_device_info->device_descriptor : NULL);
+}
+
+pusb_configuration_descriptor_entry_t usb_enum_get_configuration_descriptors(
+		pusb_device_info_t p_device_info)
+{
+	if (NULL == p_device_info)
+	{
+		return NULL;
+	}
+
+	// The configurations count comes from the device descriptor
+	if (!p_device_info->are_configuration_descriptors_read
+			&& (NULL != usb_enum_get_device_descriptor(p_device_info)))
+	{
+		usb_get_configurations_from_node(p_device_info,
+				p_device_info->connection_info.ConnectionIndex);
+
+		p_device_info->are_configuration_descriptors_read = true;
+	}
+
+	return p_device_info->p_configuration_descriptors;
+}
+
+void usb_enum_free_configuration_descriptors(pusb_device_info_t p_device)
+{
+	if (NULL == p_device)
+	{
+		return;
+	}
+
+	if (p_device->p_configuration_descriptors != NULL)
+	{
+		do
+		{
+			pusb_configuration_descriptor_entry_t p_next_node,
+					p_config_node;
+
+			// Point to top node
+			p_config_node = p_device->p_configuration_descriptors;
+
+			// First we can free any string descriptors we may have acquired
+			if (p_config_node->p_string_descriptors != NULL)
+			{
+				do
+				{
+					pusb_string_descriptor_entry_t p_next_node,
+							p_string_node;
+
+					// Point to top node
+					p_string_node = p_config_node->p_string_descriptors;
+
+					// Remember next node
+					p_next_node = p_string_node->p_next;
+
+					// free node
+					free(p_string_node);
+
+					// Move next node to the top
+					p_config_node->p_string_descriptors = p_next_node;
+
+				} while (p_config_node->p_string_descriptors != NULL);
+			}
+
+			// Remember next node
+			p_next_node = p_config_node->p_next;
+
+			// free node
+			free(p_config_node);
+
+			// Move next node to the top
+			p_device->p_configuration_descriptors = p_next_node;
+
+		} while (p_device->p_configuration_descriptors != NULL);
+	}
+
+	return;
+}
+
+bool usb_enum_get_hid_report_descriptor(char const * p_device_path,
+		uint8_t ** pp_descriptor, uint16_t * p_descriptor_length)
+{
+	char * p_hub_path = NULL;
+	HANDLE h_hub;
+	ULONG connection_index;
+	int interface_number; // -1 for any
+	uint8_t * p_config_desc;
+	uint16_t config_desc_length;
+	usb_descriptor_t descriptor;
+	size_t offset = 0;
+	bool is_interface = false;
+	uint8_t current_interface = 0;
+	uint16_t descriptor_length = 0;
+	uint8_t * p_descriptor;
+	bool success = false;
+
+	// Reused for the configuration, only a larger one is allocated
+	UCHAR scratch[sizeof(USB_DESCRIPTOR_REQUEST) + CONFIG_DESCRIPTOR_GUESS];
+	PUSB_DESCRIPTOR_REQUEST p_scratch = (PUSB_DESCRIPTOR_REQUEST) scratch;
+
+	if ((NULL == p_device_path) || (NULL == pp_descriptor)
+			|| (NULL == p_descriptor_length))
+	{
+		return false;
+	}
+
+	if (!usb_find_hid_connection(p_device_path, &p_hub_path,
+			&connection_index, &interface_number))
+	{
+		return false;
+	}
+
+	h_hub = CreateFile(p_hub_path, GENERIC_WRITE, FILE_SHARE_WRITE, NULL,
+			OPEN_EXISTING, 0, NULL);
+	free(p_hub_path);
+
+	if (INVALID_HANDLE_VALUE == h_hub)
+	{
+		return false;
+	}
+
+	// The HID Descriptor following the interface (the first with one when the
+	// device is not composite) gives the length of its report descriptor
+	if (usb_get_config_descriptor(h_hub, connection_index, 0, 0, p_scratch,
+			sizeof(scratch), &p_config_desc, &config_desc_length))
+	{
+		while ((0 == descriptor_length)
+				&& usb_descriptor_next(p_config_desc, config_desc_length,
+						&offset, &descriptor))
+		{
+			PUSB_INTERFACE_DESCRIPTOR p_interface;
+			pusb_hid_descriptor_t p_hid;
+			uint8_t index;
+
+			switch (descriptor.kind)
+			{
+			case USB_DESCRIPTOR_KIND_INTERFACE:
+				p_interface = descriptor.u.p_interface;
+				is_interface = (0 == p_interface->bAlternateSetting)
+						&& ((interface_number < 0)
+								|| (interface_number
+										== p_interface->bInterfaceNumber));
+				current_interface = p_interface->bInterfaceNumber;
+				break;
+
+			case USB_DESCRIPTOR_KIND_HID:
+				p_hid = descriptor.u.p_hid;
+				for (index = 0;
+						is_interface && (index < p_hid->bNumDescriptors);
+						index++)
+				{
+					if (USB_HID_REPORT_DESCRIPTOR_TYPE
+							== p_hid->optional_descriptors[index].bDescriptorType)
+					{
+						descriptor_length =
+								p_hid->optional_descriptors[index].wDescriptorLength;
+						break;
+					}
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		if (p_config_desc != p_scratch->Data)
+		{
+			usb_free_descriptor(p_config_desc);
+		}
+	}
+
+	if ((0 != descriptor_length)
+			&& usb_request_hid_report_descriptor(h_hub, connection_index,
+					current_interface, descriptor_length,
+					&p_descriptor))
+	{
+		// Handed over in a buffer of its own, so the caller can free() it
+		*pp_descriptor = (uint8_t *) malloc(descriptor_length);
+		if (NULL != *pp_descriptor)
+		{
+			memcpy(*pp_descriptor, p_descriptor, descriptor_length);
+			*p_descriptor_length = descriptor_length;
+			success = true;
+		}
+
+		usb_free_descriptor(p_descriptor);
+	}
+
+	CloseHandle(h_hub);
+
+	return success;
+}
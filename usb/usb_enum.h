@@ -141,6 +141,13 @@ typedef struct _usb_configuration_descriptor_entry_t
 
 } usb_configuration_descriptor_entry_t, *pusb_configuration_descriptor_entry_t;
 
+//
+// The descriptors of a device are only requested from it when first read
+// through usb_enum_get_device_descriptor() and
+// usb_enum_get_configuration_descriptors(), so enumerating the topology alone
+// costs one request per port.
+//
+
 typedef struct _usb_device_info_t
 {
 	HANDLE h_hub;
@@ -151,6 +158,12 @@ typedef struct _usb_device_info_t
 
 	pusb_configuration_descriptor_entry_t p_configuration_descriptors;
 
+	// Lazy retrieval state (private to usb_enum)
+	HANDLE h_string_cache;
+	bool is_device_descriptor_read;
+	bool is_device_descriptor_valid;
+	bool are_configuration_descriptors_read;
+
 } usb_device_info_t, *pusb_device_info_t;
 
 typedef struct _usb_external_hub_info_t
@@ -175,6 +188,10 @@ typedef struct _usb_enum_info_t
 	usb_device_type_t type;
 	usb_enum_info_union_t u;
 
+	// Nesting of this item (0 for a host controller, its root hub is 1, the
+	// root hub's ports 2 and so on)
+	size_t depth;
+
 } usb_enum_info_t, *pusb_enum_info_t;
 
 /* ************************************************************************** */
@@ -196,6 +213,30 @@ typedef struct _usb_enum_info_t
 typedef bool
 (*USB_ENUM_ITEM_CALLBACK)(pusb_enum_info_t const p_enum_info, void *p_arg);
 
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum
+
+ \brief Declaration of a source of enumerated items, such as the system
+ (usb_enumerate_cached()), a synthetic topology (usb_enum_synthetic_run())
+ or a Linux sysfs tree (usb_enum_sysfs_run()).
+
+ \param[in] usb_enum_item_callback - The callback called for each entry.
+ \param[in] p_enum_item_callback_arg - The user provided callback argument.
+ \param[in] h_provider - The provider's own context.
+
+ \return Indicates if enumeration was successful.
+
+ Providers call back host controllers, hubs and ports in the order described
+ for usb_enumerate().
+
+ */
+/* ************************************************************************** */
+
+typedef bool
+(*USB_ENUM_PROVIDER)(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_provider);
+
 /* ************************************************************************** */
 /*!
  \ingroup usb_enum
@@ -244,6 +285,107 @@ typedef bool
 bool usb_enumerate(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
 		void *p_enum_item_callback_arg);
 
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum
+
+ \brief This API enumerates(iterates) over all USB entries, taking string
+ descriptors from a string cache when it holds them.
+
+ \param[in] usb_enum_item_callback - The callback called for each entry.
+ \param[in] p_enum_item_callback_arg - The user provided callback argument.
+ \param[in] h_string_cache - A handle to the string cache (NULL for none).
+
+ \return Indicates if enumeration was successful.
+
+ Strings requested from a device are added to the cache, see
+ usb_string_cache_create().
+
+ */
+/* ************************************************************************** */
+
+bool usb_enumerate_cached(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_string_cache);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum
+
+ \brief Retrieves the device descriptor of an enumerated device, taking it
+ from the hub driver's copy or else requesting it from the device on first use.
+
+ \param[in,out] p_device_info - The device passed to the enumeration callback.
+
+ \return A pointer to the device descriptor, or NULL if the device is not
+ connected or did not return it.
+
+ */
+/* ************************************************************************** */
+
+PUSB_DEVICE_DESCRIPTOR usb_enum_get_device_descriptor(
+		pusb_device_info_t p_device_info);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum
+
+ \brief Retrieves the configuration descriptors, each with the string
+ descriptors it refers to, of an enumerated device, requesting them from the
+ device on first use.
+
+ \param[in,out] p_device_info - The device passed to the enumeration callback.
+
+ \return The list of configuration descriptors (NULL if none were returned).
+
+ The list is only valid until the enumeration callback returns.
+
+ */
+/* ************************************************************************** */
+
+pusb_configuration_descriptor_entry_t usb_enum_get_configuration_descriptors(
+		pusb_device_info_t p_device_info);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum
+
+ \brief Frees the configuration descriptors, and their string descriptors,
+ held by an enumerated device.
+
+ \param[in,out] p_device_info - The device holding the descriptors.
+
+ Providers call this once the enumeration callback has returned.
+
+ */
+/* ************************************************************************** */
+
+void usb_enum_free_configuration_descriptors(pusb_device_info_t p_device_info);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum
+
+ \brief Requests the report descriptor of a USB HID from the device, through
+ the hub it is connected to.
+
+ \param[in] p_device_path - The interface path the HID is opened with.
+ \param[out] pp_descriptor - Receives the report descriptor, which the caller
+ frees with free().
+ \param[out] p_descriptor_length - Receives the length of the report
+ descriptor.
+
+ \return Indicates if the report descriptor was returned in full (false for a
+ HID that is not on USB).
+
+ The length requested is the one the HID Descriptor of the interface gives, in
+ the first configuration of the device.
+
+ */
+/* ************************************************************************** */
+
+bool usb_enum_get_hid_report_descriptor(char const * p_device_path,
+		uint8_t ** pp_descriptor, uint16_t * p_descriptor_length);
+
 #ifdef __cplusplus
 }
 #endif
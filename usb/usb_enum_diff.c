@@ -0,0 +1,489 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_diff.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <dbt.h>
+
+// WDK includes
+#include <usbiodef.h>
+#include <usbioctl.h>
+
+// Other includes
+#include "utils.h"
+#include "fnv1a.h"
+#include "console_stop.h"
+#include "usb_enum.h"
+#include "win_msg_hdlr.h"
+#include "win_device_notification.h"
+
+// Module include
+#include "usb_enum_diff.h"
+
+// Longest port path, "255-" and ".255" per level
+#define PATH_LENGTH					(4 + 4 * USB_ENUM_DIFF_MAX_LEVELS + 1)
+
+// Number of devices an index first makes room for
+#define INDEX_INITIAL_CAPACITY		(64)
+
+// Marks an empty bucket
+#define NO_NODE						(SIZE_MAX)
+
+// How long notifications must stop for before enumerating again
+#define WATCH_SETTLE_MSEC			(250)
+
+typedef struct _diff_node_t
+{
+	char path[PATH_LENGTH];
+	uint64_t path_hash;
+	uint64_t descriptor_hash;
+
+	uint16_t vid;
+	uint16_t pid;
+
+} diff_node_t, *pdiff_node_t;
+
+typedef struct _diff_index_t
+{
+	pdiff_node_t p_nodes;
+	size_t node_count;
+	size_t capacity;
+
+	// Open addressed table of node indexes by path hash
+	size_t *p_buckets;
+	size_t bucket_mask; // Number of buckets - 1
+
+	// Port path of the item being enumerated
+	char path[PATH_LENGTH];
+	size_t level_length[USB_ENUM_DIFF_MAX_LEVELS + 1];
+	unsigned long controller_count;
+
+	bool is_error; // Out of memory while indexing
+
+} diff_index_t, *pdiff_index_t;
+
+typedef struct _watch_context_t
+{
+	HDEVNOTIFY h_device_notify;
+
+	// Set when a device arrived or left since last cleared
+	bool is_changed;
+
+} watch_context_t, *pwatch_context_t;
+
+// Local declarations
+static bool index_item_callback(pusb_enum_info_t const p_enum_info,
+		void *p_arg);
+
+static bool build_buckets(pdiff_index_t p_index);
+
+static pdiff_node_t find_node(pdiff_index_t p_index, pdiff_node_t p_key);
+
+static bool watch_msg_hdlr(p_win_proc_msg_context_t p_context);
+
+// Implementation
+
+static bool index_item_callback(pusb_enum_info_t const p_enum_info,
+		void *p_arg)
+{
+	pdiff_index_t p_index = (pdiff_index_t) p_arg;
+	pusb_device_info_t p_device_info = &p_enum_info->u.device;
+	PUSB_DEVICE_DESCRIPTOR p_device_descriptor;
+	pdiff_node_t p_node;
+	size_t level = p_enum_info->depth / 2; // Ports are 2 deep per hub tier
+	int length;
+
+	if (USB_HOST_CONTROLLER == p_enum_info->type)
+	{
+		p_index->controller_count++;
+		p_index->level_length[0] = (size_t) _snprintf(p_index->path,
+				sizeof(p_index->path), "%lu", p_index->controller_count);
+
+		return (true);
+	}
+
+	// Hubs are seen through the ports they are connected to
+	if ((USB_DEVICE != p_enum_info->type) || (0 == level)
+			|| (level > USB_ENUM_DIFF_MAX_LEVELS) || p_index->is_error)
+	{
+		return (true);
+	}
+
+	length = _snprintf(&p_index->path[p_index->level_length[level - 1]],
+			sizeof(p_index->path) - p_index->level_length[level - 1],
+			(1 == level) ? "-%u" : ".%u",
+			(unsigned int) p_device_info->connection_info.ConnectionIndex);
+	if (length < 0)
+	{
+		return (true);
+	}
+	p_index->level_length[level] = p_index->level_length[level - 1] + length;
+
+	if (DeviceConnected != p_device_info->connection_info.ConnectionStatus)
+	{
+		return (true);
+	}
+
+	if (p_index->node_count == p_index->capacity)
+	{
+		size_t capacity =
+				(0 == p_index->capacity) ?
+						INDEX_INITIAL_CAPACITY : 2 * p_index->capacity;
+		pdiff_node_t p_nodes;
+
+		p_nodes = (pdiff_node_t) realloc(p_index->p_nodes,
+				capacity * sizeof(diff_node_t));
+		if (NULL == p_nodes)
+		{
+			p_index->is_error = true;
+			return (true);
+		}
+
+		p_index->p_nodes = p_nodes;
+		p_index->capacity = capacity;
+	}
+
+	p_node = &p_index->p_nodes[p_index->node_count++];
+	memset(p_node, 0, sizeof(diff_node_t));
+
+	memcpy(p_node->path, p_index->path, p_index->level_length[level]);
+	p_node->path[p_index->level_length[level]] = '\0';
+	p_node->path_hash = fnv1a_hash(FNV1A_OFFSET_BASIS, p_node->path,
+			p_index->level_length[level]);
+
+	p_node->descriptor_hash = FNV1A_OFFSET_BASIS;
+	p_device_descriptor = usb_enum_get_device_descriptor(p_device_info);
+	if (NULL != p_device_descriptor)
+	{
+		p_node->descriptor_hash = fnv1a_hash(p_node->descriptor_hash,
+				p_device_descriptor, sizeof(USB_DEVICE_DESCRIPTOR));
+		p_node->vid = p_device_descriptor->idVendor;
+		p_node->pid = p_device_descriptor->idProduct;
+	}
+
+	return (true);
+}
+
+static bool build_buckets(pdiff_index_t p_index)
+{
+	size_t bucket_count = INDEX_INITIAL_CAPACITY;
+	size_t node_index;
+
+	// At most half full keeps the probes short
+	while (bucket_count < 2 * p_index->node_count)
+	{
+		bucket_count *= 2;
+	}
+
+	p_index->p_buckets = (size_t *) malloc(bucket_count * sizeof(size_t));
+	if (NULL == p_index->p_buckets)
+	{
+		return (false);
+	}
+
+	memset(p_index->p_buckets, 0xff, bucket_count * sizeof(size_t));
+	p_index->bucket_mask = bucket_count - 1;
+
+	for (node_index = 0; node_index < p_index->node_count; node_index++)
+	{
+		size_t bucket = (size_t) p_index->p_nodes[node_index].path_hash
+				& p_index->bucket_mask;
+
+		while (NO_NODE != p_index->p_buckets[bucket])
+		{
+			bucket = (bucket + 1) & p_index->bucket_mask;
+		}
+
+		p_index->p_buckets[bucket] = node_index;
+	}
+
+	return (true);
+}
+
+static pdiff_node_t find_node(pdiff_index_t p_index, pdiff_node_t p_key)
+{
+	size_t bucket = (size_t) p_key->path_hash & p_index->bucket_mask;
+
+	while (NO_NODE != p_index->p_buckets[bucket])
+	{
+		pdiff_node_t p_node = &p_index->p_nodes[p_index->p_buckets[bucket]];
+
+		if ((p_node->path_hash == p_key->path_hash)
+				&& (0 == strcmp(p_node->path, p_key->path)))
+		{
+			return (p_node);
+		}
+
+		bucket = (bucket + 1) & p_index->bucket_mask;
+	}
+
+	return (NULL);
+}
+
+HANDLE usb_enum_diff_index(USB_ENUM_PROVIDER provider, HANDLE h_provider)
+{
+	pdiff_index_t p_index;
+
+	if (NULL == provider)
+	{
+		return (NULL);
+	}
+
+	p_index = (pdiff_index_t) calloc(1, sizeof(diff_index_t));
+	if (NULL == p_index)
+	{
+		return (NULL);
+	}
+
+	if (!provider(index_item_callback, p_index, h_provider)
+			|| p_index->is_error || !build_buckets(p_index))
+	{
+		usb_enum_diff_destroy((HANDLE) p_index);
+		return (NULL);
+	}
+
+	return ((HANDLE) p_index);
+}
+
+size_t usb_enum_diff_print(HANDLE h_old, HANDLE h_new, FILE *p_file)
+{
+	pdiff_index_t p_old = (pdiff_index_t) h_old;
+	pdiff_index_t p_new = (pdiff_index_t) h_new;
+	bool *p_is_matched;
+	size_t differences = 0;
+	size_t node_index;
+
+	if ((NULL == p_old) || (NULL == p_new) || (NULL == p_file))
+	{
+		return (0);
+	}
+
+	// Old devices not found again were removed
+	p_is_matched = (bool *) calloc(p_old->node_count + 1, sizeof(bool));
+	if (NULL == p_is_matched)
+	{
+		return (0);
+	}
+
+	for (node_index = 0; node_index < p_new->node_count; node_index++)
+	{
+		pdiff_node_t p_node = &p_new->p_nodes[node_index];
+		pdiff_node_t p_old_node = find_node(p_old, p_node);
+
+		if (NULL == p_old_node)
+		{
+			fprintf(p_file, "added   %s %04x:%04x\n", p_node->path,
+					p_node->vid, p_node->pid);
+			differences++;
+			continue;
+		}
+
+		p_is_matched[p_old_node - p_old->p_nodes] = true;
+
+		if (p_old_node->descriptor_hash != p_node->descriptor_hash)
+		{
+			fprintf(p_file, "changed %s %04x:%04x -> %04x:%04x\n",
+					p_node->path, p_old_node->vid, p_old_node->pid,
+					p_node->vid, p_node->pid);
+			differences++;
+		}
+	}
+
+	for (node_index = 0; node_index < p_old->node_count; node_index++)
+	{
+		if (!p_is_matched[node_index])
+		{
+			pdiff_node_t p_node = &p_old->p_nodes[node_index];
+
+			fprintf(p_file, "removed %s %04x:%04x\n", p_node->path,
+					p_node->vid, p_node->pid);
+			differences++;
+		}
+	}
+
+	free(p_is_matched);
+
+	return (differences);
+}
+
+void usb_enum_diff_destroy(HANDLE h_index)
+{
+	pdiff_index_t p_index = (pdiff_index_t) h_index;
+
+	if (NULL == p_index)
+	{
+		return;
+	}
+
+	free(p_index->p_buckets);
+	free(p_index->p_nodes);
+	free(p_index);
+}
+
+static bool watch_msg_hdlr(p_win_proc_msg_context_t p_context)
+{
+	bool msg_handled = TRUE;
+	p_winapi_proc_args_t p_args = p_context->p_winapi_proc_args;
+	pwatch_context_t p_watch = (pwatch_context_t) p_context->p_callback_arg;
+
+	switch (p_args->message)
+	{
+	case WM_CREATE:
+		if (!register_device_notifications(GUID_DEVINTERFACE_USB_DEVICE,
+				p_args->hWnd, &p_watch->h_device_notify))
+		{
+			print_errno("register_device_notifications");
+		}
+		break;
+
+	case WM_DEVICECHANGE:
+		if ((DBT_DEVICEARRIVAL == p_args->wParam)
+				|| (DBT_DEVICEREMOVECOMPLETE == p_args->wParam))
+		{
+			p_watch->is_changed = true;
+		}
+		break;
+
+	case WM_CLOSE:
+		if (NULL != p_watch->h_device_notify)
+		{
+			UnregisterDeviceNotification(p_watch->h_device_notify);
+			p_watch->h_device_notify = NULL;
+		}
+		break;
+
+	default:
+		msg_handled = FALSE;
+		break;
+	}
+
+	return msg_handled;
+}
+
+bool usb_enum_diff_watch(HINSTANCE hInstance, USB_ENUM_PROVIDER provider,
+		HANDLE h_provider)
+{
+	watch_context_t context;
+	HANDLE h_msg_hdlr;
+	HANDLE h_index;
+	HANDLE h_stop_event;
+	bool running = true;
+
+	h_index = usb_enum_diff_index(provider, h_provider);
+	if (NULL == h_index)
+	{
+		return (false);
+	}
+
+	h_stop_event = console_stop_create();
+	if (NULL == h_stop_event)
+	{
+		print_errno("console_stop_create");
+		usb_enum_diff_destroy(h_index);
+		return (false);
+	}
+
+	memset(&context, 0, sizeof(context));
+	h_msg_hdlr = win_msg_hdlr_create(hInstance, watch_msg_hdlr, &context);
+
+	printf("Watching %lu USB devices, press Ctrl+C to stop.\n",
+			(unsigned long) ((pdiff_index_t) h_index)->node_count);
+
+	while (running && (NULL != h_msg_hdlr))
+	{
+		DWORD wait_status;
+
+		// Enumerate once the notifications of a change stop coming
+		wait_status = MsgWaitForMultipleObjects(1, &h_stop_event, FALSE,
+				context.is_changed ? WATCH_SETTLE_MSEC : INFINITE,
+				QS_ALLINPUT);
+
+		switch (wait_status)
+		{
+		case WAIT_OBJECT_0 + 1:
+			// Window messages are queued
+			running = win_msg_hdlr_dispatch();
+			break;
+
+		case WAIT_TIMEOUT:
+		{
+			HANDLE h_new_index = usb_enum_diff_index(provider, h_provider);
+
+			context.is_changed = false;
+
+			if (NULL != h_new_index)
+			{
+				usb_enum_diff_print(h_index, h_new_index, stdout);
+				fflush(stdout);
+
+				usb_enum_diff_destroy(h_index);
+				h_index = h_new_index;
+			}
+			break;
+		}
+
+		case WAIT_OBJECT_0:
+		default:
+			running = false;
+			break;
+		}
+	}
+
+	win_msg_hdlr_destroy(h_msg_hdlr);
+
+	console_stop_destroy(h_stop_event);
+
+	usb_enum_diff_destroy(h_index);
+
+	return (NULL != h_msg_hdlr);
+}
@@ -0,0 +1,155 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_diff.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_ENUM_DIFF_H_
+#define USB_ENUM_DIFF_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_enum_diff
+
+ \brief These APIs compare enumerations, reporting the devices added, removed
+ or changed between them, and watch the system for such changes.
+ */
+/* ************************************************************************* */
+
+/*
+
+ A device is identified by its port path, the 1 based number of its host
+ controller in enumeration order followed by the port of every hub down to
+ it (e.g. "1-3.2"), and compared by a hash of its device descriptor. Both are
+ hashed when an enumeration is indexed so comparing two indexes takes time
+ linear in the number of devices.
+
+ Only the device descriptor USBHUB keeps for each port is hashed, so indexing
+ the system sends no request to the devices themselves.
+
+ */
+
+// Hub tiers below a root hub a port path may have
+#define USB_ENUM_DIFF_MAX_LEVELS	(32)
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_diff
+
+ \brief Indexes the connected devices a provider enumerates.
+
+ \param[in] provider - The provider to enumerate.
+ \param[in] h_provider - The provider's own context.
+
+ \return A handle to the index or NULL on failure.
+
+ */
+/* ************************************************************************** */
+
+HANDLE usb_enum_diff_index(USB_ENUM_PROVIDER provider, HANDLE h_provider);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_diff
+
+ \brief Prints a line for each device added, removed or changed from one
+ index to another.
+
+ \param[in] h_old - A handle to the earlier index.
+ \param[in] h_new - A handle to the later index.
+ \param[in] p_file - Where to print the differences.
+
+ \return The number of differences printed.
+
+ */
+/* ************************************************************************** */
+
+size_t usb_enum_diff_print(HANDLE h_old, HANDLE h_new, FILE *p_file);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_diff
+
+ \brief Destroys an index.
+
+ \param[in] h_index - A handle to the index.
+
+ */
+/* ************************************************************************** */
+
+void usb_enum_diff_destroy(HANDLE h_index);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_diff
+
+ \brief Prints the differences every time USB devices arrive or leave until
+ the user interrupts (Ctrl+C) the program.
+
+ \param[in] hInstance - The instance owning the notification window.
+ \param[in] provider - The provider to enumerate (e.g. usb_enumerate_cached()).
+ \param[in] h_provider - The provider's own context.
+
+ \return Indicates if the watch ran.
+
+ The provider is only enumerated again once the device notifications of a
+ change have settled, a burst of arrivals costing a single enumeration.
+
+ */
+/* ************************************************************************** */
+
+bool usb_enum_diff_watch(HINSTANCE hInstance, USB_ENUM_PROVIDER provider,
+		HANDLE h_provider);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_ENUM_DIFF_H_ */
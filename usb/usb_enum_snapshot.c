@@ -0,0 +1,897 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_snapshot.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <tchar.h>
+
+// WDK includes
+#include <usbioctl.h>
+#include <usb100.h>
+
+// Other includes
+#include "utils.h"
+#include "buffered_writer.h"
+#include "usb_enum.h"
+
+// Module include
+#include "usb_enum_snapshot.h"
+
+// Marks the absence of a subtree being skipped
+#define NO_DEPTH		(SIZE_MAX)
+
+typedef struct _snapshot_writer_t
+{
+	buffered_writer_t writer;
+	usb_enum_snapshot_format_t format;
+
+} snapshot_writer_t, *psnapshot_writer_t;
+
+typedef struct _snapshot_t
+{
+	uint8_t *p_data; // The whole file
+	size_t length;
+	size_t max_name_length; // Of all records
+
+} snapshot_t, *psnapshot_t;
+
+// Local declarations
+static size_t get_descriptors_length(
+		pusb_configuration_descriptor_entry_t p_configurations);
+
+static void write_binary_item(pbuffered_writer_t p_writer,
+		pusb_enum_info_t const p_enum_info, PTSTR p_name, uint8_t num_ports,
+		pusb_device_info_t p_device_info);
+
+static void put_json_string(pbuffered_writer_t p_writer, PTSTR p_text);
+
+static void put_json_hex(pbuffered_writer_t p_writer, void const * p_data,
+		size_t length);
+
+static void write_json_item(pbuffered_writer_t p_writer,
+		pusb_enum_info_t const p_enum_info, PTSTR p_name, uint8_t num_ports,
+		pusb_device_info_t p_device_info);
+
+static bool save_item_callback(pusb_enum_info_t const p_enum_info,
+		void *p_arg);
+
+static bool is_valid_record(uint8_t const * p_record, size_t length,
+		size_t *p_record_length);
+
+static bool build_configurations(uint8_t const * p_blocks, size_t length,
+		pusb_device_info_t p_device_info);
+
+// Implementation
+
+static size_t get_descriptors_length(
+		pusb_configuration_descriptor_entry_t p_configurations)
+{
+	pusb_configuration_descriptor_entry_t p_config;
+	size_t length = 0;
+
+	for (p_config = p_configurations; NULL != p_config;
+			p_config = p_config->p_next)
+	{
+		pusb_string_descriptor_entry_t p_string;
+
+		length += sizeof(usb_enum_snapshot_block_t)
+				+ p_config->configuration_descriptor->wTotalLength;
+
+		for (p_string = p_config->p_string_descriptors; NULL != p_string;
+				p_string = p_string->p_next)
+		{
+			length += sizeof(usb_enum_snapshot_block_t)
+					+ p_string->string_descriptor->bLength;
+		}
+	}
+
+	return (length);
+}
+
+static void write_binary_item(pbuffered_writer_t p_writer,
+		pusb_enum_info_t const p_enum_info, PTSTR p_name, uint8_t num_ports,
+		pusb_device_info_t p_device_info)
+{
+	usb_enum_snapshot_record_t record;
+	pusb_configuration_descriptor_entry_t p_configurations = NULL;
+	pusb_configuration_descriptor_entry_t p_config;
+	size_t name_length = (NULL == p_name) ? 0 : _tcslen(p_name);
+	size_t index;
+
+	memset(&record, 0, sizeof(record));
+	record.type = (uint8_t) p_enum_info->type;
+	record.num_ports = num_ports;
+	record.depth = (uint16_t) p_enum_info->depth;
+	record.name_length = (uint16_t) name_length;
+
+	if (NULL != p_device_info)
+	{
+		PUSB_NODE_CONNECTION_INFORMATION p_connection =
+				&p_device_info->connection_info;
+		PUSB_DEVICE_DESCRIPTOR p_device_descriptor =
+				usb_enum_get_device_descriptor(p_device_info);
+
+		record.connection_index = p_connection->ConnectionIndex;
+		record.connection_status = (uint32_t) p_connection->ConnectionStatus;
+		record.is_hub = p_connection->DeviceIsHub ? 1 : 0;
+		record.is_low_speed = p_connection->LowSpeed ? 1 : 0;
+		record.device_address = p_connection->DeviceAddress;
+
+		if (NULL != p_device_descriptor)
+		{
+			memcpy(record.device_descriptor, p_device_descriptor,
+					sizeof(record.device_descriptor));
+		}
+
+		p_configurations = usb_enum_get_configuration_descriptors(
+				p_device_info);
+		record.descriptors_length = (uint32_t) get_descriptors_length(
+				p_configurations);
+	}
+
+	buffered_writer_write(p_writer, &record, sizeof(record));
+
+	// Names are ASCII, stored a byte per character whatever TCHAR is
+	for (index = 0; index < name_length; index++)
+	{
+		buffered_writer_putc(p_writer, (char) p_name[index]);
+	}
+
+	for (p_config = p_configurations; NULL != p_config;
+			p_config = p_config->p_next)
+	{
+		pusb_string_descriptor_entry_t p_string;
+		usb_enum_snapshot_block_t block;
+
+		block.descriptor_type = USB_CONFIGURATION_DESCRIPTOR_TYPE;
+		block.index = p_config->configuration_index;
+		block.language_id = 0;
+		buffered_writer_write(p_writer, &block, sizeof(block));
+		buffered_writer_write(p_writer, p_config->configuration_descriptor,
+				p_config->configuration_descriptor->wTotalLength);
+
+		for (p_string = p_config->p_string_descriptors; NULL != p_string;
+				p_string = p_string->p_next)
+		{
+			block.descriptor_type = USB_STRING_DESCRIPTOR_TYPE;
+			block.index = p_string->index;
+			block.language_id = p_string->language_id;
+			buffered_writer_write(p_writer, &block, sizeof(block));
+			buffered_writer_write(p_writer, p_string->string_descriptor,
+					p_string->string_descriptor->bLength);
+		}
+	}
+
+	return;
+}
+
+static void put_json_string(pbuffered_writer_t p_writer, PTSTR p_text)
+{
+	buffered_writer_putc(p_writer, '"');
+
+	for (; (NULL != p_text) && (_T('\0') != *p_text); p_text++)
+	{
+		unsigned int c = (unsigned int) *p_text;
+
+		if (('"' == c) || ('\\' == c))
+		{
+			buffered_writer_putc(p_writer, '\\');
+			buffered_writer_putc(p_writer, (char) c);
+		}
+		else if ((c < 0x20) || (c > 0x7e))
+		{
+			buffered_writer_puts(p_writer, "\\u");
+			buffered_writer_put_hex(p_writer, c & 0xffff, 4);
+		}
+		else
+		{
+			buffered_writer_putc(p_writer, (char) c);
+		}
+	}
+
+	buffered_writer_putc(p_writer, '"');
+
+	return;
+}
+
+static void put_json_hex(pbuffered_writer_t p_writer, void const * p_data,
+		size_t length)
+{
+	uint8_t const *p_bytes = (uint8_t const *) p_data;
+	size_t index;
+
+	buffered_writer_putc(p_writer, '"');
+
+	for (index = 0; index < length; index++)
+	{
+		buffered_writer_put_hex(p_writer, p_bytes[index], 2);
+	}
+
+	buffered_writer_putc(p_writer, '"');
+
+	return;
+}
+
+static void write_json_item(pbuffered_writer_t p_writer,
+		pusb_enum_info_t const p_enum_info, PTSTR p_name, uint8_t num_ports,
+		pusb_device_info_t p_device_info)
+{
+	static char const * const type_names[] =
+	{ "host_controller", "root_hub", "external_hub", "device" };
+
+	buffered_writer_puts(p_writer, "{\"type\":\"");
+	buffered_writer_puts(p_writer, type_names[p_enum_info->type]);
+	buffered_writer_puts(p_writer, "\",\"depth\":");
+	buffered_writer_put_uint(p_writer, p_enum_info->depth);
+
+	if (NULL != p_name)
+	{
+		buffered_writer_puts(p_writer, ",\"name\":");
+		put_json_string(p_writer, p_name);
+	}
+
+	if ((USB_ROOT_HUB == p_enum_info->type)
+			|| (USB_EXTERNAL_HUB == p_enum_info->type))
+	{
+		buffered_writer_puts(p_writer, ",\"ports\":");
+		buffered_writer_put_uint(p_writer, num_ports);
+	}
+
+	if (NULL != p_device_info)
+	{
+		PUSB_NODE_CONNECTION_INFORMATION p_connection =
+				&p_device_info->connection_info;
+		bool is_connected = (DeviceConnected
+				== p_connection->ConnectionStatus);
+
+		buffered_writer_puts(p_writer, ",\"port\":");
+		buffered_writer_put_uint(p_writer, p_connection->ConnectionIndex);
+		buffered_writer_puts(p_writer, ",\"connected\":");
+		buffered_writer_puts(p_writer, is_connected ? "true" : "false");
+
+		if (is_connected)
+		{
+			PUSB_DEVICE_DESCRIPTOR p_device_descriptor =
+					usb_enum_get_device_descriptor(p_device_info);
+			pusb_configuration_descriptor_entry_t p_config;
+			bool is_first = true;
+
+			buffered_writer_puts(p_writer, ",\"hub\":");
+			buffered_writer_puts(p_writer,
+					p_connection->DeviceIsHub ? "true" : "false");
+			buffered_writer_puts(p_writer, ",\"address\":");
+			buffered_writer_put_uint(p_writer, p_connection->DeviceAddress);
+
+			if (NULL != p_device_descriptor)
+			{
+				buffered_writer_puts(p_writer, ",\"vid\":");
+				buffered_writer_put_uint(p_writer,
+						p_device_descriptor->idVendor);
+				buffered_writer_puts(p_writer, ",\"pid\":");
+				buffered_writer_put_uint(p_writer,
+						p_device_descriptor->idProduct);
+				buffered_writer_puts(p_writer, ",\"device_descriptor\":");
+				put_json_hex(p_writer, p_device_descriptor,
+						sizeof(USB_DEVICE_DESCRIPTOR));
+			}
+
+			buffered_writer_puts(p_writer, ",\"configurations\":[");
+
+			for (p_config = usb_enum_get_configuration_descriptors(
+					p_device_info); NULL != p_config;
+					p_config = p_config->p_next)
+			{
+				pusb_string_descriptor_entry_t p_string;
+
+				if (!is_first)
+				{
+					buffered_writer_putc(p_writer, ',');
+				}
+				is_first = false;
+
+				buffered_writer_puts(p_writer, "{\"index\":");
+				buffered_writer_put_uint(p_writer,
+						p_config->configuration_index);
+				buffered_writer_puts(p_writer, ",\"descriptor\":");
+				put_json_hex(p_writer, p_config->configuration_descriptor,
+						p_config->configuration_descriptor->wTotalLength);
+				buffered_writer_puts(p_writer, ",\"strings\":[");
+
+				for (p_string = p_config->p_string_descriptors;
+						NULL != p_string; p_string = p_string->p_next)
+				{
+					buffered_writer_puts(p_writer, "{\"index\":");
+					buffered_writer_put_uint(p_writer, p_string->index);
+					buffered_writer_puts(p_writer, ",\"language_id\":");
+					buffered_writer_put_uint(p_writer, p_string->language_id);
+					buffered_writer_puts(p_writer, ",\"descriptor\":");
+					put_json_hex(p_writer, p_string->string_descriptor,
+							p_string->string_descriptor->bLength);
+					buffered_writer_puts(p_writer,
+							(NULL != p_string->p_next) ? "}," : "}");
+				}
+
+				buffered_writer_puts(p_writer, "]}");
+			}
+
+			buffered_writer_putc(p_writer, ']');
+		}
+	}
+
+	buffered_writer_puts(p_writer, "}\n");
+
+	return;
+}
+
+static bool save_item_callback(pusb_enum_info_t const p_enum_info,
+		void *p_arg)
+{
+	psnapshot_writer_t p_context = (psnapshot_writer_t) p_arg;
+	PTSTR p_name = NULL;
+	uint8_t num_ports = 0;
+	pusb_device_info_t p_device_info = NULL;
+
+	switch (p_enum_info->type)
+	{
+	case USB_HOST_CONTROLLER:
+		p_name = p_enum_info->u.host_controller.p_driver_key;
+		break;
+	case USB_ROOT_HUB:
+		p_name = p_enum_info->u.root_hub.p_hub_name;
+		num_ports = p_enum_info->u.root_hub.node_info.u.HubInformation
+				.HubDescriptor.bNumberOfPorts;
+		break;
+	case USB_EXTERNAL_HUB:
+		p_name = p_enum_info->u.external_hub.hub.p_hub_name;
+		num_ports = p_enum_info->u.external_hub.hub.node_info.u.HubInformation
+				.HubDescriptor.bNumberOfPorts;
+		p_device_info = &p_enum_info->u.external_hub.device_info;
+		break;
+	case USB_DEVICE:
+		p_device_info = &p_enum_info->u.device;
+		break;
+	default:
+		return (true);
+	}
+
+	if (USB_ENUM_SNAPSHOT_FORMAT_JSON == p_context->format)
+	{
+		write_json_item(&p_context->writer, p_enum_info, p_name, num_ports,
+				p_device_info);
+	}
+	else
+	{
+		write_binary_item(&p_context->writer, p_enum_info, p_name, num_ports,
+				p_device_info);
+	}
+
+	// Everything is recorded, a failed write is reported once at the end
+	return (true);
+}
+
+bool usb_enum_snapshot_save(char const * p_path,
+		usb_enum_snapshot_format_t format, USB_ENUM_PROVIDER provider,
+		HANDLE h_provider)
+{
+	snapshot_writer_t context;
+	FILE *p_file;
+	bool success;
+
+	if ((NULL == p_path) || (NULL == provider))
+	{
+		return (false);
+	}
+
+	p_file = fopen(p_path,
+			(USB_ENUM_SNAPSHOT_FORMAT_JSON == format) ? "w" : "wb");
+	if (NULL == p_file)
+	{
+		fprintf(stderr, "Cannot create snapshot '%s'\n", p_path);
+		return (false);
+	}
+
+	context.format = format;
+	if (!buffered_writer_init(&context.writer, p_file,
+			BUFFERED_WRITER_DEFAULT_SIZE))
+	{
+		fclose(p_file);
+		return (false);
+	}
+
+	if (USB_ENUM_SNAPSHOT_FORMAT_BINARY == format)
+	{
+		usb_enum_snapshot_header_t header;
+
+		memset(&header, 0, sizeof(header));
+		strncpy(header.magic, USB_ENUM_SNAPSHOT_MAGIC, sizeof(header.magic));
+		header.version = USB_ENUM_SNAPSHOT_VERSION;
+		buffered_writer_write(&context.writer, &header, sizeof(header));
+	}
+
+	success = provider(save_item_callback, &context, h_provider);
+
+	if (USB_ENUM_SNAPSHOT_FORMAT_BINARY == format)
+	{
+		usb_enum_snapshot_record_t record;
+
+		memset(&record, 0, sizeof(record));
+		record.type = USB_ENUM_SNAPSHOT_END;
+		buffered_writer_write(&context.writer, &record, sizeof(record));
+	}
+
+	if (!buffered_writer_flush(&context.writer))
+	{
+		fprintf(stderr, "Cannot write snapshot '%s'\n", p_path);
+		success = false;
+	}
+
+	buffered_writer_free(&context.writer);
+
+	if (0 != fclose(p_file))
+	{
+		success = false;
+	}
+
+	return (success);
+}
+
+// Checks a record and its descriptor blocks fit in length bytes
+static bool is_valid_record(uint8_t const * p_record, size_t length,
+		size_t *p_record_length)
+{
+	usb_enum_snapshot_record_t record;
+	size_t offset;
+	bool is_config_seen = false;
+
+	if (length < sizeof(record))
+	{
+		return (false);
+	}
+
+	memcpy(&record, p_record, sizeof(record));
+
+	if (USB_ENUM_SNAPSHOT_END == record.type)
+	{
+		*p_record_length = sizeof(record);
+		return (true);
+	}
+
+	if ((record.type > USB_DEVICE)
+			|| ((size_t) record.name_length + record.descriptors_length
+					> length - sizeof(record)))
+	{
+		return (false);
+	}
+
+	// Walk the blocks, each descriptor's own length must stay inside
+	offset = sizeof(record) + record.name_length;
+	length = offset + record.descriptors_length;
+
+	while (offset < length)
+	{
+		usb_enum_snapshot_block_t block;
+		size_t descriptor_length;
+
+		if (length - offset < sizeof(block) + 2)
+		{
+			return (false);
+		}
+
+		memcpy(&block, &p_record[offset], sizeof(block));
+		offset += sizeof(block);
+
+		if (USB_CONFIGURATION_DESCRIPTOR_TYPE == block.descriptor_type)
+		{
+			uint16_t total_length;
+
+			if (length - offset < sizeof(USB_CONFIGURATION_DESCRIPTOR))
+			{
+				return (false);
+			}
+
+			memcpy(&total_length,
+					&p_record[offset]
+							+ offsetof(USB_CONFIGURATION_DESCRIPTOR,
+									wTotalLength), sizeof(total_length));
+			descriptor_length = total_length;
+			if (descriptor_length < sizeof(USB_CONFIGURATION_DESCRIPTOR))
+			{
+				return (false);
+			}
+
+			is_config_seen = true;
+		}
+		else if ((USB_STRING_DESCRIPTOR_TYPE == block.descriptor_type)
+				&& is_config_seen)
+		{
+			descriptor_length = p_record[offset];
+			if (descriptor_length < 2)
+			{
+				return (false);
+			}
+		}
+		else
+		{
+			return (false);
+		}
+
+		if (length - offset < descriptor_length)
+		{
+			return (false);
+		}
+
+		offset += descriptor_length;
+	}
+
+	*p_record_length = length;
+
+	return (true);
+}
+
+HANDLE usb_enum_snapshot_load(char const * p_path)
+{
+	psnapshot_t p_snapshot;
+	FILE *p_file;
+	long file_length;
+	usb_enum_snapshot_header_t header;
+	size_t offset;
+	bool is_ended = false;
+
+	if (NULL == p_path)
+	{
+		return (NULL);
+	}
+
+	p_file = fopen(p_path, "rb");
+	if (NULL == p_file)
+	{
+		fprintf(stderr, "Cannot open snapshot '%s'\n", p_path);
+		return (NULL);
+	}
+
+	p_snapshot = (psnapshot_t) calloc(1, sizeof(snapshot_t));
+	if (NULL == p_snapshot)
+	{
+		fclose(p_file);
+		return (NULL);
+	}
+
+	if ((0 != fseek(p_file, 0, SEEK_END))
+			|| ((file_length = ftell(p_file)) < 0)
+			|| (0 != fseek(p_file, 0, SEEK_SET)))
+	{
+		file_length = 0;
+	}
+
+	p_snapshot->length = (size_t) file_length;
+	p_snapshot->p_data = (uint8_t *) malloc(
+			(0 == p_snapshot->length) ? 1 : p_snapshot->length);
+
+	if ((NULL == p_snapshot->p_data)
+			|| (p_snapshot->length
+					!= fread(p_snapshot->p_data, 1, p_snapshot->length,
+							p_file)))
+	{
+		fprintf(stderr, "Cannot read snapshot '%s'\n", p_path);
+		fclose(p_file);
+		usb_enum_snapshot_destroy((HANDLE) p_snapshot);
+		return (NULL);
+	}
+
+	fclose(p_file);
+
+	// Check everything now so enumerating needs no checks of its own
+	if (p_snapshot->length >= sizeof(header))
+	{
+		memcpy(&header, p_snapshot->p_data, sizeof(header));
+	}
+
+	if ((p_snapshot->length < sizeof(header))
+			|| (0 != memcmp(header.magic, USB_ENUM_SNAPSHOT_MAGIC,
+					sizeof(USB_ENUM_SNAPSHOT_MAGIC)))
+			|| (USB_ENUM_SNAPSHOT_VERSION != header.version))
+	{
+		fprintf(stderr, "'%s' is not a snapshot\n", p_path);
+		usb_enum_snapshot_destroy((HANDLE) p_snapshot);
+		return (NULL);
+	}
+
+	offset = sizeof(header);
+
+	while (!is_ended)
+	{
+		size_t record_length;
+		uint16_t name_length;
+
+		if (!is_valid_record(&p_snapshot->p_data[offset],
+				p_snapshot->length - offset, &record_length))
+		{
+			fprintf(stderr, "Snapshot '%s' is corrupt at offset %lu\n",
+					p_path, (unsigned long) offset);
+			usb_enum_snapshot_destroy((HANDLE) p_snapshot);
+			return (NULL);
+		}
+
+		is_ended = (USB_ENUM_SNAPSHOT_END == p_snapshot->p_data[offset]);
+
+		memcpy(&name_length,
+				&p_snapshot->p_data[offset]
+						+ offsetof(usb_enum_snapshot_record_t, name_length),
+				sizeof(name_length));
+		if (name_length > p_snapshot->max_name_length)
+		{
+			p_snapshot->max_name_length = name_length;
+		}
+
+		offset += record_length;
+	}
+
+	return ((HANDLE) p_snapshot);
+}
+
+// Rebuilds the descriptor lists usb_enum would have requested
+static bool build_configurations(uint8_t const * p_blocks, size_t length,
+		pusb_device_info_t p_device_info)
+{
+	pusb_configuration_descriptor_entry_t *p_config_tail =
+			&p_device_info->p_configuration_descriptors;
+	pusb_string_descriptor_entry_t *p_string_tail = NULL;
+	size_t offset = 0;
+
+	while (offset < length)
+	{
+		usb_enum_snapshot_block_t block;
+		uint8_t const *p_descriptor;
+
+		memcpy(&block, &p_blocks[offset], sizeof(block));
+		p_descriptor = &p_blocks[offset + sizeof(block)];
+
+		if (USB_CONFIGURATION_DESCRIPTOR_TYPE == block.descriptor_type)
+		{
+			pusb_configuration_descriptor_entry_t p_config;
+			uint16_t total_length;
+
+			memcpy(&total_length,
+					p_descriptor
+							+ offsetof(USB_CONFIGURATION_DESCRIPTOR,
+									wTotalLength), sizeof(total_length));
+
+			p_config = (pusb_configuration_descriptor_entry_t) malloc(
+					sizeof(usb_configuration_descriptor_entry_t)
+							+ total_length);
+			if (NULL == p_config)
+			{
+				return (false);
+			}
+
+			p_config->p_next = NULL;
+			p_config->p_string_descriptors = NULL;
+			p_config->configuration_index = block.index;
+			memcpy(p_config->configuration_descriptor, p_descriptor,
+					total_length);
+
+			*p_config_tail = p_config;
+			p_config_tail = &p_config->p_next;
+			p_string_tail = &p_config->p_string_descriptors;
+
+			offset += sizeof(block) + total_length;
+		}
+		else
+		{
+			pusb_string_descriptor_entry_t p_string;
+
+			p_string = (pusb_string_descriptor_entry_t) malloc(
+					sizeof(usb_string_descriptor_entry_t) + p_descriptor[0]);
+			if (NULL == p_string)
+			{
+				return (false);
+			}
+
+			p_string->p_next = NULL;
+			p_string->index = block.index;
+			p_string->language_id = block.language_id;
+			memcpy(p_string->string_descriptor, p_descriptor, p_descriptor[0]);
+
+			*p_string_tail = p_string;
+			p_string_tail = &p_string->p_next;
+
+			offset += sizeof(block) + p_descriptor[0];
+		}
+	}
+
+	return (true);
+}
+
+bool usb_enum_snapshot_run(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_snapshot)
+{
+	psnapshot_t p_snapshot = (psnapshot_t) h_snapshot;
+	PTSTR p_name;
+	size_t offset = sizeof(usb_enum_snapshot_header_t);
+	size_t skip_depth = NO_DEPTH; // Items this deep or deeper are skipped
+	bool success = true;
+
+	if ((NULL == usb_enum_item_callback) || (NULL == p_snapshot))
+	{
+		return (false);
+	}
+
+	p_name = (PTSTR) malloc((p_snapshot->max_name_length + 1) * sizeof(TCHAR));
+	if (NULL == p_name)
+	{
+		return (false);
+	}
+
+	for (;;)
+	{
+		usb_enum_snapshot_record_t record;
+		uint8_t const *p_payload;
+		usb_enum_info_t info;
+		pusb_hub_info_t p_hub = NULL;
+		pusb_device_info_t p_device_info = NULL;
+		size_t index;
+
+		memcpy(&record, &p_snapshot->p_data[offset], sizeof(record));
+		if (USB_ENUM_SNAPSHOT_END == record.type)
+		{
+			break;
+		}
+
+		p_payload = &p_snapshot->p_data[offset + sizeof(record)];
+		offset += sizeof(record) + record.name_length
+				+ record.descriptors_length;
+
+		// Was the caller not interested in this part of the tree?
+		if (record.depth >= skip_depth)
+		{
+			continue;
+		}
+		skip_depth = NO_DEPTH;
+
+		for (index = 0; index < record.name_length; index++)
+		{
+			p_name[index] = (TCHAR) p_payload[index];
+		}
+		p_name[record.name_length] = _T('\0');
+
+		memset(&info, 0, sizeof(usb_enum_info_t));
+		info.type = (usb_device_type_t) record.type;
+		info.depth = record.depth;
+
+		switch (info.type)
+		{
+		case USB_HOST_CONTROLLER:
+			info.u.host_controller.h_host_controller = INVALID_HANDLE_VALUE;
+			info.u.host_controller.p_driver_key = p_name;
+			break;
+		case USB_ROOT_HUB:
+			p_hub = &info.u.root_hub;
+			break;
+		case USB_EXTERNAL_HUB:
+			p_hub = &info.u.external_hub.hub;
+			p_device_info = &info.u.external_hub.device_info;
+			break;
+		default:
+			p_device_info = &info.u.device;
+			break;
+		}
+
+		if (NULL != p_hub)
+		{
+			p_hub->p_hub_name = p_name;
+			p_hub->h_hub = INVALID_HANDLE_VALUE;
+			p_hub->node_info.NodeType = UsbHub;
+			p_hub->node_info.u.HubInformation.HubDescriptor.bNumberOfPorts =
+					record.num_ports;
+		}
+
+		if (NULL != p_device_info)
+		{
+			PUSB_NODE_CONNECTION_INFORMATION p_connection =
+					&p_device_info->connection_info;
+
+			p_device_info->h_hub = INVALID_HANDLE_VALUE;
+			p_connection->ConnectionIndex = record.connection_index;
+			p_connection->ConnectionStatus =
+					(USB_CONNECTION_STATUS) record.connection_status;
+			p_connection->DeviceIsHub = record.is_hub;
+			p_connection->LowSpeed = record.is_low_speed;
+			p_connection->DeviceAddress = record.device_address;
+			memcpy(&p_connection->DeviceDescriptor, record.device_descriptor,
+					sizeof(record.device_descriptor));
+
+			// Everything was recorded, there is nothing left to request
+			p_device_info->device_descriptor = p_connection->DeviceDescriptor;
+			p_device_info->is_device_descriptor_valid =
+					(sizeof(USB_DEVICE_DESCRIPTOR)
+							== p_device_info->device_descriptor.bLength);
+			p_device_info->is_device_descriptor_read = true;
+			p_device_info->are_configuration_descriptors_read = true;
+
+			if (!build_configurations(&p_payload[record.name_length],
+					record.descriptors_length, p_device_info))
+			{
+				usb_enum_free_configuration_descriptors(p_device_info);
+				success = false;
+				break;
+			}
+		}
+
+		// A hub's callback declines its ports, a port's the remaining ports
+		if (!usb_enum_item_callback(&info, p_enum_item_callback_arg))
+		{
+			skip_depth = (USB_DEVICE == info.type) ?
+					record.depth : (size_t) record.depth + 1;
+		}
+
+		usb_enum_free_configuration_descriptors(p_device_info);
+	}
+
+	free(p_name);
+
+	return (success);
+}
+
+void usb_enum_snapshot_destroy(HANDLE h_snapshot)
+{
+	psnapshot_t p_snapshot = (psnapshot_t) h_snapshot;
+
+	if (NULL == p_snapshot)
+	{
+		return;
+	}
+
+	free(p_snapshot->p_data);
+	free(p_snapshot);
+}
@@ -0,0 +1,222 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_snapshot.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_ENUM_SNAPSHOT_H_
+#define USB_ENUM_SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_enum_snapshot
+
+ \brief These APIs record an enumeration, topology and raw descriptors, to a
+ snapshot file and enumerate it again later without touching the hardware.
+ */
+/* ************************************************************************* */
+
+/*
+
+ A snapshot file starts with a usb_enum_snapshot_header_t followed by one
+ record per enumerated item, in enumeration order, and a last record of type
+ USB_ENUM_SNAPSHOT_END. A record is a usb_enum_snapshot_record_t followed by
+ name_length bytes of name (driver key or hub name, not terminated) and
+ descriptors_length bytes of descriptor blocks.
+
+ A descriptor block is a usb_enum_snapshot_block_t immediately followed by
+ the raw descriptor, whose own length (wTotalLength of a configuration
+ descriptor, bLength of a string descriptor) gives its size. The blocks of a
+ configuration's strings follow the configuration's block.
+
+ All integers are stored little-endian.
+
+ The JSON view holds one object per enumerated item and line instead, with
+ the descriptors as hexadecimal strings. It cannot be loaded back.
+
+ */
+
+#define USB_ENUM_SNAPSHOT_MAGIC		"USBSNAP"
+#define USB_ENUM_SNAPSHOT_VERSION	(1)
+
+// Type of the record closing a snapshot
+#define USB_ENUM_SNAPSHOT_END		(0xff)
+
+typedef enum _usb_enum_snapshot_format_t
+{
+	USB_ENUM_SNAPSHOT_FORMAT_BINARY, // A snapshot file
+	USB_ENUM_SNAPSHOT_FORMAT_JSON // JSON Lines
+
+} usb_enum_snapshot_format_t;
+
+__PACKED__
+
+typedef struct _usb_enum_snapshot_header_t
+{
+	char magic[8]; // USB_ENUM_SNAPSHOT_MAGIC padded with zeros
+	uint16_t version; // USB_ENUM_SNAPSHOT_VERSION
+	uint16_t reserved;
+	uint32_t reserved2;
+
+} usb_enum_snapshot_header_t, *pusb_enum_snapshot_header_t;
+
+typedef struct _usb_enum_snapshot_record_t
+{
+	uint8_t type; // usb_device_type_t or USB_ENUM_SNAPSHOT_END
+	uint8_t num_ports; // Ports of a (root) hub
+	uint16_t depth; // See usb_enum_info_t
+
+	// Connection of a device or external hub to its port
+	uint32_t connection_index;
+	uint32_t connection_status; // USB_CONNECTION_STATUS
+	uint8_t is_hub;
+	uint8_t is_low_speed;
+	uint16_t device_address;
+	uint8_t device_descriptor[18]; // Zeros if unknown
+
+	uint16_t name_length;
+	uint32_t descriptors_length;
+
+} usb_enum_snapshot_record_t, *pusb_enum_snapshot_record_t;
+
+typedef struct _usb_enum_snapshot_block_t
+{
+	uint8_t descriptor_type; // USB_CONFIGURATION_DESCRIPTOR_TYPE or
+							 // USB_STRING_DESCRIPTOR_TYPE
+	uint8_t index; // Configuration or string index
+	uint16_t language_id; // Language of a string
+
+} usb_enum_snapshot_block_t, *pusb_enum_snapshot_block_t;
+
+__UNPACKED__
+
+COMPILE_TIME_ASSERT(sizeof(usb_enum_snapshot_header_t) == 16,
+		usb_enum_snapshot_header_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(usb_enum_snapshot_record_t) == 40,
+		usb_enum_snapshot_record_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(usb_enum_snapshot_block_t) == 4,
+		usb_enum_snapshot_block_t_is_wrong_size);
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_snapshot
+
+ \brief Enumerates through a provider and records everything it enumerates,
+ with all descriptors of connected devices, in a single buffered pass.
+
+ \param[in] p_path - The file to write.
+ \param[in] format - Snapshot file or JSON view.
+ \param[in] provider - The provider to enumerate.
+ \param[in] h_provider - The provider's own context.
+
+ \return Indicates if the enumeration was recorded.
+
+ */
+/* ************************************************************************** */
+
+bool usb_enum_snapshot_save(char const * p_path,
+		usb_enum_snapshot_format_t format, USB_ENUM_PROVIDER provider,
+		HANDLE h_provider);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_snapshot
+
+ \brief Loads a snapshot file.
+
+ \param[in] p_path - The snapshot file.
+
+ \return A handle to the snapshot or NULL on failure (reported on stderr).
+
+ */
+/* ************************************************************************** */
+
+HANDLE usb_enum_snapshot_load(char const * p_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_snapshot
+
+ \brief Enumerates a snapshot, calling back its items like usb_enumerate().
+
+ \param[in] usb_enum_item_callback - The callback called for each entry.
+ \param[in] p_enum_item_callback_arg - The user provided callback argument.
+ \param[in] h_snapshot - A handle to the snapshot.
+
+ \return Indicates if enumeration was successful.
+
+ This is a USB_ENUM_PROVIDER. The descriptors recorded are handed out through
+ usb_enum_get_device_descriptor() and usb_enum_get_configuration_descriptors()
+ as usual.
+
+ */
+/* ************************************************************************** */
+
+bool usb_enum_snapshot_run(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_snapshot);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_snapshot
+
+ \brief Destroys a snapshot.
+
+ \param[in] h_snapshot - A handle to the snapshot.
+
+ */
+/* ************************************************************************** */
+
+void usb_enum_snapshot_destroy(HANDLE h_snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_ENUM_SNAPSHOT_H_ */
@@ -0,0 +1,507 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_synthetic.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+// Windows includes
+#include <windows.h>
+#include <tchar.h>
+
+// WDK includes
+#include <usbioctl.h>
+#include <usb100.h>
+
+// Other includes
+#include "usb_enum.h"
+
+// Module include
+#include "usb_enum_synthetic.h"
+
+// Longest line a topology file may hold
+#define LINE_LENGTH					(256)
+
+// Number of items a topology first makes room for
+#define TOPOLOGY_INITIAL_CAPACITY	(256)
+
+// Marks a port with nothing connected
+#define NO_NODE						(SIZE_MAX)
+
+// Class of hub devices
+#define USB_HUB_CLASS				(0x09)
+
+typedef struct _synthetic_node_t
+{
+	usb_device_type_t type; // USB_HOST_CONTROLLER, USB_EXTERNAL_HUB or
+							// USB_DEVICE
+
+	uint8_t port; // Port of the parent this item is connected to
+	uint16_t vid;
+	uint16_t pid;
+
+	uint8_t num_ports; // Ports of the (root) hub
+	size_t *p_ports; // Item connected to each port (NO_NODE if none)
+
+} synthetic_node_t, *psynthetic_node_t;
+
+typedef struct _synthetic_topology_t
+{
+	psynthetic_node_t p_nodes;
+	size_t node_count;
+	size_t capacity;
+
+} synthetic_topology_t, *psynthetic_topology_t;
+
+// Local declarations
+static psynthetic_node_t new_node(psynthetic_topology_t p_topology,
+		usb_device_type_t type, unsigned int num_ports);
+
+static char const * parse_line(psynthetic_topology_t p_topology,
+		char const * p_line, size_t parent);
+
+static void fill_device_info(psynthetic_topology_t p_topology,
+		size_t node_index, HANDLE h_hub, pusb_device_info_t p_device_info);
+
+static bool enumerate_hub(psynthetic_topology_t p_topology, size_t node_index,
+		size_t depth, USB_ENUM_ITEM_CALLBACK enum_item_callback,
+		void * p_enum_item_arg);
+
+// Implementation
+
+static psynthetic_node_t new_node(psynthetic_topology_t p_topology,
+		usb_device_type_t type, unsigned int num_ports)
+{
+	psynthetic_node_t p_node;
+
+	if (p_topology->node_count == p_topology->capacity)
+	{
+		size_t capacity =
+				(0 == p_topology->capacity) ?
+						TOPOLOGY_INITIAL_CAPACITY : 2 * p_topology->capacity;
+		psynthetic_node_t p_nodes;
+
+		p_nodes = (psynthetic_node_t) realloc(p_topology->p_nodes,
+				capacity * sizeof(synthetic_node_t));
+		if (NULL == p_nodes)
+		{
+			return (NULL);
+		}
+
+		p_topology->p_nodes = p_nodes;
+		p_topology->capacity = capacity;
+	}
+
+	p_node = &p_topology->p_nodes[p_topology->node_count];
+	memset(p_node, 0, sizeof(*p_node));
+	p_node->type = type;
+	p_node->num_ports = (uint8_t) num_ports;
+
+	if (0 != num_ports)
+	{
+		unsigned int port;
+
+		p_node->p_ports = (size_t *) malloc(num_ports * sizeof(size_t));
+		if (NULL == p_node->p_ports)
+		{
+			return (NULL);
+		}
+
+		for (port = 0; port < num_ports; port++)
+		{
+			p_node->p_ports[port] = NO_NODE;
+		}
+	}
+
+	p_topology->node_count++;
+
+	return (p_node);
+}
+
+// Returns NULL on success, otherwise why the line was rejected
+static char const * parse_line(psynthetic_topology_t p_topology,
+		char const * p_line, size_t parent)
+{
+	psynthetic_node_t p_parent =
+			(NO_NODE == parent) ? NULL : &p_topology->p_nodes[parent];
+	psynthetic_node_t p_node;
+	unsigned int port = 0, num_ports = 0, vid = 0, pid = 0;
+	int fields;
+
+	if (1 == sscanf(p_line, "controller %u", &num_ports))
+	{
+		if (NULL != p_parent)
+		{
+			return ("A controller cannot be connected to a port");
+		}
+
+		if ((0 == num_ports) || (num_ports > UINT8_MAX))
+		{
+			return ("A root hub has 1 to 255 ports");
+		}
+
+		if (NULL == new_node(p_topology, USB_HOST_CONTROLLER, num_ports))
+		{
+			return ("Out of memory");
+		}
+
+		return (NULL);
+	}
+
+	fields = sscanf(p_line, "hub %u %u %x %x", &port, &num_ports, &vid, &pid);
+	if (fields >= 2)
+	{
+		if ((0 == num_ports) || (num_ports > UINT8_MAX))
+		{
+			return ("A hub has 1 to 255 ports");
+		}
+	}
+	else if (3 == sscanf(p_line, "device %u %x %x", &port, &vid, &pid))
+	{
+		num_ports = 0;
+	}
+	else
+	{
+		return ("Unknown item");
+	}
+
+	if ((NULL == p_parent) || (USB_DEVICE == p_parent->type))
+	{
+		return ("Hubs and devices need a controller or hub above them");
+	}
+
+	if ((0 == port) || (port > p_parent->num_ports)
+			|| (NO_NODE != p_parent->p_ports[port - 1]))
+	{
+		return ("Not a free port of the item above");
+	}
+
+	if ((vid > UINT16_MAX) || (pid > UINT16_MAX))
+	{
+		return ("VID and PID are 16 bit");
+	}
+
+	// May move the nodes, p_parent is not used beyond this point
+	p_node = new_node(p_topology,
+			(0 == num_ports) ? USB_DEVICE : USB_EXTERNAL_HUB, num_ports);
+	if (NULL == p_node)
+	{
+		return ("Out of memory");
+	}
+
+	p_node->port = (uint8_t) port;
+	p_node->vid = (uint16_t) vid;
+	p_node->pid = (uint16_t) pid;
+
+	p_topology->p_nodes[parent].p_ports[port - 1] = p_topology->node_count - 1;
+
+	return (NULL);
+}
+
+static void fill_device_info(psynthetic_topology_t p_topology,
+		size_t node_index, HANDLE h_hub, pusb_device_info_t p_device_info)
+{
+	psynthetic_node_t p_node = &p_topology->p_nodes[node_index];
+	PUSB_DEVICE_DESCRIPTOR p_descriptor =
+			&p_device_info->connection_info.DeviceDescriptor;
+
+	p_device_info->h_hub = h_hub;
+	p_device_info->connection_info.ConnectionIndex = p_node->port;
+	p_device_info->connection_info.ConnectionStatus = DeviceConnected;
+	p_device_info->connection_info.DeviceIsHub =
+			(USB_EXTERNAL_HUB == p_node->type);
+
+	// What USBHUB would have read from the device when it was attached
+	p_descriptor->bLength = sizeof(USB_DEVICE_DESCRIPTOR);
+	p_descriptor->bDescriptorType = USB_DEVICE_DESCRIPTOR_TYPE;
+	p_descriptor->bcdUSB = 0x0200;
+	p_descriptor->bDeviceClass =
+			(USB_EXTERNAL_HUB == p_node->type) ? USB_HUB_CLASS : 0;
+	p_descriptor->bMaxPacketSize0 = 64;
+	p_descriptor->idVendor = p_node->vid;
+	p_descriptor->idProduct = p_node->pid;
+
+	// There are no configurations to request
+	p_device_info->are_configuration_descriptors_read = true;
+
+	return;
+}
+
+static bool enumerate_hub(psynthetic_topology_t p_topology, size_t node_index,
+		size_t depth, USB_ENUM_ITEM_CALLBACK enum_item_callback,
+		void * p_enum_item_arg)
+{
+	TCHAR hub_name[32];
+	usb_enum_info_t info;
+	pusb_hub_info_t p_hub;
+	unsigned int num_ports = p_topology->p_nodes[node_index].num_ports;
+	unsigned int port;
+
+	// initialize structure
+	memset(&info, 0, sizeof(usb_enum_info_t));
+	info.depth = depth;
+
+	if (USB_HOST_CONTROLLER == p_topology->p_nodes[node_index].type)
+	{
+		info.type = USB_ROOT_HUB;
+		p_hub = &info.u.root_hub;
+	}
+	else
+	{
+		info.type = USB_EXTERNAL_HUB;
+		p_hub = &info.u.external_hub.hub;
+
+		fill_device_info(p_topology, node_index, INVALID_HANDLE_VALUE,
+				&info.u.external_hub.device_info);
+	}
+
+	_sntprintf(hub_name, sizeof(hub_name) / sizeof(hub_name[0]),
+			_T("SYNTHETIC#HUB#%lu"), (unsigned long) node_index);
+	hub_name[sizeof(hub_name) / sizeof(hub_name[0]) - 1] = _T('\0');
+
+	p_hub->p_hub_name = hub_name;
+	p_hub->h_hub = INVALID_HANDLE_VALUE;
+	p_hub->node_info.NodeType = UsbHub;
+	p_hub->node_info.u.HubInformation.HubDescriptor.bNumberOfPorts =
+			(UCHAR) num_ports;
+
+	// Is the caller interested in the ports?
+	if (!enum_item_callback(&info, p_enum_item_arg))
+	{
+		return (true);
+	}
+
+	for (port = 1; port <= num_ports; port++)
+	{
+		size_t child = p_topology->p_nodes[node_index].p_ports[port - 1];
+		usb_enum_info_t port_info;
+
+		memset(&port_info, 0, sizeof(usb_enum_info_t));
+		port_info.type = USB_DEVICE;
+		port_info.depth = depth + 1;
+
+		if (NO_NODE == child)
+		{
+			port_info.u.device.h_hub = INVALID_HANDLE_VALUE;
+			port_info.u.device.connection_info.ConnectionIndex = port;
+			port_info.u.device.connection_info.ConnectionStatus =
+					NoDeviceConnected;
+		}
+		else
+		{
+			fill_device_info(p_topology, child, INVALID_HANDLE_VALUE,
+					&port_info.u.device);
+		}
+
+		// Is the caller done?
+		if (!enum_item_callback(&port_info, p_enum_item_arg))
+		{
+			break;
+		}
+
+		if ((NO_NODE != child)
+				&& (USB_EXTERNAL_HUB == p_topology->p_nodes[child].type))
+		{
+			enumerate_hub(p_topology, child, depth + 2, enum_item_callback,
+					p_enum_item_arg);
+		}
+	}
+
+	return (true);
+}
+
+HANDLE usb_enum_synthetic_load(char const * p_path)
+{
+	psynthetic_topology_t p_topology;
+	FILE *p_file;
+	char line[LINE_LENGTH];
+	size_t stack_indent[USB_ENUM_SYNTHETIC_MAX_DEPTH];
+	size_t stack_node[USB_ENUM_SYNTHETIC_MAX_DEPTH];
+	size_t stack_size = 0;
+	unsigned long line_number = 0;
+	bool success = true;
+
+	if (NULL == p_path)
+	{
+		return (NULL);
+	}
+
+	p_file = fopen(p_path, "r");
+	if (NULL == p_file)
+	{
+		fprintf(stderr, "Cannot open topology '%s'\n", p_path);
+		return (NULL);
+	}
+
+	p_topology = (psynthetic_topology_t) calloc(1,
+			sizeof(synthetic_topology_t));
+	if (NULL == p_topology)
+	{
+		fclose(p_file);
+		return (NULL);
+	}
+
+	while (success && (NULL != fgets(line, sizeof(line), p_file)))
+	{
+		size_t indent = 0;
+		char const *p_error;
+
+		line_number++;
+
+		while ((' ' == line[indent]) || ('\t' == line[indent]))
+		{
+			indent++;
+		}
+
+		if (('\0' == line[indent]) || ('#' == line[indent])
+				|| isspace((unsigned char) line[indent]))
+		{
+			continue;
+		}
+
+		// Leave the items this one is not nested in
+		while ((stack_size > 0) && (stack_indent[stack_size - 1] >= indent))
+		{
+			stack_size--;
+		}
+
+		if (stack_size == USB_ENUM_SYNTHETIC_MAX_DEPTH)
+		{
+			fprintf(stderr, "%s:%lu: Nested deeper than %u items\n", p_path,
+					line_number, USB_ENUM_SYNTHETIC_MAX_DEPTH);
+			success = false;
+			break;
+		}
+
+		p_error = parse_line(p_topology, &line[indent],
+				(0 == stack_size) ? NO_NODE : stack_node[stack_size - 1]);
+		if (NULL != p_error)
+		{
+			fprintf(stderr, "%s:%lu: %s\n", p_path, line_number, p_error);
+			success = false;
+			break;
+		}
+
+		stack_indent[stack_size] = indent;
+		stack_node[stack_size] = p_topology->node_count - 1;
+		stack_size++;
+	}
+
+	fclose(p_file);
+
+	if (!success)
+	{
+		usb_enum_synthetic_destroy((HANDLE) p_topology);
+		return (NULL);
+	}
+
+	return ((HANDLE) p_topology);
+}
+
+bool usb_enum_synthetic_run(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_topology)
+{
+	psynthetic_topology_t p_topology = (psynthetic_topology_t) h_topology;
+	size_t node_index;
+	size_t controller_number = 0;
+
+	if ((NULL == usb_enum_item_callback) || (NULL == p_topology))
+	{
+		return (false);
+	}
+
+	for (node_index = 0; node_index < p_topology->node_count; node_index++)
+	{
+		TCHAR driver_key[32];
+		usb_enum_info_t enum_info;
+
+		if (USB_HOST_CONTROLLER != p_topology->p_nodes[node_index].type)
+		{
+			continue;
+		}
+
+		memset(&enum_info, 0, sizeof(usb_enum_info_t));
+		enum_info.type = USB_HOST_CONTROLLER;
+
+		_sntprintf(driver_key, sizeof(driver_key) / sizeof(driver_key[0]),
+				_T("SYNTHETIC#HC#%lu"), (unsigned long) controller_number++);
+		driver_key[sizeof(driver_key) / sizeof(driver_key[0]) - 1] = _T('\0');
+
+		enum_info.u.host_controller.h_host_controller = INVALID_HANDLE_VALUE;
+		enum_info.u.host_controller.p_driver_key = driver_key;
+
+		if (usb_enum_item_callback(&enum_info, p_enum_item_callback_arg))
+		{
+			enumerate_hub(p_topology, node_index, 1, usb_enum_item_callback,
+					p_enum_item_callback_arg);
+		}
+	}
+
+	return (true);
+}
+
+void usb_enum_synthetic_destroy(HANDLE h_topology)
+{
+	psynthetic_topology_t p_topology = (psynthetic_topology_t) h_topology;
+	size_t node_index;
+
+	if (NULL == p_topology)
+	{
+		return;
+	}
+
+	for (node_index = 0; node_index < p_topology->node_count; node_index++)
+	{
+		free(p_topology->p_nodes[node_index].p_ports);
+	}
+
+	free(p_topology->p_nodes);
+	free(p_topology);
+}
@@ -0,0 +1,143 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_synthetic.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_ENUM_SYNTHETIC_H_
+#define USB_ENUM_SYNTHETIC_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_enum_synthetic
+
+ \brief These APIs enumerate a USB topology described in a file rather than
+ the system's, so enumeration and its callers can be exercised at any scale
+ without the hardware.
+ */
+/* ************************************************************************* */
+
+/*
+
+ A topology file holds one item per line, nested by indentation. An item
+ belongs to the nearest item above it that is indented less (spaces and tabs
+ count alike). Blank lines and lines starting with '#' are ignored.
+
+ controller <ports>                A host controller with its root hub
+ hub <port> <ports> [<vid> <pid>]  An external hub on a port of its parent
+ device <port> <vid> <pid>         A device on a port of its parent
+
+ Ports are numbered from 1, VIDs and PIDs are hexadecimal. For example:
+
+ controller 4
+   hub 1 7
+     device 3 046d c077
+   device 2 1234 5678
+
+ Synthetic devices carry a device descriptor but no configurations.
+
+ */
+
+// Deepest nesting of items a topology file may use
+#define USB_ENUM_SYNTHETIC_MAX_DEPTH	(64)
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_synthetic
+
+ \brief Loads a topology file.
+
+ \param[in] p_path - The path of the topology file.
+
+ \return A handle to the topology or NULL on failure (reported on stderr).
+
+ */
+/* ************************************************************************** */
+
+HANDLE usb_enum_synthetic_load(char const * p_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_synthetic
+
+ \brief Enumerates a topology, calling back its items like usb_enumerate().
+
+ \param[in] usb_enum_item_callback - The callback called for each entry.
+ \param[in] p_enum_item_callback_arg - The user provided callback argument.
+ \param[in] h_topology - A handle to the topology.
+
+ \return Indicates if enumeration was successful.
+
+ This is a USB_ENUM_PROVIDER.
+
+ */
+/* ************************************************************************** */
+
+bool usb_enum_synthetic_run(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_topology);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_synthetic
+
+ \brief Destroys a topology.
+
+ \param[in] h_topology - A handle to the topology.
+
+ */
+/* ************************************************************************** */
+
+void usb_enum_synthetic_destroy(HANDLE h_topology);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_ENUM_SYNTHETIC_H_ */
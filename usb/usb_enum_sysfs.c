@@ -0,0 +1,600 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_sysfs.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dirent.h>
+
+// Windows includes
+#include <windows.h>
+#include <tchar.h>
+
+// WDK includes
+#include <usbioctl.h>
+#include <usb100.h>
+
+// Other includes
+#include "usb_enum.h"
+
+// Module include
+#include "usb_enum_sysfs.h"
+
+// Longest path of an attribute file
+#define PATH_LENGTH					(512)
+
+// Longest device directory name ("<busnum>-" and 7 tiers of ports)
+#define NAME_LENGTH					(32)
+
+// Longest attribute text read
+#define ATTRIBUTE_LENGTH			(64)
+
+// Most bytes of descriptors read from a device
+#define DESCRIPTORS_MAX_LENGTH		(64 * 1024)
+
+// Number of buses first made room for
+#define BUSES_INITIAL_CAPACITY		(16)
+
+// Class of hub devices
+#define USB_HUB_CLASS				(0x09)
+
+typedef struct _sysfs_tree_t
+{
+	char *p_root_path;
+
+} sysfs_tree_t, *psysfs_tree_t;
+
+// Local declarations
+static bool read_attribute(psysfs_tree_t p_tree, char const * p_name,
+		char const * p_attribute, char * p_text, size_t text_size);
+
+static bool read_number(psysfs_tree_t p_tree, char const * p_name,
+		char const * p_attribute, int base, unsigned long * p_value);
+
+static uint8_t * read_descriptors(psysfs_tree_t p_tree, char const * p_name,
+		size_t * p_length);
+
+static bool build_configurations(uint8_t const * p_data, size_t length,
+		pusb_device_info_t p_device_info);
+
+static bool fill_device_info(psysfs_tree_t p_tree, char const * p_name,
+		unsigned int port, pusb_device_info_t p_device_info);
+
+static void enumerate_hub(psysfs_tree_t p_tree, char const * p_name,
+		unsigned long busnum, unsigned int port, size_t depth,
+		USB_ENUM_ITEM_CALLBACK enum_item_callback, void * p_enum_item_arg);
+
+static int compare_buses(void const * p_a, void const * p_b);
+
+// Implementation
+
+// Reads the first line of an attribute, without its line break
+static bool read_attribute(psysfs_tree_t p_tree, char const * p_name,
+		char const * p_attribute, char * p_text, size_t text_size)
+{
+	char path[PATH_LENGTH];
+	FILE *p_file;
+	bool is_read;
+	int length;
+
+	length = _snprintf(path, sizeof(path), "%s/%s/%s", p_tree->p_root_path,
+			p_name, p_attribute);
+	if ((length < 0) || ((size_t) length >= sizeof(path)))
+	{
+		return (false);
+	}
+
+	p_file = fopen(path, "r");
+	if (NULL == p_file)
+	{
+		return (false);
+	}
+
+	is_read = (NULL != fgets(p_text, (int) text_size, p_file));
+	fclose(p_file);
+
+	if (is_read)
+	{
+		p_text[strcspn(p_text, "\r\n")] = '\0';
+	}
+
+	return (is_read);
+}
+
+static bool read_number(psysfs_tree_t p_tree, char const * p_name,
+		char const * p_attribute, int base, unsigned long * p_value)
+{
+	char text[ATTRIBUTE_LENGTH];
+	char *p_end;
+
+	if (!read_attribute(p_tree, p_name, p_attribute, text, sizeof(text)))
+	{
+		return (false);
+	}
+
+	*p_value = strtoul(text, &p_end, base);
+
+	return ((p_end != text) && ('\0' == *p_end));
+}
+
+static uint8_t * read_descriptors(psysfs_tree_t p_tree, char const * p_name,
+		size_t * p_length)
+{
+	char path[PATH_LENGTH];
+	FILE *p_file;
+	uint8_t *p_data;
+	int length;
+
+	*p_length = 0;
+
+	length = _snprintf(path, sizeof(path), "%s/%s/descriptors",
+			p_tree->p_root_path, p_name);
+	if ((length < 0) || ((size_t) length >= sizeof(path)))
+	{
+		return (NULL);
+	}
+
+	p_file = fopen(path, "rb");
+	if (NULL == p_file)
+	{
+		return (NULL);
+	}
+
+	// The file reports no size of its own, so read it whole
+	p_data = (uint8_t *) malloc(DESCRIPTORS_MAX_LENGTH);
+	if (NULL != p_data)
+	{
+		*p_length = fread(p_data, 1, DESCRIPTORS_MAX_LENGTH, p_file);
+	}
+
+	fclose(p_file);
+
+	return (p_data);
+}
+
+// Builds the configuration list usb_enum would have requested
+static bool build_configurations(uint8_t const * p_data, size_t length,
+		pusb_device_info_t p_device_info)
+{
+	pusb_configuration_descriptor_entry_t *p_config_tail =
+			&p_device_info->p_configuration_descriptors;
+	uint8_t configuration_index = 0;
+	size_t offset = 0;
+
+	while ((length - offset) >= sizeof(USB_CONFIGURATION_DESCRIPTOR))
+	{
+		pusb_configuration_descriptor_entry_t p_config;
+		uint16_t total_length;
+
+		memcpy(&total_length,
+				&p_data[offset]
+						+ offsetof(USB_CONFIGURATION_DESCRIPTOR, wTotalLength),
+				sizeof(total_length));
+
+		// Whatever follows a malformed configuration cannot be trusted
+		if ((USB_CONFIGURATION_DESCRIPTOR_TYPE != p_data[offset + 1])
+				|| (total_length < sizeof(USB_CONFIGURATION_DESCRIPTOR))
+				|| (total_length > (length - offset)))
+		{
+			break;
+		}
+
+		p_config = (pusb_configuration_descriptor_entry_t) malloc(
+				sizeof(usb_configuration_descriptor_entry_t) + total_length);
+		if (NULL == p_config)
+		{
+			return (false);
+		}
+
+		p_config->p_next = NULL;
+		p_config->p_string_descriptors = NULL;
+		p_config->configuration_index = configuration_index++;
+		memcpy(p_config->configuration_descriptor, &p_data[offset],
+				total_length);
+
+		*p_config_tail = p_config;
+		p_config_tail = &p_config->p_next;
+
+		offset += total_length;
+	}
+
+	return (true);
+}
+
+// Returns false if no device is connected to the port
+static bool fill_device_info(psysfs_tree_t p_tree, char const * p_name,
+		unsigned int port, pusb_device_info_t p_device_info)
+{
+	PUSB_NODE_CONNECTION_INFORMATION p_connection =
+			&p_device_info->connection_info;
+	PUSB_DEVICE_DESCRIPTOR p_descriptor = &p_connection->DeviceDescriptor;
+	char speed[ATTRIBUTE_LENGTH];
+	unsigned long value;
+	uint8_t *p_data;
+	size_t length;
+
+	memset(p_device_info, 0, sizeof(usb_device_info_t));
+	p_device_info->h_hub = INVALID_HANDLE_VALUE;
+	p_connection->ConnectionIndex = port;
+	p_connection->ConnectionStatus = NoDeviceConnected;
+
+	// Every device has an address, a port without one is empty
+	if ((NULL == p_name) || !read_number(p_tree, p_name, "devnum", 10, &value))
+	{
+		return (false);
+	}
+
+	p_connection->ConnectionStatus = DeviceConnected;
+	p_connection->DeviceAddress = (USHORT) value;
+
+	if (read_number(p_tree, p_name, "bConfigurationValue", 10, &value))
+	{
+		p_connection->CurrentConfigurationValue = (UCHAR) value;
+	}
+
+	if (read_attribute(p_tree, p_name, "speed", speed, sizeof(speed)))
+	{
+		p_connection->LowSpeed = (0 == strcmp(speed, "1.5"));
+	}
+
+	p_data = read_descriptors(p_tree, p_name, &length);
+	if ((NULL != p_data) && (length >= sizeof(USB_DEVICE_DESCRIPTOR))
+			&& (sizeof(USB_DEVICE_DESCRIPTOR) == p_data[0])
+			&& (USB_DEVICE_DESCRIPTOR_TYPE == p_data[1]))
+	{
+		memcpy(p_descriptor, p_data, sizeof(USB_DEVICE_DESCRIPTOR));
+
+		if (!build_configurations(&p_data[sizeof(USB_DEVICE_DESCRIPTOR)],
+				length - sizeof(USB_DEVICE_DESCRIPTOR), p_device_info))
+		{
+			usb_enum_free_configuration_descriptors(p_device_info);
+		}
+	}
+	else if (read_number(p_tree, p_name, "idVendor", 16, &value))
+	{
+		// Without descriptors, the IDs and class are still attributes
+		p_descriptor->bLength = sizeof(USB_DEVICE_DESCRIPTOR);
+		p_descriptor->bDescriptorType = USB_DEVICE_DESCRIPTOR_TYPE;
+		p_descriptor->idVendor = (USHORT) value;
+
+		if (read_number(p_tree, p_name, "idProduct", 16, &value))
+		{
+			p_descriptor->idProduct = (USHORT) value;
+		}
+
+		if (read_number(p_tree, p_name, "bDeviceClass", 16, &value))
+		{
+			p_descriptor->bDeviceClass = (UCHAR) value;
+		}
+	}
+
+	free(p_data);
+
+	p_connection->DeviceIsHub = (USB_HUB_CLASS == p_descriptor->bDeviceClass);
+
+	// Everything there is was read, there is nothing left to request
+	p_device_info->device_descriptor = *p_descriptor;
+	p_device_info->is_device_descriptor_valid =
+			(sizeof(USB_DEVICE_DESCRIPTOR) == p_descriptor->bLength);
+	p_device_info->is_device_descriptor_read = true;
+	p_device_info->are_configuration_descriptors_read = true;
+
+	return (true);
+}
+
+// A root hub is on no port (0) of its own
+static void enumerate_hub(psysfs_tree_t p_tree, char const * p_name,
+		unsigned long busnum, unsigned int port, size_t depth,
+		USB_ENUM_ITEM_CALLBACK enum_item_callback, void * p_enum_item_arg)
+{
+	TCHAR hub_name[NAME_LENGTH];
+	usb_enum_info_t info;
+	pusb_hub_info_t p_hub;
+	unsigned long num_ports = 0;
+	unsigned int child_port;
+	bool is_root = (0 == port);
+	bool is_continue;
+	size_t index;
+
+	// initialize structure
+	memset(&info, 0, sizeof(usb_enum_info_t));
+	info.depth = depth;
+
+	if (is_root)
+	{
+		info.type = USB_ROOT_HUB;
+		p_hub = &info.u.root_hub;
+	}
+	else
+	{
+		info.type = USB_EXTERNAL_HUB;
+		p_hub = &info.u.external_hub.hub;
+
+		fill_device_info(p_tree, p_name, port,
+				&info.u.external_hub.device_info);
+	}
+
+	for (index = 0; ('\0' != p_name[index]) && (index < (NAME_LENGTH - 1));
+			index++)
+	{
+		hub_name[index] = (TCHAR) p_name[index];
+	}
+	hub_name[index] = _T('\0');
+
+	if (!read_number(p_tree, p_name, "maxchild", 10, &num_ports)
+			|| (num_ports > UINT8_MAX))
+	{
+		num_ports = 0;
+	}
+
+	p_hub->p_hub_name = hub_name;
+	p_hub->h_hub = INVALID_HANDLE_VALUE;
+	p_hub->node_info.NodeType = UsbHub;
+	p_hub->node_info.u.HubInformation.HubDescriptor.bNumberOfPorts =
+			(UCHAR) num_ports;
+
+	// Is the caller interested in the ports?
+	is_continue = enum_item_callback(&info, p_enum_item_arg);
+
+	if (!is_root)
+	{
+		usb_enum_free_configuration_descriptors(
+				&info.u.external_hub.device_info);
+	}
+
+	if (!is_continue)
+	{
+		return;
+	}
+
+	for (child_port = 1; child_port <= num_ports; child_port++)
+	{
+		char child[NAME_LENGTH];
+		usb_enum_info_t port_info;
+		bool is_hub;
+		int length;
+
+		// A root hub's ports start the devpath, a hub's ports extend it
+		if (is_root)
+		{
+			length = _snprintf(child, sizeof(child), "%lu-%u", busnum,
+					child_port);
+		}
+		else
+		{
+			length = _snprintf(child, sizeof(child), "%s.%u", p_name,
+					child_port);
+		}
+
+		memset(&port_info, 0, sizeof(usb_enum_info_t));
+		port_info.type = USB_DEVICE;
+		port_info.depth = depth + 1;
+
+		// Deeper than USB allows, so nothing can be connected
+		is_hub = fill_device_info(p_tree,
+				((length > 0) && ((size_t) length < sizeof(child))) ?
+						child : NULL, child_port, &port_info.u.device)
+				&& port_info.u.device.connection_info.DeviceIsHub;
+
+		// Is the caller done?
+		is_continue = enum_item_callback(&port_info, p_enum_item_arg);
+
+		usb_enum_free_configuration_descriptors(&port_info.u.device);
+
+		if (!is_continue)
+		{
+			break;
+		}
+
+		if (is_hub)
+		{
+			enumerate_hub(p_tree, child, busnum, child_port, depth + 2,
+					enum_item_callback, p_enum_item_arg);
+		}
+	}
+
+	return;
+}
+
+static int compare_buses(void const * p_a, void const * p_b)
+{
+	unsigned long a = *((unsigned long const *) p_a);
+	unsigned long b = *((unsigned long const *) p_b);
+
+	return ((a < b) ? -1 : ((a > b) ? 1 : 0));
+}
+
+HANDLE usb_enum_sysfs_create(char const * p_root_path)
+{
+	psysfs_tree_t p_tree;
+	DIR *p_dir;
+
+	if (NULL == p_root_path)
+	{
+		p_root_path = USB_ENUM_SYSFS_ROOT;
+	}
+
+	p_dir = opendir(p_root_path);
+	if (NULL == p_dir)
+	{
+		fprintf(stderr, "Cannot open sysfs tree '%s'\n", p_root_path);
+		return (NULL);
+	}
+	closedir(p_dir);
+
+	p_tree = (psysfs_tree_t) calloc(1, sizeof(sysfs_tree_t));
+	if (NULL == p_tree)
+	{
+		return (NULL);
+	}
+
+	p_tree->p_root_path = (char *) malloc(strlen(p_root_path) + 1);
+	if (NULL == p_tree->p_root_path)
+	{
+		free(p_tree);
+		return (NULL);
+	}
+
+	strcpy(p_tree->p_root_path, p_root_path);
+
+	return ((HANDLE) p_tree);
+}
+
+bool usb_enum_sysfs_run(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_sysfs)
+{
+	psysfs_tree_t p_tree = (psysfs_tree_t) h_sysfs;
+	unsigned long *p_buses = NULL;
+	size_t bus_count = 0;
+	size_t capacity = 0;
+	struct dirent *p_entry;
+	DIR *p_dir;
+	size_t index;
+
+	if ((NULL == usb_enum_item_callback) || (NULL == p_tree))
+	{
+		return (false);
+	}
+
+	p_dir = opendir(p_tree->p_root_path);
+	if (NULL == p_dir)
+	{
+		fprintf(stderr, "Cannot open sysfs tree '%s'\n", p_tree->p_root_path);
+		return (false);
+	}
+
+	// Root hubs name their bus, directory order is arbitrary
+	while (NULL != (p_entry = readdir(p_dir)))
+	{
+		unsigned long busnum;
+		char *p_end;
+
+		if (0 != strncmp(p_entry->d_name, "usb", 3))
+		{
+			continue;
+		}
+
+		busnum = strtoul(&p_entry->d_name[3], &p_end, 10);
+		if ((p_end == &p_entry->d_name[3]) || ('\0' != *p_end))
+		{
+			continue;
+		}
+
+		if (bus_count == capacity)
+		{
+			unsigned long *p_grown;
+
+			capacity = (0 == capacity) ?
+					BUSES_INITIAL_CAPACITY : 2 * capacity;
+			p_grown = (unsigned long *) realloc(p_buses,
+					capacity * sizeof(unsigned long));
+			if (NULL == p_grown)
+			{
+				closedir(p_dir);
+				free(p_buses);
+				return (false);
+			}
+
+			p_buses = p_grown;
+		}
+
+		p_buses[bus_count++] = busnum;
+	}
+
+	closedir(p_dir);
+
+	if (bus_count > 0)
+	{
+		qsort(p_buses, bus_count, sizeof(unsigned long), compare_buses);
+	}
+
+	for (index = 0; index < bus_count; index++)
+	{
+		char name[NAME_LENGTH];
+		TCHAR driver_key[NAME_LENGTH];
+		usb_enum_info_t enum_info;
+
+		_snprintf(name, sizeof(name), "usb%lu", p_buses[index]);
+		name[sizeof(name) - 1] = '\0';
+
+		memset(&enum_info, 0, sizeof(usb_enum_info_t));
+		enum_info.type = USB_HOST_CONTROLLER;
+
+		_sntprintf(driver_key, sizeof(driver_key) / sizeof(driver_key[0]),
+				_T("SYSFS#HC#%lu"), p_buses[index]);
+		driver_key[sizeof(driver_key) / sizeof(driver_key[0]) - 1] = _T('\0');
+
+		enum_info.u.host_controller.h_host_controller = INVALID_HANDLE_VALUE;
+		enum_info.u.host_controller.p_driver_key = driver_key;
+
+		if (usb_enum_item_callback(&enum_info, p_enum_item_callback_arg))
+		{
+			enumerate_hub(p_tree, name, p_buses[index], 0, 1,
+					usb_enum_item_callback, p_enum_item_callback_arg);
+		}
+	}
+
+	free(p_buses);
+
+	return (true);
+}
+
+void usb_enum_sysfs_destroy(HANDLE h_sysfs)
+{
+	psysfs_tree_t p_tree = (psysfs_tree_t) h_sysfs;
+
+	if (NULL == p_tree)
+	{
+		return;
+	}
+
+	free(p_tree->p_root_path);
+	free(p_tree);
+}
@@ -0,0 +1,146 @@
+/*
+ ==============================================================================
+ Name        : usb_enum_sysfs.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_ENUM_SYSFS_H_
+#define USB_ENUM_SYSFS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_enum_sysfs
+
+ \brief These APIs enumerate the USB topology Linux describes in sysfs, with
+ no request sent to any device.
+ */
+/* ************************************************************************* */
+
+/*
+
+ The tree is read as Linux lays out /sys/bus/usb/devices: a directory per
+ root hub named "usb<busnum>" and a directory per device named
+ "<busnum>-<devpath>", where the devpath lists the ports from the root hub
+ down, separated by '.' (e.g. "1-2.3" is on port 3 of the hub on port 2 of
+ bus 1's root hub). Other entries, such as interfaces ("1-2:1.0"), are
+ ignored.
+
+ Each directory holds attributes as text files. Hubs give their number of
+ ports in "maxchild", devices their address in "devnum" and their speed in
+ "speed". The binary "descriptors" file holds the device descriptor followed
+ by the configuration descriptors the kernel read when the device was
+ attached; these are handed out through usb_enum_get_device_descriptor()
+ and usb_enum_get_configuration_descriptors(). String descriptors are not
+ available there, so none are handed out.
+
+ The tree is read again on every run, so a run reflects the devices present
+ at that time. A copy of the tree (or a fake one) may be enumerated anywhere,
+ which is how this provider is tested (see tools/sysfs_check.py).
+
+ */
+
+// Where Linux lays out its USB devices
+#define USB_ENUM_SYSFS_ROOT		"/sys/bus/usb/devices"
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_sysfs
+
+ \brief Prepares the enumeration of a sysfs tree.
+
+ \param[in] p_root_path - The directory holding the tree (NULL for
+ USB_ENUM_SYSFS_ROOT).
+
+ \return A handle to the tree or NULL on failure (reported on stderr).
+
+ */
+/* ************************************************************************** */
+
+HANDLE usb_enum_sysfs_create(char const * p_root_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_sysfs
+
+ \brief Enumerates a sysfs tree, calling back its items like usb_enumerate().
+
+ \param[in] usb_enum_item_callback - The callback called for each entry.
+ \param[in] p_enum_item_callback_arg - The user provided callback argument.
+ \param[in] h_sysfs - A handle to the tree.
+
+ \return Indicates if enumeration was successful.
+
+ Buses are called back as host controllers in ascending bus number order.
+ This is a USB_ENUM_PROVIDER.
+
+ */
+/* ************************************************************************** */
+
+bool usb_enum_sysfs_run(USB_ENUM_ITEM_CALLBACK usb_enum_item_callback,
+		void *p_enum_item_callback_arg, HANDLE h_sysfs);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_enum_sysfs
+
+ \brief Releases a tree prepared by usb_enum_sysfs_create().
+
+ \param[in] h_sysfs - A handle to the tree.
+
+ */
+/* ************************************************************************** */
+
+void usb_enum_sysfs_destroy(HANDLE h_sysfs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_ENUM_SYSFS_H_ */
@@ -75,9 +75,12 @@
 // Other includes
 #include "utils.h"
 #include "usb_defs.h"
+#include "usb_hid_strings.h"
 
 // Module include
 #include "usb_hid.h"
+#include "usb_hid_plan.h"
+#include "usb_hid_snapshot.h"
 
 // Local declarations
 static bool open_hid(char * const p_device_path, bool has_read_access,
@@ -86,6 +89,11 @@ static bool open_hid(char * const p_device_path, bool has_read_access,
 
 static bool fill_hid_info(phid_device_t p_hid_device);
 
+static bool fill_hid_report_ids(phid_report_t p_report);
+
+static bool filter_matches(phid_filter_t const p_filter,
+		phid_device_t p_hid_device);
+
 // Implementation
 static bool open_hid(char * const p_device_path, bool has_read_access,
 		bool has_write_access, bool is_exclusive, bool is_overlapped,
@@ -116,6 +124,14 @@ static bool open_hid(char * const p_device_path, bool has_read_access,
 		sharing_flags = FILE_SHARE_READ | FILE_SHARE_WRITE;
 	}
 
+	// Kept so the HID's strings may be looked up by it
+	p_hid_device->p_device_path = (char *) malloc(strlen(p_device_path) + 1);
+	if (NULL == p_hid_device->p_device_path)
+	{
+		return (false);
+	}
+	strcpy(p_hid_device->p_device_path, p_device_path);
+
 	/*
 
 	 The hid.dll api's do not pass the overlapped structure into
@@ -488,6 +504,148 @@ static bool fill_hid_info(phid_device_t p_hid_device)
 				data_index++;
 			}
 		}
+
+		// Now index the data by report ID
+		if (!fill_hid_report_ids(p_report))
+		{
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
+static bool fill_hid_report_ids(phid_report_t p_report)
+{
+	size_t counts[UINT8_MAX + 1];
+	size_t index;
+	size_t id_index;
+	phid_data_t p_data;
+
+	p_report->p_report_ids = NULL;
+	p_report->number_report_ids = 0;
+
+	/*
+
+	 Count how many data elements belong to each report ID. The report ID
+	 is a single byte so a small table covers every possible value.
+
+	 */
+
+	memset(counts, 0, sizeof(counts));
+
+	p_data = p_report->p_hid_data;
+	for (index = 0; index < p_report->hid_data_length; index++, p_data++)
+	{
+		if (0 == counts[p_data->report_id]++)
+		{
+			p_report->number_report_ids++;
+		}
+	}
+
+	if (0 == p_report->number_report_ids)
+	{
+		return (true);
+	}
+
+	p_report->p_report_ids = (phid_report_id_t) calloc(
+			p_report->number_report_ids, sizeof(hid_report_id_t));
+	if (NULL == p_report->p_report_ids)
+	{
+		p_report->number_report_ids = 0;
+		return (false);
+	}
+
+	// Allocate one entry per report ID (in ascending report ID order)
+	id_index = 0;
+	for (index = 0; index <= UINT8_MAX; index++)
+	{
+		phid_report_id_t p_id;
+
+		if (0 == counts[index])
+		{
+			continue;
+		}
+
+		p_id = &p_report->p_report_ids[id_index++];
+		p_id->report_id = (uint8_t) index;
+		p_id->h_event = NULL;
+		p_id->is_pending = false;
+
+		p_id->pp_hid_data = (phid_data_t *) calloc(counts[index],
+				sizeof(phid_data_t));
+		if (NULL == p_id->pp_hid_data)
+		{
+			return (false);
+		}
+
+		if (p_report->report_buffer_length > 0)
+		{
+			p_id->p_report_buffer = (PCHAR) calloc(
+					p_report->report_buffer_length, sizeof(char));
+			if (NULL == p_id->p_report_buffer)
+			{
+				return (false);
+			}
+
+			// The report ID always occupies the first byte
+			p_id->p_report_buffer[0] = p_id->report_id;
+		}
+
+		// Remember where this report ID lives so the data can be filled in
+		counts[index] = id_index;
+	}
+
+	// Now fill in the data elements of each report ID
+	p_data = p_report->p_hid_data;
+	for (index = 0; index < p_report->hid_data_length; index++, p_data++)
+	{
+		phid_report_id_t p_id =
+				&p_report->p_report_ids[counts[p_data->report_id] - 1];
+
+		p_id->pp_hid_data[p_id->hid_data_length++] = p_data;
+	}
+
+	return (true);
+}
+
+static bool filter_matches(phid_filter_t const p_filter,
+		phid_device_t p_hid_device)
+{
+	if ((0 != p_filter->vid)
+			&& (p_filter->vid != p_hid_device->attributes.VendorID))
+	{
+		return (false);
+	}
+
+	if ((0 != p_filter->pid)
+			&& (p_filter->pid != p_hid_device->attributes.ProductID))
+	{
+		return (false);
+	}
+
+	if ((0 != p_filter->usage_page)
+			&& (p_filter->usage_page != p_hid_device->caps.UsagePage))
+	{
+		return (false);
+	}
+
+	if ((0 != p_filter->usage) && (p_filter->usage != p_hid_device->caps.Usage))
+	{
+		return (false);
+	}
+
+	// Last, as the serial number may have to be requested from the HID
+	if (NULL != p_filter->p_serial_number)
+	{
+		char serial_number[HID_STRINGS_TEXT_SIZE];
+
+		if (!hid_strings_get(p_hid_device->p_device_path,
+				HID_STRING_SERIAL_NUMBER, serial_number, sizeof(serial_number))
+				|| (0 != strcmp(p_filter->p_serial_number, serial_number)))
+		{
+			return (false);
+		}
 	}
 
 	return (true);
@@ -495,12 +653,30 @@ static bool fill_hid_info(phid_device_t p_hid_device)
 
 bool usb_get_hid_device_path(usb_vid_t vid, usb_pid_t pid,
 		char ** pp_device_path)
+{
+	hid_filter_t filter;
+
+	memset(&filter, 0, sizeof(filter));
+	filter.vid = vid;
+	filter.pid = pid;
+
+	return (usb_find_hid_device_path(&filter, pp_device_path));
+}
+
+bool usb_find_hid_device_path(phid_filter_t const p_filter,
+		char ** pp_device_path)
 {
 	GUID guid;
 	HDEVINFO device_info_set;
 	size_t member_index;
+	size_t instance;
 	bool found = false;
 
+	if (NULL == p_filter)
+	{
+		return (false);
+	}
+
 	// Obtain the HID-device interface GUID
 	HidD_GetHidGuid(&guid);
 
@@ -525,8 +701,9 @@ bool usb_get_hid_device_path(usb_vid_t vid, usb_pid_t pid,
 		return (false);
 	}
 
-	// Initialize index
+	// Initialize indexes
 	member_index = 0;
+	instance = 0;
 
 	do
 	{
@@ -610,8 +787,8 @@ bool usb_get_hid_device_path(usb_vid_t vid, usb_pid_t pid,
 		}
 
 		// Now determine what to do. Is this the HID we are looking for?
-		if ((pid == hid_device.attributes.ProductID)
-				&& (vid == hid_device.attributes.VendorID))
+		if (filter_matches(p_filter, &hid_device)
+				&& (p_filter->instance == instance++))
 		{
 			// This is what we are looking for.
 
@@ -659,6 +836,12 @@ bool usb_get_hid_device_path(usb_vid_t vid, usb_pid_t pid,
 
 bool usb_open_hid(char * const p_device_path, uint8_t options,
 		phid_device_t p_hid_device)
+{
+	return (usb_open_hid_cached(p_device_path, options, p_hid_device, NULL));
+}
+
+bool usb_open_hid_cached(char * const p_device_path, uint8_t options,
+		phid_device_t p_hid_device, HANDLE h_plan_cache)
 {
 	bool result = false;
 	bool open_for_read = false;
@@ -690,6 +873,13 @@ bool usb_open_hid(char * const p_device_path, uint8_t options,
 		// Open the device
 		result = open_hid(p_device_path, open_for_read, open_for_write,
 				open_exclusive, open_overlapped, p_hid_device);
+
+		// Learn the report layouts once so reports may be packed directly
+		if (result)
+		{
+			hid_plan_compile_device_cached(p_hid_device, h_plan_cache);
+			p_hid_device->h_snapshot = hid_snapshot_create(p_hid_device);
+		}
 	}
 
 	return (result);
@@ -716,6 +906,12 @@ void usb_close_hid(phid_device_t p_hid_device)
 		p_hid_device->p_ppd = NULL;
 	}
 
+	if (NULL != p_hid_device->h_snapshot)
+	{
+		hid_snapshot_destroy(p_hid_device->h_snapshot);
+		p_hid_device->h_snapshot = NULL;
+	}
+
 	for (report_index = HID_REPORT_TYPE_FIRST;
 			report_index < HID_REPORT_TYPE_SIZE; report_index++)
 	{
@@ -744,8 +940,33 @@ void usb_close_hid(phid_device_t p_hid_device)
 			free(report->p_value_caps);
 			report->p_value_caps = NULL;
 		}
+
+		if (NULL != report->p_report_ids)
+		{
+			size_t index;
+
+			for (index = 0; index < report->number_report_ids; index++)
+			{
+				phid_report_id_t p_id = &report->p_report_ids[index];
+
+				free(p_id->pp_hid_data);
+				free(p_id->p_report_buffer);
+				hid_plan_free(p_id->p_plan);
+
+				if (NULL != p_id->h_event)
+				{
+					CloseHandle(p_id->h_event);
+				}
+			}
+
+			free(report->p_report_ids);
+			report->p_report_ids = NULL;
+			report->number_report_ids = 0;
+		}
 	}
 
+	free(p_hid_device->p_device_path);
+
 	// Re-Initialize
 	memset(p_hid_device, 0, sizeof(*p_hid_device));
 
@@ -158,11 +158,42 @@ typedef enum _hid_report_type_t
 // For the above enumeration to work, the following must be true
 COMPILE_TIME_ASSERT(HID_REPORT_TYPE_SIZE == 3, hid_report_type_t_is_wrong_size);
 
+/*
+
+ A report type may carry several report IDs. Each report ID gets its own
+ entry which indexes the hid_data_t elements belonging to it and owns a
+ dedicated report buffer, so reports with different IDs may be transferred
+ and decoded independently of one another.
+
+ */
+
+typedef struct _hid_report_id_t
+{
+	uint8_t report_id; // The report ID this entry describes
+
+	phid_data_t *pp_hid_data; // hid data elements carrying this report ID
+	size_t hid_data_length; // Number elements in this array.
+
+	char *p_report_buffer; // Report buffer dedicated to this report ID
+
+	// Overlapped transfer state
+	OVERLAPPED overlap;
+	HANDLE h_event; // Completion event (created on first use)
+	bool is_pending; // A transfer is outstanding on this entry
+
+	// Compiled plan of this report ID's layout (NULL if none)
+	struct _hid_plan_t *p_plan;
+
+} hid_report_id_t, *phid_report_id_t;
+
 typedef struct _hid_report_t
 {
 	char *p_report_buffer;
 	size_t report_buffer_length;
 
+	// When p_report_buffer was last received (usec since Jan 1, 1970 UTC)
+	uint64_t timestamp_us;
+
 	phid_data_t p_hid_data; // array of hid data structures
 	size_t hid_data_length; // Number elements in this array.
 
@@ -172,6 +203,12 @@ typedef struct _hid_report_t
 	PHIDP_VALUE_CAPS p_value_caps;
 	size_t number_value_caps;
 
+	phid_report_id_t p_report_ids; // array of report ID entries
+	size_t number_report_ids; // Number elements in this array.
+
+	// Overlapped transfer state of p_report_buffer
+	OVERLAPPED overlap;
+
 } hid_report_t, *phid_report_t;
 
 typedef struct _hid_device_t
@@ -185,10 +222,30 @@ typedef struct _hid_device_t
 	// Hid Report Type Details
 	hid_report_t report[HID_REPORT_TYPE_SIZE];
 
+	// Latest input report of every report ID (NULL if none)
+	HANDLE h_snapshot;
+
+	char *p_device_path; // The interface path the HID was opened with
+
 } hid_device_t, *phid_device_t;
 
 typedef uint8_t usb_open_options_t;
 
+// Selects HIDs by their attributes, top level collection and serial number
+// (0 matches any)
+typedef struct _hid_filter_t
+{
+	usb_vid_t vid;
+	usb_pid_t pid;
+	USAGE usage_page;
+	USAGE usage;
+
+	char const *p_serial_number; // Serial number string (NULL matches any)
+
+	size_t instance; // Which of several matching HIDs (0 for the first)
+
+} hid_filter_t, *phid_filter_t;
+
 // APIs
 
 /* ************************************************************************** */
@@ -211,6 +268,25 @@ typedef uint8_t usb_open_options_t;
 bool usb_get_hid_device_path(usb_vid_t vid, usb_pid_t pid,
 		char ** pp_device_path);
 
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid
+
+ \brief Retrieves the null terminated character string containing the path of
+ the HID selected by the provided filter.
+
+ \param[in] p_filter - The attributes and usage the HID must match.
+ \param[in,out] pp_device_path - The pointer to the device path (must be freed).
+
+ \return Indicates if the location and retrieval of the path was
+ successful.
+
+ */
+/* ************************************************************************** */
+
+bool usb_find_hid_device_path(phid_filter_t const p_filter,
+		char ** pp_device_path);
+
 /* ************************************************************************** */
 /*!
  \ingroup usb_hid
@@ -229,6 +305,26 @@ bool usb_get_hid_device_path(usb_vid_t vid, usb_pid_t pid,
 bool usb_open_hid(char * const pp_device_path, uint8_t options,
 		phid_device_t p_hid_device);
 
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid
+
+ \brief Opens the HID identified by the provided device path and options,
+ taking its report plans from a plan cache when it holds them.
+
+ \param[in] pp_device_path - The device path of the HID.
+ \param[in] options - A bitmask containing the desired access options.
+ \param[in,out] p_hid_device - A pointer to a hid_device_t struct to populate.
+ \param[in] h_plan_cache - A handle to the plan cache (NULL for none).
+
+ \return Indicates if the HID was opened successfully.
+
+ */
+/* ************************************************************************** */
+
+bool usb_open_hid_cached(char * const pp_device_path, uint8_t options,
+		phid_device_t p_hid_device, HANDLE h_plan_cache);
+
 /* ************************************************************************** */
 /*!
  \ingroup usb_hid
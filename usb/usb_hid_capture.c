@@ -0,0 +1,950 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_capture.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "buffered_writer.h"
+#include "xor_rle.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_hid_plan.h"
+
+// Module include
+#include "usb_hid_capture.h"
+
+// Bytes of capture the reader maps at a time (a 32 bit process cannot map
+// a multi-GB capture at once)
+#define VIEW_SIZE				(64 * 1024 * 1024)
+
+typedef struct _hid_capture_writer_t
+{
+	FILE *p_file;
+	buffered_writer_t writer;
+	uint64_t offset; // Bytes written to the capture so far
+
+	// The segment being gathered
+	uint8_t *p_segment; // Raw records (HID_CAPTURE_SEGMENT_SIZE bytes)
+	size_t segment_length;
+	hid_capture_segment_t segment;
+
+	uint8_t *p_encoded; // Compressed segment (HID_CAPTURE_SEGMENT_SIZE bytes)
+
+	phid_capture_index_t p_index; // The segment index
+	size_t segment_count;
+	size_t index_capacity;
+
+} hid_capture_writer_t, *phid_capture_writer_t;
+
+typedef struct _hid_capture_reader_t
+{
+	HANDLE h_file;
+	HANDLE h_mapping;
+	uint64_t file_length;
+	DWORD granularity; // Alignment of view offsets
+
+	// The currently mapped view of the capture
+	uint8_t const *p_view;
+	uint64_t view_offset;
+	size_t view_length;
+
+	hid_capture_header_t header;
+	phid_capture_field_t p_fields; // array of header.field_count fields
+
+	phid_capture_index_t p_index; // The segment index
+	size_t segment_count;
+	size_t next_segment; // The segment to load once this one is consumed
+
+	// The current segment's records, within the view or p_decoded
+	uint8_t const *p_segment;
+	size_t segment_length;
+	size_t position; // Offset of the next record within p_segment
+	uint32_t record_count; // Number of records in the segment
+
+	// Decompressed segment
+	uint8_t *p_decoded;
+	size_t decoded_capacity;
+
+} hid_capture_reader_t, *phid_capture_reader_t;
+
+// Local declarations
+static void write_bytes(phid_capture_writer_t p_context, void const * p_data,
+		size_t length);
+
+static bool flush_segment(phid_capture_writer_t p_context);
+
+static bool append_index(phid_capture_index_t * pp_index, size_t * p_count,
+		size_t * p_capacity, phid_capture_segment_t const p_segment,
+		uint64_t offset);
+
+static uint8_t const * map_range(phid_capture_reader_t p_context,
+		uint64_t offset, size_t length);
+
+static bool load_index(phid_capture_reader_t p_context);
+
+static bool load_segment(phid_capture_reader_t p_context, size_t segment);
+
+static bool grow_buffer(uint8_t ** pp_buffer, size_t * p_capacity,
+		size_t length);
+
+// Implementation
+
+size_t hid_capture_fill_fields(phid_report_t const p_report,
+		phid_capture_field_t p_fields)
+{
+	size_t field_count = 0;
+	size_t id_index;
+
+	/*
+
+	 Only the fields a plan describes as bit fields can be decoded offline,
+	 library fields (e.g. button arrays) are left out of the field table.
+	 Passing NULL for p_fields merely counts the fields.
+
+	 */
+
+	for (id_index = 0; id_index < p_report->number_report_ids; id_index++)
+	{
+		phid_plan_t p_plan = p_report->p_report_ids[id_index].p_plan;
+		size_t index;
+
+		if (NULL == p_plan)
+		{
+			continue;
+		}
+
+		for (index = 0; index < p_plan->field_count; index++)
+		{
+			phid_plan_field_t p_plan_field = &p_plan->p_fields[index];
+			phid_capture_field_t p_field;
+
+			if (HID_PLAN_FIELD_LIBRARY == p_plan_field->type)
+			{
+				continue;
+			}
+
+			if (NULL != p_fields)
+			{
+				p_field = &p_fields[field_count];
+				memset(p_field, 0, sizeof(*p_field));
+				p_field->report_id = p_plan->report_id;
+				p_field->type = (uint8_t) p_plan_field->type;
+				p_field->bit_offset = p_plan_field->bit_offset;
+				p_field->bit_size = p_plan_field->bit_size;
+				p_field->count = p_plan_field->count;
+				p_field->usage_page = p_plan_field->usage_page;
+				p_field->usage = p_plan_field->usage;
+				p_field->usage_max = p_plan_field->usage_max;
+				p_field->logical_min = p_plan_field->logical_min;
+				p_field->logical_max = p_plan_field->logical_max;
+			}
+
+			field_count++;
+		}
+	}
+
+	return (field_count);
+}
+
+static void write_bytes(phid_capture_writer_t p_context, void const * p_data,
+		size_t length)
+{
+	buffered_writer_write(&p_context->writer, p_data, length);
+	p_context->offset += length;
+}
+
+static bool append_index(phid_capture_index_t * pp_index, size_t * p_count,
+		size_t * p_capacity, phid_capture_segment_t const p_segment,
+		uint64_t offset)
+{
+	phid_capture_index_t p_entry;
+
+	if (*p_count == *p_capacity)
+	{
+		size_t capacity = (0 == *p_capacity) ? 64 : (2 * *p_capacity);
+		phid_capture_index_t p_index = (phid_capture_index_t) realloc(
+				*pp_index, capacity * sizeof(hid_capture_index_t));
+
+		if (NULL == p_index)
+		{
+			return (false);
+		}
+
+		*pp_index = p_index;
+		*p_capacity = capacity;
+	}
+
+	p_entry = &(*pp_index)[(*p_count)++];
+	p_entry->first_timestamp_us = p_segment->first_timestamp_us;
+	p_entry->last_timestamp_us = p_segment->last_timestamp_us;
+	p_entry->offset = offset;
+
+	return (true);
+}
+
+static bool flush_segment(phid_capture_writer_t p_context)
+{
+	phid_capture_segment_t p_segment = &p_context->segment;
+	size_t encoded_length;
+
+	if (0 == p_segment->record_count)
+	{
+		return (true);
+	}
+
+	if (!append_index(&p_context->p_index, &p_context->segment_count,
+			&p_context->index_capacity, p_segment, p_context->offset))
+	{
+		return (false);
+	}
+
+	// Compression must gain something, otherwise the records are stored as is
+	encoded_length = xor_rle_encode(p_context->p_segment,
+			p_context->segment_length, p_segment->stride,
+			p_context->p_encoded, p_context->segment_length - 1);
+
+	memcpy(p_segment->magic, HID_CAPTURE_SEGMENT_MAGIC,
+			sizeof(p_segment->magic));
+	p_segment->raw_length = (uint32_t) p_context->segment_length;
+
+	if (0 != encoded_length)
+	{
+		p_segment->codec = HID_CAPTURE_CODEC_XOR_RLE;
+		p_segment->stored_length = (uint32_t) encoded_length;
+		write_bytes(p_context, p_segment, sizeof(*p_segment));
+		write_bytes(p_context, p_context->p_encoded, encoded_length);
+	}
+	else
+	{
+		p_segment->codec = HID_CAPTURE_CODEC_NONE;
+		p_segment->stored_length = p_segment->raw_length;
+		write_bytes(p_context, p_segment, sizeof(*p_segment));
+		write_bytes(p_context, p_context->p_segment,
+				p_context->segment_length);
+	}
+
+	memset(p_segment, 0, sizeof(*p_segment));
+	p_context->segment_length = 0;
+
+	return (!p_context->writer.is_error);
+}
+
+HANDLE hid_capture_create_writer(char const * p_path,
+		phid_device_t p_hid_device, hid_report_type_t report_type)
+{
+	phid_capture_writer_t p_context;
+	phid_capture_field_t p_fields = NULL;
+	hid_capture_header_t header;
+	phid_report_t p_report;
+	size_t field_count;
+
+	if ((NULL == p_path) || (NULL == p_hid_device)
+			|| (report_type >= HID_REPORT_TYPE_SIZE))
+	{
+		return (NULL);
+	}
+
+	p_report = &p_hid_device->report[report_type];
+
+	field_count = hid_capture_fill_fields(p_report, NULL);
+
+	// The header stores its length and the report length in 16 bits
+	if (((sizeof(header) + (field_count * sizeof(hid_capture_field_t)))
+			> UINT16_MAX) || (p_report->report_buffer_length > UINT16_MAX))
+	{
+		fprintf(stderr, "Cannot capture '%s', its reports are too large\n",
+				p_path);
+		return (NULL);
+	}
+
+	if (field_count > 0)
+	{
+		p_fields = (phid_capture_field_t) calloc(field_count,
+				sizeof(hid_capture_field_t));
+		if (NULL == p_fields)
+		{
+			return (NULL);
+		}
+		hid_capture_fill_fields(p_report, p_fields);
+	}
+
+	p_context = (phid_capture_writer_t) calloc(1,
+			sizeof(hid_capture_writer_t));
+	if (NULL == p_context)
+	{
+		free(p_fields);
+		return (NULL);
+	}
+
+	p_context->p_segment = (uint8_t *) malloc(HID_CAPTURE_SEGMENT_SIZE);
+	p_context->p_encoded = (uint8_t *) malloc(HID_CAPTURE_SEGMENT_SIZE);
+	p_context->p_file = fopen(p_path, "wb");
+	if ((NULL == p_context->p_segment) || (NULL == p_context->p_encoded)
+			|| (NULL == p_context->p_file)
+			|| !buffered_writer_init(&p_context->writer, p_context->p_file,
+					BUFFERED_WRITER_DEFAULT_SIZE))
+	{
+		if (NULL != p_context->p_file)
+		{
+			fclose(p_context->p_file);
+		}
+		free(p_context->p_segment);
+		free(p_context->p_encoded);
+		free(p_context);
+		free(p_fields);
+		return (NULL);
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, HID_CAPTURE_MAGIC, sizeof(HID_CAPTURE_MAGIC) - 1);
+	header.version = HID_CAPTURE_VERSION;
+	header.header_length = (uint16_t) (sizeof(header)
+			+ (field_count * sizeof(hid_capture_field_t)));
+	header.vendor_id = p_hid_device->attributes.VendorID;
+	header.product_id = p_hid_device->attributes.ProductID;
+	header.version_number = p_hid_device->attributes.VersionNumber;
+	header.report_length = (uint16_t) p_report->report_buffer_length;
+	header.field_count = (uint16_t) field_count;
+
+	write_bytes(p_context, &header, sizeof(header));
+	write_bytes(p_context, p_fields,
+			field_count * sizeof(hid_capture_field_t));
+
+	free(p_fields);
+
+	return ((HANDLE) p_context);
+}
+
+bool hid_capture_write(HANDLE h_capture, uint64_t timestamp_us,
+		char const * p_report_buffer, size_t report_buffer_length)
+{
+	phid_capture_writer_t p_context = (phid_capture_writer_t) h_capture;
+	hid_capture_record_header_t record;
+	size_t record_length;
+
+	// The whole record must fit the segment's 16 bit stride
+	if ((NULL == p_context) || (NULL == p_report_buffer)
+			|| (report_buffer_length > (UINT16_MAX - sizeof(record))))
+	{
+		return (false);
+	}
+
+	record_length = sizeof(record) + report_buffer_length;
+
+	// Records never straddle segments
+	if ((p_context->segment_length + record_length) > HID_CAPTURE_SEGMENT_SIZE)
+	{
+		if (!flush_segment(p_context))
+		{
+			return (false);
+		}
+	}
+
+	// The first record sets the stride the codec XORs against
+	if (0 == p_context->segment.record_count)
+	{
+		p_context->segment.first_timestamp_us = timestamp_us;
+		p_context->segment.stride = (uint16_t) record_length;
+	}
+
+	p_context->segment.last_timestamp_us = timestamp_us;
+	p_context->segment.record_count++;
+
+	record.timestamp_us = timestamp_us;
+	record.device_index = 0;
+	record.length = (uint16_t) report_buffer_length;
+
+	memcpy(&p_context->p_segment[p_context->segment_length], &record,
+			sizeof(record));
+	memcpy(&p_context->p_segment[p_context->segment_length + sizeof(record)],
+			p_report_buffer, report_buffer_length);
+	p_context->segment_length += record_length;
+
+	return (!p_context->writer.is_error);
+}
+
+bool hid_capture_destroy_writer(HANDLE h_capture)
+{
+	phid_capture_writer_t p_context = (phid_capture_writer_t) h_capture;
+	hid_capture_trailer_t trailer;
+	bool status;
+
+	if (NULL == p_context)
+	{
+		return (false);
+	}
+
+	status = flush_segment(p_context);
+
+	// The index and trailer make the capture seekable
+	memset(&trailer, 0, sizeof(trailer));
+	trailer.index_offset = p_context->offset;
+	trailer.segment_count = (uint32_t) p_context->segment_count;
+	memcpy(trailer.magic, HID_CAPTURE_TRAILER_MAGIC, sizeof(trailer.magic));
+
+	write_bytes(p_context, p_context->p_index,
+			p_context->segment_count * sizeof(hid_capture_index_t));
+	write_bytes(p_context, &trailer, sizeof(trailer));
+
+	status = buffered_writer_flush(&p_context->writer) && status;
+	buffered_writer_free(&p_context->writer);
+
+	if (0 != fclose(p_context->p_file))
+	{
+		status = false;
+	}
+
+	free(p_context->p_segment);
+	free(p_context->p_encoded);
+	free(p_context->p_index);
+	free(p_context);
+
+	return (status);
+}
+
+static uint8_t const * map_range(phid_capture_reader_t p_context,
+		uint64_t offset, size_t length)
+{
+	uint64_t view_offset;
+	uint64_t view_length;
+
+	if ((offset > p_context->file_length)
+			|| (length > (p_context->file_length - offset)))
+	{
+		return (NULL);
+	}
+
+	// Most reads land within the current view
+	if ((NULL != p_context->p_view) && (offset >= p_context->view_offset)
+			&& ((offset + length)
+					<= (p_context->view_offset + p_context->view_length)))
+	{
+		return (&p_context->p_view[offset - p_context->view_offset]);
+	}
+
+	if (NULL != p_context->p_view)
+	{
+		UnmapViewOfFile(p_context->p_view);
+		p_context->p_view = NULL;
+	}
+
+	// Views start on the allocation granularity and span several segments
+	view_offset = offset - (offset % p_context->granularity);
+	view_length = (offset - view_offset) + length;
+	if (view_length < VIEW_SIZE)
+	{
+		view_length = VIEW_SIZE;
+	}
+	if (view_length > (p_context->file_length - view_offset))
+	{
+		view_length = p_context->file_length - view_offset;
+	}
+	if (view_length > (SIZE_T) -1)
+	{
+		return (NULL);
+	}
+
+	p_context->p_view = (uint8_t const *) MapViewOfFile(p_context->h_mapping,
+			FILE_MAP_READ, (DWORD) (view_offset >> 32), (DWORD) view_offset,
+			(SIZE_T) view_length);
+	if (NULL == p_context->p_view)
+	{
+		return (NULL);
+	}
+
+	p_context->view_offset = view_offset;
+	p_context->view_length = (size_t) view_length;
+
+	return (&p_context->p_view[offset - view_offset]);
+}
+
+static bool load_index(phid_capture_reader_t p_context)
+{
+	hid_capture_trailer_t trailer;
+	hid_capture_segment_t segment;
+	uint8_t const * p_data;
+	size_t capacity = 0;
+	uint64_t offset;
+
+	// A completed capture carries its index in front of the trailer
+	if (p_context->file_length >= (p_context->header.header_length
+			+ sizeof(trailer)))
+	{
+		p_data = map_range(p_context,
+				p_context->file_length - sizeof(trailer), sizeof(trailer));
+		if (NULL == p_data)
+		{
+			return (false);
+		}
+		memcpy(&trailer, p_data, sizeof(trailer));
+
+		if ((0 == memcmp(trailer.magic, HID_CAPTURE_TRAILER_MAGIC,
+				sizeof(trailer.magic)))
+				&& ((trailer.index_offset
+						+ (trailer.segment_count * sizeof(hid_capture_index_t))
+						+ sizeof(trailer)) == p_context->file_length))
+		{
+			p_context->segment_count = trailer.segment_count;
+			if (0 == p_context->segment_count)
+			{
+				return (true);
+			}
+
+			p_context->p_index = (phid_capture_index_t) malloc(
+					p_context->segment_count * sizeof(hid_capture_index_t));
+			p_data = map_range(p_context, trailer.index_offset,
+					p_context->segment_count * sizeof(hid_capture_index_t));
+			if ((NULL == p_context->p_index) || (NULL == p_data))
+			{
+				return (false);
+			}
+
+			memcpy(p_context->p_index, p_data,
+					p_context->segment_count * sizeof(hid_capture_index_t));
+
+			return (true);
+		}
+	}
+
+	// Otherwise rebuild the index by walking the segment headers
+	offset = p_context->header.header_length;
+	while ((NULL != (p_data = map_range(p_context, offset, sizeof(segment))))
+			&& (0 == memcmp(p_data, HID_CAPTURE_SEGMENT_MAGIC,
+					sizeof(segment.magic))))
+	{
+		memcpy(&segment, p_data, sizeof(segment));
+		if ((p_context->file_length - offset - sizeof(segment))
+				< segment.stored_length)
+		{
+			break;
+		}
+
+		if (!append_index(&p_context->p_index, &p_context->segment_count,
+				&capacity, &segment, offset))
+		{
+			return (false);
+		}
+
+		offset += sizeof(segment) + segment.stored_length;
+	}
+
+	return (true);
+}
+
+static bool grow_buffer(uint8_t ** pp_buffer, size_t * p_capacity,
+		size_t length)
+{
+	uint8_t *p_buffer;
+
+	if (length <= *p_capacity)
+	{
+		return (true);
+	}
+
+	p_buffer = (uint8_t *) realloc(*pp_buffer, length);
+	if (NULL == p_buffer)
+	{
+		return (false);
+	}
+
+	*pp_buffer = p_buffer;
+	*p_capacity = length;
+
+	return (true);
+}
+
+static bool load_segment(phid_capture_reader_t p_context, size_t segment)
+{
+	hid_capture_segment_t header;
+	uint8_t const * p_data;
+	uint64_t offset = p_context->p_index[segment].offset;
+
+	p_context->p_segment = NULL;
+	p_context->segment_length = 0;
+	p_context->position = 0;
+	p_context->record_count = 0;
+	p_context->next_segment = segment + 1;
+
+	p_data = map_range(p_context, offset, sizeof(header));
+	if (NULL == p_data)
+	{
+		return (false);
+	}
+
+	memcpy(&header, p_data, sizeof(header));
+	if (0 != memcmp(header.magic, HID_CAPTURE_SEGMENT_MAGIC,
+			sizeof(header.magic)))
+	{
+		return (false);
+	}
+
+	// The header and the records are mapped together
+	p_data = map_range(p_context, offset, sizeof(header)
+			+ header.stored_length);
+	if (NULL == p_data)
+	{
+		return (false);
+	}
+	p_data += sizeof(header);
+
+	switch (header.codec)
+	{
+	case HID_CAPTURE_CODEC_NONE:
+		// Records are handed out straight from the mapping
+		if (header.stored_length != header.raw_length)
+		{
+			return (false);
+		}
+		p_context->p_segment = p_data;
+		break;
+
+	case HID_CAPTURE_CODEC_XOR_RLE:
+		if (!grow_buffer(&p_context->p_decoded, &p_context->decoded_capacity,
+				header.raw_length)
+				|| !xor_rle_decode(p_data, header.stored_length, header.stride,
+						p_context->p_decoded, header.raw_length))
+		{
+			return (false);
+		}
+		p_context->p_segment = p_context->p_decoded;
+		break;
+
+	default:
+		return (false);
+	}
+
+	p_context->segment_length = header.raw_length;
+	p_context->record_count = header.record_count;
+
+	return (true);
+}
+
+HANDLE hid_capture_open_reader(char const * p_path)
+{
+	phid_capture_reader_t p_context;
+	uint8_t const * p_data;
+	LARGE_INTEGER file_length;
+	SYSTEM_INFO system_info;
+	size_t fields_length;
+
+	if (NULL == p_path)
+	{
+		return (NULL);
+	}
+
+	p_context = (phid_capture_reader_t) calloc(1,
+			sizeof(hid_capture_reader_t));
+	if (NULL == p_context)
+	{
+		return (NULL);
+	}
+
+	GetSystemInfo(&system_info);
+	p_context->granularity = system_info.dwAllocationGranularity;
+
+	// Captures are mostly scanned front to back
+	p_context->h_file = CreateFile(p_path, GENERIC_READ, FILE_SHARE_READ,
+			NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if ((INVALID_HANDLE_VALUE == p_context->h_file)
+			|| !GetFileSizeEx(p_context->h_file, &file_length)
+			|| (file_length.QuadPart < (LONGLONG) sizeof(hid_capture_header_t)))
+	{
+		fprintf(stderr, "Cannot open capture '%s'\n", p_path);
+		hid_capture_close_reader((HANDLE) p_context);
+		return (NULL);
+	}
+
+	p_context->file_length = (uint64_t) file_length.QuadPart;
+	p_context->h_mapping = CreateFileMapping(p_context->h_file, NULL,
+			PAGE_READONLY, 0, 0, NULL);
+	if (NULL == p_context->h_mapping)
+	{
+		hid_capture_close_reader((HANDLE) p_context);
+		return (NULL);
+	}
+
+	// Verify this is a capture we understand
+	p_data = map_range(p_context, 0, sizeof(p_context->header));
+	if (NULL != p_data)
+	{
+		memcpy(&p_context->header, p_data, sizeof(p_context->header));
+	}
+
+	if ((NULL == p_data)
+			|| (0 != memcmp(p_context->header.magic, HID_CAPTURE_MAGIC,
+					sizeof(HID_CAPTURE_MAGIC) - 1))
+			|| (HID_CAPTURE_VERSION != p_context->header.version))
+	{
+		fprintf(stderr, "'%s' is not a supported capture file\n", p_path);
+		hid_capture_close_reader((HANDLE) p_context);
+		return (NULL);
+	}
+
+	fields_length = p_context->header.field_count
+			* sizeof(hid_capture_field_t);
+
+	p_context->p_fields = (phid_capture_field_t) malloc(fields_length + 1);
+	p_data = map_range(p_context, sizeof(p_context->header), fields_length);
+	if ((NULL == p_context->p_fields) || (NULL == p_data))
+	{
+		hid_capture_close_reader((HANDLE) p_context);
+		return (NULL);
+	}
+
+	memcpy(p_context->p_fields, p_data, fields_length);
+
+	if (!load_index(p_context))
+	{
+		hid_capture_close_reader((HANDLE) p_context);
+		return (NULL);
+	}
+
+	return ((HANDLE) p_context);
+}
+
+hid_capture_header_t const * hid_capture_get_header(HANDLE h_capture,
+		hid_capture_field_t const ** pp_fields)
+{
+	phid_capture_reader_t p_context = (phid_capture_reader_t) h_capture;
+
+	if (NULL == p_context)
+	{
+		return (NULL);
+	}
+
+	if (NULL != pp_fields)
+	{
+		*pp_fields = p_context->p_fields;
+	}
+
+	return (&p_context->header);
+}
+
+bool hid_capture_read(HANDLE h_capture, phid_capture_record_t p_record)
+{
+	phid_capture_reader_t p_context = (phid_capture_reader_t) h_capture;
+	hid_capture_record_header_t record;
+
+	if ((NULL == p_context) || (NULL == p_record))
+	{
+		return (false);
+	}
+
+	// Move on to the next segment once this one is consumed
+	while (p_context->position >= p_context->segment_length)
+	{
+		if ((p_context->next_segment >= p_context->segment_count)
+				|| !load_segment(p_context, p_context->next_segment))
+		{
+			return (false);
+		}
+	}
+
+	if ((p_context->segment_length - p_context->position) < sizeof(record))
+	{
+		return (false);
+	}
+
+	memcpy(&record, &p_context->p_segment[p_context->position],
+			sizeof(record));
+
+	// A truncated record ends the capture
+	if ((p_context->segment_length - p_context->position - sizeof(record))
+			< record.length)
+	{
+		return (false);
+	}
+
+	p_record->timestamp_us = record.timestamp_us;
+	p_record->device_index = record.device_index;
+	p_record->length = record.length;
+	p_record->p_data = &p_context->p_segment[p_context->position
+			+ sizeof(record)];
+
+	p_context->position += sizeof(record) + record.length;
+
+	return (true);
+}
+
+bool hid_capture_seek(HANDLE h_capture, uint64_t timestamp_us)
+{
+	phid_capture_reader_t p_context = (phid_capture_reader_t) h_capture;
+	size_t low = 0;
+	size_t high;
+	size_t segment;
+
+	if (NULL == p_context)
+	{
+		return (false);
+	}
+
+	// Find the first segment which ends at or after the time sought
+	high = p_context->segment_count;
+	while (low < high)
+	{
+		size_t middle = low + ((high - low) / 2);
+
+		if (p_context->p_index[middle].last_timestamp_us < timestamp_us)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	for (segment = low; segment < p_context->segment_count; segment++)
+	{
+		if (!load_segment(p_context, segment))
+		{
+			return (false);
+		}
+
+		// Skip the segment's records preceding the time sought
+		while ((p_context->segment_length - p_context->position)
+				>= sizeof(hid_capture_record_header_t))
+		{
+			hid_capture_record_header_t record;
+
+			memcpy(&record, &p_context->p_segment[p_context->position],
+					sizeof(record));
+			if (record.timestamp_us >= timestamp_us)
+			{
+				return (true);
+			}
+
+			// A truncated record ends the capture
+			if ((p_context->segment_length - p_context->position
+					- sizeof(record)) < record.length)
+			{
+				segment = p_context->segment_count;
+				break;
+			}
+
+			p_context->position += sizeof(record) + record.length;
+		}
+	}
+
+	// Nothing left to read
+	p_context->segment_length = 0;
+	p_context->position = 0;
+	p_context->next_segment = p_context->segment_count;
+
+	return (false);
+}
+
+size_t hid_capture_get_segment_count(HANDLE h_capture)
+{
+	phid_capture_reader_t p_context = (phid_capture_reader_t) h_capture;
+
+	if (NULL == p_context)
+	{
+		return (0);
+	}
+
+	return (p_context->segment_count);
+}
+
+bool hid_capture_seek_segment(HANDLE h_capture, size_t segment,
+		uint32_t * p_record_count)
+{
+	phid_capture_reader_t p_context = (phid_capture_reader_t) h_capture;
+
+	if ((NULL == p_context) || (segment >= p_context->segment_count)
+			|| !load_segment(p_context, segment))
+	{
+		return (false);
+	}
+
+	if (NULL != p_record_count)
+	{
+		*p_record_count = p_context->record_count;
+	}
+
+	return (true);
+}
+
+void hid_capture_close_reader(HANDLE h_capture)
+{
+	phid_capture_reader_t p_context = (phid_capture_reader_t) h_capture;
+
+	if (NULL == p_context)
+	{
+		return;
+	}
+
+	if (NULL != p_context->p_view)
+	{
+		UnmapViewOfFile(p_context->p_view);
+	}
+
+	if (NULL != p_context->h_mapping)
+	{
+		CloseHandle(p_context->h_mapping);
+	}
+
+	if ((NULL != p_context->h_file)
+			&& (INVALID_HANDLE_VALUE != p_context->h_file))
+	{
+		CloseHandle(p_context->h_file);
+	}
+
+	free(p_context->p_fields);
+	free(p_context->p_index);
+	free(p_context->p_decoded);
+	free(p_context);
+}
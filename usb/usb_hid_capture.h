@@ -0,0 +1,408 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_capture.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_CAPTURE_H_
+#define USB_HID_CAPTURE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_capture
+
+ \brief These APIs record raw HID reports to capture files and read them back
+ for offline analysis.
+ */
+/* ************************************************************************* */
+
+/*
+
+ A capture file starts with a hid_capture_header_t followed by field_count
+ hid_capture_field_t entries describing where each value and button bitmap
+ lives within a report (taken from the compiled plans, see usb_hid_plan), so
+ captures can be decoded without the HID or its pre-parsed data.
+
+ The records follow in segments. Each segment is a hid_capture_segment_t
+ followed by stored_length bytes holding raw_length bytes of records, either
+ as is (HID_CAPTURE_CODEC_NONE) or compressed with the xor_rle codec using
+ the segment's stride (HID_CAPTURE_CODEC_XOR_RLE). A record is a
+ hid_capture_record_header_t immediately followed by length bytes of raw
+ report (report ID in byte 0). Segments hold at most
+ HID_CAPTURE_SEGMENT_SIZE bytes of records and records never straddle
+ segments.
+
+ A completed capture ends with the segment index (segment_count
+ hid_capture_index_t entries) and a hid_capture_trailer_t, so readers can
+ seek to a point in time and decompress only the segments needed. Readers
+ rebuild the index from the segment headers when a capture was cut short.
+
+ All integers are stored little-endian.
+
+ */
+
+#define HID_CAPTURE_MAGIC			"HIDCAP"
+#define HID_CAPTURE_SEGMENT_MAGIC	"HSEG"
+#define HID_CAPTURE_TRAILER_MAGIC	"HIDX"
+#define HID_CAPTURE_VERSION			(2)
+
+// Most bytes of records a segment holds
+#define HID_CAPTURE_SEGMENT_SIZE	(256 * 1024)
+
+typedef enum _hid_capture_codec_t
+{
+	HID_CAPTURE_CODEC_NONE, // Records stored as is
+	HID_CAPTURE_CODEC_XOR_RLE // Records compressed with xor_rle
+
+} hid_capture_codec_t;
+
+__PACKED__
+
+typedef struct _hid_capture_header_t
+{
+	char magic[8]; // HID_CAPTURE_MAGIC padded with zeros
+	uint16_t version; // HID_CAPTURE_VERSION
+	uint16_t header_length; // Bytes of this header and the field table
+
+	uint16_t vendor_id; // Attributes of the captured HID
+	uint16_t product_id;
+	uint16_t version_number;
+
+	uint16_t report_length; // Maximum report length (incl. report ID)
+	uint16_t field_count; // Number of hid_capture_field_t entries
+	uint16_t reserved;
+
+} hid_capture_header_t, *phid_capture_header_t;
+
+typedef struct _hid_capture_field_t
+{
+	uint8_t report_id; // The report ID carrying this field
+	uint8_t type; // HID_PLAN_FIELD_VALUE or HID_PLAN_FIELD_BUTTONS
+
+	uint16_t bit_offset; // Position of the field's first bit in the report
+	uint16_t bit_size; // Number of bits of a value (1 for buttons)
+	uint16_t count; // Number of values (bits for buttons)
+
+	uint16_t usage_page;
+	uint16_t usage; // The value usage (or usage minimum for buttons)
+	uint16_t usage_max; // The usage maximum (buttons only)
+	uint16_t reserved;
+
+	int32_t logical_min;
+	int32_t logical_max;
+
+} hid_capture_field_t, *phid_capture_field_t;
+
+typedef struct _hid_capture_record_header_t
+{
+	uint64_t timestamp_us; // When the report was received (usec since 1970)
+	uint16_t device_index; // The captured HID (always 0 for now)
+	uint16_t length; // Bytes of report following this header
+
+} hid_capture_record_header_t, *phid_capture_record_header_t;
+
+typedef struct _hid_capture_segment_t
+{
+	char magic[4]; // HID_CAPTURE_SEGMENT_MAGIC
+	uint32_t record_count; // Number of records in this segment
+	uint64_t first_timestamp_us; // Timestamp of the first record
+	uint64_t last_timestamp_us; // Timestamp of the last record
+	uint32_t raw_length; // Bytes of records
+	uint32_t stored_length; // Bytes following this header
+	uint16_t stride; // Record size the codec XORs against
+	uint8_t codec; // hid_capture_codec_t
+	uint8_t reserved[5];
+
+} hid_capture_segment_t, *phid_capture_segment_t;
+
+typedef struct _hid_capture_index_t
+{
+	uint64_t first_timestamp_us; // Timestamp of the segment's first record
+	uint64_t last_timestamp_us; // Timestamp of the segment's last record
+	uint64_t offset; // File offset of the segment's hid_capture_segment_t
+
+} hid_capture_index_t, *phid_capture_index_t;
+
+typedef struct _hid_capture_trailer_t
+{
+	uint64_t index_offset; // File offset of the segment index
+	uint32_t segment_count; // Number of hid_capture_index_t entries
+	char magic[4]; // HID_CAPTURE_TRAILER_MAGIC
+
+} hid_capture_trailer_t, *phid_capture_trailer_t;
+
+__UNPACKED__
+
+// For the file format to be stable, the following must be true
+COMPILE_TIME_ASSERT(sizeof(hid_capture_header_t) == 24,
+		hid_capture_header_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_capture_field_t) == 24,
+		hid_capture_field_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_capture_record_header_t) == 12,
+		hid_capture_record_header_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_capture_segment_t) == 40,
+		hid_capture_segment_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_capture_index_t) == 24,
+		hid_capture_index_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_capture_trailer_t) == 16,
+		hid_capture_trailer_t_is_wrong_size);
+
+// A record as returned by hid_capture_read()
+typedef struct _hid_capture_record_t
+{
+	uint64_t timestamp_us;
+	uint16_t device_index;
+	uint16_t length;
+
+	uint8_t const *p_data; // The report (valid until the next read or seek
+	// moves to another segment)
+
+} hid_capture_record_t, *phid_capture_record_t;
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Describes the fields of a report type as a capture field table.
+
+ \param[in] p_report - The report whose compiled plans describe the fields.
+ \param[out] p_fields - Receives the fields (NULL to merely count them).
+
+ \return The number of fields.
+
+ Fields are listed by report ID and within a report ID in plan order. Library
+ fields (e.g. button arrays) cannot be decoded without the HID and are left
+ out, as are report IDs without a plan.
+
+ */
+/* ************************************************************************** */
+
+size_t hid_capture_fill_fields(phid_report_t const p_report,
+		phid_capture_field_t p_fields);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Creates a capture file for the reports of the given type.
+
+ \param[in] p_path - The path of the capture file to create.
+ \param[in] p_hid_device - A pointer to the HID whose reports are captured.
+ \param[in] report_type - The report type (input, output, feature) captured.
+
+ \return A handle to the capture writer or NULL on failure.
+
+ */
+/* ************************************************************************** */
+
+HANDLE hid_capture_create_writer(char const * p_path,
+		phid_device_t p_hid_device, hid_report_type_t report_type);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Appends a report to the capture.
+
+ \param[in] h_capture - A handle to the capture writer.
+ \param[in] timestamp_us - When the report was received (usec since 1970).
+ \param[in] p_report_buffer - The raw report (report ID in byte 0).
+ \param[in] report_buffer_length - Size of the report.
+
+ \return Indicates if the report was written successfully.
+
+ */
+/* ************************************************************************** */
+
+bool hid_capture_write(HANDLE h_capture, uint64_t timestamp_us,
+		char const * p_report_buffer, size_t report_buffer_length);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Completes the capture file and destroys the capture writer.
+
+ \param[in] h_capture - A handle to the capture writer.
+
+ \return Indicates if the capture was completed successfully.
+
+ */
+/* ************************************************************************** */
+
+bool hid_capture_destroy_writer(HANDLE h_capture);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Opens a capture file for reading.
+
+ \param[in] p_path - The path of the capture file.
+
+ \return A handle to the capture reader or NULL on failure.
+
+ The capture is memory mapped rather than read. Records of uncompressed
+ segments are handed out as pointers into the mapping, records of compressed
+ segments point into a buffer each segment is decompressed into once.
+
+ */
+/* ************************************************************************** */
+
+HANDLE hid_capture_open_reader(char const * p_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Retrieves the header of an opened capture.
+
+ \param[in] h_capture - A handle to the capture reader.
+ \param[out] pp_fields - Receives the field table (header->field_count
+ entries).
+
+ \return A pointer to the capture's header.
+
+ */
+/* ************************************************************************** */
+
+hid_capture_header_t const * hid_capture_get_header(HANDLE h_capture,
+		hid_capture_field_t const ** pp_fields);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Reads the next record of the capture.
+
+ \param[in] h_capture - A handle to the capture reader.
+ \param[out] p_record - Receives the record.
+
+ \return Indicates if a record was read (false at the end of the capture).
+
+ */
+/* ************************************************************************** */
+
+bool hid_capture_read(HANDLE h_capture, phid_capture_record_t p_record);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Positions the capture at the first record at or after a given time.
+
+ \param[in] h_capture - A handle to the capture reader.
+ \param[in] timestamp_us - The time to seek to (usec since 1970).
+
+ \return Indicates if there is a record at or after the given time.
+
+ Only the segment holding the record is decompressed. The next call of
+ hid_capture_read() returns the record sought.
+
+ */
+/* ************************************************************************** */
+
+bool hid_capture_seek(HANDLE h_capture, uint64_t timestamp_us);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Retrieves the number of segments of an opened capture.
+
+ \param[in] h_capture - A handle to the capture reader.
+
+ \return The number of segments.
+
+ */
+/* ************************************************************************** */
+
+size_t hid_capture_get_segment_count(HANDLE h_capture);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Positions the capture at the first record of a segment.
+
+ \param[in] h_capture - A handle to the capture reader.
+ \param[in] segment - The index of the segment.
+ \param[out] p_record_count - Receives the number of records in the segment
+ (may be NULL).
+
+ \return Indicates if the segment was loaded.
+
+ Segments are independent of one another, so readers opened on the same
+ capture may each work through a share of its segments.
+
+ */
+/* ************************************************************************** */
+
+bool hid_capture_seek_segment(HANDLE h_capture, size_t segment,
+		uint32_t * p_record_count);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_capture
+
+ \brief Closes a capture reader.
+
+ \param[in] h_capture - A handle to the capture reader.
+
+ */
+/* ************************************************************************** */
+
+void hid_capture_close_reader(HANDLE h_capture);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_CAPTURE_H_ */
@@ -0,0 +1,720 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_columns.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "buffered_writer.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_hid_plan.h"
+#include "usb_hid_capture.h"
+#include "usb_hid_export.h"
+
+// Module include
+#include "usb_hid_columns.h"
+
+// Marks a report ID without columns
+#define NO_GROUP				(SIZE_MAX)
+
+// Open addressing table large enough to keep the dictionary sparse
+#define DICTIONARY_SLOTS		(2 * HID_COLUMNS_MAX_DICTIONARY)
+
+// Bytes a varint of up to 64 bits may occupy
+#define VARINT_MAX_LENGTH		(10)
+
+// Maximum number of buttons held by a single column
+#define BUTTONS_PER_COLUMN		(32)
+
+// Room kept in a column name for telling shared names apart
+#define NAME_SUFFIX_SIZE		(8)
+
+typedef struct _column_t
+{
+	hid_columns_column_t desc; // The column as described in the file
+
+	uint16_t bit_offset; // Where the column's bits live within a report
+	uint16_t bit_size;
+	bool is_signed; // Sign extend the extracted values
+	bool is_shared; // Another column of the report ID has the same name
+
+	int64_t *p_values; // Values of the chunk being gathered
+
+} column_t, *pcolumn_t;
+
+typedef struct _column_group_t
+{
+	uint8_t report_id;
+
+	size_t first_column; // The group's timestamp column
+	size_t column_count; // Number of columns (incl. the timestamp column)
+
+	size_t row_count; // Rows gathered for the current chunk
+	size_t min_length; // Bytes a report needs to hold every column
+
+} column_group_t, *pcolumn_group_t;
+
+typedef struct _columns_context_t
+{
+	FILE *p_file;
+	buffered_writer_t writer;
+	uint64_t offset; // Bytes written to the columns file so far
+
+	pcolumn_t p_columns; // array of columns
+	size_t column_count; // Number elements in this array.
+
+	pcolumn_group_t p_groups; // array of groups, one per report ID
+	size_t group_count; // Number elements in this array.
+	size_t group_index[UINT8_MAX + 1]; // Report ID to group (or NO_GROUP)
+
+	phid_columns_chunk_t p_chunks; // The chunk index
+	size_t chunk_count;
+	size_t chunk_capacity;
+
+	// Encoding scratch space, allocated once
+	uint8_t *p_encode_buffer;
+	uint8_t *p_dictionary_indices; // Dictionary index of each value
+	int64_t dictionary[HID_COLUMNS_MAX_DICTIONARY];
+	int16_t dictionary_slots[DICTIONARY_SLOTS];
+
+} columns_context_t, *pcolumns_context_t;
+
+// Local declarations
+static size_t put_varint(uint8_t * p_buffer, uint64_t value);
+
+static uint64_t zigzag(int64_t value);
+
+static size_t encode_delta(int64_t const * p_values, size_t count,
+		uint8_t * p_buffer);
+
+static size_t encode_dictionary(pcolumns_context_t p_context,
+		int64_t const * p_values, size_t count, uint8_t * p_buffer);
+
+static void write_bytes(pcolumns_context_t p_context, void const * p_data,
+		size_t length);
+
+static bool flush_group(pcolumns_context_t p_context, pcolumn_group_t p_group);
+
+static bool build_columns(pcolumns_context_t p_context,
+		hid_capture_header_t const * p_header,
+		hid_capture_field_t const * p_fields);
+
+static void name_group_columns(pcolumns_context_t p_context,
+		pcolumn_group_t p_group);
+
+static void free_columns(pcolumns_context_t p_context);
+
+// Implementation
+
+static size_t put_varint(uint8_t * p_buffer, uint64_t value)
+{
+	size_t length = 0;
+
+	while (value >= 0x80)
+	{
+		p_buffer[length++] = (uint8_t) (value | 0x80);
+		value >>= 7;
+	}
+	p_buffer[length++] = (uint8_t) value;
+
+	return (length);
+}
+
+static uint64_t zigzag(int64_t value)
+{
+	// Interleave positive and negative values so small magnitudes stay short
+	return (((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+}
+
+static size_t encode_delta(int64_t const * p_values, size_t count,
+		uint8_t * p_buffer)
+{
+	uint64_t previous = 0;
+	size_t length = 0;
+	size_t index;
+
+	for (index = 0; index < count; index++)
+	{
+		// Differences wrap around as unsigned so they can never overflow
+		uint64_t delta = (uint64_t) p_values[index] - previous;
+
+		length += put_varint(&p_buffer[length], zigzag((int64_t) delta));
+		previous = (uint64_t) p_values[index];
+	}
+
+	return (length);
+}
+
+static size_t encode_dictionary(pcolumns_context_t p_context,
+		int64_t const * p_values, size_t count, uint8_t * p_buffer)
+{
+	size_t dictionary_count = 0;
+	size_t length = 0;
+	size_t index;
+
+	memset(p_context->dictionary_slots, 0xFF,
+			sizeof(p_context->dictionary_slots));
+
+	// Look up (or add) every value, giving up on too many distinct values
+	for (index = 0; index < count; index++)
+	{
+		int64_t value = p_values[index];
+		size_t slot = (size_t) ((zigzag(value) * 0x9E3779B97F4A7C15ULL) >> 55)
+				% DICTIONARY_SLOTS;
+
+		while ((p_context->dictionary_slots[slot] >= 0)
+				&& (p_context->dictionary[p_context->dictionary_slots[slot]]
+						!= value))
+		{
+			slot = (slot + 1) % DICTIONARY_SLOTS;
+		}
+
+		if (p_context->dictionary_slots[slot] < 0)
+		{
+			if (HID_COLUMNS_MAX_DICTIONARY == dictionary_count)
+			{
+				return (0);
+			}
+
+			p_context->dictionary[dictionary_count] = value;
+			p_context->dictionary_slots[slot] = (int16_t) dictionary_count;
+			dictionary_count++;
+		}
+
+		p_context->p_dictionary_indices[index] =
+				(uint8_t) p_context->dictionary_slots[slot];
+	}
+
+	length += put_varint(&p_buffer[length], dictionary_count);
+	for (index = 0; index < dictionary_count; index++)
+	{
+		length += put_varint(&p_buffer[length],
+				zigzag(p_context->dictionary[index]));
+	}
+
+	// Slowly changing values collapse into a few runs
+	index = 0;
+	while (index < count)
+	{
+		uint8_t dictionary_index = p_context->p_dictionary_indices[index];
+		size_t run_length = 1;
+
+		while (((index + run_length) < count)
+				&& (dictionary_index
+						== p_context->p_dictionary_indices[index + run_length]))
+		{
+			run_length++;
+		}
+
+		length += put_varint(&p_buffer[length], dictionary_index);
+		length += put_varint(&p_buffer[length], run_length);
+		index += run_length;
+	}
+
+	return (length);
+}
+
+static void write_bytes(pcolumns_context_t p_context, void const * p_data,
+		size_t length)
+{
+	buffered_writer_write(&p_context->writer, p_data, length);
+	p_context->offset += length;
+}
+
+static bool flush_group(pcolumns_context_t p_context, pcolumn_group_t p_group)
+{
+	size_t index;
+
+	if (0 == p_group->row_count)
+	{
+		return (true);
+	}
+
+	for (index = 0; index < p_group->column_count; index++)
+	{
+		size_t column_index = p_group->first_column + index;
+		pcolumn_t p_column = &p_context->p_columns[column_index];
+		phid_columns_chunk_t p_chunk;
+		size_t length = 0;
+
+		if (p_context->chunk_count == p_context->chunk_capacity)
+		{
+			size_t capacity = (0 == p_context->chunk_capacity) ?
+					64 : (2 * p_context->chunk_capacity);
+			phid_columns_chunk_t p_chunks = (phid_columns_chunk_t) realloc(
+					p_context->p_chunks, capacity * sizeof(hid_columns_chunk_t));
+
+			if (NULL == p_chunks)
+			{
+				return (false);
+			}
+
+			p_context->p_chunks = p_chunks;
+			p_context->chunk_capacity = capacity;
+		}
+
+		p_chunk = &p_context->p_chunks[p_context->chunk_count++];
+		memset(p_chunk, 0, sizeof(*p_chunk));
+		p_chunk->column_index = (uint32_t) column_index;
+		p_chunk->value_count = (uint32_t) p_group->row_count;
+		p_chunk->offset = p_context->offset;
+
+		// Timestamps always change, everything else usually changes slowly
+		if (HID_COLUMN_KIND_TIMESTAMP != p_column->desc.kind)
+		{
+			length = encode_dictionary(p_context, p_column->p_values,
+					p_group->row_count, p_context->p_encode_buffer);
+		}
+
+		if (0 != length)
+		{
+			p_chunk->encoding = HID_COLUMN_ENCODING_DICTIONARY;
+		}
+		else
+		{
+			p_chunk->encoding = HID_COLUMN_ENCODING_DELTA;
+			length = encode_delta(p_column->p_values, p_group->row_count,
+					p_context->p_encode_buffer);
+		}
+
+		p_chunk->length = length;
+		write_bytes(p_context, p_context->p_encode_buffer, length);
+	}
+
+	p_group->row_count = 0;
+
+	return (!p_context->writer.is_error);
+}
+
+static bool build_columns(pcolumns_context_t p_context,
+		hid_capture_header_t const * p_header,
+		hid_capture_field_t const * p_fields)
+{
+	size_t report_id;
+	size_t index;
+
+	// Count the groups and columns first so each array is allocated once
+	for (index = 0; index <= UINT8_MAX; index++)
+	{
+		p_context->group_index[index] = NO_GROUP;
+	}
+
+	for (index = 0; index < p_header->field_count; index++)
+	{
+		hid_capture_field_t const * p_field = &p_fields[index];
+
+		if (NO_GROUP == p_context->group_index[p_field->report_id])
+		{
+			p_context->group_index[p_field->report_id] = 0;
+			p_context->group_count++;
+			p_context->column_count++; // The group's timestamp column
+		}
+
+		if (HID_PLAN_FIELD_BUTTONS == p_field->type)
+		{
+			p_context->column_count += (p_field->count
+					+ BUTTONS_PER_COLUMN - 1) / BUTTONS_PER_COLUMN;
+		}
+		else
+		{
+			p_context->column_count++;
+		}
+	}
+
+	if (0 == p_context->group_count)
+	{
+		return (true);
+	}
+
+	p_context->p_groups = (pcolumn_group_t) calloc(p_context->group_count,
+			sizeof(column_group_t));
+	p_context->p_columns = (pcolumn_t) calloc(p_context->column_count,
+			sizeof(column_t));
+	if ((NULL == p_context->p_groups) || (NULL == p_context->p_columns))
+	{
+		return (false);
+	}
+
+	// Lay the columns out by ascending report ID, each group contiguous
+	p_context->group_count = 0;
+	p_context->column_count = 0;
+	for (report_id = 0; report_id <= UINT8_MAX; report_id++)
+	{
+		pcolumn_group_t p_group;
+		pcolumn_t p_column;
+
+		if (NO_GROUP == p_context->group_index[report_id])
+		{
+			continue;
+		}
+
+		p_context->group_index[report_id] = p_context->group_count;
+		p_group = &p_context->p_groups[p_context->group_count++];
+		p_group->report_id = (uint8_t) report_id;
+		p_group->first_column = p_context->column_count;
+		p_group->min_length = 1;
+
+		p_column = &p_context->p_columns[p_context->column_count++];
+		strcpy(p_column->desc.name, "timestamp_us");
+		p_column->desc.report_id = (uint8_t) report_id;
+		p_column->desc.kind = HID_COLUMN_KIND_TIMESTAMP;
+		p_column->desc.bit_count = 64;
+
+		for (index = 0; index < p_header->field_count; index++)
+		{
+			hid_capture_field_t const * p_field = &p_fields[index];
+			size_t base;
+
+			if (report_id != p_field->report_id)
+			{
+				continue;
+			}
+
+			for (base = 0; base < p_field->count; base += BUTTONS_PER_COLUMN)
+			{
+				size_t bit_size;
+				size_t end;
+
+				p_column = &p_context->p_columns[p_context->column_count++];
+				p_column->desc.report_id = (uint8_t) report_id;
+				p_column->desc.usage_page = p_field->usage_page;
+
+				if (HID_PLAN_FIELD_BUTTONS == p_field->type)
+				{
+					bit_size = p_field->count - base;
+					if (bit_size > BUTTONS_PER_COLUMN)
+					{
+						bit_size = BUTTONS_PER_COLUMN;
+					}
+
+					p_column->desc.kind = HID_COLUMN_KIND_BUTTONS;
+					p_column->desc.usage = (uint16_t) (p_field->usage + base);
+					p_column->bit_offset = (uint16_t) (p_field->bit_offset
+							+ base);
+					hid_export_format_name(p_field->usage_page,
+							p_column->desc.usage,
+							(USAGE) (p_column->desc.usage + bit_size - 1),
+							true, p_column->desc.name,
+							sizeof(p_column->desc.name) - NAME_SUFFIX_SIZE);
+				}
+				else
+				{
+					bit_size = p_field->bit_size;
+
+					p_column->desc.kind = HID_COLUMN_KIND_VALUE;
+					p_column->desc.usage = p_field->usage;
+					p_column->bit_offset = p_field->bit_offset;
+					p_column->is_signed = (p_field->logical_min < 0);
+					hid_export_format_name(p_field->usage_page,
+							p_field->usage, p_field->usage, false,
+							p_column->desc.name,
+							sizeof(p_column->desc.name) - NAME_SUFFIX_SIZE);
+
+					// A value field is a single column
+					base = p_field->count;
+				}
+
+				p_column->bit_size = (uint16_t) bit_size;
+				p_column->desc.bit_count = (uint16_t) bit_size;
+
+				end = (p_column->bit_offset + bit_size + 7) / 8;
+				if (end > p_group->min_length)
+				{
+					p_group->min_length = end;
+				}
+			}
+		}
+
+		p_group->column_count = p_context->column_count - p_group->first_column;
+		name_group_columns(p_context, p_group);
+	}
+
+	// Only now allocate the per column value buffers
+	for (index = 0; index < p_context->column_count; index++)
+	{
+		p_context->p_columns[index].p_values = (int64_t *) malloc(
+				HID_COLUMNS_ROWS_PER_CHUNK * sizeof(int64_t));
+		if (NULL == p_context->p_columns[index].p_values)
+		{
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
+static void name_group_columns(pcolumns_context_t p_context,
+		pcolumn_group_t p_group)
+{
+	pcolumn_t p_columns = &p_context->p_columns[p_group->first_column];
+	size_t index;
+	size_t other;
+
+	// Names shared within a report ID would make ambiguous columns
+	for (index = 0; index < p_group->column_count; index++)
+	{
+		for (other = index + 1; other < p_group->column_count; other++)
+		{
+			if (0 == strcmp(p_columns[index].desc.name,
+					p_columns[other].desc.name))
+			{
+				p_columns[index].is_shared = true;
+				p_columns[other].is_shared = true;
+			}
+		}
+	}
+
+	// Tell them apart by their index within the report ID's columns
+	for (index = 0; index < p_group->column_count; index++)
+	{
+		char *p_name = p_columns[index].desc.name;
+		size_t length = strlen(p_name);
+
+		if (p_columns[index].is_shared)
+		{
+			_snprintf(&p_name[length], HID_COLUMNS_NAME_SIZE - length, "_%u",
+					(unsigned int) index);
+		}
+	}
+}
+
+static void free_columns(pcolumns_context_t p_context)
+{
+	size_t index;
+
+	if (NULL != p_context->p_columns)
+	{
+		for (index = 0; index < p_context->column_count; index++)
+		{
+			free(p_context->p_columns[index].p_values);
+		}
+	}
+
+	buffered_writer_free(&p_context->writer);
+	if (NULL != p_context->p_file)
+	{
+		fclose(p_context->p_file);
+	}
+
+	free(p_context->p_columns);
+	free(p_context->p_groups);
+	free(p_context->p_chunks);
+	free(p_context->p_encode_buffer);
+	free(p_context->p_dictionary_indices);
+	free(p_context);
+}
+
+bool hid_columns_export(char const * p_capture_path,
+		char const * p_columns_path, uint64_t from_us, uint64_t to_us)
+{
+	HANDLE h_capture;
+	pcolumns_context_t p_context;
+	hid_capture_header_t const * p_capture_header;
+	hid_capture_field_t const * p_fields;
+	hid_capture_record_t record;
+	hid_columns_header_t header;
+	hid_columns_trailer_t trailer;
+	bool status = true;
+	bool is_record;
+	size_t index;
+
+	h_capture = hid_capture_open_reader(p_capture_path);
+	if (NULL == h_capture)
+	{
+		fprintf(stderr, "Cannot open capture '%s'\n", p_capture_path);
+		return (false);
+	}
+
+	p_capture_header = hid_capture_get_header(h_capture, &p_fields);
+
+	p_context = (pcolumns_context_t) calloc(1, sizeof(columns_context_t));
+	if (NULL == p_context)
+	{
+		hid_capture_close_reader(h_capture);
+		return (false);
+	}
+
+	p_context->p_encode_buffer = (uint8_t *) malloc(
+			(HID_COLUMNS_ROWS_PER_CHUNK * VARINT_MAX_LENGTH)
+					+ ((HID_COLUMNS_MAX_DICTIONARY + 1) * VARINT_MAX_LENGTH));
+	p_context->p_dictionary_indices = (uint8_t *) malloc(
+			HID_COLUMNS_ROWS_PER_CHUNK);
+
+	if ((NULL == p_context->p_encode_buffer)
+			|| (NULL == p_context->p_dictionary_indices)
+			|| !build_columns(p_context, p_capture_header, p_fields))
+	{
+		free_columns(p_context);
+		hid_capture_close_reader(h_capture);
+		return (false);
+	}
+
+	// The header stores the number of columns in 16 bits
+	if (p_context->column_count > UINT16_MAX)
+	{
+		fprintf(stderr, "Capture '%s' has too many columns\n", p_capture_path);
+		free_columns(p_context);
+		hid_capture_close_reader(h_capture);
+		return (false);
+	}
+
+	p_context->p_file = fopen(p_columns_path, "wb");
+	if ((NULL == p_context->p_file)
+			|| !buffered_writer_init(&p_context->writer, p_context->p_file,
+					BUFFERED_WRITER_DEFAULT_SIZE))
+	{
+		fprintf(stderr, "Cannot create columns file '%s'\n", p_columns_path);
+		free_columns(p_context);
+		hid_capture_close_reader(h_capture);
+		return (false);
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, HID_COLUMNS_MAGIC, sizeof(HID_COLUMNS_MAGIC) - 1);
+	header.version = HID_COLUMNS_VERSION;
+	header.column_count = (uint16_t) p_context->column_count;
+	header.vendor_id = p_capture_header->vendor_id;
+	header.product_id = p_capture_header->product_id;
+
+	write_bytes(p_context, &header, sizeof(header));
+	for (index = 0; index < p_context->column_count; index++)
+	{
+		write_bytes(p_context, &p_context->p_columns[index].desc,
+				sizeof(hid_columns_column_t));
+	}
+
+	// Start at the window, skipping the segments before it
+	is_record = (0 == from_us) || hid_capture_seek(h_capture, from_us);
+
+	// Gather each report's values into its group's columns
+	while (status && is_record && hid_capture_read(h_capture, &record))
+	{
+		pcolumn_group_t p_group;
+		pcolumn_t p_column;
+		size_t group_index;
+		size_t row;
+
+		if ((0 != to_us) && (record.timestamp_us > to_us))
+		{
+			break;
+		}
+
+		if (0 == record.length)
+		{
+			continue;
+		}
+
+		group_index = p_context->group_index[record.p_data[0]];
+		if (NO_GROUP == group_index)
+		{
+			continue;
+		}
+
+		// A short report cannot hold every column
+		p_group = &p_context->p_groups[group_index];
+		if (record.length < p_group->min_length)
+		{
+			continue;
+		}
+
+		row = p_group->row_count;
+		p_column = &p_context->p_columns[p_group->first_column];
+		p_column->p_values[row] = (int64_t) record.timestamp_us;
+
+		for (index = 1; index < p_group->column_count; index++)
+		{
+			p_column++;
+			p_column->p_values[row] = hid_plan_extract_value(record.p_data,
+					p_column->bit_offset, p_column->bit_size,
+					p_column->is_signed);
+		}
+
+		if (HID_COLUMNS_ROWS_PER_CHUNK == ++p_group->row_count)
+		{
+			status = flush_group(p_context, p_group);
+		}
+	}
+
+	for (index = 0; status && (index < p_context->group_count); index++)
+	{
+		status = flush_group(p_context, &p_context->p_groups[index]);
+	}
+
+	if (status)
+	{
+		memset(&trailer, 0, sizeof(trailer));
+		trailer.index_offset = p_context->offset;
+		trailer.chunk_count = (uint32_t) p_context->chunk_count;
+		memcpy(trailer.magic, HID_COLUMNS_TRAILER_MAGIC,
+				sizeof(trailer.magic));
+
+		write_bytes(p_context, p_context->p_chunks,
+				p_context->chunk_count * sizeof(hid_columns_chunk_t));
+		write_bytes(p_context, &trailer, sizeof(trailer));
+
+		status = buffered_writer_flush(&p_context->writer);
+	}
+
+	if (!status)
+	{
+		fprintf(stderr, "Cannot write columns file '%s'\n", p_columns_path);
+	}
+
+	free_columns(p_context);
+	hid_capture_close_reader(h_capture);
+
+	return (status);
+}
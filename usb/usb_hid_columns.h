@@ -0,0 +1,203 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_columns.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_COLUMNS_H_
+#define USB_HID_COLUMNS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_columns
+
+ \brief These APIs convert capture files into column oriented files so
+ analysis may read only the fields it needs.
+ */
+/* ************************************************************************* */
+
+/*
+
+ A columns file starts with a hid_columns_header_t followed by column_count
+ hid_columns_column_t entries. Every report ID of the capture contributes a
+ "timestamp_us" column followed by one column per value and one column per
+ (up to) 32 buttons of its fields. Columns are named after their usages, as
+ the export names its fields (see hid_export_format_name()), and columns
+ sharing a name within a report ID get their index in the report ID's
+ columns appended.
+
+ The column data follows as chunks of at most HID_COLUMNS_ROWS_PER_CHUNK
+ values, each chunk holding consecutive values of a single column. The file
+ ends with the chunk index (chunk_count hid_columns_chunk_t entries, in file
+ order) and a hid_columns_trailer_t, so a reader seeks to the trailer, loads
+ the index and reads just the chunks of the columns it wants.
+
+ Each chunk is encoded as one of the following, where a varint is an
+ unsigned LEB128 integer and a signed varint is zigzag encoded first:
+
+ HID_COLUMN_ENCODING_DELTA - The first value followed by the difference of
+ every value from its predecessor, all as signed varints. Used for
+ timestamps and quickly changing values.
+
+ HID_COLUMN_ENCODING_DICTIONARY - The number of distinct values (varint), the
+ distinct values (signed varints) and then runs of (dictionary index,
+ run length) varint pairs. Used when a chunk has few distinct values.
+
+ All integers outside of the chunk data are stored little-endian.
+
+ tools/hid_columns.py reads these files, e.g. into CSV for analysis tools. Its
+ --self-test checks it against tools/hid_columns_sample.hcol, which is to be
+ written again with -x whenever this format changes.
+
+ */
+
+#define HID_COLUMNS_MAGIC				"HIDCOL"
+#define HID_COLUMNS_TRAILER_MAGIC		"HCOL"
+#define HID_COLUMNS_VERSION				(2)
+
+#define HID_COLUMNS_ROWS_PER_CHUNK		(64 * 1024)
+#define HID_COLUMNS_MAX_DICTIONARY		(256)
+#define HID_COLUMNS_NAME_SIZE			(56)
+
+typedef enum _hid_column_kind_t
+{
+	HID_COLUMN_KIND_TIMESTAMP, // Report timestamps (usec since 1970)
+	HID_COLUMN_KIND_VALUE, // A value (sign extended if logically signed)
+	HID_COLUMN_KIND_BUTTONS // A bitmap of up to 32 buttons, lowest usage first
+
+} hid_column_kind_t;
+
+typedef enum _hid_column_encoding_t
+{
+	HID_COLUMN_ENCODING_DELTA,
+	HID_COLUMN_ENCODING_DICTIONARY
+
+} hid_column_encoding_t;
+
+__PACKED__
+
+typedef struct _hid_columns_header_t
+{
+	char magic[8]; // HID_COLUMNS_MAGIC padded with zeros
+	uint16_t version; // HID_COLUMNS_VERSION
+	uint16_t column_count; // Number of hid_columns_column_t entries
+	uint16_t vendor_id; // Attributes of the captured HID
+	uint16_t product_id;
+
+} hid_columns_header_t, *phid_columns_header_t;
+
+typedef struct _hid_columns_column_t
+{
+	char name[HID_COLUMNS_NAME_SIZE]; // Zero terminated column name
+	uint8_t report_id; // The report ID the column's rows belong to
+	uint8_t kind; // hid_column_kind_t
+	uint16_t usage_page;
+	uint16_t usage; // The value usage (or the usage of the lowest button)
+	uint16_t bit_count; // Bits of a value (number of buttons for bitmaps)
+
+} hid_columns_column_t, *phid_columns_column_t;
+
+typedef struct _hid_columns_chunk_t
+{
+	uint32_t column_index; // The column this chunk belongs to
+	uint32_t value_count; // Number of values in this chunk
+	uint8_t encoding; // hid_column_encoding_t
+	uint8_t reserved[7];
+	uint64_t offset; // File offset of the chunk's data
+	uint64_t length; // Bytes of chunk data
+
+} hid_columns_chunk_t, *phid_columns_chunk_t;
+
+typedef struct _hid_columns_trailer_t
+{
+	uint64_t index_offset; // File offset of the chunk index
+	uint32_t chunk_count; // Number of hid_columns_chunk_t entries
+	char magic[4]; // HID_COLUMNS_TRAILER_MAGIC
+
+} hid_columns_trailer_t, *phid_columns_trailer_t;
+
+__UNPACKED__
+
+// For the file format to be stable, the following must be true
+COMPILE_TIME_ASSERT(sizeof(hid_columns_header_t) == 16,
+		hid_columns_header_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_columns_column_t) == 64,
+		hid_columns_column_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_columns_chunk_t) == 32,
+		hid_columns_chunk_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(hid_columns_trailer_t) == 16,
+		hid_columns_trailer_t_is_wrong_size);
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_columns
+
+ \brief Converts a capture file, or a window of it, into a columns file.
+
+ \param[in] p_capture_path - The path of the capture file to convert.
+ \param[in] p_columns_path - The path of the columns file to create.
+ \param[in] from_us - The first timestamp to convert (usec since 1970).
+ \param[in] to_us - The last timestamp to convert (0 for no limit).
+
+ \return Indicates if the conversion was successful.
+
+ Only the capture segments overlapping the window are decompressed.
+
+ */
+/* ************************************************************************** */
+
+bool hid_columns_export(char const * p_capture_path,
+		char const * p_columns_path, uint64_t from_us, uint64_t to_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_COLUMNS_H_ */
@@ -0,0 +1,377 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_decode.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "buffered_writer.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_hid_plan.h"
+#include "usb_hid_capture.h"
+#include "usb_hid_export.h"
+
+// Module include
+#include "usb_hid_decode.h"
+
+// Initial size of a segment's decoded text
+#define SEGMENT_TEXT_SIZE	(256 * 1024)
+
+// A decoded segment waiting to be written
+typedef struct _decode_slot_t
+{
+	HANDLE h_done; // Signaled once the segment is decoded
+
+	char *p_text; // The segment's records (NULL on failure)
+	size_t length;
+
+} decode_slot_t, *pdecode_slot_t;
+
+typedef struct _decode_context_t
+{
+	char const *p_capture_path;
+
+	// Record fields, one per capture field
+	hid_export_layout_t layout;
+
+	size_t segment_count;
+	LONG volatile next_segment; // The next segment to be claimed
+	LONG volatile is_abort; // Threads stop claiming segments
+
+	// Bounds the segments claimed but not yet written to slot_count
+	HANDLE h_free_slots;
+	pdecode_slot_t p_slots; // Segment N uses slot N % slot_count
+	size_t slot_count;
+
+} decode_context_t, *pdecode_context_t;
+
+// Per thread decoding state
+typedef struct _decode_thread_t
+{
+	pdecode_context_t p_context;
+
+	HANDLE h_thread;
+	HANDLE h_capture; // The thread's own reader (mapping and buffers)
+
+} decode_thread_t, *pdecode_thread_t;
+
+// Local declarations
+static bool decode_segment(pdecode_thread_t p_thread, size_t segment,
+		pdecode_slot_t p_slot);
+
+static DWORD WINAPI decode_thread_proc(pdecode_thread_t p_thread);
+
+// Implementation
+
+static bool decode_segment(pdecode_thread_t p_thread, size_t segment,
+		pdecode_slot_t p_slot)
+{
+	HANDLE h_capture = p_thread->h_capture;
+	buffered_writer_t writer;
+	hid_capture_record_t record;
+	uint32_t record_count;
+	uint32_t index;
+
+	if (!buffered_writer_init_memory(&writer, SEGMENT_TEXT_SIZE))
+	{
+		return (false);
+	}
+
+	if (!hid_capture_seek_segment(h_capture, segment, &record_count))
+	{
+		buffered_writer_free(&writer);
+		return (false);
+	}
+
+	for (index = 0; index < record_count; index++)
+	{
+		if (!hid_capture_read(h_capture, &record))
+		{
+			buffered_writer_free(&writer);
+			return (false);
+		}
+
+		hid_export_write_record(&p_thread->p_context->layout, &writer,
+				record.timestamp_us, record.p_data, record.length);
+	}
+
+	if (writer.is_error)
+	{
+		buffered_writer_free(&writer);
+		return (false);
+	}
+
+	// The slot takes over the text
+	p_slot->p_text = writer.p_buffer;
+	p_slot->length = writer.length;
+
+	return (true);
+}
+
+static DWORD WINAPI decode_thread_proc(pdecode_thread_t p_thread)
+{
+	pdecode_context_t p_context = p_thread->p_context;
+
+	for (;;)
+	{
+		pdecode_slot_t p_slot;
+		size_t segment;
+
+		// Stay within the slots the writer has not caught up with yet
+		WaitForSingleObject(p_context->h_free_slots, INFINITE);
+
+		segment = (size_t) InterlockedIncrement(&p_context->next_segment) - 1;
+		if (segment >= p_context->segment_count)
+		{
+			// Let the other threads find out as well
+			ReleaseSemaphore(p_context->h_free_slots, 1, NULL);
+			break;
+		}
+
+		p_slot = &p_context->p_slots[segment % p_context->slot_count];
+		p_slot->p_text = NULL;
+		p_slot->length = 0;
+
+		if (!p_context->is_abort)
+		{
+			decode_segment(p_thread, segment, p_slot);
+		}
+
+		SetEvent(p_slot->h_done);
+	}
+
+	return (0);
+}
+
+bool hid_decode_capture(char const * p_capture_path, FILE * p_file,
+		hid_export_format_t format, size_t thread_count)
+{
+	decode_context_t context;
+	pdecode_thread_t p_threads = NULL;
+	hid_capture_header_t const * p_header;
+	hid_capture_field_t const * p_fields;
+	HANDLE h_capture;
+	buffered_writer_t writer;
+	bool status = true;
+	size_t started = 0;
+	size_t index;
+
+	if ((NULL == p_capture_path) || (NULL == p_file)
+			|| (HID_EXPORT_FORMAT_NONE == format))
+	{
+		return (false);
+	}
+
+	h_capture = hid_capture_open_reader(p_capture_path);
+	if (NULL == h_capture)
+	{
+		fprintf(stderr, "Cannot open capture '%s'\n", p_capture_path);
+		return (false);
+	}
+
+	memset(&context, 0, sizeof(context));
+	context.p_capture_path = p_capture_path;
+
+	p_header = hid_capture_get_header(h_capture, &p_fields);
+	context.segment_count = hid_capture_get_segment_count(h_capture);
+
+	// The fields are laid out and named as the live export does
+	if (!hid_export_layout_init(&context.layout, format, p_header->vendor_id,
+			p_header->product_id, p_fields, p_header->field_count))
+	{
+		hid_capture_close_reader(h_capture);
+		return (false);
+	}
+
+	if (0 == thread_count)
+	{
+		SYSTEM_INFO system_info;
+
+		GetSystemInfo(&system_info);
+		thread_count = system_info.dwNumberOfProcessors;
+	}
+	if (thread_count > context.segment_count)
+	{
+		thread_count = context.segment_count;
+	}
+
+	if (buffered_writer_init(&writer, p_file, BUFFERED_WRITER_DEFAULT_SIZE))
+	{
+		hid_export_write_header(&context.layout, &writer);
+		status = buffered_writer_flush(&writer);
+		buffered_writer_free(&writer);
+	}
+	else
+	{
+		status = false;
+	}
+
+	if (thread_count > 0)
+	{
+		context.slot_count = thread_count * HID_DECODE_SEGMENTS_PER_THREAD;
+		context.p_slots = (pdecode_slot_t) calloc(context.slot_count,
+				sizeof(decode_slot_t));
+		p_threads = (pdecode_thread_t) calloc(thread_count,
+				sizeof(decode_thread_t));
+		context.h_free_slots = CreateSemaphore(NULL, (LONG) context.slot_count,
+				(LONG) context.slot_count, NULL);
+		status = status && (NULL != context.p_slots) && (NULL != p_threads)
+				&& (NULL != context.h_free_slots);
+
+		for (index = 0; status && (index < context.slot_count); index++)
+		{
+			context.p_slots[index].h_done = CreateEvent(NULL, FALSE, FALSE,
+					NULL);
+			status = (NULL != context.p_slots[index].h_done);
+		}
+
+		// Every thread works with its own reader
+		for (index = 0; status && (index < thread_count); index++)
+		{
+			pdecode_thread_t p_thread = &p_threads[index];
+
+			p_thread->p_context = &context;
+			p_thread->h_capture = hid_capture_open_reader(p_capture_path);
+			if (NULL == p_thread->h_capture)
+			{
+				status = false;
+				break;
+			}
+
+			p_thread->h_thread = CreateThread(NULL, 0,
+					(LPTHREAD_START_ROUTINE) decode_thread_proc, p_thread, 0,
+					NULL);
+			if (NULL == p_thread->h_thread)
+			{
+				hid_capture_close_reader(p_thread->h_capture);
+				status = false;
+				break;
+			}
+
+			started++;
+		}
+	}
+
+	// Write the segments in order, each as soon as it is decoded
+	if (started > 0)
+	{
+		if (!status)
+		{
+			InterlockedExchange(&context.is_abort, TRUE);
+		}
+
+		for (index = 0; index < context.segment_count; index++)
+		{
+			pdecode_slot_t p_slot = &context.p_slots[index
+					% context.slot_count];
+
+			WaitForSingleObject(p_slot->h_done, INFINITE);
+
+			if (status
+					&& ((NULL == p_slot->p_text)
+							|| (p_slot->length
+									!= fwrite(p_slot->p_text, 1,
+											p_slot->length, p_file))))
+			{
+				status = false;
+				InterlockedExchange(&context.is_abort, TRUE);
+			}
+
+			free(p_slot->p_text);
+			p_slot->p_text = NULL;
+
+			ReleaseSemaphore(context.h_free_slots, 1, NULL);
+		}
+
+		for (index = 0; index < started; index++)
+		{
+			WaitForSingleObject(p_threads[index].h_thread, INFINITE);
+			CloseHandle(p_threads[index].h_thread);
+			hid_capture_close_reader(p_threads[index].h_capture);
+		}
+	}
+
+	if (0 != fflush(p_file))
+	{
+		status = false;
+	}
+
+	if (!status)
+	{
+		fprintf(stderr, "Cannot decode capture '%s'\n", p_capture_path);
+	}
+
+	for (index = 0; (NULL != context.p_slots) && (index < context.slot_count);
+			index++)
+	{
+		if (NULL != context.p_slots[index].h_done)
+		{
+			CloseHandle(context.p_slots[index].h_done);
+		}
+	}
+
+	if (NULL != context.h_free_slots)
+	{
+		CloseHandle(context.h_free_slots);
+	}
+
+	free(context.p_slots);
+	free(p_threads);
+	hid_export_layout_free(&context.layout);
+	hid_capture_close_reader(h_capture);
+
+	return (status);
+}
@@ -0,0 +1,101 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_decode.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_DECODE_H_
+#define USB_HID_DECODE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_decode
+
+ \brief These APIs decode capture files offline into the structured output
+ of usb_hid_export, spreading the work across all processors.
+ */
+/* ************************************************************************* */
+
+// Segments each thread may decode ahead of the output being written
+#define HID_DECODE_SEGMENTS_PER_THREAD	(4)
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_decode
+
+ \brief Decodes every record of a capture file to a stream.
+
+ \param[in] p_capture_path - The path of the capture file to decode.
+ \param[in] p_file - The stream to write records to.
+ \param[in] format - The record format.
+ \param[in] thread_count - The number of decoding threads (0 for one per
+ processor).
+
+ \return Indicates if the capture was decoded successfully.
+
+ Records are written as hid_export_report() writes them, in capture order,
+ with buttons as the list of pressed usages and values as their (signed)
+ logical value (tools/export_check.py compares both for a capture recorded
+ along with a live export). Every thread opens its own reader and repeatedly claims
+ the next segment not yet taken, so faster threads simply decode more
+ segments. The calling thread writes the decoded segments in order as they
+ complete.
+
+ */
+/* ************************************************************************** */
+
+bool hid_decode_capture(char const * p_capture_path, FILE * p_file,
+		hid_export_format_t format, size_t thread_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_DECODE_H_ */
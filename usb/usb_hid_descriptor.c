@@ -0,0 +1,333 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_descriptor.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+
+// Module include
+#include "usb_hid_descriptor.h"
+
+// Prefix of long items (type HID_ITEM_TYPE_LONG, tag 0xF, size 2)
+#define LONG_ITEM_PREFIX		(0xFE)
+
+// Implementation
+
+bool hid_descriptor_next_item(uint8_t const * p_descriptor, size_t length,
+		size_t * p_offset, phid_item_t p_item)
+{
+	size_t offset = *p_offset;
+	size_t remaining;
+	uint8_t prefix;
+	size_t index;
+
+	if ((NULL == p_descriptor) || (offset >= length))
+	{
+		return (false);
+	}
+
+	remaining = length - offset;
+	prefix = p_descriptor[offset];
+
+	memset(p_item, 0, sizeof(*p_item));
+	p_item->offset = offset;
+
+	if (LONG_ITEM_PREFIX == prefix)
+	{
+		// bDataSize and bLongItemTag follow the prefix
+		if ((remaining < 3) || ((remaining - 3) < p_descriptor[offset + 1]))
+		{
+			return (false);
+		}
+
+		p_item->type = HID_ITEM_TYPE_LONG;
+		p_item->tag = p_descriptor[offset + 2];
+		p_item->size = p_descriptor[offset + 1];
+		p_item->p_data = &p_descriptor[offset + 3];
+		p_item->length = 3 + p_item->size;
+	}
+	else
+	{
+		// Sizes 0, 1, 2 and 4 are encoded as 0, 1, 2 and 3
+		p_item->size = (uint8_t) ((3 == (prefix & 0x3)) ? 4 : (prefix & 0x3));
+		if ((remaining - 1) < p_item->size)
+		{
+			return (false);
+		}
+
+		p_item->type = (uint8_t) ((prefix >> 2) & 0x3);
+		p_item->tag = (uint8_t) (prefix >> 4);
+		p_item->p_data = &p_descriptor[offset + 1];
+		p_item->length = 1 + p_item->size;
+
+		// Data is little-endian
+		for (index = 0; index < p_item->size; index++)
+		{
+			p_item->data |= (uint32_t) p_item->p_data[index] << (8 * index);
+		}
+
+		p_item->signed_data = (int32_t) p_item->data;
+		if ((p_item->size > 0) && (p_item->size < 4)
+				&& (p_item->data & (1UL << ((8 * p_item->size) - 1))))
+		{
+			p_item->signed_data = (int32_t) (p_item->data
+					| ~((1UL << (8 * p_item->size)) - 1));
+		}
+	}
+
+	*p_offset = offset + p_item->length;
+
+	return (true);
+}
+
+void hid_descriptor_parser_init(phid_descriptor_parser_t p_parser)
+{
+	memset(p_parser, 0, sizeof(*p_parser));
+}
+
+bool hid_descriptor_parse_item(phid_descriptor_parser_t p_parser,
+		hid_item_t const * p_item)
+{
+	phid_descriptor_globals_t p_globals = &p_parser->globals;
+	bool is_valid = true;
+
+	p_parser->is_field = false;
+
+	switch (p_item->type)
+	{
+	case HID_ITEM_TYPE_MAIN:
+		switch (p_item->tag)
+		{
+		case HID_MAIN_INPUT:
+		case HID_MAIN_OUTPUT:
+		case HID_MAIN_FEATURE:
+		{
+			phid_descriptor_field_t p_field = &p_parser->field;
+			uint32_t *p_bits;
+
+			memset(p_field, 0, sizeof(*p_field));
+			p_field->report_type =
+					(HID_MAIN_INPUT == p_item->tag) ? HID_REPORT_TYPE_INPUT :
+					(HID_MAIN_OUTPUT == p_item->tag) ?
+							HID_REPORT_TYPE_OUTPUT : HID_REPORT_TYPE_FEATURE;
+			p_field->report_id = p_globals->report_id;
+
+			// The report ID byte leads every report buffer
+			p_bits = &p_parser->report_bits[p_field->report_type]
+					[p_field->report_id];
+			p_field->bit_offset = 8 + *p_bits;
+			p_field->bit_size = p_globals->report_size;
+			p_field->count = p_globals->report_count;
+			p_field->flags = p_item->data;
+			*p_bits += p_field->bit_size * p_field->count;
+
+			p_field->usage_page =
+					(0 != p_parser->usage_page) ?
+							p_parser->usage_page : p_globals->usage_page;
+			p_field->usage_min = p_parser->usage_min;
+			p_field->usage_max = p_parser->usage_max;
+			p_field->logical_min = p_globals->logical_min;
+			p_field->logical_max = p_globals->logical_max;
+
+			p_parser->is_field = true;
+		}
+			break;
+		case HID_MAIN_COLLECTION:
+			p_parser->collection_depth++;
+			break;
+		case HID_MAIN_END_COLLECTION:
+			if (0 == p_parser->collection_depth)
+			{
+				is_valid = false;
+			}
+			else
+			{
+				p_parser->collection_depth--;
+			}
+			break;
+		default:
+			is_valid = false;
+			break;
+		}
+
+		// Main items consume the local state
+		p_parser->usage_page = 0;
+		p_parser->usage_min = 0;
+		p_parser->usage_max = 0;
+		p_parser->usage_count = 0;
+		break;
+
+	case HID_ITEM_TYPE_GLOBAL:
+		switch (p_item->tag)
+		{
+		case HID_GLOBAL_USAGE_PAGE:
+			p_globals->usage_page = (uint16_t) p_item->data;
+			break;
+		case HID_GLOBAL_LOGICAL_MIN:
+			p_globals->logical_min = p_item->signed_data;
+			break;
+		case HID_GLOBAL_LOGICAL_MAX:
+			// Unsigned when the minimum is not negative
+			p_globals->logical_max =
+					(p_globals->logical_min >= 0) ?
+							(int32_t) p_item->data : p_item->signed_data;
+			break;
+		case HID_GLOBAL_PHYSICAL_MIN:
+			p_globals->physical_min = p_item->signed_data;
+			break;
+		case HID_GLOBAL_PHYSICAL_MAX:
+			p_globals->physical_max =
+					(p_globals->physical_min >= 0) ?
+							(int32_t) p_item->data : p_item->signed_data;
+			break;
+		case HID_GLOBAL_UNIT_EXPONENT:
+			p_globals->unit_exponent = p_item->data;
+			break;
+		case HID_GLOBAL_UNIT:
+			p_globals->unit = p_item->data;
+			break;
+		case HID_GLOBAL_REPORT_SIZE:
+			p_globals->report_size = p_item->data;
+			break;
+		case HID_GLOBAL_REPORT_ID:
+			if ((0 == p_item->data) || (p_item->data > 0xFF))
+			{
+				is_valid = false;
+			}
+			else
+			{
+				p_globals->report_id = (uint8_t) p_item->data;
+				p_parser->is_report_id = true;
+			}
+			break;
+		case HID_GLOBAL_REPORT_COUNT:
+			p_globals->report_count = p_item->data;
+			break;
+		case HID_GLOBAL_PUSH:
+			if (HID_DESCRIPTOR_STACK_DEPTH == p_parser->stack_depth)
+			{
+				is_valid = false;
+			}
+			else
+			{
+				p_parser->stack[p_parser->stack_depth++] = *p_globals;
+			}
+			break;
+		case HID_GLOBAL_POP:
+			if (0 == p_parser->stack_depth)
+			{
+				is_valid = false;
+			}
+			else
+			{
+				*p_globals = p_parser->stack[--p_parser->stack_depth];
+			}
+			break;
+		default:
+			is_valid = false;
+			break;
+		}
+		break;
+
+	case HID_ITEM_TYPE_LOCAL:
+		switch (p_item->tag)
+		{
+		case HID_LOCAL_USAGE:
+		case HID_LOCAL_USAGE_MIN:
+		case HID_LOCAL_USAGE_MAX:
+		{
+			uint16_t usage = (uint16_t) p_item->data;
+
+			// Extended usages carry their usage page in the high word
+			if (4 == p_item->size)
+			{
+				p_parser->usage_page = (uint16_t) (p_item->data >> 16);
+			}
+
+			if (HID_LOCAL_USAGE_MAX == p_item->tag)
+			{
+				p_parser->usage_max = usage;
+			}
+			else if (HID_LOCAL_USAGE_MIN == p_item->tag)
+			{
+				p_parser->usage_min = usage;
+			}
+			else
+			{
+				// A list of usages spans from the first to the last
+				if (0 == p_parser->usage_count++)
+				{
+					p_parser->usage_min = usage;
+				}
+				p_parser->usage_max = usage;
+			}
+		}
+			break;
+		default:
+			// Designators, strings and delimiters do not affect the layout
+			break;
+		}
+		break;
+
+	default:
+		// Long items are reserved and carry no state
+		break;
+	}
+
+	return (is_valid);
+}
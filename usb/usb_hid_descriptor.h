@@ -0,0 +1,253 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_descriptor.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_DESCRIPTOR_H_
+#define USB_HID_DESCRIPTOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_descriptor
+
+ \brief These APIs walk the items of a HID report descriptor and track the
+ parser state they imply, including where each field lies in its report.
+ */
+/* ************************************************************************* */
+
+// Item types
+#define HID_ITEM_TYPE_MAIN			(0)
+#define HID_ITEM_TYPE_GLOBAL		(1)
+#define HID_ITEM_TYPE_LOCAL			(2)
+#define HID_ITEM_TYPE_LONG			(3) // Reserved type, used by long items
+
+// Main item tags
+#define HID_MAIN_INPUT				(0x8)
+#define HID_MAIN_OUTPUT				(0x9)
+#define HID_MAIN_COLLECTION			(0xA)
+#define HID_MAIN_FEATURE			(0xB)
+#define HID_MAIN_END_COLLECTION		(0xC)
+
+// Global item tags
+#define HID_GLOBAL_USAGE_PAGE		(0x0)
+#define HID_GLOBAL_LOGICAL_MIN		(0x1)
+#define HID_GLOBAL_LOGICAL_MAX		(0x2)
+#define HID_GLOBAL_PHYSICAL_MIN		(0x3)
+#define HID_GLOBAL_PHYSICAL_MAX		(0x4)
+#define HID_GLOBAL_UNIT_EXPONENT	(0x5)
+#define HID_GLOBAL_UNIT				(0x6)
+#define HID_GLOBAL_REPORT_SIZE		(0x7)
+#define HID_GLOBAL_REPORT_ID		(0x8)
+#define HID_GLOBAL_REPORT_COUNT		(0x9)
+#define HID_GLOBAL_PUSH				(0xA)
+#define HID_GLOBAL_POP				(0xB)
+
+// Local item tags
+#define HID_LOCAL_USAGE				(0x0)
+#define HID_LOCAL_USAGE_MIN			(0x1)
+#define HID_LOCAL_USAGE_MAX			(0x2)
+#define HID_LOCAL_DESIGNATOR_INDEX	(0x3)
+#define HID_LOCAL_DESIGNATOR_MIN	(0x4)
+#define HID_LOCAL_DESIGNATOR_MAX	(0x5)
+#define HID_LOCAL_STRING_INDEX		(0x7)
+#define HID_LOCAL_STRING_MIN		(0x8)
+#define HID_LOCAL_STRING_MAX		(0x9)
+#define HID_LOCAL_DELIMITER			(0xA)
+
+// Main item data flags (input, output and feature)
+#define HID_MAIN_FLAG_CONSTANT		(0x01) // Constant, otherwise data
+#define HID_MAIN_FLAG_VARIABLE		(0x02) // Variable, otherwise array
+#define HID_MAIN_FLAG_RELATIVE		(0x04) // Relative, otherwise absolute
+
+// Depth of the global item stack (push and pop)
+#define HID_DESCRIPTOR_STACK_DEPTH	(8)
+
+// Report IDs range from 1 to 255, 0 stands for "no report ID"
+#define HID_DESCRIPTOR_REPORT_IDS	(256)
+
+// A single (short or long) item
+typedef struct _hid_item_t
+{
+	uint8_t type; // HID_ITEM_TYPE_*
+	uint8_t tag; // The tag within the type
+	uint8_t size; // Number of data bytes
+
+	uint32_t data; // Data of short items, zero extended
+	int32_t signed_data; // Data of short items, sign extended
+
+	uint8_t const *p_data; // The item's data bytes
+
+	size_t offset; // Offset of the item within the descriptor
+	size_t length; // Length of the item (prefix included)
+
+} hid_item_t, *phid_item_t;
+
+// The state set by global items
+typedef struct _hid_descriptor_globals_t
+{
+	uint16_t usage_page;
+	int32_t logical_min;
+	int32_t logical_max;
+	int32_t physical_min;
+	int32_t physical_max;
+	uint32_t unit_exponent;
+	uint32_t unit;
+	uint32_t report_size;
+	uint32_t report_count;
+	uint8_t report_id;
+
+} hid_descriptor_globals_t, *phid_descriptor_globals_t;
+
+// The field declared by an input, output or feature item
+typedef struct _hid_descriptor_field_t
+{
+	hid_report_type_t report_type;
+	uint8_t report_id;
+
+	uint32_t bit_offset; // Position in the report buffer (report ID in byte 0)
+	uint32_t bit_size; // Report size
+	uint32_t count; // Report count
+
+	uint32_t flags; // HID_MAIN_FLAG_*
+
+	uint16_t usage_page;
+	uint16_t usage_min; // The first usage (or usage minimum)
+	uint16_t usage_max; // The last usage (or usage maximum)
+
+	int32_t logical_min;
+	int32_t logical_max;
+
+} hid_descriptor_field_t, *phid_descriptor_field_t;
+
+typedef struct _hid_descriptor_parser_t
+{
+	hid_descriptor_globals_t globals;
+	hid_descriptor_globals_t stack[HID_DESCRIPTOR_STACK_DEPTH];
+	size_t stack_depth;
+
+	// The state set by local items (cleared by every main item)
+	uint16_t usage_page; // Page of extended usages (0 if none)
+	uint16_t usage_min;
+	uint16_t usage_max;
+	size_t usage_count;
+
+	size_t collection_depth;
+	bool is_report_id; // A report ID item was seen
+
+	// Bits declared so far per report type and report ID
+	uint32_t report_bits[HID_REPORT_TYPE_SIZE][HID_DESCRIPTOR_REPORT_IDS];
+
+	// The field declared by the last item (valid when is_field is set)
+	hid_descriptor_field_t field;
+	bool is_field;
+
+} hid_descriptor_parser_t, *phid_descriptor_parser_t;
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_descriptor
+
+ \brief Retrieves the next item of a report descriptor.
+
+ \param[in] p_descriptor - The report descriptor.
+ \param[in] length - The length of the report descriptor.
+ \param[in,out] p_offset - The offset of the item (advanced past it).
+ \param[out] p_item - Receives the item.
+
+ \return Indicates if an item was retrieved (false at the end of the
+ descriptor or for an item running past it).
+
+ */
+/* ************************************************************************** */
+
+bool hid_descriptor_next_item(uint8_t const * p_descriptor, size_t length,
+		size_t * p_offset, phid_item_t p_item);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_descriptor
+
+ \brief Initialises a report descriptor parser.
+
+ \param[out] p_parser - The parser to initialise.
+
+ */
+/* ************************************************************************** */
+
+void hid_descriptor_parser_init(phid_descriptor_parser_t p_parser);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_descriptor
+
+ \brief Applies an item to the parser state.
+
+ \param[in,out] p_parser - The parser.
+ \param[in] p_item - The item, as retrieved by hid_descriptor_next_item().
+
+ \return Indicates if the item was valid in the current state (e.g. an end
+ collection without a collection or a pop without a push is not).
+
+ Input, output and feature items set is_field and describe their field in
+ field. Bit offsets count the report ID byte which leads every report buffer,
+ so they match those of the compiled plans (see usb_hid_plan).
+
+ */
+/* ************************************************************************** */
+
+bool hid_descriptor_parse_item(phid_descriptor_parser_t p_parser,
+		hid_item_t const * p_item);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_DESCRIPTOR_H_ */
@@ -0,0 +1,295 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_event_loop.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+#include <usbioctl.h>
+
+// Other includes
+#include "output.h"
+#include "hexdump.h"
+#include "utils.h"
+#include "console_stop.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_enum.h"
+#include "usb_debug.h"
+#include "usb_hid_reports.h"
+#include "usb_hid_plan.h"
+#include "usb_hid_capture.h"
+#include "usb_hid_export.h"
+#include "usb_hid_snapshot.h"
+#include "usb_hid_strings.h"
+#include "win_msg_hdlr.h"
+#include "usb_hid_msg_hdlr.h"
+
+// Module include
+#include "usb_hid_event_loop.h"
+
+// Handles waited for besides the window messages
+#define EVENT_READ			(0) // A read completed
+#define EVENT_STOP			(1) // The user asked to stop
+#define EVENT_COUNT			(2)
+
+// Options a returning HID is opened with
+#define READ_OPTIONS		(USB_READ_ACCESS | USB_OVERLAPPED)
+
+// Local declarations
+static void handle_report(p_hid_handler_context_t p_hid, uint32_t count);
+
+static bool reattach(p_hid_handler_context_t p_hid, uint64_t layout_hash,
+		HANDLE h_read_event);
+
+// Implementation
+
+static void handle_report(p_hid_handler_context_t p_hid, uint32_t count)
+{
+	static char buffer[1024];
+	phid_report_t p_report = &p_hid->p_hid_device->report[HID_REPORT_TYPE_INPUT];
+
+	//
+	// Capture the raw Input report
+	//
+
+	if (NULL != p_hid->h_capture)
+	{
+		hid_capture_write(p_hid->h_capture, p_report->timestamp_us,
+				p_report->p_report_buffer, p_report->report_buffer_length);
+	}
+
+	//
+	// Either export the Input data as a structured record or display all
+	// of it for the device
+	//
+
+	if (NULL != p_hid->h_export)
+	{
+		hid_export_report(p_hid->h_export);
+	}
+	else
+	{
+		phid_data_t p_hid_data = p_report->p_hid_data;
+		size_t loop;
+
+		Message("INPUT_REPORT", count);
+
+		hex_dump(stdout, NULL, (uint8_t const *) p_report->p_report_buffer,
+				p_report->report_buffer_length);
+
+		for (loop = 0; loop < p_report->hid_data_length; loop++)
+		{
+			usb_print_hid_report(p_hid_data, buffer, sizeof(buffer));
+			printf("::\t%s\n", buffer);
+			p_hid_data++;
+		}
+	}
+}
+
+static bool reattach(p_hid_handler_context_t p_hid, uint64_t layout_hash,
+		HANDLE h_read_event)
+{
+	phid_device_t p_hid_device = p_hid->p_hid_device;
+	char *p_device_path;
+	bool success;
+
+	// Arrivals of other HIDs are expected, stay quiet about them
+	if (!usb_find_hid_device_path(&p_hid->filter, &p_device_path))
+	{
+		return (false);
+	}
+
+	success = usb_open_hid_cached(p_device_path, READ_OPTIONS, p_hid_device,
+			p_hid->h_plan_cache);
+	if (!success)
+	{
+		fprintf(stderr, "Cannot open HID with device path '%s'\n",
+				p_device_path);
+		free(p_device_path);
+		return (false);
+	}
+	free(p_device_path);
+
+	if ((layout_hash != hid_plan_layout_hash(p_hid_device))
+			|| ((NULL != p_hid->h_export) && !hid_export_rebind(p_hid->h_export)))
+	{
+		fprintf(stderr, "HID returned with different reports, ignoring it\n");
+		usb_close_hid(p_hid_device);
+		return (false);
+	}
+
+	// stdout may carry the exported records
+	fprintf(stderr, "HID returned, resuming.\n");
+
+	if (!hid_read_overlapped(p_hid_device, h_read_event))
+	{
+		usb_close_hid(p_hid_device);
+		return (false);
+	}
+
+	return (true);
+}
+
+bool hid_event_loop_run(HINSTANCE hInstance, p_hid_handler_context_t p_hid)
+{
+	phid_device_t p_hid_device = p_hid->p_hid_device;
+	phid_report_t p_report = &p_hid_device->report[HID_REPORT_TYPE_INPUT];
+	HANDLE h_events[EVENT_COUNT];
+	HANDLE h_msg_hdlr;
+	uint64_t layout_hash;
+	uint32_t count = 0;
+	bool attached;
+	bool running;
+
+	h_events[EVENT_READ] = CreateEvent(NULL, FALSE, FALSE, NULL);
+	h_events[EVENT_STOP] = console_stop_create();
+	if ((NULL == h_events[EVENT_READ]) || (NULL == h_events[EVENT_STOP]))
+	{
+		print_errno("CreateEvent");
+		CloseHandle(h_events[EVENT_READ]);
+		console_stop_destroy(h_events[EVENT_STOP]);
+		return (false);
+	}
+
+	// The window only receives the device notifications
+	h_msg_hdlr = win_msg_hdlr_create(hInstance, hid_msg_hdlr, p_hid);
+
+	// A returning HID must have the layout the capture and export expect
+	layout_hash = hid_plan_layout_hash(p_hid_device);
+
+	attached = hid_read_overlapped(p_hid_device, h_events[EVENT_READ]);
+	running = attached;
+	while (running)
+	{
+		DWORD length;
+		DWORD wait_status;
+
+		wait_status = MsgWaitForMultipleObjects(EVENT_COUNT, h_events, FALSE,
+				INFINITE, QS_ALLINPUT);
+
+		switch (wait_status)
+		{
+		case WAIT_OBJECT_0 + EVENT_READ:
+			// Fails once the HID is gone
+			if (attached
+					&& GetOverlappedResult(p_hid_device->h_device,
+							&p_report->overlap, &length, FALSE))
+			{
+				p_report->timestamp_us = hid_timestamp_now();
+
+				// Unpack Input Report from device. InputReportBuffer gets
+				// unpacked into various HID_DATA structures
+				hid_unpack_report(p_report->p_report_buffer,
+						p_report->report_buffer_length, HidP_Input,
+						p_report->p_hid_data, p_report->hid_data_length,
+						p_hid_device->p_ppd);
+
+				hid_snapshot_update(p_hid_device->h_snapshot,
+						p_report->p_report_buffer, length,
+						p_report->timestamp_us);
+
+				handle_report(p_hid, ++count);
+
+				attached = hid_read_overlapped(p_hid_device,
+						h_events[EVENT_READ]);
+			}
+			else
+			{
+				attached = false;
+			}
+
+			if (!attached)
+			{
+				fprintf(stderr, "HID removed, waiting for it to return.\n");
+				hid_export_flush(p_hid->h_export);
+
+				// Whatever arrives at this path next is asked afresh
+				hid_strings_forget(p_hid_device->p_device_path);
+				usb_close_hid(p_hid_device);
+			}
+			break;
+
+		case WAIT_OBJECT_0 + EVENT_COUNT:
+			// Window messages are queued
+			running = win_msg_hdlr_dispatch();
+
+			if (running && !attached && p_hid->is_arrival)
+			{
+				p_hid->is_arrival = false;
+				attached = reattach(p_hid, layout_hash, h_events[EVENT_READ]);
+			}
+			break;
+
+		case WAIT_OBJECT_0 + EVENT_STOP:
+		default:
+			running = false;
+			break;
+		}
+
+		if (!running && attached)
+		{
+			// The buffer must not be reused while the read is outstanding
+			CancelIo(p_hid_device->h_device);
+			GetOverlappedResult(p_hid_device->h_device, &p_report->overlap,
+					&length, TRUE);
+		}
+	}
+
+	hid_export_flush(p_hid->h_export);
+
+	win_msg_hdlr_destroy(h_msg_hdlr);
+
+	CloseHandle(h_events[EVENT_READ]);
+	console_stop_destroy(h_events[EVENT_STOP]);
+
+	return (true);
+}
@@ -0,0 +1,94 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_event_loop.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_EVENT_LOOP_H_
+#define USB_HID_EVENT_LOOP_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_event_loop
+
+ \brief These APIs service a HID's reports, hotplug notifications and shutdown
+ from a single thread.
+ */
+/* ************************************************************************* */
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_event_loop
+
+ \brief Reads and handles the input reports of a HID until the user
+ interrupts (Ctrl+C) the program.
+
+ \param[in] hInstance - The instance owning the notification window.
+ \param[in] p_hid - The HID and where its reports go.
+
+ \return Indicates if the loop ran.
+
+ Read completions, the device notification window's messages and the shutdown
+ request are all waited for at once with MsgWaitForMultipleObjects(), so every
+ report is captured, exported or displayed as soon as its read completes
+ rather than being posted to the window first.
+
+ When the HID is removed the loop waits for a HID matching p_hid->filter to
+ arrive, reopens it with the plans of p_hid->h_plan_cache and resumes into the
+ same capture and export, provided its report layout did not change.
+
+ */
+/* ************************************************************************** */
+
+bool hid_event_loop_run(HINSTANCE hInstance, p_hid_handler_context_t p_hid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_EVENT_LOOP_H_ */
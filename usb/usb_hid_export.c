@@ -0,0 +1,755 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_export.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "buffered_writer.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_hid_usages.h"
+#include "usb_hid_strings.h"
+#include "usb_hid_plan.h"
+#include "usb_hid_capture.h"
+
+// Module include
+#include "usb_hid_export.h"
+
+// Room kept at the end of a name for the ordinal telling it apart
+#define NAME_SUFFIX_SIZE	(8)
+
+typedef struct _hid_export_context_t
+{
+	// Fields, as the plans of the report exported describe them
+	hid_export_layout_t layout;
+
+	// The report exported
+	phid_report_t p_report;
+
+	buffered_writer_t writer;
+
+	// Timestamp of the last hand off to the stream
+	uint64_t last_flush_us;
+
+} hid_export_context_t, *phid_export_context_t;
+
+// Local declarations
+static void write_field_value(phid_export_layout_t const p_layout,
+		pbuffered_writer_t p_writer, hid_capture_field_t const * p_field,
+		uint8_t const * p_report_buffer, size_t report_buffer_length);
+
+static bool name_fields(phid_export_layout_t p_layout);
+
+static phid_capture_field_t get_report_fields(phid_report_t const p_report,
+		size_t * p_field_count);
+
+static void append_identifier(char const * p_text, char * p_name,
+		size_t name_size);
+
+static void write_json_string(pbuffered_writer_t p_writer,
+		char const * p_text);
+
+static void write_csv_string(pbuffered_writer_t p_writer,
+		char const * p_text);
+
+static void write_metadata(phid_export_layout_t const p_layout,
+		pbuffered_writer_t p_writer);
+
+static void free_export(phid_export_context_t p_context);
+
+// Implementation
+
+// Appends text as lower case letters and digits, '_' for whatever is between
+static void append_identifier(char const * p_text, char * p_name,
+		size_t name_size)
+{
+	size_t length = strlen(p_name);
+	bool is_separated = (0 == length) || ('_' == p_name[length - 1]);
+
+	for (; ('\0' != *p_text) && ((length + 1) < name_size); p_text++)
+	{
+		unsigned char c = (unsigned char) *p_text;
+
+		if (isalnum(c))
+		{
+			p_name[length++] = (char) tolower(c);
+			is_separated = false;
+		}
+		else if (!is_separated)
+		{
+			p_name[length++] = '_';
+			is_separated = true;
+		}
+	}
+
+	// Trailing punctuation leaves no trailing separator
+	if ((length > 0) && ('_' == p_name[length - 1]))
+	{
+		length--;
+	}
+
+	p_name[length] = '\0';
+}
+
+static void write_json_string(pbuffered_writer_t p_writer,
+		char const * p_text)
+{
+	static char const hex_digits[] = "0123456789abcdef";
+
+	// An empty string is an unknown one
+	if ('\0' == *p_text)
+	{
+		buffered_writer_puts(p_writer, "null");
+		return;
+	}
+
+	buffered_writer_putc(p_writer, '"');
+	for (; '\0' != *p_text; p_text++)
+	{
+		unsigned char c = (unsigned char) *p_text;
+
+		if (('"' == c) || ('\\' == c))
+		{
+			buffered_writer_putc(p_writer, '\\');
+			buffered_writer_putc(p_writer, (char) c);
+		}
+		else if (c < 0x20)
+		{
+			buffered_writer_puts(p_writer, "\\u00");
+			buffered_writer_putc(p_writer, hex_digits[c >> 4]);
+			buffered_writer_putc(p_writer, hex_digits[c & 0xF]);
+		}
+		else
+		{
+			buffered_writer_putc(p_writer, (char) c);
+		}
+	}
+	buffered_writer_putc(p_writer, '"');
+}
+
+static void write_csv_string(pbuffered_writer_t p_writer,
+		char const * p_text)
+{
+	// Quotes are doubled and control characters become spaces
+	buffered_writer_putc(p_writer, '"');
+	for (; '\0' != *p_text; p_text++)
+	{
+		if ('"' == *p_text)
+		{
+			buffered_writer_putc(p_writer, '"');
+		}
+
+		buffered_writer_putc(p_writer,
+				((unsigned char) *p_text < 0x20) ? ' ' : *p_text);
+	}
+	buffered_writer_putc(p_writer, '"');
+}
+
+static void write_metadata(phid_export_layout_t const p_layout,
+		pbuffered_writer_t p_writer)
+{
+	if (HID_EXPORT_FORMAT_JSON == p_layout->format)
+	{
+		buffered_writer_puts(p_writer, "{\"metadata\":{\"device\":\"");
+		buffered_writer_puts(p_writer, p_layout->device);
+		buffered_writer_puts(p_writer, "\",\"product\":");
+		write_json_string(p_writer, p_layout->product);
+		buffered_writer_puts(p_writer, ",\"serial_number\":");
+		write_json_string(p_writer, p_layout->serial_number);
+		buffered_writer_puts(p_writer, "}}\n");
+	}
+	else
+	{
+		// Analysis tools skip comment lines (e.g. pandas' comment='#')
+		buffered_writer_puts(p_writer, "# device: ");
+		buffered_writer_puts(p_writer, p_layout->device);
+		if ('\0' != p_layout->product[0])
+		{
+			buffered_writer_puts(p_writer, ", product: ");
+			write_csv_string(p_writer, p_layout->product);
+		}
+		if ('\0' != p_layout->serial_number[0])
+		{
+			buffered_writer_puts(p_writer, ", serial_number: ");
+			write_csv_string(p_writer, p_layout->serial_number);
+		}
+		buffered_writer_putc(p_writer, '\n');
+	}
+}
+
+static void write_field_value(phid_export_layout_t const p_layout,
+		pbuffered_writer_t p_writer, hid_capture_field_t const * p_field,
+		uint8_t const * p_report_buffer, size_t report_buffer_length)
+{
+	bool is_json = (HID_EXPORT_FORMAT_JSON == p_layout->format);
+	size_t bit_end = p_field->bit_offset
+			+ ((size_t) p_field->bit_size * p_field->count);
+
+	// A field beyond a short report is null (JSON) or empty (CSV)
+	if (bit_end > (report_buffer_length * 8))
+	{
+		if (is_json)
+		{
+			buffered_writer_puts(p_writer, "null");
+		}
+		return;
+	}
+
+	if (HID_PLAN_FIELD_BUTTONS == p_field->type)
+	{
+		bool is_first = true;
+		size_t index;
+
+		if (is_json)
+		{
+			buffered_writer_putc(p_writer, '[');
+		}
+
+		// List the usages of the buttons down, as the HID parser does
+		for (index = 0; index < p_field->count; index++)
+		{
+			if (0 == hid_plan_extract_bits(p_report_buffer,
+					p_field->bit_offset + index, 1))
+			{
+				continue;
+			}
+
+			if (!is_first)
+			{
+				buffered_writer_putc(p_writer, is_json ? ',' : ' ');
+			}
+			is_first = false;
+
+			buffered_writer_put_uint(p_writer, p_field->usage + index);
+		}
+
+		if (is_json)
+		{
+			buffered_writer_putc(p_writer, ']');
+		}
+	}
+	else
+	{
+		// A negative logical minimum makes the field's top bit its sign
+		buffered_writer_put_int(p_writer,
+				hid_plan_extract_value(p_report_buffer, p_field->bit_offset,
+						p_field->bit_size, (p_field->logical_min < 0)));
+	}
+}
+
+// Returns the report's capture field table (NULL if it has no fields)
+static phid_capture_field_t get_report_fields(phid_report_t const p_report,
+		size_t * p_field_count)
+{
+	phid_capture_field_t p_fields;
+
+	*p_field_count = hid_capture_fill_fields(p_report, NULL);
+	if (0 == *p_field_count)
+	{
+		return (NULL);
+	}
+
+	p_fields = (phid_capture_field_t) calloc(*p_field_count,
+			sizeof(hid_capture_field_t));
+	if (NULL != p_fields)
+	{
+		hid_capture_fill_fields(p_report, p_fields);
+	}
+
+	return (p_fields);
+}
+
+static bool name_fields(phid_export_layout_t p_layout)
+{
+	bool prefix_report_id = false;
+	bool *p_is_shared;
+	size_t index;
+
+	// CSV columns must be unique across every report ID
+	for (index = 1; index < p_layout->field_count; index++)
+	{
+		if (p_layout->p_fields[index].field.report_id
+				!= p_layout->p_fields[0].field.report_id)
+		{
+			prefix_report_id = (HID_EXPORT_FORMAT_CSV == p_layout->format);
+			break;
+		}
+	}
+
+	p_is_shared = (bool *) calloc(p_layout->field_count + 1, sizeof(bool));
+	if (NULL == p_is_shared)
+	{
+		return (false);
+	}
+
+	// Name every field once so records need no formatting of names
+	for (index = 0; index < p_layout->field_count; index++)
+	{
+		phid_export_field_t p_field = &p_layout->p_fields[index];
+		char *p_name = p_field->name;
+		int length = 0;
+
+		if (prefix_report_id)
+		{
+			length = _snprintf(p_name, HID_EXPORT_FIELD_NAME_SIZE, "r%u_",
+					p_field->field.report_id);
+		}
+
+		hid_export_format_name(p_field->field.usage_page, p_field->field.usage,
+				p_field->field.usage_max,
+				(HID_PLAN_FIELD_BUTTONS == p_field->field.type),
+				&p_name[length],
+				HID_EXPORT_FIELD_NAME_SIZE - NAME_SUFFIX_SIZE - length);
+	}
+
+	// Names shared within a report ID would make duplicate keys
+	for (index = 0; index < p_layout->field_count; index++)
+	{
+		phid_export_field_t p_field = &p_layout->p_fields[index];
+		size_t other;
+
+		for (other = index + 1; other < p_layout->field_count; other++)
+		{
+			phid_export_field_t p_other = &p_layout->p_fields[other];
+
+			if ((p_field->field.report_id == p_other->field.report_id)
+					&& (0 == strcmp(p_field->name, p_other->name)))
+			{
+				p_is_shared[index] = true;
+				p_is_shared[other] = true;
+			}
+		}
+	}
+
+	// Tell them apart by their ordinal within the report ID, which does not
+	// depend on the fields of other report IDs
+	for (index = 0; index < p_layout->field_count; index++)
+	{
+		phid_export_field_t p_field = &p_layout->p_fields[index];
+		size_t length = strlen(p_field->name);
+		size_t ordinal = 0;
+		size_t other;
+
+		if (!p_is_shared[index])
+		{
+			continue;
+		}
+
+		for (other = 0; other < index; other++)
+		{
+			if (p_layout->p_fields[other].field.report_id
+					== p_field->field.report_id)
+			{
+				ordinal++;
+			}
+		}
+
+		_snprintf(&p_field->name[length], HID_EXPORT_FIELD_NAME_SIZE - length,
+				"_%u", (unsigned int) ordinal);
+	}
+
+	free(p_is_shared);
+
+	return (true);
+}
+
+static void free_export(phid_export_context_t p_context)
+{
+	buffered_writer_free(&p_context->writer);
+	hid_export_layout_free(&p_context->layout);
+	free(p_context);
+}
+
+void hid_export_format_name(USAGE usage_page, USAGE usage, USAGE usage_max,
+		bool is_button, char * p_name, size_t name_size)
+{
+	char text[HID_EXPORT_FIELD_NAME_SIZE];
+
+	if (0 == name_size)
+	{
+		return;
+	}
+	p_name[0] = '\0';
+
+	if (is_button && (usage != usage_max))
+	{
+		char const *p_page_name = hid_usage_page_name(usage_page);
+
+		if (NULL != p_page_name)
+		{
+			append_identifier(p_page_name, p_name, name_size);
+		}
+		else
+		{
+			_snprintf(text, sizeof(text), "Page 0x%04x", usage_page);
+			append_identifier(text, p_name, name_size);
+		}
+
+		_snprintf(text, sizeof(text), "_%u_%u", usage, usage_max);
+	}
+	else
+	{
+		hid_usage_format(usage_page, usage, text, sizeof(text));
+	}
+
+	// _snprintf() does not terminate a text it truncates
+	text[sizeof(text) - 1] = '\0';
+	append_identifier(text, p_name, name_size);
+}
+
+bool hid_export_layout_init(phid_export_layout_t p_layout,
+		hid_export_format_t format, uint16_t vendor_id, uint16_t product_id,
+		hid_capture_field_t const * p_fields, size_t field_count)
+{
+	size_t index;
+
+	memset(p_layout, 0, sizeof(hid_export_layout_t));
+
+	p_layout->format = format;
+
+	_snprintf(p_layout->device, sizeof(p_layout->device), "%04x:%04x",
+			vendor_id, product_id);
+
+	if (0 == field_count)
+	{
+		return (true);
+	}
+
+	p_layout->p_fields = (phid_export_field_t) calloc(field_count,
+			sizeof(hid_export_field_t));
+	if (NULL == p_layout->p_fields)
+	{
+		return (false);
+	}
+	p_layout->field_count = field_count;
+
+	for (index = 0; index < field_count; index++)
+	{
+		p_layout->p_fields[index].field = p_fields[index];
+	}
+
+	if (!name_fields(p_layout))
+	{
+		hid_export_layout_free(p_layout);
+		return (false);
+	}
+
+	return (true);
+}
+
+void hid_export_layout_free(phid_export_layout_t p_layout)
+{
+	free(p_layout->p_fields);
+	p_layout->p_fields = NULL;
+	p_layout->field_count = 0;
+}
+
+void hid_export_write_header(phid_export_layout_t const p_layout,
+		pbuffered_writer_t p_writer)
+{
+	size_t index;
+
+	if (HID_EXPORT_FORMAT_NONE == p_layout->format)
+	{
+		return;
+	}
+
+	if (p_layout->is_metadata)
+	{
+		write_metadata(p_layout, p_writer);
+	}
+
+	if (HID_EXPORT_FORMAT_CSV != p_layout->format)
+	{
+		return;
+	}
+
+	buffered_writer_puts(p_writer, "timestamp_us,device,report_id");
+
+	for (index = 0; index < p_layout->field_count; index++)
+	{
+		buffered_writer_putc(p_writer, ',');
+		buffered_writer_puts(p_writer, p_layout->p_fields[index].name);
+	}
+
+	buffered_writer_putc(p_writer, '\n');
+}
+
+void hid_export_write_record(phid_export_layout_t const p_layout,
+		pbuffered_writer_t p_writer, uint64_t timestamp_us,
+		uint8_t const * p_report_buffer, size_t report_buffer_length)
+{
+	uint8_t report_id;
+	size_t index;
+
+	if (0 == report_buffer_length)
+	{
+		return;
+	}
+	report_id = p_report_buffer[0];
+
+	if (HID_EXPORT_FORMAT_JSON == p_layout->format)
+	{
+		bool is_first = true;
+
+		buffered_writer_puts(p_writer, "{\"timestamp_us\":");
+		buffered_writer_put_uint(p_writer, timestamp_us);
+		buffered_writer_puts(p_writer, ",\"device\":\"");
+		buffered_writer_puts(p_writer, p_layout->device);
+		buffered_writer_puts(p_writer, "\",\"report_id\":");
+		buffered_writer_put_uint(p_writer, report_id);
+		buffered_writer_puts(p_writer, ",\"fields\":{");
+
+		for (index = 0; index < p_layout->field_count; index++)
+		{
+			phid_export_field_t p_field = &p_layout->p_fields[index];
+
+			if (report_id != p_field->field.report_id)
+			{
+				continue;
+			}
+
+			if (!is_first)
+			{
+				buffered_writer_putc(p_writer, ',');
+			}
+			is_first = false;
+
+			buffered_writer_putc(p_writer, '"');
+			buffered_writer_puts(p_writer, p_field->name);
+			buffered_writer_puts(p_writer, "\":");
+			write_field_value(p_layout, p_writer, &p_field->field,
+					p_report_buffer, report_buffer_length);
+		}
+
+		buffered_writer_puts(p_writer, "}}\n");
+	}
+	else
+	{
+		buffered_writer_put_uint(p_writer, timestamp_us);
+		buffered_writer_putc(p_writer, ',');
+		buffered_writer_puts(p_writer, p_layout->device);
+		buffered_writer_putc(p_writer, ',');
+		buffered_writer_put_uint(p_writer, report_id);
+
+		// Every row has every column, fields of other report IDs stay empty
+		for (index = 0; index < p_layout->field_count; index++)
+		{
+			hid_capture_field_t const * p_field =
+					&p_layout->p_fields[index].field;
+
+			buffered_writer_putc(p_writer, ',');
+			if (report_id == p_field->report_id)
+			{
+				write_field_value(p_layout, p_writer, p_field,
+						p_report_buffer, report_buffer_length);
+			}
+		}
+
+		buffered_writer_putc(p_writer, '\n');
+	}
+}
+
+HANDLE hid_export_create(FILE * p_file, hid_export_format_t format,
+		bool is_metadata, phid_device_t p_hid_device,
+		hid_report_type_t report_type)
+{
+	phid_export_context_t p_context;
+	phid_capture_field_t p_fields;
+	phid_report_t p_report;
+	size_t field_count;
+	bool success;
+
+	if ((NULL == p_file) || (NULL == p_hid_device)
+			|| (HID_EXPORT_FORMAT_NONE == format)
+			|| (report_type >= HID_REPORT_TYPE_SIZE))
+	{
+		return (NULL);
+	}
+
+	p_context = (phid_export_context_t) calloc(1,
+			sizeof(hid_export_context_t));
+	if (NULL == p_context)
+	{
+		return (NULL);
+	}
+
+	p_report = &p_hid_device->report[report_type];
+	p_context->p_report = p_report;
+
+	// The fields a capture of the report would describe
+	p_fields = get_report_fields(p_report, &field_count);
+	if ((field_count > 0) && (NULL == p_fields))
+	{
+		free(p_context);
+		return (NULL);
+	}
+
+	success = buffered_writer_init(&p_context->writer, p_file,
+			BUFFERED_WRITER_DEFAULT_SIZE)
+			&& hid_export_layout_init(&p_context->layout, format,
+					p_hid_device->attributes.VendorID,
+					p_hid_device->attributes.ProductID, p_fields, field_count);
+	free(p_fields);
+
+	if (!success)
+	{
+		free_export(p_context);
+		return (NULL);
+	}
+
+	// Taken from the strings cache, the HID is asked only if not yet known
+	p_context->layout.is_metadata = is_metadata;
+	if (is_metadata)
+	{
+		hid_strings_get(p_hid_device->p_device_path, HID_STRING_PRODUCT,
+				p_context->layout.product, sizeof(p_context->layout.product));
+		hid_strings_get(p_hid_device->p_device_path, HID_STRING_SERIAL_NUMBER,
+				p_context->layout.serial_number,
+				sizeof(p_context->layout.serial_number));
+	}
+
+	hid_export_write_header(&p_context->layout, &p_context->writer);
+	buffered_writer_flush(&p_context->writer);
+
+	return ((HANDLE) p_context);
+}
+
+bool hid_export_report(HANDLE h_export)
+{
+	phid_export_context_t p_context = (phid_export_context_t) h_export;
+	pbuffered_writer_t p_writer;
+	phid_report_t p_report;
+
+	if ((NULL == p_context)
+			|| (NULL == p_context->p_report->p_report_buffer))
+	{
+		return (false);
+	}
+
+	p_writer = &p_context->writer;
+	p_report = p_context->p_report;
+
+	hid_export_write_record(&p_context->layout, p_writer,
+			p_report->timestamp_us, (uint8_t const *) p_report->p_report_buffer,
+			p_report->report_buffer_length);
+
+	// Keep a live consumer fed without handing over every single record
+	if ((p_report->timestamp_us - p_context->last_flush_us)
+			>= HID_EXPORT_FLUSH_INTERVAL_US)
+	{
+		buffered_writer_flush(p_writer);
+		p_context->last_flush_us = p_report->timestamp_us;
+	}
+
+	return (!p_writer->is_error);
+}
+
+bool hid_export_rebind(HANDLE h_export)
+{
+	phid_export_context_t p_context = (phid_export_context_t) h_export;
+	phid_capture_field_t p_fields;
+	size_t field_count;
+	size_t index;
+	bool is_same;
+
+	if (NULL == p_context)
+	{
+		return (false);
+	}
+
+	// The records must keep their fields, where in the report they live
+	// included
+	p_fields = get_report_fields(p_context->p_report, &field_count);
+	is_same = (field_count == p_context->layout.field_count)
+			&& ((0 == field_count) || (NULL != p_fields));
+
+	for (index = 0; is_same && (index < field_count); index++)
+	{
+		is_same = (0 == memcmp(&p_fields[index],
+				&p_context->layout.p_fields[index].field,
+				sizeof(hid_capture_field_t)));
+	}
+
+	free(p_fields);
+
+	return (is_same);
+}
+
+bool hid_export_flush(HANDLE h_export)
+{
+	phid_export_context_t p_context = (phid_export_context_t) h_export;
+
+	if (NULL == p_context)
+	{
+		return (false);
+	}
+
+	return (buffered_writer_flush(&p_context->writer));
+}
+
+void hid_export_destroy(HANDLE h_export)
+{
+	phid_export_context_t p_context = (phid_export_context_t) h_export;
+
+	if (NULL == p_context)
+	{
+		return;
+	}
+
+	free_export(p_context);
+}
@@ -0,0 +1,326 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_export.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_EXPORT_H_
+#define USB_HID_EXPORT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_export
+
+ \brief These APIs stream decoded HID reports as structured records (JSON
+ Lines or CSV) for consumption by other tools.
+ */
+/* ************************************************************************* */
+
+typedef enum _hid_export_format_t
+{
+	HID_EXPORT_FORMAT_NONE, // No structured output
+	HID_EXPORT_FORMAT_JSON, // One JSON object per line and report
+	HID_EXPORT_FORMAT_CSV // A header line followed by one row per report
+
+} hid_export_format_t;
+
+// Pending records are handed to the stream at least this often (in usec)
+#define HID_EXPORT_FLUSH_INTERVAL_US	(250 * 1000)
+
+// Room for the longest field name (prefix, usage name and suffix included)
+#define HID_EXPORT_FIELD_NAME_SIZE		(64)
+
+// Room for a string of the HID in the metadata (longer ones are cut short)
+#define HID_EXPORT_STRING_SIZE			(128)
+
+/*
+
+ The live export and the offline decoder of captures write the same records.
+ Both lay out their records from the same capture field table (see
+ hid_capture_fill_fields()), which the live export builds from the HID's
+ plans and the decoder reads from the capture, and both extract the values
+ from the raw report with hid_export_write_record(). A report therefore
+ makes the same record whether it is exported live or decoded later.
+
+ */
+
+typedef struct _hid_export_field_t
+{
+	hid_capture_field_t field; // Where the field lives within its report
+
+	char name[HID_EXPORT_FIELD_NAME_SIZE]; // Unique within its report ID
+
+} hid_export_field_t, *phid_export_field_t;
+
+typedef struct _hid_export_layout_t
+{
+	hid_export_format_t format;
+	bool is_metadata; // Precede the records with the metadata
+
+	// "VVVV:PPPP" identifying the HID
+	char device[10];
+
+	// Strings of the HID for the metadata (empty if unknown)
+	char product[HID_EXPORT_STRING_SIZE];
+	char serial_number[HID_EXPORT_STRING_SIZE];
+
+	phid_export_field_t p_fields; // array of fields
+	size_t field_count; // Number elements in this array.
+
+} hid_export_layout_t, *phid_export_layout_t;
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Creates an exporter for the reports of the given type.
+
+ \param[in] p_file - The stream to write records to.
+ \param[in] format - The record format.
+ \param[in] is_metadata - Precede the records with the metadata.
+ \param[in] p_hid_device - A pointer to the HID whose reports are exported.
+ \param[in] report_type - The report type (input, output, feature) exported.
+
+ \return A handle to the exporter or NULL on failure.
+
+ The fields are those hid_capture_fill_fields() finds in the HID's plans,
+ so fields no plan describes (e.g. button arrays) are not exported. Their
+ names are derived once, see hid_export_format_name(). Fields sharing a name
+ within a report ID (e.g. the X and Y of every contact of a digitizer) are
+ told apart by their ordinal within the report ID, as in "x_2". CSV column
+ names are prefixed with "rN_" when the report type carries more than one
+ report ID.
+
+ For CSV the header line is written immediately, so it is always the first
+ line. Only when asked for, the metadata precedes it: a line identifying the
+ HID by its IDs, product string and serial number, as a "# device: ..."
+ comment line for CSV and as a first line of the form
+ {"metadata":{"device":...,"product":...,"serial_number":...}} for JSON.
+ Consumers expecting the header or a record on every line must not ask for
+ it.
+
+ */
+/* ************************************************************************** */
+
+HANDLE hid_export_create(FILE * p_file, hid_export_format_t format,
+		bool is_metadata, phid_device_t p_hid_device,
+		hid_report_type_t report_type);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Exports the report currently held in the report buffer.
+
+ \param[in] h_export - A handle to the exporter.
+
+ \return Indicates if the record was written successfully.
+
+ The report ID is taken from the first byte of the report buffer and the
+ timestamp from the report's timestamp_us. Only the fields of that report ID
+ are written, extracted from the report buffer itself. Records are
+ buffered and handed to the stream when the buffer fills or once
+ HID_EXPORT_FLUSH_INTERVAL_US has passed since the last hand off.
+
+ */
+/* ************************************************************************** */
+
+bool hid_export_report(HANDLE h_export);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Hands all buffered records to the stream.
+
+ \param[in] h_export - A handle to the exporter.
+
+ \return Indicates if all records were written successfully.
+
+ */
+/* ************************************************************************** */
+
+bool hid_export_flush(HANDLE h_export);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Binds the exporter to its HID again after the HID was closed and
+ reopened in place.
+
+ \param[in] h_export - A handle to the exporter.
+
+ \return Indicates if the reopened HID's plans describe the same fields.
+
+ */
+/* ************************************************************************** */
+
+bool hid_export_rebind(HANDLE h_export);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Formats the name of a field from the HID Usage Tables.
+
+ \param[in] usage_page - The usage page of the field.
+ \param[in] usage - The value usage (or usage minimum for buttons).
+ \param[in] usage_max - The usage maximum (buttons only).
+ \param[in] is_button - Indicates if the field is a bitmap of buttons.
+ \param[out] p_name - Receives the name.
+ \param[in] name_size - The size of p_name.
+
+ Names are the usage names in lower case with anything but letters and
+ digits replaced by '_', so they need no quoting in JSON or CSV (e.g. "x" or
+ "keyboard_a_and_a"). A range of buttons is named after its usage page and
+ usage range (e.g. "button_1_8").
+
+ */
+/* ************************************************************************** */
+
+void hid_export_format_name(USAGE usage_page, USAGE usage, USAGE usage_max,
+		bool is_button, char * p_name, size_t name_size);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Prepares the layout of records from a capture field table.
+
+ \param[in,out] p_layout - The layout to prepare.
+ \param[in] format - The record format.
+ \param[in] vendor_id - The Vendor-Id of the HID the records describe.
+ \param[in] product_id - The Product-Id of the HID the records describe.
+ \param[in] p_fields - The fields of the records (see
+ hid_capture_fill_fields()).
+ \param[in] field_count - Number elements in p_fields.
+
+ \return Indicates if the layout was prepared.
+
+ The fields are copied and named as hid_export_create() describes.
+
+ */
+/* ************************************************************************** */
+
+bool hid_export_layout_init(phid_export_layout_t p_layout,
+		hid_export_format_t format, uint16_t vendor_id, uint16_t product_id,
+		hid_capture_field_t const * p_fields, size_t field_count);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Releases the fields of a layout.
+
+ \param[in,out] p_layout - The layout.
+
+ */
+/* ************************************************************************** */
+
+void hid_export_layout_free(phid_export_layout_t p_layout);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Writes what precedes the records (the metadata if the layout asks
+ for it and the CSV header line).
+
+ \param[in] p_layout - The layout of the records.
+ \param[in,out] p_writer - The writer receiving the text.
+
+ */
+/* ************************************************************************** */
+
+void hid_export_write_header(phid_export_layout_t const p_layout,
+		struct _buffered_writer_t * p_writer);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Writes the record of a report.
+
+ \param[in] p_layout - The layout of the records.
+ \param[in,out] p_writer - The writer receiving the text.
+ \param[in] timestamp_us - When the report was received.
+ \param[in] p_report_buffer - The raw report (report ID in byte 0).
+ \param[in] report_buffer_length - Size of the report.
+
+ Buttons are written as the list of pressed usages and values as their
+ logical value, sign extended when the logical minimum is negative. Fields beyond a short report are null (JSON) or empty (CSV).
+ Nothing is written for an empty report.
+
+ */
+/* ************************************************************************** */
+
+void hid_export_write_record(phid_export_layout_t const p_layout,
+		struct _buffered_writer_t * p_writer, uint64_t timestamp_us,
+		uint8_t const * p_report_buffer, size_t report_buffer_length);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_export
+
+ \brief Flushes and destroys an exporter. The stream is not closed.
+
+ \param[in] h_export - A handle to the exporter.
+
+ */
+/* ************************************************************************** */
+
+void hid_export_destroy(HANDLE h_export);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_EXPORT_H_ */
@@ -57,12 +57,9 @@
 
 // Other includes
 #include "output.h"
-#include "hexdump.h"
 #include "utils.h"
 #include "usb_defs.h"
 #include "usb_hid.h"
-#include "usb_debug.h"
-#include "usb_hid_reader.h"
 #include "win_msg_hdlr.h"
 #include "win_device_notification.h"
 
@@ -79,52 +76,6 @@ bool hid_msg_hdlr(p_win_proc_msg_context_t p_context)
 
 	switch (p_args->message)
 	{
-	case WM_DISPLAY_READ_DATA:
-	{
-		static char buffer[1024];
-		phid_data_t p_hid_data;
-		size_t loop;
-		phid_device_t p_hid_device;
-
-		Message("WM_DISPLAY_READ_DATA", p_context->msg_count);
-
-		//
-		// LParam is the device that was read from
-		//
-
-		p_hid_device = (phid_device_t) p_args->lParam;
-
-		//
-		// Display all the data stored in the Input data field for the device
-		//
-
-//		if ((pParams->msg_count % 50) == 0)
-		{
-			phid_report_t p_report =
-					&p_hid_device->report[HID_REPORT_TYPE_INPUT];
-
-			p_hid_data = p_report->p_hid_data;
-
-			hex_dump(stdout, NULL, (uint8_t const *) p_report->p_report_buffer,
-					p_report->report_buffer_length);
-
-			for (loop = 0; loop < p_report->hid_data_length; loop++)
-			{
-				usb_print_hid_report(p_hid_data, buffer, sizeof(buffer));
-				printf("::\t%s\n", buffer);
-				p_hid_data++;
-			}
-		}
-		usb_hid_read_handled(p_hid->h_reader);
-
-	}
-
-		break;
-	case WM_READ_THREAD_TERMINATED:
-		Message("WM_READ_THREAD_TERMINATED", p_context->msg_count);
-		usb_hid_destroy_reader(p_hid->h_reader);
-		break;
-
 	case WM_CREATE:
 	{
 		GUID guid;
@@ -144,10 +95,6 @@ bool hid_msg_hdlr(p_win_proc_msg_context_t p_context)
 			ExitProcess(1);
 		}
 		printf("Registered for HID-USB device notifications.\n");
-
-		// Create reader thread
-		p_hid->h_reader = usb_hid_create_reader(p_args->hWnd,
-				p_hid->p_hid_device);
 	}
 		break;
 
@@ -170,6 +117,7 @@ bool hid_msg_hdlr(p_win_proc_msg_context_t p_context)
 		{
 		case DBT_DEVICEARRIVAL:
 			Message("DBT_DEVICEARRIVAL", p_context->msg_count);
+			p_hid->is_arrival = true;
 			break;
 		case DBT_DEVICEREMOVECOMPLETE:
 			Message("DBT_DEVICEREMOVECOMPLETE", p_context->msg_count);
@@ -187,7 +135,6 @@ bool hid_msg_hdlr(p_win_proc_msg_context_t p_context)
 	{
 		BOOL success;
 		Message("WM_CLOSE", p_context->msg_count);
-		usb_hid_stop_reader(p_hid->h_reader);
 		success = UnregisterDeviceNotification(p_hid->h_device_notify);
 		if (!success)
 		{
@@ -56,7 +56,7 @@ extern "C"
 /*!
  \defgroup usb_hid_msg_hdlr
 
- \brief These APIs are used to process HID messages
+ \brief These APIs are used to process the HID notification window messages
  */
 /* ************************************************************************* */
 
@@ -68,8 +68,20 @@ typedef struct _hid_handler_context_t
 	// HID-Device
 	phid_device_t p_hid_device;
 
-	// HID-Reader
-	HANDLE h_reader;
+	// HID report exporter (NULL for the human readable output)
+	HANDLE h_export;
+
+	// HID report capture writer (NULL for none)
+	HANDLE h_capture;
+
+	// Selects the HID again when it returns after being removed
+	hid_filter_t filter;
+
+	// Plans of the HIDs opened so far (NULL for none)
+	HANDLE h_plan_cache;
+
+	// Set when a HID arrived since last cleared
+	bool is_arrival;
 
 } hid_handler_context_t, *p_hid_handler_context_t;
 
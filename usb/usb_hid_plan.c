@@ -0,0 +1,1289 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_plan.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "cache_path.h"
+#include "fnv1a.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+
+// Module include
+#include "usb_hid_plan.h"
+
+// Local declarations
+
+// Bit 1 of a main item's data distinguishes Variable (1) from Array (0)
+#define HID_MAIN_ITEM_VARIABLE		(0x02)
+
+// Number of plans a cache first makes room for
+#define CACHE_INITIAL_CAPACITY		(16)
+
+typedef struct _plan_cache_entry_t
+{
+	uint64_t layout_hash; // hid_plan_layout_hash() of the HID
+	uint8_t report_type;
+	uint8_t report_id;
+
+	phid_plan_t p_plan; // NULL if no plan could be compiled
+
+} plan_cache_entry_t, *pplan_cache_entry_t;
+
+typedef struct _plan_cache_t
+{
+	pplan_cache_entry_t p_entries;
+	size_t entry_count;
+	size_t capacity;
+
+	bool is_dirty; // Plans were compiled since the cache was loaded
+
+} plan_cache_t, *pplan_cache_t;
+
+/*
+
+ A plan cache file is a cache_file_header_t followed by entry_count entries,
+ each a cache_file_entry_t immediately followed by its field_count
+ cache_file_field_t. An entry without fields records that no plan could be
+ compiled. All integers are stored little-endian.
+
+ */
+
+#define CACHE_FILE_MAGIC			"HIDPLAN"
+#define CACHE_FILE_VERSION			(1)
+
+// Name of the cache file within its directory
+#define CACHE_FILE_NAME				"plans.cache"
+
+__PACKED__
+
+typedef struct _cache_file_header_t
+{
+	char magic[8]; // CACHE_FILE_MAGIC padded with zeros
+	uint16_t version; // CACHE_FILE_VERSION
+	uint16_t reserved;
+	uint32_t entry_count;
+
+} cache_file_header_t;
+
+typedef struct _cache_file_entry_t
+{
+	uint64_t layout_hash;
+	uint8_t report_type;
+	uint8_t report_id;
+	uint16_t report_length;
+	uint16_t field_count; // 0 if no plan could be compiled
+	uint16_t library_field_count;
+
+} cache_file_entry_t;
+
+typedef struct _cache_file_field_t
+{
+	uint8_t type;
+	uint8_t reserved;
+	uint16_t data_index;
+
+	uint16_t bit_offset;
+	uint16_t bit_size;
+	uint16_t count;
+
+	uint16_t usage_page;
+	uint16_t usage;
+	uint16_t usage_max;
+
+	int32_t logical_min;
+	int32_t logical_max;
+	int32_t physical_min;
+	int32_t physical_max;
+
+} cache_file_field_t;
+
+__UNPACKED__
+
+COMPILE_TIME_ASSERT(sizeof(cache_file_header_t) == 16,
+		cache_file_header_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(cache_file_entry_t) == 16,
+		cache_file_entry_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(cache_file_field_t) == 32,
+		cache_file_field_t_is_wrong_size);
+
+static void insert_bits(uint8_t * p_buffer, size_t bit_offset,
+		size_t bit_size, uint32_t value);
+
+static bool find_bit_run(uint8_t const * p_buffer, size_t length,
+		size_t * p_first, size_t * p_count);
+
+static uint32_t clamp_value(phid_plan_field_t const p_field, uint32_t value);
+
+static bool probe_value(HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		PHIDP_VALUE_CAPS const p_caps, USAGE usage,
+		PHIDP_PREPARSED_DATA const p_ppd, uint8_t * p_scratch, size_t length,
+		phid_plan_field_t p_field);
+
+static bool probe_button(HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		USAGE usage_page, USAGE usage, PHIDP_PREPARSED_DATA const p_ppd,
+		uint8_t * p_scratch, size_t length, size_t * p_bit);
+
+static bool probe_buttons(HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		PHIDP_BUTTON_CAPS const p_caps, PHIDP_PREPARSED_DATA const p_ppd,
+		uint8_t * p_scratch, size_t length, phid_plan_field_t p_field);
+
+static phid_plan_t copy_plan(phid_plan_t const p_plan);
+
+static bool plan_fits(phid_plan_t const p_plan, phid_report_t const p_report,
+		uint8_t report_id);
+
+static pplan_cache_entry_t find_entry(pplan_cache_t p_cache,
+		uint64_t layout_hash, uint8_t report_type, uint8_t report_id);
+
+static bool add_entry(pplan_cache_t p_cache, uint64_t layout_hash,
+		uint8_t report_type, uint8_t report_id, phid_plan_t p_plan);
+
+static bool load_entries(pplan_cache_t p_cache, uint8_t const * p_data,
+		size_t length);
+
+static bool save_entries(pplan_cache_t p_cache, FILE * p_file);
+
+// Implementation
+
+static void insert_bits(uint8_t * p_buffer, size_t bit_offset,
+		size_t bit_size, uint32_t value)
+{
+	// HID reports are packed least significant bit first
+	while (bit_size > 0)
+	{
+		size_t byte_index = bit_offset >> 3;
+		size_t shift = bit_offset & 7;
+		size_t bits = 8 - shift;
+		uint8_t mask;
+
+		if (bits > bit_size)
+		{
+			bits = bit_size;
+		}
+
+		mask = (uint8_t) (((1u << bits) - 1) << shift);
+		p_buffer[byte_index] = (uint8_t) ((p_buffer[byte_index] & ~mask)
+				| ((value << shift) & mask));
+
+		value >>= bits;
+		bit_offset += bits;
+		bit_size -= bits;
+	}
+}
+
+static bool find_bit_run(uint8_t const * p_buffer, size_t length,
+		size_t * p_first, size_t * p_count)
+{
+	size_t bit;
+	size_t first = 0;
+	size_t last = 0;
+	size_t count = 0;
+
+	// The first byte holds the report ID, not data
+	for (bit = 8; bit < (length * 8); bit++)
+	{
+		if (p_buffer[bit >> 3] & (1u << (bit & 7)))
+		{
+			if (0 == count)
+			{
+				first = bit;
+			}
+			last = bit;
+			count++;
+		}
+	}
+
+	// Only a single contiguous run of bits describes a field
+	if ((0 == count) || ((last - first + 1) != count))
+	{
+		return (false);
+	}
+
+	*p_first = first;
+	*p_count = count;
+
+	return (true);
+}
+
+static uint32_t clamp_value(phid_plan_field_t const p_field, uint32_t value)
+{
+	// A reversed range is left alone, the value is merely truncated
+	if (p_field->logical_min > p_field->logical_max)
+	{
+		return (value);
+	}
+
+	if (p_field->logical_min < 0)
+	{
+		int32_t signed_value;
+
+		// Raw values are not sign extended, so the field's top bit is the sign
+		if ((p_field->bit_size > 0) && (p_field->bit_size < 32))
+		{
+			uint32_t sign_bit = 1UL << (p_field->bit_size - 1);
+
+			value &= (sign_bit << 1) - 1;
+			value = (value ^ sign_bit) - sign_bit;
+		}
+		signed_value = (int32_t) value;
+
+		if (signed_value < p_field->logical_min)
+		{
+			signed_value = p_field->logical_min;
+		}
+		else if (signed_value > p_field->logical_max)
+		{
+			signed_value = p_field->logical_max;
+		}
+
+		value = (uint32_t) signed_value;
+	}
+	else
+	{
+		if (value < (uint32_t) p_field->logical_min)
+		{
+			value = (uint32_t) p_field->logical_min;
+		}
+		else if (value > (uint32_t) p_field->logical_max)
+		{
+			value = (uint32_t) p_field->logical_max;
+		}
+	}
+
+	return (value);
+}
+
+static bool probe_value(HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		PHIDP_VALUE_CAPS const p_caps, USAGE usage,
+		PHIDP_PREPARSED_DATA const p_ppd, uint8_t * p_scratch, size_t length,
+		phid_plan_field_t p_field)
+{
+	NTSTATUS status;
+	ULONG all_ones;
+	size_t first;
+	size_t count;
+	size_t lsb;
+
+	if ((0 == p_caps->BitSize) || (p_caps->BitSize > 32))
+	{
+		return (false);
+	}
+
+	// A field holds one value, more are a usage value array
+	if (p_caps->ReportCount > 1)
+	{
+		return (false);
+	}
+
+	all_ones = (32 == p_caps->BitSize) ?
+			0xFFFFFFFFUL : ((1UL << p_caps->BitSize) - 1);
+
+	// Setting every bit of the value reveals where the field lives
+	memset(p_scratch, 0, length);
+	p_scratch[0] = report_id;
+
+	status = HidP_SetUsageValue(report_type, p_caps->UsagePage,
+			0, // All Collections.
+			usage, all_ones, p_ppd, (PCHAR) p_scratch, length);
+	if ((HIDP_STATUS_SUCCESS != status)
+			|| !find_bit_run(p_scratch, length, &first, &count)
+			|| (count != p_caps->BitSize) || (first > UINT16_MAX))
+	{
+		return (false);
+	}
+
+	// Setting just the lowest bit confirms the bit order
+	memset(p_scratch, 0, length);
+	p_scratch[0] = report_id;
+
+	status = HidP_SetUsageValue(report_type, p_caps->UsagePage,
+			0, // All Collections.
+			usage, 1, p_ppd, (PCHAR) p_scratch, length);
+	if ((HIDP_STATUS_SUCCESS != status)
+			|| !find_bit_run(p_scratch, length, &lsb, &count) || (1 != count)
+			|| (lsb != first))
+	{
+		return (false);
+	}
+
+	p_field->type = HID_PLAN_FIELD_VALUE;
+	p_field->bit_offset = (uint16_t) first;
+	p_field->bit_size = p_caps->BitSize;
+	p_field->count = 1;
+	p_field->logical_min = p_caps->LogicalMin;
+	p_field->logical_max = p_caps->LogicalMax;
+	p_field->physical_min = p_caps->PhysicalMin;
+	p_field->physical_max = p_caps->PhysicalMax;
+
+	return (true);
+}
+
+static bool probe_button(HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		USAGE usage_page, USAGE usage, PHIDP_PREPARSED_DATA const p_ppd,
+		uint8_t * p_scratch, size_t length, size_t * p_bit)
+{
+	NTSTATUS status;
+	ULONG num_usages = 1;
+	size_t count;
+
+	memset(p_scratch, 0, length);
+	p_scratch[0] = report_id;
+
+	status = HidP_SetUsages(report_type, usage_page,
+			0, // All collections
+			&usage, &num_usages, p_ppd, (PCHAR) p_scratch, length);
+
+	return ((HIDP_STATUS_SUCCESS == status)
+			&& find_bit_run(p_scratch, length, p_bit, &count) && (1 == count));
+}
+
+static bool probe_buttons(HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		PHIDP_BUTTON_CAPS const p_caps, PHIDP_PREPARSED_DATA const p_ppd,
+		uint8_t * p_scratch, size_t length, phid_plan_field_t p_field)
+{
+	size_t bit_min;
+	size_t bit;
+	uint32_t usage;
+
+	// Button arrays hold usage indices rather than bits and stay in the library
+	if (!(p_caps->BitField & HID_MAIN_ITEM_VARIABLE))
+	{
+		return (false);
+	}
+
+	if ((p_field->usage_max < p_field->usage)
+			|| !probe_button(report_type, report_id, p_field->usage_page,
+					p_field->usage, p_ppd, p_scratch, length, &bit_min))
+	{
+		return (false);
+	}
+
+	// The bitmap must be laid out one bit per usage in usage order, which
+	// only probing every usage shows (a range may skip or reorder bits)
+	for (usage = p_field->usage + 1; usage <= p_field->usage_max; usage++)
+	{
+		if (!probe_button(report_type, report_id, p_field->usage_page,
+				(USAGE) usage, p_ppd, p_scratch, length, &bit)
+				|| (bit != bit_min + (usage - p_field->usage)))
+		{
+			return (false);
+		}
+	}
+
+	bit = bit_min + (p_field->usage_max - p_field->usage);
+	if (bit > UINT16_MAX)
+	{
+		return (false);
+	}
+
+	p_field->type = HID_PLAN_FIELD_BUTTONS;
+	p_field->bit_offset = (uint16_t) bit_min;
+	p_field->bit_size = 1;
+	p_field->count = (uint16_t) (bit - bit_min + 1);
+	p_field->logical_min = 0;
+	p_field->logical_max = 1;
+
+	return (true);
+}
+
+phid_plan_t hid_plan_compile(phid_report_t const p_report,
+		HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		PHIDP_PREPARSED_DATA const p_ppd)
+{
+	phid_plan_t p_plan;
+	uint8_t *p_scratch;
+	PHIDP_BUTTON_CAPS p_button_caps;
+	PHIDP_VALUE_CAPS p_value_caps;
+	size_t data_index;
+	size_t index;
+
+	if ((0 == p_report->report_buffer_length) || (NULL == p_report->p_hid_data)
+			|| (0 == p_report->hid_data_length))
+	{
+		return (NULL);
+	}
+
+	p_plan = (phid_plan_t) calloc(1, sizeof(hid_plan_t));
+	p_scratch = (uint8_t *) malloc(p_report->report_buffer_length);
+	if ((NULL == p_plan) || (NULL == p_scratch))
+	{
+		free(p_plan);
+		free(p_scratch);
+		return (NULL);
+	}
+
+	// There is never more than one field per data element
+	p_plan->p_fields = (phid_plan_field_t) calloc(p_report->hid_data_length,
+			sizeof(hid_plan_field_t));
+	if (NULL == p_plan->p_fields)
+	{
+		free(p_plan);
+		free(p_scratch);
+		return (NULL);
+	}
+
+	p_plan->report_id = report_id;
+	p_plan->report_length = p_report->report_buffer_length;
+
+	/*
+
+	 Walk the capabilities in the same order fill_hid_info() expanded them
+	 into hid_data_t elements: one element per button caps followed by one
+	 element per value usage.
+
+	 */
+
+	data_index = 0;
+	p_button_caps = p_report->p_button_caps;
+	for (index = 0; index < p_report->number_button_caps;
+			index++, p_button_caps++, data_index++)
+	{
+		phid_plan_field_t p_field;
+
+		if (p_button_caps->ReportID != report_id)
+		{
+			continue;
+		}
+
+		p_field = &p_plan->p_fields[p_plan->field_count++];
+		p_field->data_index = data_index;
+		p_field->usage_page = p_button_caps->UsagePage;
+		if (p_button_caps->IsRange)
+		{
+			p_field->usage = p_button_caps->Range.UsageMin;
+			p_field->usage_max = p_button_caps->Range.UsageMax;
+		}
+		else
+		{
+			p_field->usage = p_field->usage_max =
+					p_button_caps->NotRange.Usage;
+		}
+
+		if (!probe_buttons(report_type, report_id, p_button_caps, p_ppd,
+				p_scratch, p_report->report_buffer_length, p_field))
+		{
+			p_field->type = HID_PLAN_FIELD_LIBRARY;
+			p_plan->library_field_count++;
+		}
+	}
+
+	p_value_caps = p_report->p_value_caps;
+	for (index = 0; index < p_report->number_value_caps;
+			index++, p_value_caps++)
+	{
+		uint32_t usage_min;
+		uint32_t usage_max;
+		uint32_t usage;
+
+		if (p_value_caps->IsRange)
+		{
+			usage_min = p_value_caps->Range.UsageMin;
+			usage_max = p_value_caps->Range.UsageMax;
+		}
+		else
+		{
+			usage_min = usage_max = p_value_caps->NotRange.Usage;
+		}
+
+		for (usage = usage_min; usage <= usage_max; usage++, data_index++)
+		{
+			phid_plan_field_t p_field;
+
+			if (data_index >= p_report->hid_data_length)
+			{
+				hid_plan_free(p_plan);
+				free(p_scratch);
+				return (NULL); // error case
+			}
+
+			if (p_value_caps->ReportID != report_id)
+			{
+				continue;
+			}
+
+			p_field = &p_plan->p_fields[p_plan->field_count++];
+			p_field->data_index = data_index;
+			p_field->usage_page = p_value_caps->UsagePage;
+			p_field->usage = p_field->usage_max = (USAGE) usage;
+
+			if (!probe_value(report_type, report_id, p_value_caps,
+					(USAGE) usage, p_ppd, p_scratch,
+					p_report->report_buffer_length, p_field))
+			{
+				p_field->type = HID_PLAN_FIELD_LIBRARY;
+				p_plan->library_field_count++;
+			}
+		}
+	}
+
+	free(p_scratch);
+
+	// A plan made of library fields only gains nothing over the library
+	if (p_plan->library_field_count == p_plan->field_count)
+	{
+		hid_plan_free(p_plan);
+		return (NULL);
+	}
+
+	return (p_plan);
+}
+
+static phid_plan_t copy_plan(phid_plan_t const p_plan)
+{
+	phid_plan_t p_copy;
+
+	if (NULL == p_plan)
+	{
+		return (NULL);
+	}
+
+	p_copy = (phid_plan_t) malloc(sizeof(hid_plan_t));
+	if (NULL == p_copy)
+	{
+		return (NULL);
+	}
+
+	*p_copy = *p_plan;
+	p_copy->p_fields = (phid_plan_field_t) malloc(
+			p_plan->field_count * sizeof(hid_plan_field_t));
+	if (NULL == p_copy->p_fields)
+	{
+		free(p_copy);
+		return (NULL);
+	}
+
+	memcpy(p_copy->p_fields, p_plan->p_fields,
+			p_plan->field_count * sizeof(hid_plan_field_t));
+
+	return (p_copy);
+}
+
+// Plans are packed without bounds checks, so one read from a cache file (or
+// found under a colliding layout hash) must first be shown to fit the report
+static bool plan_fits(phid_plan_t const p_plan, phid_report_t const p_report,
+		uint8_t report_id)
+{
+	size_t index;
+
+	// Having no plan always fits
+	if (NULL == p_plan)
+	{
+		return (true);
+	}
+
+	if ((p_plan->report_id != report_id)
+			|| (p_plan->report_length != p_report->report_buffer_length)
+			|| (p_plan->report_length < 1)
+			|| (p_plan->library_field_count > p_plan->field_count))
+	{
+		return (false);
+	}
+
+	for (index = 0; index < p_plan->field_count; index++)
+	{
+		phid_plan_field_t const p_field = &p_plan->p_fields[index];
+
+		if (p_field->data_index >= p_report->hid_data_length)
+		{
+			return (false);
+		}
+
+		switch (p_field->type)
+		{
+		case HID_PLAN_FIELD_VALUE:
+			if ((0 == p_field->bit_size) || (p_field->bit_size > 32))
+			{
+				return (false);
+			}
+			break;
+
+		case HID_PLAN_FIELD_BUTTONS:
+			if ((1 != p_field->bit_size)
+					|| (p_field->usage_max < p_field->usage)
+					|| ((size_t) (p_field->usage_max - p_field->usage)
+							>= p_field->count))
+			{
+				return (false);
+			}
+			break;
+
+		case HID_PLAN_FIELD_LIBRARY:
+			if (p_field->bit_size > 32)
+			{
+				return (false);
+			}
+			break;
+
+		default:
+			return (false);
+		}
+
+		if (((size_t) p_field->bit_offset
+				+ ((size_t) p_field->bit_size * p_field->count))
+				> (p_plan->report_length * 8))
+		{
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
+static pplan_cache_entry_t find_entry(pplan_cache_t p_cache,
+		uint64_t layout_hash, uint8_t report_type, uint8_t report_id)
+{
+	size_t index;
+
+	for (index = 0; index < p_cache->entry_count; index++)
+	{
+		pplan_cache_entry_t p_entry = &p_cache->p_entries[index];
+
+		if ((layout_hash == p_entry->layout_hash)
+				&& (report_type == p_entry->report_type)
+				&& (report_id == p_entry->report_id))
+		{
+			return (p_entry);
+		}
+	}
+
+	return (NULL);
+}
+
+static bool add_entry(pplan_cache_t p_cache, uint64_t layout_hash,
+		uint8_t report_type, uint8_t report_id, phid_plan_t p_plan)
+{
+	pplan_cache_entry_t p_entry;
+
+	if (p_cache->entry_count == p_cache->capacity)
+	{
+		size_t capacity =
+				(0 == p_cache->capacity) ?
+						CACHE_INITIAL_CAPACITY : 2 * p_cache->capacity;
+		pplan_cache_entry_t p_entries = (pplan_cache_entry_t) realloc(
+				p_cache->p_entries, capacity * sizeof(plan_cache_entry_t));
+
+		// Not caching only costs compiling again
+		if (NULL == p_entries)
+		{
+			return (false);
+		}
+
+		p_cache->p_entries = p_entries;
+		p_cache->capacity = capacity;
+	}
+
+	p_entry = &p_cache->p_entries[p_cache->entry_count];
+	p_entry->layout_hash = layout_hash;
+	p_entry->report_type = report_type;
+	p_entry->report_id = report_id;
+	p_entry->p_plan = p_plan; // The cache now owns the plan
+
+	p_cache->entry_count++;
+
+	return (true);
+}
+
+static bool load_entries(pplan_cache_t p_cache, uint8_t const * p_data,
+		size_t length)
+{
+	cache_file_header_t const *p_header = (cache_file_header_t const *) p_data;
+	size_t offset = sizeof(cache_file_header_t);
+	size_t index;
+
+	if ((length < sizeof(cache_file_header_t))
+			|| (0 != memcmp(p_header->magic, CACHE_FILE_MAGIC,
+					sizeof(CACHE_FILE_MAGIC)))
+			|| (CACHE_FILE_VERSION != p_header->version))
+	{
+		return (false);
+	}
+
+	for (index = 0; index < p_header->entry_count; index++)
+	{
+		cache_file_entry_t const *p_entry;
+		cache_file_field_t const *p_file_fields;
+		phid_plan_t p_plan = NULL;
+		size_t field;
+
+		if ((length - offset) < sizeof(cache_file_entry_t))
+		{
+			return (false);
+		}
+
+		p_entry = (cache_file_entry_t const *) &p_data[offset];
+		offset += sizeof(cache_file_entry_t);
+
+		if ((length - offset)
+				< (p_entry->field_count * sizeof(cache_file_field_t)))
+		{
+			return (false);
+		}
+
+		p_file_fields = (cache_file_field_t const *) &p_data[offset];
+		offset += p_entry->field_count * sizeof(cache_file_field_t);
+
+		// Plans compiled in this process take precedence
+		if (NULL != find_entry(p_cache, p_entry->layout_hash,
+				p_entry->report_type, p_entry->report_id))
+		{
+			continue;
+		}
+
+		if (0 != p_entry->field_count)
+		{
+			p_plan = (phid_plan_t) calloc(1, sizeof(hid_plan_t));
+			if (NULL == p_plan)
+			{
+				return (false);
+			}
+
+			p_plan->p_fields = (phid_plan_field_t) calloc(p_entry->field_count,
+					sizeof(hid_plan_field_t));
+			if (NULL == p_plan->p_fields)
+			{
+				free(p_plan);
+				return (false);
+			}
+
+			p_plan->report_id = p_entry->report_id;
+			p_plan->report_length = p_entry->report_length;
+			p_plan->field_count = p_entry->field_count;
+			p_plan->library_field_count = p_entry->library_field_count;
+
+			for (field = 0; field < p_entry->field_count; field++)
+			{
+				cache_file_field_t const *p_in = &p_file_fields[field];
+				phid_plan_field_t p_out = &p_plan->p_fields[field];
+
+				p_out->type = (hid_plan_field_type_t) p_in->type;
+				p_out->data_index = p_in->data_index;
+				p_out->bit_offset = p_in->bit_offset;
+				p_out->bit_size = p_in->bit_size;
+				p_out->count = p_in->count;
+				p_out->usage_page = p_in->usage_page;
+				p_out->usage = p_in->usage;
+				p_out->usage_max = p_in->usage_max;
+				p_out->logical_min = p_in->logical_min;
+				p_out->logical_max = p_in->logical_max;
+				p_out->physical_min = p_in->physical_min;
+				p_out->physical_max = p_in->physical_max;
+			}
+		}
+
+		if (!add_entry(p_cache, p_entry->layout_hash, p_entry->report_type,
+				p_entry->report_id, p_plan))
+		{
+			hid_plan_free(p_plan);
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
+static bool save_entries(pplan_cache_t p_cache, FILE * p_file)
+{
+	cache_file_header_t header;
+	size_t index;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+	header.version = CACHE_FILE_VERSION;
+	header.entry_count = (uint32_t) p_cache->entry_count;
+
+	if (1 != fwrite(&header, sizeof(header), 1, p_file))
+	{
+		return (false);
+	}
+
+	for (index = 0; index < p_cache->entry_count; index++)
+	{
+		pplan_cache_entry_t p_cache_entry = &p_cache->p_entries[index];
+		phid_plan_t p_plan = p_cache_entry->p_plan;
+		cache_file_entry_t entry;
+		size_t field;
+
+		memset(&entry, 0, sizeof(entry));
+		entry.layout_hash = p_cache_entry->layout_hash;
+		entry.report_type = p_cache_entry->report_type;
+		entry.report_id = p_cache_entry->report_id;
+
+		if (NULL != p_plan)
+		{
+			entry.report_length = (uint16_t) p_plan->report_length;
+			entry.field_count = (uint16_t) p_plan->field_count;
+			entry.library_field_count = (uint16_t) p_plan->library_field_count;
+		}
+
+		if (1 != fwrite(&entry, sizeof(entry), 1, p_file))
+		{
+			return (false);
+		}
+
+		for (field = 0; field < entry.field_count; field++)
+		{
+			phid_plan_field_t p_in = &p_plan->p_fields[field];
+			cache_file_field_t out;
+
+			memset(&out, 0, sizeof(out));
+			out.type = (uint8_t) p_in->type;
+			out.data_index = (uint16_t) p_in->data_index;
+			out.bit_offset = p_in->bit_offset;
+			out.bit_size = p_in->bit_size;
+			out.count = p_in->count;
+			out.usage_page = p_in->usage_page;
+			out.usage = p_in->usage;
+			out.usage_max = p_in->usage_max;
+			out.logical_min = p_in->logical_min;
+			out.logical_max = p_in->logical_max;
+			out.physical_min = p_in->physical_min;
+			out.physical_max = p_in->physical_max;
+
+			if (1 != fwrite(&out, sizeof(out), 1, p_file))
+			{
+				return (false);
+			}
+		}
+	}
+
+	return (true);
+}
+
+void hid_plan_compile_device(phid_device_t p_hid_device)
+{
+	hid_plan_compile_device_cached(p_hid_device, NULL);
+}
+
+void hid_plan_compile_device_cached(phid_device_t p_hid_device,
+		HANDLE h_plan_cache)
+{
+	pplan_cache_t p_cache = (pplan_cache_t) h_plan_cache;
+	hid_report_type_t report_index;
+	uint64_t layout_hash = 0;
+
+	if (NULL != p_cache)
+	{
+		layout_hash = hid_plan_layout_hash(p_hid_device);
+	}
+
+	for (report_index = HID_REPORT_TYPE_FIRST;
+			report_index < HID_REPORT_TYPE_SIZE; report_index++)
+	{
+		phid_report_t p_report = &p_hid_device->report[report_index];
+		size_t index;
+
+		for (index = 0; index < p_report->number_report_ids; index++)
+		{
+			phid_report_id_t p_id = &p_report->p_report_ids[index];
+			pplan_cache_entry_t p_entry = NULL;
+
+			hid_plan_free(p_id->p_plan);
+
+			if (NULL != p_cache)
+			{
+				p_entry = find_entry(p_cache, layout_hash,
+						(uint8_t) report_index, p_id->report_id);
+
+				// A cached plan that does not fit is compiled again below
+				if ((NULL != p_entry)
+						&& plan_fits(p_entry->p_plan, p_report,
+								p_id->report_id))
+				{
+					p_id->p_plan = copy_plan(p_entry->p_plan);
+					continue;
+				}
+			}
+
+			// hid_report_type_t mirrors HIDP_REPORT_TYPE
+			p_id->p_plan = hid_plan_compile(p_report,
+					(HIDP_REPORT_TYPE) report_index, p_id->report_id,
+					p_hid_device->p_ppd);
+
+			if (NULL != p_cache)
+			{
+				phid_plan_t p_copy = copy_plan(p_id->p_plan);
+
+				// A plan that could not be copied must not be cached as
+				// "no plan"
+				if ((NULL != p_id->p_plan) && (NULL == p_copy))
+				{
+					continue;
+				}
+
+				if (NULL != p_entry)
+				{
+					// The compiled plan replaces the one that did not fit
+					hid_plan_free(p_entry->p_plan);
+					p_entry->p_plan = p_copy;
+					p_cache->is_dirty = true;
+				}
+				else if (add_entry(p_cache, layout_hash, (uint8_t) report_index,
+						p_id->report_id, p_copy))
+				{
+					p_cache->is_dirty = true;
+				}
+				else
+				{
+					hid_plan_free(p_copy);
+				}
+			}
+		}
+	}
+}
+
+uint64_t hid_plan_layout_hash(phid_device_t const p_hid_device)
+{
+	uint64_t hash = FNV1A_OFFSET_BASIS;
+	hid_report_type_t report_index;
+
+	hash = fnv1a_hash(hash, &p_hid_device->attributes.VendorID,
+			sizeof(p_hid_device->attributes.VendorID));
+	hash = fnv1a_hash(hash, &p_hid_device->attributes.ProductID,
+			sizeof(p_hid_device->attributes.ProductID));
+	hash = fnv1a_hash(hash, &p_hid_device->attributes.VersionNumber,
+			sizeof(p_hid_device->attributes.VersionNumber));
+	hash = fnv1a_hash(hash, &p_hid_device->caps, sizeof(p_hid_device->caps));
+
+	// The capabilities are what the parser library derived from the report
+	// descriptor, so they change whenever the layout does
+	for (report_index = HID_REPORT_TYPE_FIRST;
+			report_index < HID_REPORT_TYPE_SIZE; report_index++)
+	{
+		phid_report_t p_report = &p_hid_device->report[report_index];
+
+		hash = fnv1a_hash(hash, p_report->p_button_caps,
+				p_report->number_button_caps * sizeof(HIDP_BUTTON_CAPS));
+		hash = fnv1a_hash(hash, p_report->p_value_caps,
+				p_report->number_value_caps * sizeof(HIDP_VALUE_CAPS));
+	}
+
+	return (hash);
+}
+
+HANDLE hid_plan_cache_create(void)
+{
+	return ((HANDLE) calloc(1, sizeof(plan_cache_t)));
+}
+
+bool hid_plan_cache_load(HANDLE h_plan_cache, char const * p_path)
+{
+	pplan_cache_t p_cache = (pplan_cache_t) h_plan_cache;
+	HANDLE h_file;
+	HANDLE h_mapping;
+	LARGE_INTEGER file_length;
+	uint8_t const *p_view;
+	bool success = false;
+
+	if ((NULL == p_cache) || (NULL == p_path))
+	{
+		return (false);
+	}
+
+	// No cache file is expected the first time
+	h_file = CreateFile(p_path, GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+			FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (INVALID_HANDLE_VALUE == h_file)
+	{
+		return (false);
+	}
+
+	if (!GetFileSizeEx(h_file, &file_length)
+			|| (file_length.QuadPart < (LONGLONG) sizeof(cache_file_header_t))
+			|| ((uint64_t) file_length.QuadPart > SIZE_MAX))
+	{
+		CloseHandle(h_file);
+		return (false);
+	}
+
+	// The whole file is read through a single view
+	h_mapping = CreateFileMapping(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (NULL != h_mapping)
+	{
+		p_view = (uint8_t const *) MapViewOfFile(h_mapping, FILE_MAP_READ, 0, 0,
+				0);
+		if (NULL != p_view)
+		{
+			success = load_entries(p_cache, p_view,
+					(size_t) file_length.QuadPart);
+			UnmapViewOfFile(p_view);
+		}
+		CloseHandle(h_mapping);
+	}
+
+	CloseHandle(h_file);
+
+	return (success);
+}
+
+bool hid_plan_cache_save(HANDLE h_plan_cache, char const * p_path)
+{
+	pplan_cache_t p_cache = (pplan_cache_t) h_plan_cache;
+	char temp_path[MAX_PATH];
+	FILE *p_file;
+	bool success;
+
+	if ((NULL == p_cache) || (NULL == p_path))
+	{
+		return (false);
+	}
+
+	if (!p_cache->is_dirty)
+	{
+		return (true);
+	}
+
+	// Write aside and replace so readers never see a partial cache
+	_snprintf(temp_path, sizeof(temp_path), "%s.%lu", p_path,
+			(unsigned long) GetCurrentProcessId());
+	temp_path[sizeof(temp_path) - 1] = '\0';
+
+	p_file = fopen(temp_path, "wb");
+	if (NULL == p_file)
+	{
+		return (false);
+	}
+
+	success = save_entries(p_cache, p_file);
+	success = (0 == fclose(p_file)) && success;
+
+	if (success)
+	{
+		success = MoveFileEx(temp_path, p_path, MOVEFILE_REPLACE_EXISTING);
+	}
+
+	if (!success)
+	{
+		remove(temp_path);
+		return (false);
+	}
+
+	p_cache->is_dirty = false;
+
+	return (true);
+}
+
+bool hid_plan_cache_get_default_path(char * p_path, size_t path_size)
+{
+	return (cache_path_get(CACHE_FILE_NAME, p_path, path_size));
+}
+
+void hid_plan_cache_destroy(HANDLE h_plan_cache)
+{
+	pplan_cache_t p_cache = (pplan_cache_t) h_plan_cache;
+	size_t index;
+
+	if (NULL == p_cache)
+	{
+		return;
+	}
+
+	for (index = 0; index < p_cache->entry_count; index++)
+	{
+		hid_plan_free(p_cache->p_entries[index].p_plan);
+	}
+
+	free(p_cache->p_entries);
+	free(p_cache);
+}
+
+bool hid_plan_pack(phid_plan_t const p_plan, phid_report_t const p_report,
+		char * p_report_buffer, HIDP_REPORT_TYPE report_type,
+		PHIDP_PREPARSED_DATA const p_ppd)
+{
+	uint8_t *p_buffer = (uint8_t *) p_report_buffer;
+	phid_plan_field_t p_field;
+	size_t index;
+	bool status = true;
+
+	// All report buffers that are initially sent need to be zero'd out.
+	memset(p_buffer, 0, p_plan->report_length);
+	p_buffer[0] = p_plan->report_id;
+
+	p_field = p_plan->p_fields;
+	for (index = 0; index < p_plan->field_count; index++, p_field++)
+	{
+		phid_data_t p_hid_data = &p_report->p_hid_data[p_field->data_index];
+
+		switch (p_field->type)
+		{
+		case HID_PLAN_FIELD_VALUE:
+			insert_bits(p_buffer, p_field->bit_offset, p_field->bit_size,
+					clamp_value(p_field, p_hid_data->value.value));
+			p_hid_data->status = HIDP_STATUS_SUCCESS;
+			break;
+
+		case HID_PLAN_FIELD_BUTTONS:
+		{
+			size_t usage_index;
+
+			// The usage list is terminated by a zero usage
+			for (usage_index = 0;
+					usage_index < p_hid_data->button.max_usage_length;
+					usage_index++)
+			{
+				USAGE usage = p_hid_data->button.p_usages[usage_index];
+
+				if (0 == usage)
+				{
+					break;
+				}
+
+				if ((p_field->usage <= usage) && (usage <= p_field->usage_max))
+				{
+					insert_bits(p_buffer,
+							p_field->bit_offset + (usage - p_field->usage), 1,
+							1);
+				}
+			}
+			p_hid_data->status = HIDP_STATUS_SUCCESS;
+			break;
+		}
+
+		case HID_PLAN_FIELD_LIBRARY:
+		default:
+			if (p_hid_data->is_button)
+			{
+				ULONG num_usages = p_hid_data->button.max_usage_length;
+
+				p_hid_data->status = HidP_SetUsages(report_type,
+						p_hid_data->usage_page,
+						0, // All collections
+						p_hid_data->button.p_usages, &num_usages, p_ppd,
+						p_report_buffer, p_plan->report_length);
+			}
+			else
+			{
+				p_hid_data->status = HidP_SetUsageValue(report_type,
+						p_hid_data->usage_page,
+						0, // All Collections.
+						p_hid_data->value.usage, p_hid_data->value.value,
+						p_ppd, p_report_buffer, p_plan->report_length);
+			}
+
+			if (HIDP_STATUS_SUCCESS != p_hid_data->status)
+			{
+				status = false;
+			}
+			break;
+		}
+
+		p_hid_data->is_data_set = true;
+	}
+
+	return (status);
+}
+
+uint32_t hid_plan_extract_bits(uint8_t const * p_report_buffer,
+		size_t bit_offset, size_t bit_size)
+{
+	uint32_t value = 0;
+	size_t position = 0;
+
+	// HID reports are packed least significant bit first
+	while (position < bit_size)
+	{
+		size_t byte_index = bit_offset >> 3;
+		size_t shift = bit_offset & 7;
+		size_t bits = 8 - shift;
+
+		if (bits > (bit_size - position))
+		{
+			bits = bit_size - position;
+		}
+
+		value |= (uint32_t) ((p_report_buffer[byte_index] >> shift)
+				& ((1u << bits) - 1)) << position;
+
+		position += bits;
+		bit_offset += bits;
+	}
+
+	return (value);
+}
+
+int64_t hid_plan_extract_value(uint8_t const * p_report_buffer,
+		size_t bit_offset, size_t bit_size, bool is_signed)
+{
+	uint32_t value = hid_plan_extract_bits(p_report_buffer, bit_offset,
+			bit_size);
+
+	// Sign extend from the field's most significant bit
+	if (is_signed && (bit_size > 0) && (bit_size < 32)
+			&& (value & (1UL << (bit_size - 1))))
+	{
+		value |= ~((1UL << bit_size) - 1);
+	}
+
+	if (is_signed)
+	{
+		return ((int64_t) (int32_t) value);
+	}
+
+	return ((int64_t) value);
+}
+
+void hid_plan_free(phid_plan_t p_plan)
+{
+	if (NULL == p_plan)
+	{
+		return;
+	}
+
+	free(p_plan->p_fields);
+	free(p_plan);
+}
@@ -0,0 +1,359 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_plan.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_PLAN_H_
+#define USB_HID_PLAN_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_plan
+
+ \brief These APIs compile the layout of a HID report ID into a plan of bit
+ fields so reports may be packed without going through the HID parser library
+ for every field.
+ */
+/* ************************************************************************* */
+
+/*
+
+ The HID parser library does not expose where within a report a given usage
+ lives. The plan compiler learns the layout once by probing the library with
+ known values on a scratch buffer and recording which bits change. Packing
+ then becomes plain bit insertion into a report buffer.
+
+ Fields the compiler cannot describe as a simple bit field (e.g. button
+ arrays, whose slots hold usage indices) are kept in the plan as library
+ fields and are still packed by calling the HID parser library.
+
+ */
+
+typedef enum _hid_plan_field_type_t
+{
+	HID_PLAN_FIELD_VALUE, // A single value of bit_size bits
+	HID_PLAN_FIELD_BUTTONS, // A bitmap, one bit per usage in usage..usage_max
+	HID_PLAN_FIELD_LIBRARY // Packed by the HID parser library
+
+} hid_plan_field_type_t;
+
+typedef struct _hid_plan_field_t
+{
+	hid_plan_field_type_t type;
+
+	size_t data_index; // Index of the hid_data_t element within its report
+
+	uint16_t bit_offset; // Position of the field's first bit in the report
+	uint16_t bit_size; // Number of bits of a value (1 for buttons)
+	uint16_t count; // Number of values (bits for buttons)
+
+	USAGE usage_page;
+	USAGE usage; // The value usage (or usage minimum for buttons)
+	USAGE usage_max; // The usage maximum (buttons only)
+
+	int32_t logical_min; // Logical range used for clamping values
+	int32_t logical_max;
+	int32_t physical_min; // Physical range used for scaling values
+	int32_t physical_max;
+
+} hid_plan_field_t, *phid_plan_field_t;
+
+typedef struct _hid_plan_t
+{
+	uint8_t report_id; // The report ID this plan describes
+	size_t report_length; // Length of the report buffer (incl. report ID)
+
+	phid_plan_field_t p_fields; // array of fields
+	size_t field_count; // Number elements in this array.
+
+	size_t library_field_count; // Number of fields of type HID_PLAN_FIELD_LIBRARY
+
+} hid_plan_t, *phid_plan_t;
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Compiles the plan of a single report ID.
+
+ \param[in] p_report - The report the report ID belongs to.
+ \param[in] report_type - The report type (input, output, feature) of p_report.
+ \param[in] report_id - The report ID to compile the plan for.
+ \param[in] p_ppd - The HID's pre-parsed data.
+
+ \return A pointer to the plan (must be freed with hid_plan_free()) or NULL if
+ no plan could be compiled, in which case the caller should fall back to the
+ HID parser library.
+
+ */
+/* ************************************************************************** */
+
+phid_plan_t hid_plan_compile(phid_report_t const p_report,
+		HIDP_REPORT_TYPE report_type, uint8_t report_id,
+		PHIDP_PREPARSED_DATA const p_ppd);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Compiles the plans of every report ID of the HID.
+
+ \param[in,out] p_hid_device - A pointer to the HID whose report ID entries
+ receive the plans.
+
+ Report IDs for which no plan could be compiled are left without one.
+
+ */
+/* ************************************************************************** */
+
+void hid_plan_compile_device(phid_device_t p_hid_device);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Compiles the plans of every report ID of the HID, reusing the plans
+ already compiled for a HID of the same layout.
+
+ \param[in,out] p_hid_device - A pointer to the HID whose report ID entries
+ receive the plans.
+ \param[in] h_plan_cache - A handle to the plan cache (NULL for none).
+
+ Plans are looked up by hid_plan_layout_hash(), report type and report ID.
+ Those not found are compiled and added to the cache.
+
+ */
+/* ************************************************************************** */
+
+void hid_plan_compile_device_cached(phid_device_t p_hid_device,
+		HANDLE h_plan_cache);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Hashes what determines the report layouts of a HID.
+
+ \param[in] p_hid_device - A pointer to the opened HID.
+
+ \return A hash of the HID's VID, PID, version and report capabilities.
+
+ */
+/* ************************************************************************** */
+
+uint64_t hid_plan_layout_hash(phid_device_t const p_hid_device);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Creates an empty plan cache.
+
+ \return A handle to the plan cache or NULL on failure.
+
+ A plan cache is not thread safe; each thread opening HIDs keeps its own.
+
+ */
+/* ************************************************************************** */
+
+HANDLE hid_plan_cache_create(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Destroys a plan cache and the plans it holds.
+
+ \param[in] h_plan_cache - A handle to the plan cache.
+
+ */
+/* ************************************************************************** */
+
+void hid_plan_cache_destroy(HANDLE h_plan_cache);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Adds the plans of a cache file to a plan cache.
+
+ \param[in] h_plan_cache - A handle to the plan cache.
+ \param[in] p_path - The cache file.
+
+ \return Indicates if the cache file was read (false if it does not exist or
+ is not a valid cache file).
+
+ The file is mapped and read in one go. Plans already in the cache are kept.
+
+ */
+/* ************************************************************************** */
+
+bool hid_plan_cache_load(HANDLE h_plan_cache, char const * p_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Writes a plan cache to a cache file if plans were compiled since it
+ was loaded.
+
+ \param[in] h_plan_cache - A handle to the plan cache.
+ \param[in] p_path - The cache file.
+
+ \return Indicates if the cache file is up to date.
+
+ The file is written aside and then replaces the previous one, so processes
+ sharing the cache file never read a partial one.
+
+ */
+/* ************************************************************************** */
+
+bool hid_plan_cache_save(HANDLE h_plan_cache, char const * p_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Retrieves the default cache file path.
+
+ \param[out] p_path - Receives the path.
+ \param[in] path_size - Size of p_path.
+
+ \return Indicates if the path fit.
+
+ See cache_path_get() for where the cache file lives.
+
+ */
+/* ************************************************************************** */
+
+bool hid_plan_cache_get_default_path(char * p_path, size_t path_size);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Packs a report buffer according to a plan.
+
+ \param[in] p_plan - The plan of the report ID to pack.
+ \param[in] p_report - The report whose hid_data_t elements to pack from.
+ \param[out] p_report_buffer - The buffer to pack into (at least
+ p_plan->report_length bytes).
+ \param[in] report_type - The report type (input, output, feature) being packed.
+ \param[in] p_ppd - The HID's pre-parsed data (used for library fields only).
+
+ \return Indicates if the report packing was successful.
+
+ Values are clamped to their logical range before being inserted. Every data
+ element packed has its is_data_set field marked with true.
+
+ */
+/* ************************************************************************** */
+
+bool hid_plan_pack(phid_plan_t const p_plan, phid_report_t const p_report,
+		char * p_report_buffer, HIDP_REPORT_TYPE report_type,
+		PHIDP_PREPARSED_DATA const p_ppd);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Extracts a bit field from a report buffer.
+
+ \param[in] p_report_buffer - The report buffer (report ID in byte 0).
+ \param[in] bit_offset - Position of the field's first bit in the report.
+ \param[in] bit_size - Number of bits of the field (at most 32).
+
+ \return The field's bits, least significant bit first.
+
+ */
+/* ************************************************************************** */
+
+uint32_t hid_plan_extract_bits(uint8_t const * p_report_buffer,
+		size_t bit_offset, size_t bit_size);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Extracts a value from a report buffer.
+
+ \param[in] p_report_buffer - The report buffer (report ID in byte 0).
+ \param[in] bit_offset - Position of the value's first bit in the report.
+ \param[in] bit_size - Number of bits of the value (at most 32).
+ \param[in] is_signed - Sign extend the value (i.e. its logical minimum is
+ negative).
+
+ \return The value.
+
+ */
+/* ************************************************************************** */
+
+int64_t hid_plan_extract_value(uint8_t const * p_report_buffer,
+		size_t bit_offset, size_t bit_size, bool is_signed);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_plan
+
+ \brief Frees a plan returned by hid_plan_compile().
+
+ \param[in] p_plan - The plan to free (may be NULL).
+
+ */
+/* ************************************************************************** */
+
+void hid_plan_free(phid_plan_t p_plan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_PLAN_H_ */
@@ -53,22 +53,44 @@
 // Windows includes
 #include <windows.h>
 #include <hidsdi.h>
+#include <hidclass.h>
+#include <usbioctl.h>
 
 // Other includes
 #include "output.h"
 #include "utils.h"
 #include "usb_defs.h"
 #include "usb_hid.h"
+#include "usb_enum.h"
 #include "usb_debug.h"
-#include "usb_hid_reader.h"
+#include "usb_hid_plan.h"
 
 // Module include
 #include "usb_hid_reports.h"
 
 // Local declarations
+static bool unpack_hid_data(char * const report_buffer,
+		size_t report_buffer_length, HIDP_REPORT_TYPE report_type,
+		phid_data_t p_hid_data, PHIDP_PREPARSED_DATA p_ppd);
+
+static bool issue_get_feature(HANDLE h_device, phid_report_id_t p_id,
+		size_t report_buffer_length);
 
 // Implementation
 
+uint64_t hid_timestamp_now(void)
+{
+	FILETIME now;
+	ULARGE_INTEGER ticks;
+
+	// FILETIME counts 100ns intervals since Jan 1, 1601 UTC
+	GetSystemTimeAsFileTime(&now);
+	ticks.LowPart = now.dwLowDateTime;
+	ticks.HighPart = now.dwHighDateTime;
+
+	return ((ticks.QuadPart / 10) - HID_TIMESTAMP_EPOCH_OFFSET_US);
+}
+
 bool hid_read(phid_device_t p_hid_device)
 {
 	DWORD length;
@@ -93,6 +115,8 @@ bool hid_read(phid_device_t p_hid_device)
 			p_report->report_buffer_length, &length, NULL);
 	if ((success) && (length == p_report->report_buffer_length))
 	{
+		p_report->timestamp_us = hid_timestamp_now();
+
 		// Unpack the report into our provided HID data structure
 		result = hid_unpack_report(p_report->p_report_buffer,
 				p_report->report_buffer_length, HidP_Input,
@@ -105,7 +129,6 @@ bool hid_read(phid_device_t p_hid_device)
 
 bool hid_read_overlapped(phid_device_t p_hid_device, HANDLE h_completion_event)
 {
-	static OVERLAPPED overlap;
 	DWORD length;
 	bool status;
 	BOOL read_status;
@@ -122,10 +145,10 @@ bool hid_read_overlapped(phid_device_t p_hid_device, HANDLE h_completion_event)
 	 use for signalling the completion of the Read
 	 */
 
-	memset(&overlap, 0, sizeof(OVERLAPPED));
+	memset(&p_report->overlap, 0, sizeof(OVERLAPPED));
 
 	// Assign he completion event
-	overlap.hEvent = h_completion_event;
+	p_report->overlap.hEvent = h_completion_event;
 
 	/*
 	 Execute the read call saving the return code to determine how to
@@ -137,7 +160,7 @@ bool hid_read_overlapped(phid_device_t p_hid_device, HANDLE h_completion_event)
 	 to read a single report.
 	 */
 	read_status = ReadFile(p_hid_device->h_device, p_report->p_report_buffer,
-			p_report->report_buffer_length, &length, &overlap);
+			p_report->report_buffer_length, &length, &p_report->overlap);
 	/*
 	 If the status is false, then one of two cases occurred.
 	 1) ReadFile call succeeded but the Read is an overlapped one.  Here,
@@ -194,31 +217,24 @@ bool hid_write(phid_device_t p_hid_device)
 	/*
 	 In setting all the data in the reports, we need to pack a report buffer
 	 and call WriteFile for each report ID that is represented by the
-	 device structure.  To do so, the is_data_set field will be used to
-	 determine if a given report field has already been set.
+	 device structure.
 	 */
-	p_hid_data = p_report->p_hid_data;
-	for (index = 0; index < p_report->hid_data_length; index++, p_hid_data++)
+	for (index = 0; index < p_report->number_report_ids; index++)
 	{
-		if (!p_hid_data->is_data_set)
-		{
-			/*
-			 Package the report for this data structure.  hid_pack_report will
-			 set the is_data_set fields of this structure and any other
-			 structures that it includes in the report with this structure
-			 */
-			hid_pack_report(p_report->p_report_buffer,
-					p_report->report_buffer_length, HidP_Output, p_hid_data,
-					p_report->hid_data_length - index, p_hid_device->p_ppd);
-
-			// Now a report has been packaged up...Send it down to the device
-			write_status = WriteFile(p_hid_device->h_device,
-					p_report->p_report_buffer, p_report->report_buffer_length,
-					&written, NULL)
-					&& (written == p_report->report_buffer_length);
-
-			status = (status && write_status); // any failure returns failure
-		}
+		/*
+		 Package the report for this report ID.  hid_pack_report_id will
+		 set the is_data_set fields of all the structures that it
+		 includes in the report.
+		 */
+		hid_pack_report_id(p_report, &p_report->p_report_ids[index],
+				p_report->p_report_buffer, HidP_Output, p_hid_device->p_ppd);
+
+		// Now a report has been packaged up...Send it down to the device
+		write_status = WriteFile(p_hid_device->h_device,
+				p_report->p_report_buffer, p_report->report_buffer_length,
+				&written, NULL) && (written == p_report->report_buffer_length);
+
+		status = (status && write_status); // any failure returns failure
 	}
 
 	return (status);
@@ -245,31 +261,24 @@ bool hid_set_feature(phid_device_t p_hid_device)
 
 	/*
 	 In setting all the data in the reports, we need to pack a report buffer
-	 and call WriteFile for each report ID that is represented by the
-	 device structure.  To do so, the is_data_set field will be used to
-	 determine if a given report field has already been set.
+	 and call HidD_SetFeature for each report ID that is represented by the
+	 device structure.
 	 */
-	p_hid_data = p_report->p_hid_data;
-	for (index = 0; index < p_report->hid_data_length; index++, p_hid_data++)
+	for (index = 0; index < p_report->number_report_ids; index++)
 	{
-		if (!p_hid_data->is_data_set)
-		{
-			/*
-			 Package the report for this data structure.  hid_pack_report will
-			 set the is_data_set fields of this structure and any other
-			 structures that it includes in the report with this structure
-			 */
-
-			hid_pack_report(p_report->p_report_buffer,
-					p_report->report_buffer_length, HidP_Feature, p_hid_data,
-					p_report->hid_data_length - index, p_hid_device->p_ppd);
-
-			// Now a report has been packaged up...Send it down to the device
-			feature_status = HidD_SetFeature(p_hid_device->h_device,
-					p_report->p_report_buffer, p_report->report_buffer_length);
+		/*
+		 Package the report for this report ID.  hid_pack_report_id will
+		 set the is_data_set fields of all the structures that it
+		 includes in the report.
+		 */
+		hid_pack_report_id(p_report, &p_report->p_report_ids[index],
+				p_report->p_report_buffer, HidP_Feature, p_hid_device->p_ppd);
 
-			status = (feature_status && status); // any failure returns failure
-		}
+		// Now a report has been packaged up...Send it down to the device
+		feature_status = HidD_SetFeature(p_hid_device->h_device,
+				p_report->p_report_buffer, p_report->report_buffer_length);
+
+		status = (feature_status && status); // any failure returns failure
 	}
 
 	return (status);
@@ -339,6 +348,223 @@ bool hid_get_feature(phid_device_t p_hid_device)
 	return (status);
 }
 
+bool hid_get_feature_batch(phid_device_t p_hid_device)
+{
+	size_t index;
+	phid_data_t p_hid_data;
+	bool status = true;
+	phid_report_t p_report = &p_hid_device->report[HID_REPORT_TYPE_FEATURE];
+
+	// We only do this if we can actually receive a feature report
+	if (0 == p_report->report_buffer_length)
+	{
+		return (false);
+	}
+
+	// Nothing has been retrieved yet
+	p_hid_data = p_report->p_hid_data;
+	for (index = 0; index < p_report->hid_data_length; index++, p_hid_data++)
+	{
+		p_hid_data->is_data_set = false;
+	}
+
+	/*
+	 First issue a request for every report ID, each into its own buffer,
+	 so the device may service all of them without us waiting in between.
+	 */
+	for (index = 0; index < p_report->number_report_ids; index++)
+	{
+		if (!issue_get_feature(p_hid_device->h_device,
+				&p_report->p_report_ids[index], p_report->report_buffer_length))
+		{
+			status = false; // any failure returns failure
+		}
+	}
+
+	/*
+	 Now collect the results. Each report only carries the fields of its
+	 own report ID so only those fields are decoded from it.
+	 */
+	for (index = 0; index < p_report->number_report_ids; index++)
+	{
+		phid_report_id_t p_id = &p_report->p_report_ids[index];
+		DWORD length;
+		BOOL feature_status;
+
+		if (!p_id->is_pending)
+		{
+			continue;
+		}
+
+		feature_status = GetOverlappedResult(p_hid_device->h_device,
+				&p_id->overlap, &length, TRUE);
+		p_id->is_pending = false;
+
+		// A short report leaves the rest of its fields zeroed, not read
+		if (feature_status && (length != p_report->report_buffer_length))
+		{
+			feature_status = FALSE;
+		}
+
+		if (feature_status)
+		{
+			feature_status = hid_unpack_report_id(p_id, p_id->p_report_buffer,
+					p_report->report_buffer_length, HidP_Feature,
+					p_hid_device->p_ppd);
+		}
+
+		status = (status && feature_status); // any failure returns failure
+	}
+
+	return (status);
+}
+
+static bool unpack_hid_data(char * const report_buffer,
+		size_t report_buffer_length, HIDP_REPORT_TYPE report_type,
+		phid_data_t p_hid_data, PHIDP_PREPARSED_DATA p_ppd)
+{
+	// Button
+	if (p_hid_data->is_button)
+	{
+		ULONG num_usages; // Number of usages returned from GetUsages.
+		ULONG next_usage;
+		ULONG index_usage;
+
+		num_usages = p_hid_data->button.max_usage_length;
+
+		// Extract all usages
+		p_hid_data->status = HidP_GetUsages(report_type,
+				p_hid_data->usage_page,
+				0, // All collections
+				p_hid_data->button.p_usages, &num_usages, p_ppd,
+				report_buffer, report_buffer_length);
+
+		/*
+		 Get usages writes the list of usages into the buffer
+		 p_data->button.usages. num_usages is set to the number of
+		 usages written into this array.
+
+		 A usage cannot not be defined as zero, so we'll mark a zero
+		 following the list of usages to indicate the end of the list of
+		 usages
+
+		 NOTE: One anomaly of the GetUsages function is the lack of
+		 ability to distinguish the data for one ButtonCaps from another
+		 if two different caps structures have the same UsagePage
+		 For instance:
+		 Caps1 has UsagePage 07 and UsageRange of 0x00 - 0x167
+		 Caps2 has UsagePage 07 and UsageRange of 0xe0 - 0xe7
+
+		 However, calling GetUsages for each of the data structs
+		 will return the same list of usages.  It is the
+		 responsibility of the caller to set in the hid_device_t
+		 structure which usages actually are valid for the
+		 that structure.
+		 */
+
+		/*
+		 Search through the usage list and remove those that
+		 correspond to usages outside the define ranged for this
+		 data structure.
+		 */
+
+		for (index_usage = 0, next_usage = 0; index_usage < num_usages;
+				index_usage++)
+		{
+			if (p_hid_data->button.usage_min
+					<= p_hid_data->button.p_usages[index_usage]
+					&& p_hid_data->button.p_usages[index_usage]
+							<= p_hid_data->button.usage_max)
+			{
+				p_hid_data->button.p_usages[next_usage++] =
+						p_hid_data->button.p_usages[index_usage];
+			}
+		}
+
+		if (next_usage < p_hid_data->button.max_usage_length)
+		{
+			p_hid_data->button.p_usages[next_usage] = 0;
+		}
+	}
+	// Value
+	else
+	{
+		LONG scaled_value = 0;
+		ULONG value = 0;
+
+		p_hid_data->status = HidP_GetUsageValue(report_type,
+				p_hid_data->usage_page,
+				0, // All Collections.
+				p_hid_data->value.usage, &value, p_ppd, report_buffer,
+				report_buffer_length);
+		p_hid_data->value.value = value;
+
+		if (HIDP_STATUS_SUCCESS != p_hid_data->status)
+		{
+			return (false);
+		}
+
+		p_hid_data->status = HidP_GetScaledUsageValue(report_type,
+				p_hid_data->usage_page,
+				0, // All Collections.
+				p_hid_data->value.usage, &scaled_value, p_ppd,
+				report_buffer, report_buffer_length);
+		p_hid_data->value.scaled_value = scaled_value;
+	}
+
+	p_hid_data->is_data_set = true;
+
+	return (true);
+}
+
+static bool issue_get_feature(HANDLE h_device, phid_report_id_t p_id,
+		size_t report_buffer_length)
+{
+	DWORD length;
+	BOOL success;
+
+	p_id->is_pending = false;
+
+	// Each report ID waits on its own (manual reset) completion event
+	if (NULL == p_id->h_event)
+	{
+		p_id->h_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+		if (NULL == p_id->h_event)
+		{
+			return (false);
+		}
+	}
+
+	/*
+	 Specifying the report ID in the first byte selects which report is
+	 actually retrieved from the device. The rest of the buffer should be
+	 zeroed before the call.
+	 */
+	memset(p_id->p_report_buffer, 0, report_buffer_length);
+	p_id->p_report_buffer[0] = p_id->report_id;
+
+	memset(&p_id->overlap, 0, sizeof(OVERLAPPED));
+	p_id->overlap.hEvent = p_id->h_event;
+
+	/*
+	 This is the request HidD_GetFeature() makes on our behalf, except that
+	 it is issued overlapped so it does not block waiting on the device.
+	 On a handle which was not opened overlapped it simply completes
+	 synchronously.
+	 */
+	success = DeviceIoControl(h_device, IOCTL_HID_GET_FEATURE, NULL, 0,
+			p_id->p_report_buffer, report_buffer_length, &length,
+			&p_id->overlap);
+	if ((!success) && (ERROR_IO_PENDING != GetLastError()))
+	{
+		return (false);
+	}
+
+	p_id->is_pending = true;
+
+	return (true);
+}
+
 bool hid_unpack_report(char * const report_buffer, size_t report_buffer_length,
 		HIDP_REPORT_TYPE report_type, phid_data_t p_hid_data,
 		size_t hid_data_length, PHIDP_PREPARSED_DATA p_ppd)
@@ -354,98 +580,31 @@ bool hid_unpack_report(char * const report_buffer, size_t report_buffer_length,
 		// the same report type (id)
 		if (report_id == p_hid_data->report_id)
 		{
-			// Button
-			if (p_hid_data->is_button)
+			if (!unpack_hid_data(report_buffer, report_buffer_length,
+					report_type, p_hid_data, p_ppd))
 			{
-				ULONG num_usages; // Number of usages returned from GetUsages.
-				ULONG next_usage;
-				ULONG index_usage;
-
-				num_usages = p_hid_data->button.max_usage_length;
-
-				// Extract all usages
-				p_hid_data->status = HidP_GetUsages(report_type,
-						p_hid_data->usage_page,
-						0, // All collections
-						p_hid_data->button.p_usages, &num_usages, p_ppd,
-						report_buffer, report_buffer_length);
-
-				/*
-				 Get usages writes the list of usages into the buffer
-				 p_data->button.usages. num_usages is set to the number of
-				 usages written into this array.
-
-				 A usage cannot not be defined as zero, so we'll mark a zero
-				 following the list of usages to indicate the end of the list of
-				 usages
-
-				 NOTE: One anomaly of the GetUsages function is the lack of
-				 ability to distinguish the data for one ButtonCaps from another
-				 if two different caps structures have the same UsagePage
-				 For instance:
-				 Caps1 has UsagePage 07 and UsageRange of 0x00 - 0x167
-				 Caps2 has UsagePage 07 and UsageRange of 0xe0 - 0xe7
-
-				 However, calling GetUsages for each of the data structs
-				 will return the same list of usages.  It is the
-				 responsibility of the caller to set in the hid_device_t
-				 structure which usages actually are valid for the
-				 that structure.
-				 */
-
-				/*
-				 Search through the usage list and remove those that
-				 correspond to usages outside the define ranged for this
-				 data structure.
-				 */
-
-				for (index_usage = 0, next_usage = 0; index_usage < num_usages;
-						index_usage++)
-				{
-					if (p_hid_data->button.usage_min
-							<= p_hid_data->button.p_usages[index_usage]
-							&& p_hid_data->button.p_usages[index_usage]
-									<= p_hid_data->button.usage_max)
-					{
-						p_hid_data->button.p_usages[next_usage++] =
-								p_hid_data->button.p_usages[index_usage];
-					}
-				}
-
-				if (next_usage < p_hid_data->button.max_usage_length)
-				{
-					p_hid_data->button.p_usages[next_usage] = 0;
-				}
+				return (false);
 			}
-			// Value
-			else
-			{
-				LONG scaled_value = 0;
-				ULONG value = 0;
-
-				p_hid_data->status = HidP_GetUsageValue(report_type,
-						p_hid_data->usage_page,
-						0, // All Collections.
-						p_hid_data->value.usage, &value, p_ppd, report_buffer,
-						report_buffer_length);
-				p_hid_data->value.value = value;
-
-				if (HIDP_STATUS_SUCCESS != p_hid_data->status)
-				{
-					return (false);
-				}
+		}
+	}
+	return (true);
+}
 
-				p_hid_data->status = HidP_GetScaledUsageValue(report_type,
-						p_hid_data->usage_page,
-						0, // All Collections.
-						p_hid_data->value.usage, &scaled_value, p_ppd,
-						report_buffer, report_buffer_length);
-				p_hid_data->value.scaled_value = scaled_value;
-			}
+bool hid_unpack_report_id(phid_report_id_t const p_report_id,
+		char * const p_report_buffer, size_t report_buffer_length,
+		HIDP_REPORT_TYPE report_type, PHIDP_PREPARSED_DATA const p_ppd)
+{
+	size_t index;
 
-			p_hid_data->is_data_set = true;
+	for (index = 0; index < p_report_id->hid_data_length; index++)
+	{
+		if (!unpack_hid_data(p_report_buffer, report_buffer_length,
+				report_type, p_report_id->pp_hid_data[index], p_ppd))
+		{
+			return (false);
 		}
 	}
+
 	return (true);
 }
 
@@ -455,6 +614,7 @@ bool hid_pack_report(char * report_buffer, size_t report_buffer_length,
 {
 	size_t index;
 	uint8_t curr_report_id;
+	phid_data_t p_first_hid_data = p_hid_data;
 
 	// All report buffers that are initially sent need to be zero'd out.
 	memset(report_buffer, 0, report_buffer_length);
@@ -517,6 +677,7 @@ bool hid_pack_report(char * report_buffer, size_t report_buffer_length,
 	 through the structure again and mark all of those data structures as
 	 having been set.
 	 */
+	p_hid_data = p_first_hid_data;
 	for (index = 0; index < hid_data_length; index++, p_hid_data++)
 	{
 		if (curr_report_id == p_hid_data->report_id)
@@ -527,3 +688,30 @@ bool hid_pack_report(char * report_buffer, size_t report_buffer_length,
 
 	return (true);
 }
+
+bool hid_pack_report_id(phid_report_t const p_report,
+		phid_report_id_t const p_report_id, char * report_buffer,
+		HIDP_REPORT_TYPE report_type, PHIDP_PREPARSED_DATA const p_ppd)
+{
+	phid_data_t p_first;
+
+	if (0 == p_report_id->hid_data_length)
+	{
+		return (false);
+	}
+
+	// A compiled plan packs the report without calling into the library
+	if (NULL != p_report_id->p_plan)
+	{
+		return (hid_plan_pack(p_report_id->p_plan, p_report, report_buffer,
+				report_type, p_ppd));
+	}
+
+	// Otherwise pack this report ID starting at its first data element
+	p_first = p_report_id->pp_hid_data[0];
+
+	return (hid_pack_report(report_buffer, p_report->report_buffer_length,
+			report_type, p_first,
+			p_report->hid_data_length - (p_first - p_report->p_hid_data),
+			p_ppd));
+}
@@ -60,6 +60,22 @@ extern "C"
  */
 /* ************************************************************************* */
 
+// Microseconds between Jan 1, 1601 (FILETIME) and Jan 1, 1970 (Unix) UTC
+#define HID_TIMESTAMP_EPOCH_OFFSET_US	(11644473600000000ULL)
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_reports
+
+ \brief Retrieves the current time as used for report timestamps.
+
+ \return The number of microseconds since Jan 1, 1970 UTC.
+
+ */
+/* ************************************************************************** */
+
+uint64_t hid_timestamp_now(void);
+
 /* ************************************************************************** */
 /*!
  \ingroup usb_hid_reports
@@ -137,6 +153,28 @@ bool hid_set_feature(phid_device_t p_hid_device);
 
 bool hid_get_feature(phid_device_t p_hid_device);
 
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_reports
+
+ \brief Gets every report feature from the HID as one batch.
+
+ \param[in] p_hid_device - A pointer to the HID to get the features from.
+
+ \return Indicates if all HID gets completed successfully.
+
+ Unlike hid_get_feature() which retrieves one report ID after the other, this
+ routine issues the requests for all feature report IDs up front, each into
+ the report buffer of its own report ID entry, and only then waits for them to
+ complete. When the device was opened with USB_OVERLAPPED the requests are
+ outstanding concurrently. Each returned report is decoded into only the
+ data elements belonging to its report ID.
+
+ */
+/* ************************************************************************** */
+
+bool hid_get_feature_batch(phid_device_t p_hid_device);
+
 /* ************************************************************************** */
 /*!
  \ingroup usb_hid_reports
@@ -175,6 +213,31 @@ bool hid_unpack_report(char * const p_report_buffer,
 		phid_data_t p_hid_data, size_t hid_data_length,
 		PHIDP_PREPARSED_DATA const p_ppd);
 
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_reports
+
+ \brief This API unpacks a HID report buffer for a single report ID.
+
+ \param[in] p_report_id - The report ID entry whose data elements to unpack to.
+ \param[in] p_report_buffer - The raw buffer with packed structures.
+ \param[in] report_buffer_length - Size of the buffer to unpack from.
+ \param[in] report_type - The report type (input, output, feature) being unpacked.
+ \param[in] p_ppd - The HID's pre-parsed data.
+
+ \return Indicates if the report unpacking was successful.
+
+ This behaves like hid_unpack_report() except that only the data elements
+ indexed by the report ID entry are visited. The caller is responsible for
+ the report buffer carrying the report ID of the entry.
+
+ */
+/* ************************************************************************** */
+
+bool hid_unpack_report_id(phid_report_id_t const p_report_id,
+		char * const p_report_buffer, size_t report_buffer_length,
+		HIDP_REPORT_TYPE report_type, PHIDP_PREPARSED_DATA const p_ppd);
+
 /* ************************************************************************** */
 /*!
  \ingroup usb_hid_reports
@@ -212,6 +275,31 @@ bool hid_pack_report(char * p_report_buffer, size_t report_buffer_length,
 		HIDP_REPORT_TYPE report_type, phid_data_t p_hid_data,
 		size_t hid_data_length, PHIDP_PREPARSED_DATA const p_ppd);
 
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_reports
+
+ \brief This API packs the HID report buffer of a single report ID.
+
+ \param[in] p_report - The report the report ID entry belongs to.
+ \param[in] p_report_id - The report ID entry whose data elements to pack.
+ \param[out] p_report_buffer - The output buffer to pack into (at least
+ p_report->report_buffer_length bytes).
+ \param[in] report_type - The report type (input, output, feature) being packed.
+ \param[in] p_ppd - The HID's pre-parsed data.
+
+ \return Indicates if the report packing was successful.
+
+ When a plan was compiled for the report ID (see usb_hid_plan) the report is
+ packed directly from it, otherwise this falls back to hid_pack_report().
+
+ */
+/* ************************************************************************** */
+
+bool hid_pack_report_id(phid_report_t const p_report,
+		phid_report_id_t const p_report_id, char * p_report_buffer,
+		HIDP_REPORT_TYPE report_type, PHIDP_PREPARSED_DATA const p_ppd);
+
 #ifdef __cplusplus
 }
 #endif
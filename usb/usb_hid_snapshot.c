@@ -0,0 +1,270 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_snapshot.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <malloc.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+
+// Module include
+#include "usb_hid_snapshot.h"
+
+// Slots are kept a cache line apart so readers of one report ID do not
+// disturb the reader thread updating another
+#define CACHE_LINE_SIZE		(64)
+
+// Marks a report ID without a slot
+#define NO_SLOT				(0xFF)
+
+typedef struct _snapshot_slot_t
+{
+	LONG volatile sequence; // Odd while the slot is being written
+
+	uint64_t timestamp_us;
+	uint32_t report_count;
+	size_t length; // Length of data (0 until the first report)
+
+	struct _hid_plan_t *p_plan;
+
+	uint8_t data[1]; // Report buffer (report_length bytes)
+
+} snapshot_slot_t, *psnapshot_slot_t;
+
+typedef struct _snapshot_context_t
+{
+	size_t report_length; // Length of the input reports
+
+	uint8_t *p_slots; // Slots, slot_size bytes apart
+	size_t slot_size;
+	size_t slot_count;
+
+	uint8_t slot_index[256]; // Slot of every report ID (NO_SLOT if none)
+
+} snapshot_context_t, *psnapshot_context_t;
+
+// Local declarations
+static psnapshot_slot_t get_slot(psnapshot_context_t p_context,
+		uint8_t report_id);
+
+// Implementation
+
+static psnapshot_slot_t get_slot(psnapshot_context_t p_context,
+		uint8_t report_id)
+{
+	uint8_t index = p_context->slot_index[report_id];
+
+	if (NO_SLOT == index)
+	{
+		return (NULL);
+	}
+
+	return ((psnapshot_slot_t) &p_context->p_slots[index
+			* p_context->slot_size]);
+}
+
+HANDLE hid_snapshot_create(phid_device_t p_hid_device)
+{
+	psnapshot_context_t p_context;
+	phid_report_t p_report;
+	size_t index;
+
+	if (NULL == p_hid_device)
+	{
+		return (NULL);
+	}
+
+	p_report = &p_hid_device->report[HID_REPORT_TYPE_INPUT];
+	if ((0 == p_report->report_buffer_length)
+			|| (p_report->number_report_ids >= NO_SLOT))
+	{
+		return (NULL);
+	}
+
+	p_context = (psnapshot_context_t) calloc(1, sizeof(snapshot_context_t));
+	if (NULL == p_context)
+	{
+		return (NULL);
+	}
+
+	p_context->report_length = p_report->report_buffer_length;
+	p_context->slot_count =
+			(0 == p_report->number_report_ids) ?
+					1 : p_report->number_report_ids;
+	p_context->slot_size = (offsetof(snapshot_slot_t, data)
+			+ p_context->report_length + CACHE_LINE_SIZE - 1)
+			& ~(size_t) (CACHE_LINE_SIZE - 1);
+
+	p_context->p_slots = (uint8_t *) _aligned_malloc(
+			p_context->slot_count * p_context->slot_size, CACHE_LINE_SIZE);
+	if (NULL == p_context->p_slots)
+	{
+		free(p_context);
+		return (NULL);
+	}
+	memset(p_context->p_slots, 0, p_context->slot_count * p_context->slot_size);
+
+	memset(p_context->slot_index, NO_SLOT, sizeof(p_context->slot_index));
+
+	if (0 == p_report->number_report_ids)
+	{
+		p_context->slot_index[0] = 0;
+	}
+
+	for (index = 0; index < p_report->number_report_ids; index++)
+	{
+		phid_report_id_t p_id = &p_report->p_report_ids[index];
+
+		p_context->slot_index[p_id->report_id] = (uint8_t) index;
+		get_slot(p_context, p_id->report_id)->p_plan = p_id->p_plan;
+	}
+
+	return ((HANDLE) p_context);
+}
+
+void hid_snapshot_update(HANDLE h_snapshot, char const * p_report_buffer,
+		size_t report_buffer_length, uint64_t timestamp_us)
+{
+	psnapshot_context_t p_context = (psnapshot_context_t) h_snapshot;
+	psnapshot_slot_t p_slot;
+
+	if ((NULL == p_context) || (NULL == p_report_buffer)
+			|| (0 == report_buffer_length))
+	{
+		return;
+	}
+
+	p_slot = get_slot(p_context, (uint8_t) p_report_buffer[0]);
+	if (NULL == p_slot)
+	{
+		return;
+	}
+
+	if (report_buffer_length > p_context->report_length)
+	{
+		report_buffer_length = p_context->report_length;
+	}
+
+	// Odd while the slot is written (the increments are full barriers)
+	InterlockedIncrement(&p_slot->sequence);
+
+	p_slot->timestamp_us = timestamp_us;
+	p_slot->report_count++;
+	p_slot->length = report_buffer_length;
+	memcpy(p_slot->data, p_report_buffer, report_buffer_length);
+
+	InterlockedIncrement(&p_slot->sequence);
+}
+
+bool hid_snapshot_read(HANDLE h_snapshot, uint8_t report_id,
+		phid_snapshot_t p_snapshot, size_t data_size)
+{
+	psnapshot_context_t p_context = (psnapshot_context_t) h_snapshot;
+	psnapshot_slot_t p_slot;
+	LONG sequence;
+
+	if ((NULL == p_context) || (NULL == p_snapshot)
+			|| (NULL == p_snapshot->p_data)
+			|| (data_size < p_context->report_length))
+	{
+		return (false);
+	}
+
+	p_slot = get_slot(p_context, report_id);
+	if (NULL == p_slot)
+	{
+		return (false);
+	}
+
+	// Copy until the copy was not overlapped by an update
+	do
+	{
+		sequence = p_slot->sequence;
+		if (sequence & 1)
+		{
+			YieldProcessor();
+			continue;
+		}
+
+		MemoryBarrier();
+
+		p_snapshot->timestamp_us = p_slot->timestamp_us;
+		p_snapshot->report_count = p_slot->report_count;
+		p_snapshot->length = p_slot->length;
+		memcpy(p_snapshot->p_data, p_slot->data, p_context->report_length);
+
+		MemoryBarrier();
+
+	} while ((sequence & 1) || (sequence != p_slot->sequence));
+
+	p_snapshot->p_plan = p_slot->p_plan;
+
+	return (0 != p_snapshot->length);
+}
+
+void hid_snapshot_destroy(HANDLE h_snapshot)
+{
+	psnapshot_context_t p_context = (psnapshot_context_t) h_snapshot;
+
+	if (NULL == p_context)
+	{
+		return;
+	}
+
+	_aligned_free(p_context->p_slots);
+	free(p_context);
+}
@@ -0,0 +1,166 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_snapshot.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_SNAPSHOT_H_
+#define USB_HID_SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_snapshot
+
+ \brief These APIs keep the latest input report of every report ID of a HID
+ so any number of threads may poll the device state at their own rate.
+ */
+/* ************************************************************************* */
+
+/*
+
+ Each report ID has a slot guarded by a sequence lock. The reader thread (the
+ single writer) makes the sequence odd, copies the report in and makes it
+ even again. Consumers copy the slot out and retry if the sequence was odd or
+ changed meanwhile, so they never block the reader nor each other and never
+ see a report half written.
+
+ Snapshots hold the raw report; its fields are decoded with the report ID's
+ plan (see hid_plan_extract_value()) at whatever rate the consumer polls.
+
+ */
+
+// A consumer's copy of the latest report of a report ID
+typedef struct _hid_snapshot_t
+{
+	uint64_t timestamp_us; // When the report was received
+	uint32_t report_count; // Number of reports received with this report ID
+
+	struct _hid_plan_t *p_plan; // Plan of the report ID (NULL if none)
+
+	uint8_t *p_data; // Receives the report (caller's buffer)
+	size_t length; // Length of the report
+
+} hid_snapshot_t, *phid_snapshot_t;
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_snapshot
+
+ \brief Creates the snapshot of a HID's input reports.
+
+ \param[in] p_hid_device - A pointer to the opened HID.
+
+ \return A handle to the snapshot or NULL on failure.
+
+ */
+/* ************************************************************************** */
+
+HANDLE hid_snapshot_create(phid_device_t p_hid_device);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_snapshot
+
+ \brief Publishes a received input report.
+
+ \param[in] h_snapshot - A handle to the snapshot.
+ \param[in] p_report_buffer - The report (report ID in byte 0).
+ \param[in] report_buffer_length - The length of the report.
+ \param[in] timestamp_us - When the report was received.
+
+ Only a single thread may publish reports to a snapshot.
+
+ */
+/* ************************************************************************** */
+
+void hid_snapshot_update(HANDLE h_snapshot, char const * p_report_buffer,
+		size_t report_buffer_length, uint64_t timestamp_us);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_snapshot
+
+ \brief Copies out the latest report of a report ID.
+
+ \param[in] h_snapshot - A handle to the snapshot.
+ \param[in] report_id - The report ID (0 if the HID uses none).
+ \param[in,out] p_snapshot - Receives the report into its p_data.
+ \param[in] data_size - The size of p_snapshot->p_data, at least the length of
+ the HID's input reports.
+
+ \return Indicates if a report was copied (false if no report with this
+ report ID was received yet).
+
+ Any number of threads may read a snapshot while it is being updated.
+
+ */
+/* ************************************************************************** */
+
+bool hid_snapshot_read(HANDLE h_snapshot, uint8_t report_id,
+		phid_snapshot_t p_snapshot, size_t data_size);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_snapshot
+
+ \brief Destroys a snapshot.
+
+ \param[in] h_snapshot - A handle to the snapshot.
+
+ */
+/* ************************************************************************** */
+
+void hid_snapshot_destroy(HANDLE h_snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_SNAPSHOT_H_ */
@@ -0,0 +1,429 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_stream.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_hid_reports.h"
+#include "usb_hid_snapshot.h"
+
+// Module include
+#include "usb_hid_stream.h"
+
+// Records are kept 8 byte aligned for their timestamps
+#define RECORD_ALIGNMENT	(8)
+
+typedef struct _stream_context_t
+{
+	hid_device_t hid_device;
+
+	// Reader thread
+	HANDLE h_thread;
+	HANDLE h_read_event; // Signals a completed read
+	HANDLE h_stop_event; // Asks the reader thread to end
+
+	// Push consumer
+	hid_stream_callback_t callback;
+	void *p_user_context;
+
+	// Pull consumer; the queue is single producer (the reader thread) and
+	// single consumer so the counters only ever increase
+	uint8_t *p_queue;
+	size_t queue_depth;
+	size_t record_size;
+	LONG volatile head; // Records written
+	LONG volatile tail; // Records pulled
+	LONG volatile dropped; // Records dropped while the queue was full
+	HANDLE h_queued_event; // Signals records queued into an empty queue
+
+	// Record built for the callback
+	phid_stream_record_t p_record;
+
+} stream_context_t, *pstream_context_t;
+
+// Local declarations
+static DWORD WINAPI stream_thread_proc(pstream_context_t p_context);
+
+static void queue_record(pstream_context_t p_context, uint64_t timestamp_us,
+		char const * p_data, size_t length);
+
+// Implementation
+
+static DWORD WINAPI stream_thread_proc(pstream_context_t p_context)
+{
+	phid_device_t p_hid_device = &p_context->hid_device;
+	phid_report_t p_report = &p_hid_device->report[HID_REPORT_TYPE_INPUT];
+	HANDLE h_events[2];
+
+	h_events[0] = p_context->h_read_event;
+	h_events[1] = p_context->h_stop_event;
+
+	while (hid_read_overlapped(p_hid_device, p_context->h_read_event))
+	{
+		DWORD length;
+		DWORD wait_status;
+
+		wait_status = WaitForMultipleObjects(2, h_events, FALSE, INFINITE);
+		if (WAIT_OBJECT_0 != wait_status)
+		{
+			// The buffer must not be released while the read is outstanding
+			CancelIo(p_hid_device->h_device);
+			GetOverlappedResult(p_hid_device->h_device, &p_report->overlap,
+					&length, TRUE);
+			break;
+		}
+
+		// Fails once the HID is gone
+		if (!GetOverlappedResult(p_hid_device->h_device, &p_report->overlap,
+				&length, FALSE))
+		{
+			break;
+		}
+
+		p_report->timestamp_us = hid_timestamp_now();
+
+		hid_snapshot_update(p_hid_device->h_snapshot, p_report->p_report_buffer,
+				length, p_report->timestamp_us);
+
+		if (NULL != p_context->callback)
+		{
+			p_context->p_record->timestamp_us = p_report->timestamp_us;
+			p_context->p_record->length = length;
+			memcpy(p_context->p_record->data, p_report->p_report_buffer,
+					length);
+
+			p_context->callback(p_context->p_user_context, p_hid_device,
+					p_context->p_record);
+		}
+		else
+		{
+			queue_record(p_context, p_report->timestamp_us,
+					p_report->p_report_buffer, length);
+		}
+	}
+
+	return (0);
+}
+
+static void queue_record(pstream_context_t p_context, uint64_t timestamp_us,
+		char const * p_data, size_t length)
+{
+	LONG head = p_context->head;
+	phid_stream_record_t p_record;
+
+	if ((ULONG) (head - p_context->tail) >= p_context->queue_depth)
+	{
+		InterlockedIncrement(&p_context->dropped);
+		return;
+	}
+
+	p_record = (phid_stream_record_t) &p_context->p_queue[((ULONG) head
+			% p_context->queue_depth) * p_context->record_size];
+
+	p_record->timestamp_us = timestamp_us;
+	p_record->length = length;
+	memcpy(p_record->data, p_data, length);
+
+	// Publish the record before it is counted (a full barrier)
+	InterlockedExchange(&p_context->head, head + 1);
+
+	// Only a consumer that found the queue empty may be waiting. The tail
+	// is read again as the consumer may have drained the queue meanwhile
+	if (head == p_context->tail)
+	{
+		SetEvent(p_context->h_queued_event);
+	}
+}
+
+HANDLE hid_stream_open(phid_filter_t const p_filter)
+{
+	pstream_context_t p_context;
+	char *p_device_path;
+	size_t report_length;
+	bool success;
+
+	if (!usb_find_hid_device_path(p_filter, &p_device_path))
+	{
+		return (NULL);
+	}
+
+	p_context = (pstream_context_t) calloc(1, sizeof(stream_context_t));
+	if (NULL == p_context)
+	{
+		free(p_device_path);
+		return (NULL);
+	}
+
+	success = usb_open_hid(p_device_path, USB_READ_ACCESS | USB_OVERLAPPED,
+			&p_context->hid_device);
+	free(p_device_path);
+
+	report_length =
+			p_context->hid_device.report[HID_REPORT_TYPE_INPUT].report_buffer_length;
+	if (!success || (0 == report_length))
+	{
+		usb_close_hid(&p_context->hid_device);
+		free(p_context);
+		return (NULL);
+	}
+
+	p_context->record_size = (sizeof(hid_stream_record_t) + report_length
+			+ RECORD_ALIGNMENT - 1) & ~(size_t) (RECORD_ALIGNMENT - 1);
+
+	return ((HANDLE) p_context);
+}
+
+phid_device_t hid_stream_get_device(HANDLE h_stream)
+{
+	pstream_context_t p_context = (pstream_context_t) h_stream;
+
+	if (NULL == p_context)
+	{
+		return (NULL);
+	}
+
+	return (&p_context->hid_device);
+}
+
+bool hid_stream_start(HANDLE h_stream, hid_stream_callback_t callback,
+		void *p_user_context, size_t queue_depth)
+{
+	pstream_context_t p_context = (pstream_context_t) h_stream;
+	DWORD thread_id;
+
+	if ((NULL == p_context) || (NULL != p_context->h_thread))
+	{
+		return (false);
+	}
+
+	p_context->callback = callback;
+	p_context->p_user_context = p_user_context;
+
+	if (NULL != callback)
+	{
+		p_context->p_record = (phid_stream_record_t) malloc(
+				p_context->record_size);
+		if (NULL == p_context->p_record)
+		{
+			return (false);
+		}
+	}
+	else
+	{
+		p_context->queue_depth =
+				(0 == queue_depth) ? HID_STREAM_QUEUE_DEPTH : queue_depth;
+		p_context->p_queue = (uint8_t *) malloc(
+				p_context->queue_depth * p_context->record_size);
+		p_context->h_queued_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+		if ((NULL == p_context->p_queue) || (NULL == p_context->h_queued_event))
+		{
+			return (false);
+		}
+	}
+
+	p_context->h_read_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	p_context->h_stop_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if ((NULL == p_context->h_read_event) || (NULL == p_context->h_stop_event))
+	{
+		return (false);
+	}
+
+	p_context->h_thread = CreateThread(NULL, 0,
+			(LPTHREAD_START_ROUTINE) stream_thread_proc, p_context, 0,
+			&thread_id);
+	if (NULL == p_context->h_thread)
+	{
+		print_errno("Unable to create stream thread");
+		return (false);
+	}
+
+	return (true);
+}
+
+size_t hid_stream_get_record_size(HANDLE h_stream)
+{
+	pstream_context_t p_context = (pstream_context_t) h_stream;
+
+	if (NULL == p_context)
+	{
+		return (0);
+	}
+
+	return (p_context->record_size);
+}
+
+size_t hid_stream_pull(HANDLE h_stream, void *p_batch, size_t batch_size,
+		uint32_t timeout_ms)
+{
+	pstream_context_t p_context = (pstream_context_t) h_stream;
+	uint8_t *p_out = (uint8_t *) p_batch;
+	HANDLE h_events[2];
+	DWORD event_count;
+	DWORD wait_status;
+	LONG tail;
+	size_t count;
+	size_t first;
+	size_t index;
+
+	if ((NULL == p_context) || (NULL == p_context->p_queue)
+			|| (NULL == p_batch))
+	{
+		return (0);
+	}
+
+	h_events[0] = p_context->h_queued_event;
+	h_events[1] = p_context->h_thread;
+	event_count = (NULL == p_context->h_thread) ? 1 : 2;
+
+	// A left over signal may end a wait early, so wait again until a record
+	// arrives, the reader thread ends or the timeout passes
+	tail = p_context->tail;
+	wait_status = WAIT_OBJECT_0;
+	while ((p_context->head == tail) && (WAIT_OBJECT_0 == wait_status))
+	{
+		wait_status = WaitForMultipleObjects(event_count, h_events, FALSE,
+				timeout_ms);
+	}
+
+	// Records queued before the reader thread ended are still pulled
+	if ((p_context->head == tail) && (WAIT_OBJECT_0 + 1 == wait_status))
+	{
+		return (HID_STREAM_ENDED);
+	}
+
+	count = (ULONG) (p_context->head - tail);
+	if (count > batch_size / p_context->record_size)
+	{
+		count = batch_size / p_context->record_size;
+	}
+	if (0 == count)
+	{
+		return (0);
+	}
+
+	// The records are read only after they were counted
+	MemoryBarrier();
+
+	// Copy up to the end of the queue then wrap around
+	index = (ULONG) tail % p_context->queue_depth;
+	first = p_context->queue_depth - index;
+	if (first > count)
+	{
+		first = count;
+	}
+
+	memcpy(p_out, &p_context->p_queue[index * p_context->record_size],
+			first * p_context->record_size);
+	memcpy(&p_out[first * p_context->record_size], p_context->p_queue,
+			(count - first) * p_context->record_size);
+
+	// Release the slots once copied (a full barrier)
+	InterlockedExchange(&p_context->tail, tail + (LONG) count);
+
+	return (count);
+}
+
+uint32_t hid_stream_get_dropped(HANDLE h_stream)
+{
+	pstream_context_t p_context = (pstream_context_t) h_stream;
+
+	if (NULL == p_context)
+	{
+		return (0);
+	}
+
+	return ((uint32_t) p_context->dropped);
+}
+
+void hid_stream_close(HANDLE h_stream)
+{
+	pstream_context_t p_context = (pstream_context_t) h_stream;
+
+	if (NULL == p_context)
+	{
+		return;
+	}
+
+	if (NULL != p_context->h_thread)
+	{
+		SetEvent(p_context->h_stop_event);
+		WaitForSingleObject(p_context->h_thread, INFINITE);
+		CloseHandle(p_context->h_thread);
+	}
+
+	if (NULL != p_context->h_read_event)
+	{
+		CloseHandle(p_context->h_read_event);
+	}
+
+	if (NULL != p_context->h_stop_event)
+	{
+		CloseHandle(p_context->h_stop_event);
+	}
+
+	if (NULL != p_context->h_queued_event)
+	{
+		CloseHandle(p_context->h_queued_event);
+	}
+
+	usb_close_hid(&p_context->hid_device);
+
+	free(p_context->p_queue);
+	free(p_context->p_record);
+	free(p_context);
+}
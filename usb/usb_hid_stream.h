@@ -0,0 +1,224 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_stream.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_STREAM_H_
+#define USB_HID_STREAM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_stream
+
+ \brief These APIs stream the input reports of a HID into an application.
+ */
+/* ************************************************************************* */
+
+/*
+
+ A stream owns the HID it opened, a reader thread and, when pulled, a queue.
+ All state lives in the stream's context so an application may run as many
+ streams as it has HIDs, each with its own consumer.
+
+ Reports are either pushed to a callback on the reader thread or queued as
+ fixed size records which the application pulls in batches. Either way the
+ HID's snapshot is kept up to date so the latest state may also be polled.
+
+ */
+
+// Default number of reports a pulled stream queues
+#define HID_STREAM_QUEUE_DEPTH		(1024)
+
+// Pulled once the reader thread ended (e.g. the HID was removed) and every
+// queued report was pulled
+#define HID_STREAM_ENDED			((size_t) -1)
+
+// A report of a stream
+typedef struct _hid_stream_record_t
+{
+	uint64_t timestamp_us; // When the report was received
+	uint32_t length; // Length of data
+	uint32_t reserved;
+
+	uint8_t data[0]; // The report (report ID in byte 0)
+
+} hid_stream_record_t, *phid_stream_record_t;
+
+// Receives reports on the reader thread (p_record is only valid during call)
+typedef void (*hid_stream_callback_t)(void *p_user_context,
+		phid_device_t p_hid_device, phid_stream_record_t const p_record);
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_stream
+
+ \brief Opens a stream on the HID selected by the provided filter.
+
+ \param[in] p_filter - The attributes and usage the HID must match.
+
+ \return A handle to the stream or NULL if no HID matched or it cannot be
+ opened.
+
+ The HID is opened and its report plans are compiled but no report is read
+ until the stream is started.
+
+ */
+/* ************************************************************************** */
+
+HANDLE hid_stream_open(phid_filter_t const p_filter);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_stream
+
+ \brief Retrieves the HID of a stream.
+
+ \param[in] h_stream - A handle to the stream.
+
+ \return A pointer to the HID which remains valid until the stream is closed.
+
+ */
+/* ************************************************************************** */
+
+phid_device_t hid_stream_get_device(HANDLE h_stream);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_stream
+
+ \brief Starts reading the reports of a stream.
+
+ \param[in] h_stream - A handle to the stream.
+ \param[in] callback - Receives every report on the reader thread, or NULL to
+ queue the reports for hid_stream_pull().
+ \param[in] p_user_context - Passed to the callback.
+ \param[in] queue_depth - Number of reports to queue (0 for the default).
+
+ \return Indicates if the reader thread was started.
+
+ */
+/* ************************************************************************** */
+
+bool hid_stream_start(HANDLE h_stream, hid_stream_callback_t callback,
+		void *p_user_context, size_t queue_depth);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_stream
+
+ \brief Retrieves the size of the records of a stream.
+
+ \param[in] h_stream - A handle to the stream.
+
+ \return The distance in bytes between the records hid_stream_pull() returns.
+
+ */
+/* ************************************************************************** */
+
+size_t hid_stream_get_record_size(HANDLE h_stream);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_stream
+
+ \brief Pulls a batch of queued reports.
+
+ \param[in] h_stream - A handle to the stream.
+ \param[out] p_batch - Receives the records, one record size apart.
+ \param[in] batch_size - Size of p_batch in bytes.
+ \param[in] timeout_ms - How long to wait for a report when the queue is empty.
+
+ \return The number of records pulled (0 on timeout), or HID_STREAM_ENDED
+ once the stream ended and nothing is left to pull.
+
+ Reports arriving while the queue is full are dropped and counted. The wait
+ also ends when the reader thread does, so a consumer waiting with INFINITE
+ learns that the HID is gone.
+
+ */
+/* ************************************************************************** */
+
+size_t hid_stream_pull(HANDLE h_stream, void *p_batch, size_t batch_size,
+		uint32_t timeout_ms);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_stream
+
+ \brief Retrieves the number of reports dropped because the queue was full.
+
+ \param[in] h_stream - A handle to the stream.
+
+ \return The number of dropped reports.
+
+ */
+/* ************************************************************************** */
+
+uint32_t hid_stream_get_dropped(HANDLE h_stream);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_stream
+
+ \brief Stops the reader thread and closes the stream and its HID.
+
+ \param[in] h_stream - A handle to the stream.
+
+ */
+/* ************************************************************************** */
+
+void hid_stream_close(HANDLE h_stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_STREAM_H_ */
@@ -0,0 +1,451 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_strings.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// WDK includes
+#include <usb.h>
+
+// Other includes
+#include "utf16.h"
+#include "fnv1a.h"
+
+// Module include
+#include "usb_hid_strings.h"
+
+// Number of HIDs the cache first makes room for
+#define CACHE_INITIAL_CAPACITY		(16)
+
+// States of the lock guarding the cache
+#define LOCK_NONE					(0)
+#define LOCK_INITIALIZING			(1)
+#define LOCK_READY					(2)
+
+typedef struct _hid_strings_entry_t
+{
+	char *p_device_path;
+	uint64_t path_hash; // Of the path in lower case
+
+	// Strings received so far (NULL if not received yet)
+	char *p_strings[HID_STRING_SIZE];
+
+	// When a request last failed, so it is not made again right away
+	bool is_failed[HID_STRING_SIZE];
+	DWORD failed_ms[HID_STRING_SIZE];
+
+} hid_strings_entry_t, *phid_strings_entry_t;
+
+typedef struct _hid_strings_cache_t
+{
+	phid_strings_entry_t p_entries;
+	size_t entry_count;
+	size_t capacity;
+
+	// Initialized on first use, XP offers no static initializer
+	volatile LONG lock_state;
+	CRITICAL_SECTION lock;
+
+} hid_strings_cache_t, *phid_strings_cache_t;
+
+// Local declarations
+static void lock_cache(void);
+
+static void unlock_cache(void);
+
+static uint64_t hash_path(char const * p_device_path);
+
+static phid_strings_entry_t find_entry(char const * p_device_path,
+		uint64_t path_hash);
+
+static phid_strings_entry_t add_entry(char const * p_device_path,
+		uint64_t path_hash);
+
+static void copy_text(char const * p_string, char * p_text, size_t text_size);
+
+static char * request_string(char const * p_device_path, hid_string_t string);
+
+// Interface paths name HIDs throughout the process, as does this cache
+static hid_strings_cache_t cache =
+{ NULL, 0, 0, LOCK_NONE };
+
+// Implementation
+
+static void lock_cache(void)
+{
+	// The first thread here initializes the lock, any other waits for it
+	if (LOCK_READY != cache.lock_state)
+	{
+		if (LOCK_NONE
+				== InterlockedCompareExchange(&cache.lock_state,
+						LOCK_INITIALIZING, LOCK_NONE))
+		{
+			InitializeCriticalSection(&cache.lock);
+			InterlockedExchange(&cache.lock_state, LOCK_READY);
+		}
+		else
+		{
+			while (LOCK_READY != cache.lock_state)
+			{
+				Sleep(0);
+			}
+		}
+	}
+
+	EnterCriticalSection(&cache.lock);
+}
+
+static void unlock_cache(void)
+{
+	LeaveCriticalSection(&cache.lock);
+}
+
+// Paths differing only in case name the same interface
+static uint64_t hash_path(char const * p_device_path)
+{
+	uint64_t hash = FNV1A_OFFSET_BASIS;
+
+	for (; '\0' != *p_device_path; p_device_path++)
+	{
+		uint8_t lower = (uint8_t) tolower((unsigned char) *p_device_path);
+
+		hash = fnv1a_hash(hash, &lower, sizeof(lower));
+	}
+
+	return (hash);
+}
+
+static phid_strings_entry_t find_entry(char const * p_device_path,
+		uint64_t path_hash)
+{
+	size_t index;
+
+	for (index = 0; index < cache.entry_count; index++)
+	{
+		phid_strings_entry_t p_entry = &cache.p_entries[index];
+
+		if ((p_entry->path_hash == path_hash)
+				&& (0 == _stricmp(p_entry->p_device_path, p_device_path)))
+		{
+			return (p_entry);
+		}
+	}
+
+	return (NULL);
+}
+
+static phid_strings_entry_t add_entry(char const * p_device_path,
+		uint64_t path_hash)
+{
+	phid_strings_entry_t p_entry;
+
+	if (cache.entry_count == cache.capacity)
+	{
+		size_t capacity =
+				(0 == cache.capacity) ?
+						CACHE_INITIAL_CAPACITY : 2 * cache.capacity;
+		phid_strings_entry_t p_entries;
+
+		p_entries = (phid_strings_entry_t) realloc(cache.p_entries,
+				capacity * sizeof(hid_strings_entry_t));
+		if (NULL == p_entries)
+		{
+			return (NULL);
+		}
+
+		cache.p_entries = p_entries;
+		cache.capacity = capacity;
+	}
+
+	p_entry = &cache.p_entries[cache.entry_count];
+	memset(p_entry, 0, sizeof(hid_strings_entry_t));
+
+	p_entry->p_device_path = (char *) malloc(strlen(p_device_path) + 1);
+	if (NULL == p_entry->p_device_path)
+	{
+		return (NULL);
+	}
+
+	strcpy(p_entry->p_device_path, p_device_path);
+	p_entry->path_hash = path_hash;
+	cache.entry_count++;
+
+	return (p_entry);
+}
+
+static void copy_text(char const * p_string, char * p_text, size_t text_size)
+{
+	size_t length = strlen(p_string);
+
+	if (length >= text_size)
+	{
+		length = text_size - 1;
+
+		// Never end in a partial UTF-8 sequence
+		while ((length > 0) && (0x80 == (p_string[length] & 0xC0)))
+		{
+			length--;
+		}
+	}
+
+	memcpy(p_text, p_string, length);
+	p_text[length] = '\0';
+}
+
+static char * request_string(char const * p_device_path, hid_string_t string)
+{
+	WCHAR wc_buffer[MAXIMUM_USB_STRING_LENGTH];
+	char mbc_buffer[UTF16_UTF8_SIZE(MAXIMUM_USB_STRING_LENGTH)];
+	HANDLE h_device;
+	BOOLEAN success = FALSE;
+	char *p_string;
+
+	// No access rights are needed, so HIDs the system owns open too
+	h_device = CreateFile(p_device_path, 0, FILE_SHARE_READ | FILE_SHARE_WRITE,
+			NULL, OPEN_EXISTING, 0, NULL);
+	if (INVALID_HANDLE_VALUE == h_device)
+	{
+		return (NULL);
+	}
+
+	switch (string)
+	{
+	case HID_STRING_MANUFACTURER:
+		success = HidD_GetManufacturerString(h_device, wc_buffer,
+				sizeof(wc_buffer));
+		break;
+	case HID_STRING_PRODUCT:
+		success = HidD_GetProductString(h_device, wc_buffer,
+				sizeof(wc_buffer));
+		break;
+	case HID_STRING_PHYSICAL:
+		success = HidD_GetPhysicalDescriptor(h_device, wc_buffer,
+				sizeof(wc_buffer));
+		break;
+	case HID_STRING_SERIAL_NUMBER:
+		success = HidD_GetSerialNumberString(h_device, wc_buffer,
+				sizeof(wc_buffer));
+		break;
+	default:
+		break;
+	}
+
+	CloseHandle(h_device);
+
+	if (!success)
+	{
+		return (NULL);
+	}
+
+	utf16le_to_utf8(wc_buffer, MAXIMUM_USB_STRING_LENGTH, mbc_buffer,
+			sizeof(mbc_buffer));
+
+	p_string = (char *) malloc(strlen(mbc_buffer) + 1);
+	if (NULL != p_string)
+	{
+		strcpy(p_string, mbc_buffer);
+	}
+
+	return (p_string);
+}
+
+bool hid_strings_get(char const * p_device_path, hid_string_t string,
+		char * p_text, size_t text_size)
+{
+	phid_strings_entry_t p_entry;
+	uint64_t path_hash;
+	char *p_string;
+	bool is_found = false;
+
+	if ((NULL == p_text) || (0 == text_size))
+	{
+		return (false);
+	}
+	p_text[0] = '\0';
+
+	if ((NULL == p_device_path) || (string >= HID_STRING_SIZE))
+	{
+		return (false);
+	}
+
+	path_hash = hash_path(p_device_path);
+
+	lock_cache();
+
+	p_entry = find_entry(p_device_path, path_hash);
+	if (NULL != p_entry)
+	{
+		if (NULL != p_entry->p_strings[string])
+		{
+			copy_text(p_entry->p_strings[string], p_text, text_size);
+			is_found = true;
+		}
+		else if (p_entry->is_failed[string]
+				&& ((GetTickCount() - p_entry->failed_ms[string])
+						< HID_STRINGS_RETRY_MS))
+		{
+			// Asked too recently to ask again
+			unlock_cache();
+			return (false);
+		}
+	}
+
+	unlock_cache();
+
+	if (is_found)
+	{
+		return (true);
+	}
+
+	// The HID is asked without holding the lock, as it may take a while
+	p_string = request_string(p_device_path, string);
+
+	lock_cache();
+
+	// The HID may have been forgotten, or asked by another thread, meanwhile
+	p_entry = find_entry(p_device_path, path_hash);
+	if (NULL == p_entry)
+	{
+		p_entry = add_entry(p_device_path, path_hash);
+	}
+
+	if (NULL != p_entry)
+	{
+		if (NULL == p_entry->p_strings[string])
+		{
+			p_entry->p_strings[string] = p_string;
+			p_string = NULL;
+		}
+
+		if (NULL != p_entry->p_strings[string])
+		{
+			copy_text(p_entry->p_strings[string], p_text, text_size);
+			is_found = true;
+		}
+		else
+		{
+			p_entry->is_failed[string] = true;
+			p_entry->failed_ms[string] = GetTickCount();
+		}
+	}
+	else if (NULL != p_string)
+	{
+		// Without room to keep it the string is still returned
+		copy_text(p_string, p_text, text_size);
+		is_found = true;
+	}
+
+	unlock_cache();
+
+	free(p_string);
+
+	return (is_found);
+}
+
+void hid_strings_forget(char const * p_device_path)
+{
+	phid_strings_entry_t p_entry;
+	size_t index;
+
+	if (NULL == p_device_path)
+	{
+		return;
+	}
+
+	lock_cache();
+
+	p_entry = find_entry(p_device_path, hash_path(p_device_path));
+	if (NULL != p_entry)
+	{
+		for (index = 0; index < HID_STRING_SIZE; index++)
+		{
+			free(p_entry->p_strings[index]);
+		}
+		free(p_entry->p_device_path);
+
+		// The last entry takes its place
+		*p_entry = cache.p_entries[--cache.entry_count];
+	}
+
+	unlock_cache();
+
+	return;
+}
+
+void hid_strings_free(void)
+{
+	size_t index;
+
+	lock_cache();
+
+	while (cache.entry_count > 0)
+	{
+		phid_strings_entry_t p_entry = &cache.p_entries[--cache.entry_count];
+
+		for (index = 0; index < HID_STRING_SIZE; index++)
+		{
+			free(p_entry->p_strings[index]);
+		}
+		free(p_entry->p_device_path);
+	}
+
+	free(cache.p_entries);
+	cache.p_entries = NULL;
+	cache.capacity = 0;
+
+	unlock_cache();
+
+	return;
+}
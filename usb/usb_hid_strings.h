@@ -0,0 +1,150 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_strings.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_STRINGS_H_
+#define USB_HID_STRINGS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_strings
+
+ \brief These APIs retrieve the manufacturer, product, physical and serial
+ number strings of HIDs, requesting each from a HID only when first used.
+ */
+/* ************************************************************************* */
+
+/*
+
+ Each string is a control transfer that may stall for tens of milliseconds,
+ so strings are only requested when first asked for and then kept by the
+ interface path of their HID. A HID is named by that path throughout the
+ process, so the one cache serves discovery, opening and printing alike.
+
+ The cache is shared by every thread (e.g. by streams opened concurrently)
+ and guarded by a lock, which is not held while a HID is asked for a string.
+ Strings are copied out, so a HID forgotten by another thread meanwhile does
+ no harm. A request that fails is made again once HID_STRINGS_RETRY_MS have
+ passed, as a HID may just have been too busy to answer.
+
+ Strings are requested through a handle of their own, opened without access
+ rights and not overlapped as the HidD_ functions require, so they may be
+ asked for whether or how the HID is opened.
+
+ */
+
+typedef enum _hid_string_t
+{
+	HID_STRING_MANUFACTURER,
+	HID_STRING_PRODUCT,
+	HID_STRING_PHYSICAL,
+	HID_STRING_SERIAL_NUMBER,
+	HID_STRING_SIZE
+
+} hid_string_t, *phid_string_t;
+
+// Room for the UTF-8 of the longest string descriptor (126 UTF-16 units)
+#define HID_STRINGS_TEXT_SIZE		(3 * 126 + 1)
+
+// A failed request is not made again before this many milliseconds
+#define HID_STRINGS_RETRY_MS		(1000)
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_strings
+
+ \brief Retrieves a string of a HID, requesting it on first use.
+
+ \param[in] p_device_path - The interface path of the HID.
+ \param[in] string - Which string.
+ \param[out] p_text - Receives the string in UTF-8 (empty if there is none).
+ \param[in] text_size - The size of p_text, HID_STRINGS_TEXT_SIZE holds any
+ string.
+
+ \return Indicates if the HID has the string.
+
+ */
+/* ************************************************************************** */
+
+bool hid_strings_get(char const * p_device_path, hid_string_t string,
+		char * p_text, size_t text_size);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_strings
+
+ \brief Forgets the strings of a HID, e.g. once it is removed, so another
+ device later given the same path is asked again.
+
+ \param[in] p_device_path - The interface path of the HID.
+
+ */
+/* ************************************************************************** */
+
+void hid_strings_forget(char const * p_device_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_strings
+
+ \brief Forgets the strings of every HID, releasing the cache.
+
+ */
+/* ************************************************************************** */
+
+void hid_strings_free(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_STRINGS_H_ */
@@ -0,0 +1,1328 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_usages.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Module include
+#include "usb_hid_usages.h"
+
+/*
+
+ Names are found through a two level direct index: the usage page selects
+ an entry of usage_pages (through page_index) and the usage indexes that
+ page's array of names. Both levels are plain array accesses on constant
+ tables, so naming a usage costs the same whatever the table sizes.
+
+ */
+
+typedef struct _hid_usage_page_t
+{
+	char const *p_name;
+
+	char const * const *pp_usages; // Names indexed by usage (NULL if unnamed)
+	size_t usage_count; // Number elements in this array.
+
+} hid_usage_page_t, *phid_usage_page_t;
+
+#define ENTRY_COUNT(entries)	(sizeof(entries) / sizeof((entries)[0]))
+
+// Usage pages from this one on are vendor defined
+#define VENDOR_USAGE_PAGE		(0xFF00)
+
+static char const * const generic_desktop_usages[] =
+{
+[0x01] = "Pointer",
+[0x02] = "Mouse",
+[0x04] = "Joystick",
+[0x05] = "Game Pad",
+[0x06] = "Keyboard",
+[0x07] = "Keypad",
+[0x08] = "Multi-axis Controller",
+[0x09] = "Tablet PC System Controls",
+[0x0A] = "Water Cooling Device",
+[0x0B] = "Computer Chassis Device",
+[0x0C] = "Wireless Radio Controls",
+[0x0D] = "Portable Device Control",
+[0x0E] = "System Multi-Axis Controller",
+[0x0F] = "Spatial Controller",
+[0x10] = "Assistive Control",
+[0x11] = "Device Dock",
+[0x12] = "Dockable Device",
+[0x13] = "Call State Management Control",
+[0x30] = "X",
+[0x31] = "Y",
+[0x32] = "Z",
+[0x33] = "Rx",
+[0x34] = "Ry",
+[0x35] = "Rz",
+[0x36] = "Slider",
+[0x37] = "Dial",
+[0x38] = "Wheel",
+[0x39] = "Hat Switch",
+[0x3A] = "Counted Buffer",
+[0x3B] = "Byte Count",
+[0x3C] = "Motion Wakeup",
+[0x3D] = "Start",
+[0x3E] = "Select",
+[0x40] = "Vx",
+[0x41] = "Vy",
+[0x42] = "Vz",
+[0x43] = "Vbrx",
+[0x44] = "Vbry",
+[0x45] = "Vbrz",
+[0x46] = "Vno",
+[0x47] = "Feature Notification",
+[0x48] = "Resolution Multiplier",
+[0x49] = "Qx",
+[0x4A] = "Qy",
+[0x4B] = "Qz",
+[0x4C] = "Qw",
+[0x80] = "System Control",
+[0x81] = "System Power Down",
+[0x82] = "System Sleep",
+[0x83] = "System Wake Up",
+[0x84] = "System Context Menu",
+[0x85] = "System Main Menu",
+[0x86] = "System App Menu",
+[0x87] = "System Menu Help",
+[0x88] = "System Menu Exit",
+[0x89] = "System Menu Select",
+[0x8A] = "System Menu Right",
+[0x8B] = "System Menu Left",
+[0x8C] = "System Menu Up",
+[0x8D] = "System Menu Down",
+[0x8E] = "System Cold Restart",
+[0x8F] = "System Warm Restart",
+[0x90] = "D-pad Up",
+[0x91] = "D-pad Down",
+[0x92] = "D-pad Right",
+[0x93] = "D-pad Left",
+[0x94] = "Index Trigger",
+[0x95] = "Palm Trigger",
+[0x96] = "Thumbstick",
+[0x97] = "System Function Shift",
+[0x98] = "System Function Shift Lock",
+[0x99] = "System Function Shift Lock Indicator",
+[0x9A] = "System Dismiss Notification",
+[0x9B] = "System Do Not Disturb",
+[0xA0] = "System Dock",
+[0xA1] = "System Undock",
+[0xA2] = "System Setup",
+[0xA3] = "System Break",
+[0xA4] = "System Debugger Break",
+[0xA5] = "Application Break",
+[0xA6] = "Application Debugger Break",
+[0xA7] = "System Speaker Mute",
+[0xA8] = "System Hibernate",
+[0xB0] = "System Display Invert",
+[0xB1] = "System Display Internal",
+[0xB2] = "System Display External",
+[0xB3] = "System Display Both",
+[0xB4] = "System Display Dual",
+[0xB5] = "System Display Toggle Int/Ext",
+[0xB6] = "System Display Swap Primary/Secondary",
+[0xB7] = "System Display LCD Autoscale",
+[0xC0] = "Sensor Zone",
+[0xC1] = "RPM",
+[0xC2] = "Coolant Level",
+[0xC3] = "Coolant Critical Level",
+[0xC4] = "Coolant Pump",
+[0xC5] = "Chassis Enclosure",
+[0xC6] = "Wireless Radio Button",
+[0xC7] = "Wireless Radio LED",
+[0xC8] = "Wireless Radio Slider Switch",
+[0xC9] = "System Display Rotation Lock Button",
+[0xCA] = "System Display Rotation Lock Slider Switch",
+[0xCB] = "Control Enable" };
+
+static char const * const keyboard_usages[] =
+{
+[0x01] = "ErrorRollOver",
+[0x02] = "POSTFail",
+[0x03] = "ErrorUndefined",
+[0x04] = "Keyboard A",
+[0x05] = "Keyboard B",
+[0x06] = "Keyboard C",
+[0x07] = "Keyboard D",
+[0x08] = "Keyboard E",
+[0x09] = "Keyboard F",
+[0x0A] = "Keyboard G",
+[0x0B] = "Keyboard H",
+[0x0C] = "Keyboard I",
+[0x0D] = "Keyboard J",
+[0x0E] = "Keyboard K",
+[0x0F] = "Keyboard L",
+[0x10] = "Keyboard M",
+[0x11] = "Keyboard N",
+[0x12] = "Keyboard O",
+[0x13] = "Keyboard P",
+[0x14] = "Keyboard Q",
+[0x15] = "Keyboard R",
+[0x16] = "Keyboard S",
+[0x17] = "Keyboard T",
+[0x18] = "Keyboard U",
+[0x19] = "Keyboard V",
+[0x1A] = "Keyboard W",
+[0x1B] = "Keyboard X",
+[0x1C] = "Keyboard Y",
+[0x1D] = "Keyboard Z",
+[0x1E] = "Keyboard 1",
+[0x1F] = "Keyboard 2",
+[0x20] = "Keyboard 3",
+[0x21] = "Keyboard 4",
+[0x22] = "Keyboard 5",
+[0x23] = "Keyboard 6",
+[0x24] = "Keyboard 7",
+[0x25] = "Keyboard 8",
+[0x26] = "Keyboard 9",
+[0x27] = "Keyboard 0",
+[0x28] = "Keyboard Return",
+[0x29] = "Keyboard Escape",
+[0x2A] = "Keyboard Backspace",
+[0x2B] = "Keyboard Tab",
+[0x2C] = "Keyboard Spacebar",
+[0x2D] = "Keyboard - and _",
+[0x2E] = "Keyboard = and +",
+[0x2F] = "Keyboard [ and {",
+[0x30] = "Keyboard ] and }",
+[0x31] = "Keyboard \\ and |",
+[0x32] = "Keyboard Non-US # and ~",
+[0x33] = "Keyboard ; and :",
+[0x34] = "Keyboard ' and \"",
+[0x35] = "Keyboard Grave Accent and Tilde",
+[0x36] = "Keyboard , and <",
+[0x37] = "Keyboard . and >",
+[0x38] = "Keyboard / and ?",
+[0x39] = "Keyboard Caps Lock",
+[0x3A] = "Keyboard F1",
+[0x3B] = "Keyboard F2",
+[0x3C] = "Keyboard F3",
+[0x3D] = "Keyboard F4",
+[0x3E] = "Keyboard F5",
+[0x3F] = "Keyboard F6",
+[0x40] = "Keyboard F7",
+[0x41] = "Keyboard F8",
+[0x42] = "Keyboard F9",
+[0x43] = "Keyboard F10",
+[0x44] = "Keyboard F11",
+[0x45] = "Keyboard F12",
+[0x46] = "Keyboard PrintScreen",
+[0x47] = "Keyboard Scroll Lock",
+[0x48] = "Keyboard Pause",
+[0x49] = "Keyboard Insert",
+[0x4A] = "Keyboard Home",
+[0x4B] = "Keyboard PageUp",
+[0x4C] = "Keyboard Delete Forward",
+[0x4D] = "Keyboard End",
+[0x4E] = "Keyboard PageDown",
+[0x4F] = "Keyboard RightArrow",
+[0x50] = "Keyboard LeftArrow",
+[0x51] = "Keyboard DownArrow",
+[0x52] = "Keyboard UpArrow",
+[0x53] = "Keypad Num Lock",
+[0x54] = "Keypad /",
+[0x55] = "Keypad *",
+[0x56] = "Keypad -",
+[0x57] = "Keypad +",
+[0x58] = "Keypad Enter",
+[0x59] = "Keypad 1",
+[0x5A] = "Keypad 2",
+[0x5B] = "Keypad 3",
+[0x5C] = "Keypad 4",
+[0x5D] = "Keypad 5",
+[0x5E] = "Keypad 6",
+[0x5F] = "Keypad 7",
+[0x60] = "Keypad 8",
+[0x61] = "Keypad 9",
+[0x62] = "Keypad 0",
+[0x63] = "Keypad .",
+[0x64] = "Keyboard Non-US \\ and |",
+[0x65] = "Keyboard Application",
+[0x66] = "Keyboard Power",
+[0x67] = "Keypad =",
+[0x68] = "Keyboard F13",
+[0x69] = "Keyboard F14",
+[0x6A] = "Keyboard F15",
+[0x6B] = "Keyboard F16",
+[0x6C] = "Keyboard F17",
+[0x6D] = "Keyboard F18",
+[0x6E] = "Keyboard F19",
+[0x6F] = "Keyboard F20",
+[0x70] = "Keyboard F21",
+[0x71] = "Keyboard F22",
+[0x72] = "Keyboard F23",
+[0x73] = "Keyboard F24",
+[0x74] = "Keyboard Execute",
+[0x75] = "Keyboard Help",
+[0x76] = "Keyboard Menu",
+[0x77] = "Keyboard Select",
+[0x78] = "Keyboard Stop",
+[0x79] = "Keyboard Again",
+[0x7A] = "Keyboard Undo",
+[0x7B] = "Keyboard Cut",
+[0x7C] = "Keyboard Copy",
+[0x7D] = "Keyboard Paste",
+[0x7E] = "Keyboard Find",
+[0x7F] = "Keyboard Mute",
+[0x80] = "Keyboard Volume Up",
+[0x81] = "Keyboard Volume Down",
+[0x82] = "Keyboard Locking Caps Lock",
+[0x83] = "Keyboard Locking Num Lock",
+[0x84] = "Keyboard Locking Scroll Lock",
+[0x85] = "Keypad Comma",
+[0x86] = "Keypad Equal Sign",
+[0x87] = "Keyboard International1",
+[0x88] = "Keyboard International2",
+[0x89] = "Keyboard International3",
+[0x8A] = "Keyboard International4",
+[0x8B] = "Keyboard International5",
+[0x8C] = "Keyboard International6",
+[0x8D] = "Keyboard International7",
+[0x8E] = "Keyboard International8",
+[0x8F] = "Keyboard International9",
+[0x90] = "Keyboard LANG1",
+[0x91] = "Keyboard LANG2",
+[0x92] = "Keyboard LANG3",
+[0x93] = "Keyboard LANG4",
+[0x94] = "Keyboard LANG5",
+[0x95] = "Keyboard LANG6",
+[0x96] = "Keyboard LANG7",
+[0x97] = "Keyboard LANG8",
+[0x98] = "Keyboard LANG9",
+[0x99] = "Keyboard Alternate Erase",
+[0x9A] = "Keyboard SysReq/Attention",
+[0x9B] = "Keyboard Cancel",
+[0x9C] = "Keyboard Clear",
+[0x9D] = "Keyboard Prior",
+[0x9E] = "Keyboard Return",
+[0x9F] = "Keyboard Separator",
+[0xA0] = "Keyboard Out",
+[0xA1] = "Keyboard Oper",
+[0xA2] = "Keyboard Clear/Again",
+[0xA3] = "Keyboard CrSel/Props",
+[0xA4] = "Keyboard ExSel",
+[0xB0] = "Keypad 00",
+[0xB1] = "Keypad 000",
+[0xB2] = "Keypad Thousands Separator",
+[0xB3] = "Keypad Decimal Separator",
+[0xB4] = "Keypad Currency Unit",
+[0xB5] = "Keypad Currency Sub-unit",
+[0xB6] = "Keypad (",
+[0xB7] = "Keypad )",
+[0xB8] = "Keypad {",
+[0xB9] = "Keypad }",
+[0xBA] = "Keypad Tab",
+[0xBB] = "Keypad Backspace",
+[0xBC] = "Keypad A",
+[0xBD] = "Keypad B",
+[0xBE] = "Keypad C",
+[0xBF] = "Keypad D",
+[0xC0] = "Keypad E",
+[0xC1] = "Keypad F",
+[0xC2] = "Keypad XOR",
+[0xC3] = "Keypad ^",
+[0xC4] = "Keypad %",
+[0xC5] = "Keypad <",
+[0xC6] = "Keypad >",
+[0xC7] = "Keypad &",
+[0xC8] = "Keypad &&",
+[0xC9] = "Keypad |",
+[0xCA] = "Keypad ||",
+[0xCB] = "Keypad :",
+[0xCC] = "Keypad #",
+[0xCD] = "Keypad Space",
+[0xCE] = "Keypad @",
+[0xCF] = "Keypad !",
+[0xD0] = "Keypad Memory Store",
+[0xD1] = "Keypad Memory Recall",
+[0xD2] = "Keypad Memory Clear",
+[0xD3] = "Keypad Memory Add",
+[0xD4] = "Keypad Memory Subtract",
+[0xD5] = "Keypad Memory Multiply",
+[0xD6] = "Keypad Memory Divide",
+[0xD7] = "Keypad +/-",
+[0xD8] = "Keypad Clear",
+[0xD9] = "Keypad Clear Entry",
+[0xDA] = "Keypad Binary",
+[0xDB] = "Keypad Octal",
+[0xDC] = "Keypad Decimal",
+[0xDD] = "Keypad Hexadecimal",
+[0xE0] = "Keyboard LeftControl",
+[0xE1] = "Keyboard LeftShift",
+[0xE2] = "Keyboard LeftAlt",
+[0xE3] = "Keyboard Left GUI",
+[0xE4] = "Keyboard RightControl",
+[0xE5] = "Keyboard RightShift",
+[0xE6] = "Keyboard RightAlt",
+[0xE7] = "Keyboard Right GUI" };
+
+static char const * const led_usages[] =
+{
+[0x01] = "Num Lock",
+[0x02] = "Caps Lock",
+[0x03] = "Scroll Lock",
+[0x04] = "Compose",
+[0x05] = "Kana",
+[0x06] = "Power",
+[0x07] = "Shift",
+[0x08] = "Do Not Disturb",
+[0x09] = "Mute",
+[0x0A] = "Tone Enable",
+[0x0B] = "High Cut Filter",
+[0x0C] = "Low Cut Filter",
+[0x0D] = "Equalizer Enable",
+[0x0E] = "Sound Field On",
+[0x0F] = "Surround On",
+[0x10] = "Repeat",
+[0x11] = "Stereo",
+[0x12] = "Sampling Rate Detect",
+[0x13] = "Spinning",
+[0x14] = "CAV",
+[0x15] = "CLV",
+[0x16] = "Recording Format Detect",
+[0x17] = "Off-Hook",
+[0x18] = "Ring",
+[0x19] = "Message Waiting",
+[0x1A] = "Data Mode",
+[0x1B] = "Battery Operation",
+[0x1C] = "Battery OK",
+[0x1D] = "Battery Low",
+[0x1E] = "Speaker",
+[0x1F] = "Headset",
+[0x20] = "Hold",
+[0x21] = "Microphone",
+[0x22] = "Coverage",
+[0x23] = "Night Mode",
+[0x24] = "Send Calls",
+[0x25] = "Call Pickup",
+[0x26] = "Conference",
+[0x27] = "Stand-by",
+[0x28] = "Camera On",
+[0x29] = "Camera Off",
+[0x2A] = "On-Line",
+[0x2B] = "Off-Line",
+[0x2C] = "Busy",
+[0x2D] = "Ready",
+[0x2E] = "Paper-Out",
+[0x2F] = "Paper-Jam",
+[0x30] = "Remote",
+[0x31] = "Forward",
+[0x32] = "Reverse",
+[0x33] = "Stop",
+[0x34] = "Rewind",
+[0x35] = "Fast Forward",
+[0x36] = "Play",
+[0x37] = "Pause",
+[0x38] = "Record",
+[0x39] = "Error",
+[0x3A] = "Usage Selected Indicator",
+[0x3B] = "Usage In Use Indicator",
+[0x3C] = "Usage Multi Mode Indicator",
+[0x3D] = "Indicator On",
+[0x3E] = "Indicator Flash",
+[0x3F] = "Indicator Slow Blink",
+[0x40] = "Indicator Fast Blink",
+[0x41] = "Indicator Off",
+[0x42] = "Flash On Time",
+[0x43] = "Slow Blink On Time",
+[0x44] = "Slow Blink Off Time",
+[0x45] = "Fast Blink On Time",
+[0x46] = "Fast Blink Off Time",
+[0x47] = "Usage Indicator Color",
+[0x48] = "Indicator Red",
+[0x49] = "Indicator Green",
+[0x4A] = "Indicator Amber",
+[0x4B] = "Generic Indicator",
+[0x4C] = "System Suspend",
+[0x4D] = "External Power Connected" };
+
+static char const * const consumer_usages[] =
+{
+[0x01] = "Consumer Control",
+[0x02] = "Numeric Key Pad",
+[0x03] = "Programmable Buttons",
+[0x04] = "Microphone",
+[0x05] = "Headphone",
+[0x06] = "Graphic Equalizer",
+[0x20] = "+10",
+[0x21] = "+100",
+[0x22] = "AM/PM",
+[0x30] = "Power",
+[0x31] = "Reset",
+[0x32] = "Sleep",
+[0x33] = "Sleep After",
+[0x34] = "Sleep Mode",
+[0x35] = "Illumination",
+[0x36] = "Function Buttons",
+[0x40] = "Menu",
+[0x41] = "Menu Pick",
+[0x42] = "Menu Up",
+[0x43] = "Menu Down",
+[0x44] = "Menu Left",
+[0x45] = "Menu Right",
+[0x46] = "Menu Escape",
+[0x47] = "Menu Value Increase",
+[0x48] = "Menu Value Decrease",
+[0x60] = "Data On Screen",
+[0x61] = "Closed Caption",
+[0x62] = "Closed Caption Select",
+[0x63] = "VCR/TV",
+[0x64] = "Broadcast Mode",
+[0x65] = "Snapshot",
+[0x66] = "Still",
+[0x6F] = "Display Brightness Increment",
+[0x70] = "Display Brightness Decrement",
+[0x71] = "Display Brightness",
+[0x72] = "Display Backlight Toggle",
+[0x73] = "Display Set Brightness to Minimum",
+[0x74] = "Display Set Brightness to Maximum",
+[0x75] = "Display Set Auto Brightness",
+[0x80] = "Selection",
+[0x81] = "Assign Selection",
+[0x82] = "Mode Step",
+[0x83] = "Recall Last",
+[0x84] = "Enter Channel",
+[0x85] = "Order Movie",
+[0x86] = "Channel",
+[0x87] = "Media Selection",
+[0x88] = "Media Select Computer",
+[0x89] = "Media Select TV",
+[0x8A] = "Media Select WWW",
+[0x8B] = "Media Select DVD",
+[0x8C] = "Media Select Telephone",
+[0x8D] = "Media Select Program Guide",
+[0x8E] = "Media Select Video Phone",
+[0x8F] = "Media Select Games",
+[0x90] = "Media Select Messages",
+[0x91] = "Media Select CD",
+[0x92] = "Media Select VCR",
+[0x93] = "Media Select Tuner",
+[0x94] = "Quit",
+[0x95] = "Help",
+[0x96] = "Media Select Tape",
+[0x97] = "Media Select Cable",
+[0x98] = "Media Select Satellite",
+[0x99] = "Media Select Security",
+[0x9A] = "Media Select Home",
+[0x9B] = "Media Select Call",
+[0x9C] = "Channel Increment",
+[0x9D] = "Channel Decrement",
+[0x9E] = "Media Select SAP",
+[0xA0] = "VCR Plus",
+[0xA1] = "Once",
+[0xA2] = "Daily",
+[0xA3] = "Weekly",
+[0xA4] = "Monthly",
+[0xB0] = "Play",
+[0xB1] = "Pause",
+[0xB2] = "Record",
+[0xB3] = "Fast Forward",
+[0xB4] = "Rewind",
+[0xB5] = "Scan Next Track",
+[0xB6] = "Scan Previous Track",
+[0xB7] = "Stop",
+[0xB8] = "Eject",
+[0xB9] = "Random Play",
+[0xBA] = "Select Disc",
+[0xBB] = "Enter Disc",
+[0xBC] = "Repeat",
+[0xBD] = "Tracking",
+[0xBE] = "Track Normal",
+[0xBF] = "Slow Tracking",
+[0xC0] = "Frame Forward",
+[0xC1] = "Frame Back",
+[0xC2] = "Mark",
+[0xC3] = "Clear Mark",
+[0xC4] = "Repeat From Mark",
+[0xC5] = "Return To Mark",
+[0xC6] = "Search Mark Forward",
+[0xC7] = "Search Mark Backwards",
+[0xC8] = "Counter Reset",
+[0xC9] = "Show Counter",
+[0xCA] = "Tracking Increment",
+[0xCB] = "Tracking Decrement",
+[0xCC] = "Stop/Eject",
+[0xCD] = "Play/Pause",
+[0xCE] = "Play/Skip",
+[0xCF] = "Voice Command",
+[0xE0] = "Volume",
+[0xE1] = "Balance",
+[0xE2] = "Mute",
+[0xE3] = "Bass",
+[0xE4] = "Treble",
+[0xE5] = "Bass Boost",
+[0xE6] = "Surround Mode",
+[0xE7] = "Loudness",
+[0xE8] = "MPX",
+[0xE9] = "Volume Increment",
+[0xEA] = "Volume Decrement",
+[0xF0] = "Speed Select",
+[0xF1] = "Playback Speed",
+[0xF2] = "Standard Play",
+[0xF3] = "Long Play",
+[0xF4] = "Extended Play",
+[0xF5] = "Slow",
+[0x100] = "Fan Enable",
+[0x101] = "Fan Speed",
+[0x102] = "Light Enable",
+[0x103] = "Light Illumination Level",
+[0x104] = "Climate Control Enable",
+[0x105] = "Room Temperature",
+[0x106] = "Security Enable",
+[0x107] = "Fire Alarm",
+[0x108] = "Police Alarm",
+[0x109] = "Proximity",
+[0x10A] = "Motion",
+[0x10B] = "Duress Alarm",
+[0x10C] = "Holdup Alarm",
+[0x10D] = "Medical Alarm",
+[0x150] = "Balance Right",
+[0x151] = "Balance Left",
+[0x152] = "Bass Increment",
+[0x153] = "Bass Decrement",
+[0x154] = "Treble Increment",
+[0x155] = "Treble Decrement",
+[0x160] = "Speaker System",
+[0x161] = "Channel Left",
+[0x162] = "Channel Right",
+[0x163] = "Channel Center",
+[0x164] = "Channel Front",
+[0x165] = "Channel Center Front",
+[0x166] = "Channel Side",
+[0x167] = "Channel Surround",
+[0x168] = "Channel Low Frequency Enhancement",
+[0x169] = "Channel Top",
+[0x16A] = "Channel Unknown",
+[0x170] = "Sub-channel",
+[0x171] = "Sub-channel Increment",
+[0x172] = "Sub-channel Decrement",
+[0x173] = "Alternate Audio Increment",
+[0x174] = "Alternate Audio Decrement",
+[0x180] = "Application Launch Buttons",
+[0x181] = "AL Launch Button Configuration Tool",
+[0x182] = "AL Programmable Button Configuration",
+[0x183] = "AL Consumer Control Configuration",
+[0x184] = "AL Word Processor",
+[0x185] = "AL Text Editor",
+[0x186] = "AL Spreadsheet",
+[0x187] = "AL Graphics Editor",
+[0x188] = "AL Presentation App",
+[0x189] = "AL Database App",
+[0x18A] = "AL Email Reader",
+[0x18B] = "AL Newsreader",
+[0x18C] = "AL Voicemail",
+[0x18D] = "AL Contacts/Address Book",
+[0x18E] = "AL Calendar/Schedule",
+[0x18F] = "AL Task/Project Manager",
+[0x190] = "AL Log/Journal/Timecard",
+[0x191] = "AL Checkbook/Finance",
+[0x192] = "AL Calculator",
+[0x193] = "AL A/V Capture/Playback",
+[0x194] = "AL Local Machine Browser",
+[0x195] = "AL LAN/WAN Browser",
+[0x196] = "AL Internet Browser",
+[0x197] = "AL Remote Networking/ISP Connect",
+[0x198] = "AL Network Conference",
+[0x199] = "AL Network Chat",
+[0x19A] = "AL Telephony/Dialer",
+[0x19B] = "AL Logon",
+[0x19C] = "AL Logoff",
+[0x19D] = "AL Logon/Logoff",
+[0x19E] = "AL Terminal Lock/Screensaver",
+[0x19F] = "AL Control Panel",
+[0x1A0] = "AL Command Line Processor/Run",
+[0x1A1] = "AL Process/Task Manager",
+[0x1A2] = "AL Select Task/Application",
+[0x1A3] = "AL Next Task/Application",
+[0x1A4] = "AL Previous Task/Application",
+[0x1A5] = "AL Preemptive Halt Task/Application",
+[0x1A6] = "AL Integrated Help Center",
+[0x1A7] = "AL Documents",
+[0x1A8] = "AL Thesaurus",
+[0x1A9] = "AL Dictionary",
+[0x1AA] = "AL Desktop",
+[0x1AB] = "AL Spell Check",
+[0x1AC] = "AL Grammar Check",
+[0x1AD] = "AL Wireless Status",
+[0x1AE] = "AL Keyboard Layout",
+[0x1AF] = "AL Virus Protection",
+[0x1B0] = "AL Encryption",
+[0x1B1] = "AL Screen Saver",
+[0x1B2] = "AL Alarms",
+[0x1B3] = "AL Clock",
+[0x1B4] = "AL File Browser",
+[0x1B5] = "AL Power Status",
+[0x1B6] = "AL Image Browser",
+[0x1B7] = "AL Audio Browser",
+[0x1B8] = "AL Movie Browser",
+[0x1B9] = "AL Digital Rights Manager",
+[0x1BA] = "AL Digital Wallet",
+[0x1BC] = "AL Instant Messaging",
+[0x1BD] = "AL OEM Features/Tips/Tutorial Browser",
+[0x1BE] = "AL OEM Help",
+[0x1BF] = "AL Online Community",
+[0x1C0] = "AL Entertainment Content Browser",
+[0x1C1] = "AL Online Shopping Browser",
+[0x1C2] = "AL SmartCard Information/Help",
+[0x1C3] = "AL Market Monitor/Finance Browser",
+[0x1C4] = "AL Customized Corporate News Browser",
+[0x1C5] = "AL Online Activity Browser",
+[0x1C6] = "AL Research/Search Browser",
+[0x1C7] = "AL Audio Player",
+[0x200] = "Generic GUI Application Controls",
+[0x201] = "AC New",
+[0x202] = "AC Open",
+[0x203] = "AC Close",
+[0x204] = "AC Exit",
+[0x205] = "AC Maximize",
+[0x206] = "AC Minimize",
+[0x207] = "AC Save",
+[0x208] = "AC Print",
+[0x209] = "AC Properties",
+[0x21A] = "AC Undo",
+[0x21B] = "AC Copy",
+[0x21C] = "AC Cut",
+[0x21D] = "AC Paste",
+[0x21E] = "AC Select All",
+[0x21F] = "AC Find",
+[0x220] = "AC Find and Replace",
+[0x221] = "AC Search",
+[0x222] = "AC Go To",
+[0x223] = "AC Home",
+[0x224] = "AC Back",
+[0x225] = "AC Forward",
+[0x226] = "AC Stop",
+[0x227] = "AC Refresh",
+[0x228] = "AC Previous Link",
+[0x229] = "AC Next Link",
+[0x22A] = "AC Bookmarks",
+[0x22B] = "AC History",
+[0x22C] = "AC Subscriptions",
+[0x22D] = "AC Zoom In",
+[0x22E] = "AC Zoom Out",
+[0x22F] = "AC Zoom",
+[0x230] = "AC Full Screen View",
+[0x231] = "AC Normal View",
+[0x232] = "AC View Toggle",
+[0x233] = "AC Scroll Up",
+[0x234] = "AC Scroll Down",
+[0x235] = "AC Scroll",
+[0x236] = "AC Pan Left",
+[0x237] = "AC Pan Right",
+[0x238] = "AC Pan",
+[0x239] = "AC New Window",
+[0x23A] = "AC Tile Horizontally",
+[0x23B] = "AC Tile Vertically",
+[0x23C] = "AC Format",
+[0x23D] = "AC Edit",
+[0x23E] = "AC Bold",
+[0x23F] = "AC Italics",
+[0x240] = "AC Underline",
+[0x241] = "AC Strikethrough",
+[0x242] = "AC Subscript",
+[0x243] = "AC Superscript",
+[0x244] = "AC All Caps",
+[0x245] = "AC Rotate",
+[0x246] = "AC Resize",
+[0x247] = "AC Flip Horizontal",
+[0x248] = "AC Flip Vertical",
+[0x249] = "AC Mirror Horizontal",
+[0x24A] = "AC Mirror Vertical",
+[0x24B] = "AC Font Select",
+[0x24C] = "AC Font Color",
+[0x24D] = "AC Font Size",
+[0x24E] = "AC Justify Left",
+[0x24F] = "AC Justify Center H",
+[0x250] = "AC Justify Right",
+[0x251] = "AC Justify Block H",
+[0x252] = "AC Justify Top",
+[0x253] = "AC Justify Center V",
+[0x254] = "AC Justify Bottom",
+[0x255] = "AC Justify Block V",
+[0x256] = "AC Indent Decrease",
+[0x257] = "AC Indent Increase",
+[0x258] = "AC Numbered List",
+[0x259] = "AC Restart Numbering",
+[0x25A] = "AC Bulleted List",
+[0x25B] = "AC Promote",
+[0x25C] = "AC Demote",
+[0x25D] = "AC Yes",
+[0x25E] = "AC No",
+[0x25F] = "AC Cancel",
+[0x260] = "AC Catalog",
+[0x261] = "AC Buy/Checkout",
+[0x262] = "AC Add to Cart",
+[0x263] = "AC Expand",
+[0x264] = "AC Expand All",
+[0x265] = "AC Collapse",
+[0x266] = "AC Collapse All",
+[0x267] = "AC Print Preview",
+[0x268] = "AC Paste Special",
+[0x269] = "AC Insert Mode",
+[0x26A] = "AC Delete",
+[0x26B] = "AC Lock",
+[0x26C] = "AC Unlock",
+[0x26D] = "AC Protect",
+[0x26E] = "AC Unprotect",
+[0x26F] = "AC Attach Comment",
+[0x270] = "AC Delete Comment",
+[0x271] = "AC View Comment",
+[0x272] = "AC Select Word",
+[0x273] = "AC Select Sentence",
+[0x274] = "AC Select Paragraph",
+[0x275] = "AC Select Column",
+[0x276] = "AC Select Row",
+[0x277] = "AC Select Table",
+[0x278] = "AC Select Object",
+[0x279] = "AC Redo/Repeat",
+[0x27A] = "AC Sort",
+[0x27B] = "AC Sort Ascending",
+[0x27C] = "AC Sort Descending",
+[0x27D] = "AC Filter",
+[0x27E] = "AC Set Clock",
+[0x27F] = "AC View Clock",
+[0x280] = "AC Select Time Zone",
+[0x281] = "AC Edit Time Zones",
+[0x282] = "AC Set Alarm",
+[0x283] = "AC Clear Alarm",
+[0x284] = "AC Snooze Alarm",
+[0x285] = "AC Reset Alarm",
+[0x286] = "AC Synchronize",
+[0x287] = "AC Send/Receive",
+[0x288] = "AC Send To",
+[0x289] = "AC Reply",
+[0x28A] = "AC Reply All",
+[0x28B] = "AC Forward Msg",
+[0x28C] = "AC Send",
+[0x28D] = "AC Attach File",
+[0x28E] = "AC Upload",
+[0x28F] = "AC Download (Save Target As)",
+[0x290] = "AC Set Borders",
+[0x291] = "AC Insert Row",
+[0x292] = "AC Insert Column",
+[0x293] = "AC Insert File",
+[0x294] = "AC Insert Picture",
+[0x295] = "AC Insert Object",
+[0x296] = "AC Insert Symbol",
+[0x297] = "AC Save and Close",
+[0x298] = "AC Rename",
+[0x299] = "AC Merge",
+[0x29A] = "AC Split",
+[0x29B] = "AC Distribute Horizontally",
+[0x29C] = "AC Distribute Vertically" };
+
+static char const * const digitizers_usages[] =
+{
+[0x01] = "Digitizer",
+[0x02] = "Pen",
+[0x03] = "Light Pen",
+[0x04] = "Touch Screen",
+[0x05] = "Touch Pad",
+[0x06] = "Whiteboard",
+[0x07] = "Coordinate Measuring Machine",
+[0x08] = "3D Digitizer",
+[0x09] = "Stereo Plotter",
+[0x0A] = "Articulated Arm",
+[0x0B] = "Armature",
+[0x0C] = "Multiple Point Digitizer",
+[0x0D] = "Free Space Wand",
+[0x0E] = "Device Configuration",
+[0x0F] = "Capacitive Heat Map Digitizer",
+[0x20] = "Stylus",
+[0x21] = "Puck",
+[0x22] = "Finger",
+[0x23] = "Device Settings",
+[0x24] = "Character Gesture",
+[0x30] = "Tip Pressure",
+[0x31] = "Barrel Pressure",
+[0x32] = "In Range",
+[0x33] = "Touch",
+[0x34] = "Untouch",
+[0x35] = "Tap",
+[0x36] = "Quality",
+[0x37] = "Data Valid",
+[0x38] = "Transducer Index",
+[0x39] = "Tablet Function Keys",
+[0x3A] = "Program Change Keys",
+[0x3B] = "Battery Strength",
+[0x3C] = "Invert",
+[0x3D] = "X Tilt",
+[0x3E] = "Y Tilt",
+[0x3F] = "Azimuth",
+[0x40] = "Altitude",
+[0x41] = "Twist",
+[0x42] = "Tip Switch",
+[0x43] = "Secondary Tip Switch",
+[0x44] = "Barrel Switch",
+[0x45] = "Eraser",
+[0x46] = "Tablet Pick",
+[0x47] = "Touch Valid",
+[0x48] = "Width",
+[0x49] = "Height",
+[0x51] = "Contact Identifier",
+[0x52] = "Device Mode",
+[0x53] = "Device Identifier",
+[0x54] = "Contact Count",
+[0x55] = "Contact Count Maximum",
+[0x56] = "Scan Time",
+[0x57] = "Surface Switch",
+[0x58] = "Button Switch",
+[0x59] = "Pad Type",
+[0x5A] = "Secondary Barrel Switch",
+[0x5B] = "Transducer Serial Number",
+[0x5C] = "Preferred Color",
+[0x5D] = "Preferred Color is Locked",
+[0x5E] = "Preferred Line Width",
+[0x5F] = "Preferred Line Width is Locked",
+[0x60] = "Latency Mode",
+[0x61] = "Gesture Character Quality",
+[0x62] = "Character Gesture Data Length",
+[0x63] = "Character Gesture Data",
+[0x64] = "Gesture Character Encoding",
+[0x65] = "UTF8 Character Gesture Encoding",
+[0x66] = "UTF16 Little Endian Character Gesture Encoding",
+[0x67] = "UTF16 Big Endian Character Gesture Encoding",
+[0x68] = "UTF32 Little Endian Character Gesture Encoding",
+[0x69] = "UTF32 Big Endian Character Gesture Encoding",
+[0x6A] = "Capacitive Heat Map Protocol Vendor ID",
+[0x6B] = "Capacitive Heat Map Protocol Version",
+[0x6C] = "Capacitive Heat Map Frame Data",
+[0x6D] = "Gesture Character Enable",
+[0x6E] = "Transducer Serial Number Part 2",
+[0x6F] = "No Preferred Color",
+[0x70] = "Preferred Line Style",
+[0x71] = "Preferred Line Style is Locked",
+[0x72] = "Ink",
+[0x73] = "Pencil",
+[0x74] = "Highlighter",
+[0x75] = "Chisel Marker",
+[0x76] = "Brush",
+[0x77] = "No Preference",
+[0x80] = "Digitizer Diagnostic",
+[0x81] = "Digitizer Error",
+[0x82] = "Err Normal Status",
+[0x83] = "Err Transducers Exceeded",
+[0x84] = "Err Full Trans Features Unavailable",
+[0x85] = "Err Charge Low",
+[0x90] = "Transducer Software Info",
+[0x91] = "Transducer Vendor Id",
+[0x92] = "Transducer Product Id",
+[0x93] = "Device Supported Protocols",
+[0x94] = "Transducer Supported Protocols",
+[0x95] = "No Protocol",
+[0x96] = "Wacom AES Protocol",
+[0x97] = "USI Protocol",
+[0x98] = "Microsoft Pen Protocol",
+[0xA0] = "Supported Report Rates",
+[0xA1] = "Report Rate",
+[0xA2] = "Transducer Connected",
+[0xA3] = "Switch Disabled",
+[0xA4] = "Switch Unimplemented",
+[0xA5] = "Transducer Switches" };
+
+static char const * const sensors_usages[] =
+{
+[0x01] = "Sensor",
+[0x10] = "Biometric",
+[0x11] = "Biometric: Human Presence",
+[0x12] = "Biometric: Human Proximity",
+[0x13] = "Biometric: Human Touch",
+[0x20] = "Electrical",
+[0x21] = "Electrical: Capacitance",
+[0x22] = "Electrical: Current",
+[0x23] = "Electrical: Power",
+[0x24] = "Electrical: Inductance",
+[0x25] = "Electrical: Resistance",
+[0x26] = "Electrical: Voltage",
+[0x27] = "Electrical: Potentiometer",
+[0x28] = "Electrical: Frequency",
+[0x29] = "Electrical: Period",
+[0x30] = "Environmental",
+[0x31] = "Environmental: Atmospheric Pressure",
+[0x32] = "Environmental: Humidity",
+[0x33] = "Environmental: Temperature",
+[0x34] = "Environmental: Wind Direction",
+[0x35] = "Environmental: Wind Speed",
+[0x40] = "Light",
+[0x41] = "Light: Ambient Light",
+[0x42] = "Light: Consumer Infrared",
+[0x50] = "Location",
+[0x51] = "Location: Broadcast",
+[0x52] = "Location: Dead Reckoning",
+[0x53] = "Location: GPS",
+[0x54] = "Location: Lookup",
+[0x55] = "Location: Other",
+[0x56] = "Location: Static",
+[0x57] = "Location: Triangulation",
+[0x60] = "Mechanical",
+[0x61] = "Mechanical: Boolean Switch",
+[0x62] = "Mechanical: Boolean Switch Array",
+[0x63] = "Mechanical: Multivalue Switch",
+[0x64] = "Mechanical: Force",
+[0x65] = "Mechanical: Pressure",
+[0x66] = "Mechanical: Strain",
+[0x67] = "Mechanical: Weight",
+[0x68] = "Mechanical: Haptic Vibrator",
+[0x69] = "Mechanical: Hall Effect Switch",
+[0x70] = "Motion",
+[0x71] = "Motion: Accelerometer 1D",
+[0x72] = "Motion: Accelerometer 2D",
+[0x73] = "Motion: Accelerometer 3D",
+[0x74] = "Motion: Gyrometer 1D",
+[0x75] = "Motion: Gyrometer 2D",
+[0x76] = "Motion: Gyrometer 3D",
+[0x77] = "Motion: Motion Detector",
+[0x78] = "Motion: Speedometer",
+[0x79] = "Motion: Accelerometer",
+[0x7A] = "Motion: Gyrometer",
+[0x7B] = "Motion: Gravity Vector",
+[0x7C] = "Motion: Linear Accelerometer",
+[0x80] = "Orientation",
+[0x81] = "Orientation: Compass 1D",
+[0x82] = "Orientation: Compass 2D",
+[0x83] = "Orientation: Compass 3D",
+[0x84] = "Orientation: Inclinometer 1D",
+[0x85] = "Orientation: Inclinometer 2D",
+[0x86] = "Orientation: Inclinometer 3D",
+[0x87] = "Orientation: Distance 1D",
+[0x88] = "Orientation: Distance 2D",
+[0x89] = "Orientation: Distance 3D",
+[0x8A] = "Orientation: Device Orientation",
+[0x8B] = "Orientation: Compass",
+[0x8C] = "Orientation: Inclinometer",
+[0x8D] = "Orientation: Distance",
+[0x8E] = "Orientation: Relative Orientation",
+[0x8F] = "Orientation: Simple Orientation",
+[0x90] = "Scanner",
+[0x91] = "Scanner: Barcode",
+[0x92] = "Scanner: RFID",
+[0x93] = "Scanner: NFC",
+[0xA0] = "Time",
+[0xA1] = "Time: Alarm Timer",
+[0xA2] = "Time: Real Time Clock",
+[0xE0] = "Other",
+[0xE1] = "Other: Custom",
+[0xE2] = "Other: Generic",
+[0xE3] = "Other: Generic Enumerator",
+[0x200] = "Event",
+[0x201] = "Event: Sensor State",
+[0x202] = "Event: Sensor Event",
+[0x300] = "Property",
+[0x301] = "Property: Friendly Name",
+[0x302] = "Property: Persistent Unique ID",
+[0x303] = "Property: Sensor Status",
+[0x304] = "Property: Minimum Report Interval",
+[0x305] = "Property: Sensor Manufacturer",
+[0x306] = "Property: Sensor Model",
+[0x307] = "Property: Sensor Serial Number",
+[0x308] = "Property: Sensor Description",
+[0x309] = "Property: Sensor Connection Type",
+[0x30A] = "Property: Sensor Device Path",
+[0x30B] = "Property: Hardware Revision",
+[0x30C] = "Property: Firmware Version",
+[0x30D] = "Property: Release Date",
+[0x30E] = "Property: Report Interval",
+[0x30F] = "Property: Change Sensitivity Absolute",
+[0x310] = "Property: Change Sensitivity Percent of Range",
+[0x311] = "Property: Change Sensitivity Percent Relative",
+[0x312] = "Property: Accuracy",
+[0x313] = "Property: Resolution",
+[0x314] = "Property: Maximum",
+[0x315] = "Property: Minimum",
+[0x316] = "Property: Reporting State",
+[0x317] = "Property: Sampling Rate",
+[0x318] = "Property: Response Curve",
+[0x319] = "Property: Power State",
+[0x400] = "Data Field: Location",
+[0x402] = "Data Field: Altitude Antenna Sea Level",
+[0x403] = "Data Field: Differential Reference Station ID",
+[0x404] = "Data Field: Altitude Ellipsoid Error",
+[0x405] = "Data Field: Altitude Ellipsoid",
+[0x406] = "Data Field: Altitude Sea Level Error",
+[0x407] = "Data Field: Altitude Sea Level",
+[0x408] = "Data Field: Differential GPS Data Age",
+[0x409] = "Data Field: Error Radius",
+[0x40A] = "Data Field: Fix Quality",
+[0x40B] = "Data Field: Fix Type",
+[0x40C] = "Data Field: Geoidal Separation",
+[0x40D] = "Data Field: GPS Operation Mode",
+[0x40E] = "Data Field: GPS Selection Mode",
+[0x40F] = "Data Field: GPS Status",
+[0x410] = "Data Field: Position Dilution of Precision",
+[0x411] = "Data Field: Horizontal Dilution of Precision",
+[0x412] = "Data Field: Vertical Dilution of Precision",
+[0x413] = "Data Field: Latitude",
+[0x414] = "Data Field: Longitude",
+[0x415] = "Data Field: True Heading",
+[0x416] = "Data Field: Magnetic Heading",
+[0x417] = "Data Field: Magnetic Variation",
+[0x418] = "Data Field: Speed",
+[0x430] = "Data Field: Environmental",
+[0x431] = "Data Field: Atmospheric Pressure",
+[0x433] = "Data Field: Relative Humidity",
+[0x434] = "Data Field: Temperature",
+[0x435] = "Data Field: Wind Direction",
+[0x436] = "Data Field: Wind Speed",
+[0x440] = "Data Field: Motion",
+[0x441] = "Data Field: Motion State",
+[0x442] = "Data Field: Acceleration",
+[0x443] = "Data Field: Acceleration Axis X",
+[0x444] = "Data Field: Acceleration Axis Y",
+[0x445] = "Data Field: Acceleration Axis Z",
+[0x446] = "Data Field: Angular Velocity",
+[0x447] = "Data Field: Angular Velocity about X Axis",
+[0x448] = "Data Field: Angular Velocity about Y Axis",
+[0x449] = "Data Field: Angular Velocity about Z Axis",
+[0x44A] = "Data Field: Angular Position",
+[0x44B] = "Data Field: Angular Position about X Axis",
+[0x44C] = "Data Field: Angular Position about Y Axis",
+[0x44D] = "Data Field: Angular Position about Z Axis",
+[0x44E] = "Data Field: Motion Speed",
+[0x44F] = "Data Field: Motion Intensity",
+[0x470] = "Data Field: Orientation",
+[0x471] = "Data Field: Heading",
+[0x472] = "Data Field: Heading X Axis",
+[0x473] = "Data Field: Heading Y Axis",
+[0x474] = "Data Field: Heading Z Axis",
+[0x475] = "Data Field: Heading Compensated Magnetic North",
+[0x476] = "Data Field: Heading Compensated True North",
+[0x477] = "Data Field: Heading Magnetic North",
+[0x478] = "Data Field: Heading True North",
+[0x479] = "Data Field: Distance",
+[0x47A] = "Data Field: Distance X Axis",
+[0x47B] = "Data Field: Distance Y Axis",
+[0x47C] = "Data Field: Distance Z Axis",
+[0x47D] = "Data Field: Distance Out-of-Range",
+[0x47E] = "Data Field: Tilt",
+[0x47F] = "Data Field: Tilt X Axis",
+[0x480] = "Data Field: Tilt Y Axis",
+[0x481] = "Data Field: Tilt Z Axis",
+[0x482] = "Data Field: Rotation Matrix",
+[0x483] = "Data Field: Quaternion",
+[0x484] = "Data Field: Magnetic Flux",
+[0x485] = "Data Field: Magnetic Flux X Axis",
+[0x486] = "Data Field: Magnetic Flux Y Axis",
+[0x487] = "Data Field: Magnetic Flux Z Axis",
+[0x488] = "Data Field: Magnetometer Accuracy",
+[0x489] = "Data Field: Simple Orientation Direction",
+[0x4D0] = "Data Field: Light",
+[0x4D1] = "Data Field: Illuminance",
+[0x4D2] = "Data Field: Color Temperature",
+[0x4D3] = "Data Field: Chromaticity",
+[0x4D4] = "Data Field: Chromaticity X",
+[0x4D5] = "Data Field: Chromaticity Y",
+[0x4D6] = "Data Field: Consumer IR Sentence Receive",
+[0x4D7] = "Data Field: Infrared Light",
+[0x4D8] = "Data Field: Red Light",
+[0x4D9] = "Data Field: Green Light",
+[0x4DA] = "Data Field: Blue Light",
+[0x4DB] = "Data Field: Ultraviolet A Light",
+[0x4DC] = "Data Field: Ultraviolet B Light",
+[0x4DD] = "Data Field: Ultraviolet Index",
+[0x530] = "Data Field: Time",
+[0x531] = "Data Field: Year",
+[0x532] = "Data Field: Month",
+[0x533] = "Data Field: Day",
+[0x534] = "Data Field: Day of Week",
+[0x535] = "Data Field: Hour",
+[0x536] = "Data Field: Minute",
+[0x537] = "Data Field: Second",
+[0x538] = "Data Field: Millisecond",
+[0x539] = "Data Field: Timestamp",
+[0x53A] = "Data Field: Julian Day of Year",
+[0x540] = "Data Field: Custom",
+[0x541] = "Data Field: Custom Usage",
+[0x542] = "Data Field: Custom Boolean Array",
+[0x543] = "Data Field: Custom Value",
+[0x544] = "Data Field: Custom Value 1",
+[0x545] = "Data Field: Custom Value 2",
+[0x546] = "Data Field: Custom Value 3",
+[0x547] = "Data Field: Custom Value 4",
+[0x548] = "Data Field: Custom Value 5",
+[0x549] = "Data Field: Custom Value 6" };
+
+// Second level, ordered as page_index refers to it
+static hid_usage_page_t const usage_pages[] =
+{
+{ NULL, NULL, 0 },
+{ "Generic Desktop", generic_desktop_usages,
+		ENTRY_COUNT(generic_desktop_usages) },
+{ "Simulation Controls", NULL, 0 },
+{ "VR Controls", NULL, 0 },
+{ "Sport Controls", NULL, 0 },
+{ "Game Controls", NULL, 0 },
+{ "Generic Device Controls", NULL, 0 },
+{ "Keyboard/Keypad", keyboard_usages, ENTRY_COUNT(keyboard_usages) },
+{ "LED", led_usages, ENTRY_COUNT(led_usages) },
+{ "Button", NULL, 0 },
+{ "Ordinal", NULL, 0 },
+{ "Telephony Device", NULL, 0 },
+{ "Consumer", consumer_usages, ENTRY_COUNT(consumer_usages) },
+{ "Digitizers", digitizers_usages, ENTRY_COUNT(digitizers_usages) },
+{ "Physical Input Device", NULL, 0 },
+{ "Unicode", NULL, 0 },
+{ "Auxiliary Display", NULL, 0 },
+{ "Sensors", sensors_usages, ENTRY_COUNT(sensors_usages) },
+{ "Medical Instrument", NULL, 0 },
+{ "Lighting And Illumination", NULL, 0 },
+{ "Monitor", NULL, 0 },
+{ "Power Device", NULL, 0 },
+{ "Battery System", NULL, 0 },
+{ "Bar Code Scanner", NULL, 0 },
+{ "Scale", NULL, 0 },
+{ "Magnetic Stripe Reader", NULL, 0 },
+{ "Camera Control", NULL, 0 },
+{ "Arcade", NULL, 0 } };
+
+// First level, usage pages below VENDOR_USAGE_PAGE (0 if unknown)
+static uint8_t const page_index[0x100] =
+{
+[0x01] = 1,
+[0x02] = 2,
+[0x03] = 3,
+[0x04] = 4,
+[0x05] = 5,
+[0x06] = 6,
+[0x07] = 7,
+[0x08] = 8,
+[0x09] = 9,
+[0x0A] = 10,
+[0x0B] = 11,
+[0x0C] = 12,
+[0x0D] = 13,
+[0x0F] = 14,
+[0x10] = 15,
+[0x14] = 16,
+[0x20] = 17,
+[0x40] = 18,
+[0x59] = 19,
+[0x80] = 20,
+[0x84] = 21,
+[0x85] = 22,
+[0x8C] = 23,
+[0x8D] = 24,
+[0x8E] = 25,
+[0x90] = 26,
+[0x91] = 27 };
+
+// Local declarations
+static hid_usage_page_t const * find_page(uint16_t usage_page);
+
+// Implementation
+
+static hid_usage_page_t const * find_page(uint16_t usage_page)
+{
+	if (usage_page >= ENTRY_COUNT(page_index))
+	{
+		return (NULL);
+	}
+
+	return ((0 == page_index[usage_page]) ?
+			NULL : &usage_pages[page_index[usage_page]]);
+}
+
+char const * hid_usage_page_name(uint16_t usage_page)
+{
+	hid_usage_page_t const * p_page;
+
+	if (usage_page >= VENDOR_USAGE_PAGE)
+	{
+		return ("Vendor Defined");
+	}
+
+	p_page = find_page(usage_page);
+
+	return ((NULL == p_page) ? NULL : p_page->p_name);
+}
+
+char const * hid_usage_name(uint16_t usage_page, uint16_t usage)
+{
+	hid_usage_page_t const * p_page = find_page(usage_page);
+
+	if ((NULL == p_page) || (usage >= p_page->usage_count))
+	{
+		return (NULL);
+	}
+
+	return (p_page->pp_usages[usage]);
+}
+
+int hid_usage_format(uint16_t usage_page, uint16_t usage, char * p_text,
+		size_t text_size)
+{
+	char const *p_name = hid_usage_name(usage_page, usage);
+
+	if (NULL != p_name)
+	{
+		return (_snprintf(p_text, text_size, "%s", p_name));
+	}
+
+	// Pages whose usages are numbered rather than named
+	switch (usage_page)
+	{
+	case 0x09:
+		return ((0 == usage) ?
+				_snprintf(p_text, text_size, "No Button Pressed") :
+				_snprintf(p_text, text_size, "Button %u", usage));
+	case 0x0A:
+		return (_snprintf(p_text, text_size, "Instance %u", usage));
+	case 0x10:
+		return (_snprintf(p_text, text_size, "U+%04X", usage));
+	default:
+		break;
+	}
+
+	if (usage_page >= VENDOR_USAGE_PAGE)
+	{
+		return (_snprintf(p_text, text_size, "Vendor Usage 0x%02x", usage));
+	}
+
+	return (_snprintf(p_text, text_size, "Usage 0x%02x", usage));
+}
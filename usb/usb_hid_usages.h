@@ -0,0 +1,125 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_usages.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_USAGES_H_
+#define USB_HID_USAGES_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_usages
+
+ \brief These APIs name usage pages and usages from the HID Usage Tables.
+
+ The tables are compiled in and indexed directly by usage page and usage,
+ so names may be looked up per field and report without a search.
+ */
+/* ************************************************************************* */
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_usages
+
+ \brief Retrieves the name of a usage page.
+
+ \param[in] usage_page - The usage page.
+
+ \return The name of the usage page or NULL if it is unknown.
+
+ */
+/* ************************************************************************** */
+
+char const * hid_usage_page_name(uint16_t usage_page);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_usages
+
+ \brief Retrieves the name of a usage.
+
+ \param[in] usage_page - The usage page of the usage.
+ \param[in] usage - The usage.
+
+ \return The name of the usage or NULL if it is unknown.
+
+ */
+/* ************************************************************************** */
+
+char const * hid_usage_name(uint16_t usage_page, uint16_t usage);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_usages
+
+ \brief Formats the name of any usage.
+
+ \param[in] usage_page - The usage page of the usage.
+ \param[in] usage - The usage.
+ \param[out] p_text - Receives the name.
+ \param[in] text_size - The size of p_text.
+
+ \return The length of the name as _snprintf() returns it.
+
+ Usages without a name in the tables are named after their page's numbering
+ (e.g. "Button 3") or their value (e.g. "Usage 0x2f").
+
+ */
+/* ************************************************************************** */
+
+int hid_usage_format(uint16_t usage_page, uint16_t usage, char * p_text,
+		size_t text_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_USAGES_H_ */
@@ -0,0 +1,451 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_writer.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Windows includes
+#include <windows.h>
+#include <hidsdi.h>
+
+// Other includes
+#include "utils.h"
+#include "usb_defs.h"
+#include "usb_hid.h"
+#include "usb_hid_reports.h"
+
+// Module include
+#include "usb_hid_writer.h"
+
+typedef struct _usb_hid_writer_slot_t
+{
+	// Output report ID written through this slot. Its report buffer holds
+	// the bytes of the write in flight.
+	phid_report_id_t p_report_id;
+
+	// The bytes last handed to the device for this report ID
+	char *p_shadow_buffer;
+	bool is_shadow_valid;
+
+	// The latest bytes waiting to be written for this report ID
+	char *p_next_buffer;
+	bool has_next;
+
+} usb_hid_writer_slot_t, *pusb_hid_writer_slot_t;
+
+typedef struct _usb_hid_writer_context_t
+{
+	// Pointer to the HID device we are working with
+	phid_device_t p_hid_device;
+
+	// Maximum and current number of writes in flight
+	size_t queue_depth;
+	size_t num_in_flight;
+
+	// Scratch buffer reports are packed into
+	char *p_pack_buffer;
+
+	// One slot per output report ID
+	pusb_hid_writer_slot_t p_slots;
+	size_t num_slots;
+
+	// Slot the next scan for waiting writes starts at
+	size_t next_slot;
+
+} usb_hid_writer_context_t, *pusb_hid_writer_context_t;
+
+// Local declarations
+
+static bool issue_write(pusb_hid_writer_context_t p_context,
+		pusb_hid_writer_slot_t p_slot);
+
+static bool reap_writes(pusb_hid_writer_context_t p_context, bool wait);
+
+static bool pump_writes(pusb_hid_writer_context_t p_context);
+
+static void free_writer(pusb_hid_writer_context_t p_context);
+
+// Implementation
+
+static bool issue_write(pusb_hid_writer_context_t p_context,
+		pusb_hid_writer_slot_t p_slot)
+{
+	phid_report_id_t p_id = p_slot->p_report_id;
+	size_t length =
+			p_context->p_hid_device->report[HID_REPORT_TYPE_OUTPUT].report_buffer_length;
+	DWORD written;
+	BOOL success;
+
+	// Each report ID waits on its own (manual reset) completion event
+	if (NULL == p_id->h_event)
+	{
+		p_id->h_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+		if (NULL == p_id->h_event)
+		{
+			return (false);
+		}
+	}
+
+	// The latest bytes become the ones in flight and our new shadow
+	memcpy(p_id->p_report_buffer, p_slot->p_next_buffer, length);
+	memcpy(p_slot->p_shadow_buffer, p_slot->p_next_buffer, length);
+	p_slot->is_shadow_valid = true;
+	p_slot->has_next = false;
+
+	memset(&p_id->overlap, 0, sizeof(OVERLAPPED));
+	p_id->overlap.hEvent = p_id->h_event;
+
+	success = WriteFile(p_context->p_hid_device->h_device,
+			p_id->p_report_buffer, length, &written, &p_id->overlap);
+	if ((!success) && (ERROR_IO_PENDING != GetLastError()))
+	{
+		// We do not know what the device holds now, send it again next time
+		p_slot->is_shadow_valid = false;
+		return (false);
+	}
+
+	/*
+	 Even when the write completed synchronously the completion event has
+	 been signalled, so it is reaped the same way a pending write is.
+	 */
+	p_id->is_pending = true;
+	p_context->num_in_flight++;
+
+	return (true);
+}
+
+static bool reap_writes(pusb_hid_writer_context_t p_context, bool wait)
+{
+	size_t index;
+	bool status = true;
+	size_t length =
+			p_context->p_hid_device->report[HID_REPORT_TYPE_OUTPUT].report_buffer_length;
+
+	for (index = 0; index < p_context->num_slots; index++)
+	{
+		pusb_hid_writer_slot_t p_slot = &p_context->p_slots[index];
+		phid_report_id_t p_id = p_slot->p_report_id;
+		DWORD written;
+		BOOL success;
+
+		if (!p_id->is_pending)
+		{
+			continue;
+		}
+
+		if ((!wait) && (!HasOverlappedIoCompleted(&p_id->overlap)))
+		{
+			continue;
+		}
+
+		success = GetOverlappedResult(p_context->p_hid_device->h_device,
+				&p_id->overlap, &written, TRUE);
+
+		p_id->is_pending = false;
+		p_context->num_in_flight--;
+
+		if ((!success) || (written != length))
+		{
+			p_slot->is_shadow_valid = false;
+			status = false; // any failure returns failure
+		}
+	}
+
+	return (status);
+}
+
+static bool pump_writes(pusb_hid_writer_context_t p_context)
+{
+	size_t scanned;
+	bool status = true;
+
+	/*
+	 Start the writes that are waiting as long as there is room in the
+	 queue. A report ID never has more than one write in flight, its newer
+	 bytes simply replace whatever was waiting before. Each scan starts past
+	 the slot last written, so report IDs updated often cannot take every
+	 free place in the queue from the others.
+	 */
+	for (scanned = 0; scanned < p_context->num_slots; scanned++)
+	{
+		size_t index = (p_context->next_slot + scanned) % p_context->num_slots;
+		pusb_hid_writer_slot_t p_slot = &p_context->p_slots[index];
+
+		if (p_context->num_in_flight >= p_context->queue_depth)
+		{
+			break;
+		}
+
+		if ((p_slot->has_next) && (!p_slot->p_report_id->is_pending))
+		{
+			status = (issue_write(p_context, p_slot) && status);
+			p_context->next_slot = (index + 1) % p_context->num_slots;
+		}
+	}
+
+	return (status);
+}
+
+static void free_writer(pusb_hid_writer_context_t p_context)
+{
+	size_t index;
+
+	if (NULL != p_context->p_slots)
+	{
+		for (index = 0; index < p_context->num_slots; index++)
+		{
+			free(p_context->p_slots[index].p_shadow_buffer);
+			free(p_context->p_slots[index].p_next_buffer);
+		}
+		free(p_context->p_slots);
+	}
+
+	free(p_context->p_pack_buffer);
+	free(p_context);
+
+	return;
+}
+
+HANDLE usb_hid_create_writer(phid_device_t p_hid_device, size_t queue_depth)
+{
+	pusb_hid_writer_context_t p_context;
+	phid_report_t p_report;
+	size_t index;
+
+	if (NULL == p_hid_device)
+	{
+		return NULL;
+	}
+
+	p_report = &p_hid_device->report[HID_REPORT_TYPE_OUTPUT];
+
+	// We only do this if we can actually send an output report
+	if ((0 == p_report->report_buffer_length)
+			|| (0 == p_report->number_report_ids))
+	{
+		return NULL;
+	}
+
+	// Create context memory
+	p_context = (pusb_hid_writer_context_t) calloc(1,
+			sizeof(usb_hid_writer_context_t));
+	if (NULL == p_context)
+	{
+		return NULL;
+	}
+
+	p_context->p_hid_device = p_hid_device;
+	p_context->queue_depth =
+			(0 == queue_depth) ?
+					USB_HID_WRITER_DEFAULT_QUEUE_DEPTH : queue_depth;
+	p_context->num_in_flight = 0;
+	p_context->next_slot = 0;
+
+	p_context->p_pack_buffer = (char *) calloc(p_report->report_buffer_length,
+			sizeof(char));
+	p_context->num_slots = p_report->number_report_ids;
+	p_context->p_slots = (pusb_hid_writer_slot_t) calloc(p_context->num_slots,
+			sizeof(usb_hid_writer_slot_t));
+	if ((NULL == p_context->p_pack_buffer) || (NULL == p_context->p_slots))
+	{
+		free_writer(p_context);
+		return NULL;
+	}
+
+	for (index = 0; index < p_context->num_slots; index++)
+	{
+		pusb_hid_writer_slot_t p_slot = &p_context->p_slots[index];
+
+		p_slot->p_report_id = &p_report->p_report_ids[index];
+		p_slot->is_shadow_valid = false;
+		p_slot->has_next = false;
+
+		p_slot->p_shadow_buffer = (char *) calloc(
+				p_report->report_buffer_length, sizeof(char));
+		p_slot->p_next_buffer = (char *) calloc(p_report->report_buffer_length,
+				sizeof(char));
+		if ((NULL == p_slot->p_shadow_buffer)
+				|| (NULL == p_slot->p_next_buffer))
+		{
+			free_writer(p_context);
+			return NULL;
+		}
+	}
+
+	return (HANDLE) p_context;
+}
+
+bool usb_hid_write(HANDLE h_writer)
+{
+	pusb_hid_writer_context_t p_context = (pusb_hid_writer_context_t) h_writer;
+	phid_report_t p_report;
+	size_t index;
+	bool status;
+
+	if (NULL == p_context)
+	{
+		return (false);
+	}
+
+	p_report = &p_context->p_hid_device->report[HID_REPORT_TYPE_OUTPUT];
+
+	// Retire whatever has completed since the last call
+	status = reap_writes(p_context, false);
+
+	for (index = 0; index < p_context->num_slots; index++)
+	{
+		pusb_hid_writer_slot_t p_slot = &p_context->p_slots[index];
+		bool packed;
+
+		// Pack this report ID
+		packed = hid_pack_report_id(p_report, p_slot->p_report_id,
+				p_context->p_pack_buffer, HidP_Output,
+				p_context->p_hid_device->p_ppd);
+		if (!packed)
+		{
+			status = false;
+			continue;
+		}
+
+		// The device already holds (or is being sent) these bytes, so an
+		// update waiting to change them has been reverted
+		if ((p_slot->is_shadow_valid)
+				&& (0 == memcmp(p_slot->p_shadow_buffer,
+						p_context->p_pack_buffer,
+						p_report->report_buffer_length)))
+		{
+			p_slot->has_next = false;
+			continue;
+		}
+
+		// These bytes are already waiting to be sent
+		if ((p_slot->has_next)
+				&& (0 == memcmp(p_slot->p_next_buffer,
+						p_context->p_pack_buffer,
+						p_report->report_buffer_length)))
+		{
+			continue;
+		}
+
+		// Replace anything still waiting with the latest value
+		memcpy(p_slot->p_next_buffer, p_context->p_pack_buffer,
+				p_report->report_buffer_length);
+		p_slot->has_next = true;
+	}
+
+	return (pump_writes(p_context) && status);
+}
+
+bool usb_hid_flush_writer(HANDLE h_writer)
+{
+	pusb_hid_writer_context_t p_context = (pusb_hid_writer_context_t) h_writer;
+	bool status = true;
+
+	if (NULL == p_context)
+	{
+		return (false);
+	}
+
+	do
+	{
+		size_t index;
+		bool has_next = false;
+
+		status = (pump_writes(p_context) && status);
+
+		for (index = 0; index < p_context->num_slots; index++)
+		{
+			has_next = (has_next || p_context->p_slots[index].has_next);
+		}
+
+		if ((0 == p_context->num_in_flight) && (!has_next))
+		{
+			break;
+		}
+
+		status = (reap_writes(p_context, true) && status);
+
+	} while (true);
+
+	return (status);
+}
+
+void usb_hid_invalidate_writer(HANDLE h_writer)
+{
+	pusb_hid_writer_context_t p_context = (pusb_hid_writer_context_t) h_writer;
+	size_t index;
+
+	if (NULL == p_context)
+	{
+		return;
+	}
+
+	for (index = 0; index < p_context->num_slots; index++)
+	{
+		p_context->p_slots[index].is_shadow_valid = false;
+	}
+
+	return;
+}
+
+void usb_hid_destroy_writer(HANDLE h_writer)
+{
+	pusb_hid_writer_context_t p_context = (pusb_hid_writer_context_t) h_writer;
+
+	if (NULL == p_context)
+	{
+		return;
+	}
+
+	usb_hid_flush_writer(h_writer);
+
+	free_writer(p_context);
+
+	return;
+}
@@ -0,0 +1,154 @@
+/*
+ ==============================================================================
+ Name        : usb_hid_writer.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_HID_WRITER_H_
+#define USB_HID_WRITER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_hid_writer
+
+ \brief These APIs are used to write HID output reports via overlapped I/O.
+
+ A writer keeps a shadow copy of the last bytes sent for each output report
+ ID. Reports whose packed bytes did not change are not sent again. While a
+ write for a report ID is still in flight, further updates to the same report
+ ID are coalesced so that only the latest value is sent once it completes.
+ The number of writes in flight is bounded by the writer's queue depth.
+ */
+/* ************************************************************************* */
+
+// Default number of output reports which may be in flight at once
+#define USB_HID_WRITER_DEFAULT_QUEUE_DEPTH	(4)
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_writer
+
+ \brief Creates an output report writer for a HID.
+
+ \param[in] p_hid_device - The HID to write to. It must have been opened with
+ USB_WRITE_ACCESS and USB_OVERLAPPED.
+ \param[in] queue_depth - The maximum number of writes in flight at once, or
+ zero for USB_HID_WRITER_DEFAULT_QUEUE_DEPTH.
+
+ \return A handle to the writer or NULL on failure.
+
+ */
+/* ************************************************************************** */
+
+HANDLE usb_hid_create_writer(phid_device_t p_hid_device, size_t queue_depth);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_writer
+
+ \brief Packs the HID's output data and queues any changed reports.
+
+ \param[in] h_writer - The writer handle.
+
+ \return Indicates if all reports were queued or written successfully.
+
+ Each output report ID is packed from the HID's output hid_data_t elements.
+ A report is skipped when its bytes match the last ones queued for it. This
+ call never blocks waiting on the device.
+
+ */
+/* ************************************************************************** */
+
+bool usb_hid_write(HANDLE h_writer);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_writer
+
+ \brief Waits until every queued output report has been written.
+
+ \param[in] h_writer - The writer handle.
+
+ \return Indicates if all writes completed successfully.
+
+ */
+/* ************************************************************************** */
+
+bool usb_hid_flush_writer(HANDLE h_writer);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_writer
+
+ \brief Forgets the shadow copies so the next write sends every report.
+
+ \param[in] h_writer - The writer handle.
+
+ */
+/* ************************************************************************** */
+
+void usb_hid_invalidate_writer(HANDLE h_writer);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_hid_writer
+
+ \brief Flushes and destroys an output report writer.
+
+ \param[in] h_writer - The writer handle.
+
+ */
+/* ************************************************************************** */
+
+void usb_hid_destroy_writer(HANDLE h_writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HID_WRITER_H_ */
@@ -0,0 +1,635 @@
+/*
+ ==============================================================================
+ Name        : usb_string_cache.c
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Windows includes
+#include <windows.h>
+
+// WDK includes
+#include <usbioctl.h>
+
+// Other includes
+#include "utils.h"
+#include "cache_path.h"
+#include "fnv1a.h"
+
+// Module include
+#include "usb_string_cache.h"
+
+// Number of strings a cache first makes room for
+#define CACHE_INITIAL_CAPACITY		(64)
+
+// Room for the longest string descriptor (bLength is a byte)
+#define DESCRIPTOR_SIZE				(256)
+
+/*
+
+ A string cache file is a cache_file_header_t followed by entry_count
+ string_entry_t, none of them missing, and length_count length_entry_t. All
+ integers are stored little-endian.
+
+ */
+
+#define CACHE_FILE_MAGIC			"USBSTR"
+#define CACHE_FILE_VERSION			(2)
+
+// Name of the cache file within its directory
+#define CACHE_FILE_NAME				"strings.cache"
+
+__PACKED__
+
+typedef struct _cache_file_header_t
+{
+	char magic[8]; // CACHE_FILE_MAGIC padded with zeros
+	uint16_t version; // CACHE_FILE_VERSION
+	uint16_t reserved;
+	uint32_t entry_count;
+	uint32_t length_count;
+	uint32_t reserved2;
+
+} cache_file_header_t;
+
+typedef struct _string_entry_t
+{
+	uint64_t device_key;
+	uint16_t language_id;
+	uint8_t index;
+	uint8_t is_missing; // The device returned no such string
+
+	uint8_t descriptor[DESCRIPTOR_SIZE]; // The string descriptor as returned
+
+} string_entry_t, *pstring_entry_t;
+
+typedef struct _length_entry_t
+{
+	uint64_t device_key;
+	uint8_t config_index;
+	uint8_t reserved;
+	uint16_t total_length; // wTotalLength of the configuration descriptor
+	uint32_t reserved2;
+
+} length_entry_t, *plength_entry_t;
+
+__UNPACKED__
+
+COMPILE_TIME_ASSERT(sizeof(cache_file_header_t) == 24,
+		cache_file_header_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(string_entry_t) == 268,
+		string_entry_t_is_wrong_size);
+COMPILE_TIME_ASSERT(sizeof(length_entry_t) == 16,
+		length_entry_t_is_wrong_size);
+
+typedef struct _string_cache_t
+{
+	pstring_entry_t p_entries;
+	uint64_t *p_keys; // lookup_key() of every entry, scanned before p_entries
+	size_t entry_count;
+	size_t capacity;
+
+	plength_entry_t p_lengths;
+	size_t length_count;
+	size_t length_capacity;
+
+	bool is_dirty; // Entries were added since the cache was loaded
+
+} string_cache_t, *pstring_cache_t;
+
+// Local declarations
+static uint64_t lookup_key(uint64_t device_key, uint8_t index,
+		uint16_t language_id);
+
+static pstring_entry_t find_entry(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id);
+
+static pstring_entry_t new_entry(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id);
+
+static plength_entry_t find_length(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t config_index);
+
+static plength_entry_t new_length(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t config_index);
+
+// Implementation
+
+static uint64_t lookup_key(uint64_t device_key, uint8_t index,
+		uint16_t language_id)
+{
+	return (device_key ^ (((uint64_t) language_id << 8) | index));
+}
+
+static pstring_entry_t find_entry(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id)
+{
+	uint64_t key = lookup_key(device_key, index, language_id);
+	size_t position;
+
+	for (position = 0; position < p_cache->entry_count; position++)
+	{
+		pstring_entry_t p_entry;
+
+		if (key != p_cache->p_keys[position])
+		{
+			continue;
+		}
+
+		p_entry = &p_cache->p_entries[position];
+		if ((device_key == p_entry->device_key) && (index == p_entry->index)
+				&& (language_id == p_entry->language_id))
+		{
+			return (p_entry);
+		}
+	}
+
+	return (NULL);
+}
+
+static pstring_entry_t new_entry(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id)
+{
+	pstring_entry_t p_entry;
+
+	if (p_cache->entry_count == p_cache->capacity)
+	{
+		size_t capacity =
+				(0 == p_cache->capacity) ?
+						CACHE_INITIAL_CAPACITY : 2 * p_cache->capacity;
+		pstring_entry_t p_entries;
+		uint64_t *p_keys;
+
+		p_entries = (pstring_entry_t) realloc(p_cache->p_entries,
+				capacity * sizeof(string_entry_t));
+		if (NULL == p_entries)
+		{
+			return (NULL);
+		}
+		p_cache->p_entries = p_entries;
+
+		p_keys = (uint64_t *) realloc(p_cache->p_keys,
+				capacity * sizeof(uint64_t));
+		if (NULL == p_keys)
+		{
+			return (NULL);
+		}
+		p_cache->p_keys = p_keys;
+
+		p_cache->capacity = capacity;
+	}
+
+	p_cache->p_keys[p_cache->entry_count] = lookup_key(device_key, index,
+			language_id);
+
+	p_entry = &p_cache->p_entries[p_cache->entry_count++];
+	memset(p_entry, 0, sizeof(*p_entry));
+	p_entry->device_key = device_key;
+	p_entry->index = index;
+	p_entry->language_id = language_id;
+
+	return (p_entry);
+}
+
+static plength_entry_t find_length(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t config_index)
+{
+	size_t position;
+
+	for (position = 0; position < p_cache->length_count; position++)
+	{
+		plength_entry_t p_length = &p_cache->p_lengths[position];
+
+		if ((device_key == p_length->device_key)
+				&& (config_index == p_length->config_index))
+		{
+			return (p_length);
+		}
+	}
+
+	return (NULL);
+}
+
+static plength_entry_t new_length(pstring_cache_t p_cache, uint64_t device_key,
+		uint8_t config_index)
+{
+	plength_entry_t p_length;
+
+	if (p_cache->length_count == p_cache->length_capacity)
+	{
+		size_t capacity =
+				(0 == p_cache->length_capacity) ?
+						CACHE_INITIAL_CAPACITY : 2 * p_cache->length_capacity;
+		plength_entry_t p_lengths;
+
+		p_lengths = (plength_entry_t) realloc(p_cache->p_lengths,
+				capacity * sizeof(length_entry_t));
+		if (NULL == p_lengths)
+		{
+			return (NULL);
+		}
+
+		p_cache->p_lengths = p_lengths;
+		p_cache->length_capacity = capacity;
+	}
+
+	p_length = &p_cache->p_lengths[p_cache->length_count++];
+	memset(p_length, 0, sizeof(*p_length));
+	p_length->device_key = device_key;
+	p_length->config_index = config_index;
+
+	return (p_length);
+}
+
+HANDLE usb_string_cache_create(void)
+{
+	return ((HANDLE) calloc(1, sizeof(string_cache_t)));
+}
+
+uint64_t usb_string_cache_get_device_key(
+		PUSB_DEVICE_DESCRIPTOR const p_device_descriptor,
+		PUSB_STRING_DESCRIPTOR const p_serial)
+{
+	uint64_t hash = FNV1A_OFFSET_BASIS;
+
+	hash = fnv1a_hash(hash, &p_device_descriptor->idVendor,
+			sizeof(p_device_descriptor->idVendor));
+	hash = fnv1a_hash(hash, &p_device_descriptor->idProduct,
+			sizeof(p_device_descriptor->idProduct));
+	hash = fnv1a_hash(hash, &p_device_descriptor->bcdDevice,
+			sizeof(p_device_descriptor->bcdDevice));
+
+	if (NULL != p_serial)
+	{
+		hash = fnv1a_hash(hash, p_serial, p_serial->bLength);
+	}
+
+	return (hash);
+}
+
+bool usb_string_cache_find(HANDLE h_string_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id,
+		PUSB_STRING_DESCRIPTOR * pp_descriptor)
+{
+	pstring_cache_t p_cache = (pstring_cache_t) h_string_cache;
+	pstring_entry_t p_entry;
+
+	if (NULL == p_cache)
+	{
+		return (false);
+	}
+
+	p_entry = find_entry(p_cache, device_key, index, language_id);
+	if (NULL == p_entry)
+	{
+		return (false);
+	}
+
+	*pp_descriptor =
+			p_entry->is_missing ?
+					NULL : (PUSB_STRING_DESCRIPTOR) p_entry->descriptor;
+
+	return (true);
+}
+
+void usb_string_cache_add(HANDLE h_string_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id,
+		PUSB_STRING_DESCRIPTOR const p_descriptor)
+{
+	pstring_cache_t p_cache = (pstring_cache_t) h_string_cache;
+	pstring_entry_t p_entry;
+
+	if (NULL == p_cache)
+	{
+		return;
+	}
+
+	p_entry = find_entry(p_cache, device_key, index, language_id);
+	if (NULL == p_entry)
+	{
+		// Not caching only costs requesting the string again
+		p_entry = new_entry(p_cache, device_key, index, language_id);
+		if (NULL == p_entry)
+		{
+			return;
+		}
+	}
+
+	if (NULL == p_descriptor)
+	{
+		p_entry->is_missing = true;
+		return;
+	}
+
+	p_entry->is_missing = false;
+	memcpy(p_entry->descriptor, p_descriptor, p_descriptor->bLength);
+	p_cache->is_dirty = true;
+}
+
+uint16_t usb_string_cache_get_config_length(HANDLE h_string_cache,
+		uint64_t device_key, uint8_t config_index)
+{
+	pstring_cache_t p_cache = (pstring_cache_t) h_string_cache;
+	plength_entry_t p_length;
+
+	if (NULL == p_cache)
+	{
+		return (0);
+	}
+
+	p_length = find_length(p_cache, device_key, config_index);
+
+	return ((NULL == p_length) ? 0 : p_length->total_length);
+}
+
+void usb_string_cache_set_config_length(HANDLE h_string_cache,
+		uint64_t device_key, uint8_t config_index, uint16_t total_length)
+{
+	pstring_cache_t p_cache = (pstring_cache_t) h_string_cache;
+	plength_entry_t p_length;
+
+	if (NULL == p_cache)
+	{
+		return;
+	}
+
+	p_length = find_length(p_cache, device_key, config_index);
+	if (NULL == p_length)
+	{
+		p_length = new_length(p_cache, device_key, config_index);
+		if (NULL == p_length)
+		{
+			return;
+		}
+	}
+	else if (total_length == p_length->total_length)
+	{
+		return;
+	}
+
+	p_length->total_length = total_length;
+	p_cache->is_dirty = true;
+}
+
+bool usb_string_cache_load(HANDLE h_string_cache, char const * p_path)
+{
+	pstring_cache_t p_cache = (pstring_cache_t) h_string_cache;
+	HANDLE h_file;
+	HANDLE h_mapping;
+	LARGE_INTEGER file_length;
+	uint8_t const *p_view;
+	bool success = false;
+
+	if ((NULL == p_cache) || (NULL == p_path))
+	{
+		return (false);
+	}
+
+	// No cache file is expected the first time
+	h_file = CreateFile(p_path, GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+			FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (INVALID_HANDLE_VALUE == h_file)
+	{
+		return (false);
+	}
+
+	if (!GetFileSizeEx(h_file, &file_length)
+			|| (file_length.QuadPart < (LONGLONG) sizeof(cache_file_header_t))
+			|| ((uint64_t) file_length.QuadPart > SIZE_MAX))
+	{
+		CloseHandle(h_file);
+		return (false);
+	}
+
+	// The whole file is read through a single view
+	h_mapping = CreateFileMapping(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (NULL != h_mapping)
+	{
+		p_view = (uint8_t const *) MapViewOfFile(h_mapping, FILE_MAP_READ, 0, 0,
+				0);
+		if (NULL != p_view)
+		{
+			cache_file_header_t const *p_header =
+					(cache_file_header_t const *) p_view;
+			string_entry_t const *p_file_entries =
+					(string_entry_t const *) (p_header + 1);
+			length_entry_t const *p_file_lengths =
+					(length_entry_t const *) (p_file_entries
+							+ p_header->entry_count);
+			size_t index;
+
+			success = (0 == memcmp(p_header->magic, CACHE_FILE_MAGIC,
+					sizeof(CACHE_FILE_MAGIC)))
+					&& (CACHE_FILE_VERSION == p_header->version)
+					&& ((uint64_t) file_length.QuadPart
+							- sizeof(cache_file_header_t)
+							>= (uint64_t) p_header->entry_count
+									* sizeof(string_entry_t)
+									+ (uint64_t) p_header->length_count
+											* sizeof(length_entry_t));
+
+			for (index = 0; success && (index < p_header->entry_count);
+					index++)
+			{
+				string_entry_t const *p_in = &p_file_entries[index];
+				pstring_entry_t p_entry;
+
+				// Strings requested in this process take precedence
+				if (NULL != find_entry(p_cache, p_in->device_key, p_in->index,
+						p_in->language_id))
+				{
+					continue;
+				}
+
+				p_entry = new_entry(p_cache, p_in->device_key, p_in->index,
+						p_in->language_id);
+				if (NULL == p_entry)
+				{
+					success = false;
+					break;
+				}
+
+				*p_entry = *p_in;
+				p_entry->is_missing = false;
+			}
+
+			for (index = 0; success && (index < p_header->length_count);
+					index++)
+			{
+				length_entry_t const *p_in = &p_file_lengths[index];
+				plength_entry_t p_length;
+
+				// Lengths learned in this process take precedence
+				if (NULL != find_length(p_cache, p_in->device_key,
+						p_in->config_index))
+				{
+					continue;
+				}
+
+				p_length = new_length(p_cache, p_in->device_key,
+						p_in->config_index);
+				if (NULL == p_length)
+				{
+					success = false;
+					break;
+				}
+
+				p_length->total_length = p_in->total_length;
+			}
+
+			UnmapViewOfFile(p_view);
+		}
+		CloseHandle(h_mapping);
+	}
+
+	CloseHandle(h_file);
+
+	return (success);
+}
+
+bool usb_string_cache_save(HANDLE h_string_cache, char const * p_path)
+{
+	pstring_cache_t p_cache = (pstring_cache_t) h_string_cache;
+	cache_file_header_t header;
+	char temp_path[MAX_PATH];
+	FILE *p_file;
+	size_t index;
+	bool success = true;
+
+	if ((NULL == p_cache) || (NULL == p_path))
+	{
+		return (false);
+	}
+
+	if (!p_cache->is_dirty)
+	{
+		return (true);
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+	header.version = CACHE_FILE_VERSION;
+	header.length_count = (uint32_t) p_cache->length_count;
+
+	for (index = 0; index < p_cache->entry_count; index++)
+	{
+		if (!p_cache->p_entries[index].is_missing)
+		{
+			header.entry_count++;
+		}
+	}
+
+	// Write aside and replace so readers never see a partial cache
+	_snprintf(temp_path, sizeof(temp_path), "%s.%lu", p_path,
+			(unsigned long) GetCurrentProcessId());
+	temp_path[sizeof(temp_path) - 1] = '\0';
+
+	p_file = fopen(temp_path, "wb");
+	if (NULL == p_file)
+	{
+		return (false);
+	}
+
+	success = (1 == fwrite(&header, sizeof(header), 1, p_file));
+
+	for (index = 0; success && (index < p_cache->entry_count); index++)
+	{
+		pstring_entry_t p_entry = &p_cache->p_entries[index];
+
+		if (!p_entry->is_missing)
+		{
+			success = (1 == fwrite(p_entry, sizeof(*p_entry), 1, p_file));
+		}
+	}
+
+	if (success && (0 != p_cache->length_count))
+	{
+		success = (p_cache->length_count
+				== fwrite(p_cache->p_lengths, sizeof(length_entry_t),
+						p_cache->length_count, p_file));
+	}
+
+	success = (0 == fclose(p_file)) && success;
+
+	if (success)
+	{
+		success = MoveFileEx(temp_path, p_path, MOVEFILE_REPLACE_EXISTING);
+	}
+
+	if (!success)
+	{
+		remove(temp_path);
+		return (false);
+	}
+
+	p_cache->is_dirty = false;
+
+	return (true);
+}
+
+bool usb_string_cache_get_default_path(char * p_path, size_t path_size)
+{
+	return (cache_path_get(CACHE_FILE_NAME, p_path, path_size));
+}
+
+void usb_string_cache_destroy(HANDLE h_string_cache)
+{
+	pstring_cache_t p_cache = (pstring_cache_t) h_string_cache;
+
+	if (NULL == p_cache)
+	{
+		return;
+	}
+
+	free(p_cache->p_entries);
+	free(p_cache->p_keys);
+	free(p_cache->p_lengths);
+	free(p_cache);
+}
@@ -0,0 +1,256 @@
+/*
+ ==============================================================================
+ Name        : usb_string_cache.h
+ Date        : Oct 18, 2026
+ ==============================================================================
+
+ BSD License
+ -----------
+
+ Copyright (c) 2011, and Kevin Fodor, All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ - Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ - Neither the name of Kevin Fodor nor the names of
+ its contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+
+ NOTICE:
+ SOME OF THIS CODE MAY HAVE ELEMENTS TAKEN FROM OTHER CODE WITHOUT ATTRIBUTION.
+ IF THIS IS THE CASE IT WAS DUE TO OVERSIGHT WHILE DEBUGGING AND I APOLOGIZE.
+ IF ANYONE HAS ANY REASON TO BELIEVE THAT ANY OF THIS CODE VIOLATES OTHER
+ LICENSES PLEASE CONTACT ME WITH DETAILS SO THAT I MAY CORRECT THE SITUATION.
+
+ ==============================================================================
+ */
+
+#ifndef USB_STRING_CACHE_H_
+#define USB_STRING_CACHE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ************************************************************************* */
+/*!
+ \defgroup usb_string_cache
+
+ \brief These APIs remember the string descriptors read from USB devices so
+ each is requested from a device at most once, within an enumeration and
+ across runs.
+ */
+/* ************************************************************************* */
+
+/*
+
+ Strings are kept by device key, string index and language ID. The device key
+ hashes the VID, PID and bcdDevice of the device descriptor together with the
+ serial number string when the device has one, so identical devices with
+ different serial numbers do not share their strings.
+
+ Strings a device failed to return are remembered for the current run only,
+ a device that was merely slow or suspended is asked again next time.
+
+ The cache also remembers the total length of each configuration descriptor
+ so it can be requested in a single transfer.
+
+ */
+
+// APIs
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Creates an empty string cache.
+
+ \return A handle to the string cache or NULL on failure.
+
+ */
+/* ************************************************************************** */
+
+HANDLE usb_string_cache_create(void);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Computes the key identifying a device's strings.
+
+ \param[in] p_device_descriptor - The device's device descriptor.
+ \param[in] p_serial - The device's serial number string (NULL if none).
+
+ \return The device key.
+
+ */
+/* ************************************************************************** */
+
+uint64_t usb_string_cache_get_device_key(
+		PUSB_DEVICE_DESCRIPTOR const p_device_descriptor,
+		PUSB_STRING_DESCRIPTOR const p_serial);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Looks a string descriptor up.
+
+ \param[in] h_string_cache - A handle to the string cache.
+ \param[in] device_key - The key of the device.
+ \param[in] index - The string index.
+ \param[in] language_id - The language ID (0 for the LANGID table).
+ \param[out] pp_descriptor - Receives the cached descriptor (valid until the
+ cache changes) or NULL if the device has no such string.
+
+ \return Indicates if the string is known, i.e. need not be requested.
+
+ */
+/* ************************************************************************** */
+
+bool usb_string_cache_find(HANDLE h_string_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id,
+		PUSB_STRING_DESCRIPTOR * pp_descriptor);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Adds a string descriptor requested from a device.
+
+ \param[in] h_string_cache - A handle to the string cache.
+ \param[in] device_key - The key of the device.
+ \param[in] index - The string index.
+ \param[in] language_id - The language ID (0 for the LANGID table).
+ \param[in] p_descriptor - The descriptor, or NULL if the request failed.
+
+ */
+/* ************************************************************************** */
+
+void usb_string_cache_add(HANDLE h_string_cache, uint64_t device_key,
+		uint8_t index, uint16_t language_id,
+		PUSB_STRING_DESCRIPTOR const p_descriptor);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Looks up the total length of a configuration descriptor.
+
+ \param[in] h_string_cache - A handle to the string cache.
+ \param[in] device_key - The key of the device.
+ \param[in] config_index - The configuration index.
+
+ \return The wTotalLength last read from the device (0 if unknown).
+
+ */
+/* ************************************************************************** */
+
+uint16_t usb_string_cache_get_config_length(HANDLE h_string_cache,
+		uint64_t device_key, uint8_t config_index);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Remembers the total length of a configuration descriptor.
+
+ \param[in] h_string_cache - A handle to the string cache.
+ \param[in] device_key - The key of the device.
+ \param[in] config_index - The configuration index.
+ \param[in] total_length - The wTotalLength read from the device.
+
+ */
+/* ************************************************************************** */
+
+void usb_string_cache_set_config_length(HANDLE h_string_cache,
+		uint64_t device_key, uint8_t config_index, uint16_t total_length);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Adds the strings of a cache file to a string cache.
+
+ \param[in] h_string_cache - A handle to the string cache.
+ \param[in] p_path - The cache file.
+
+ \return Indicates if the cache file was read (false if it does not exist or
+ is not a valid cache file).
+
+ */
+/* ************************************************************************** */
+
+bool usb_string_cache_load(HANDLE h_string_cache, char const * p_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Writes a string cache to a cache file if strings were added since it
+ was loaded.
+
+ \param[in] h_string_cache - A handle to the string cache.
+ \param[in] p_path - The cache file.
+
+ \return Indicates if the cache file is up to date.
+
+ */
+/* ************************************************************************** */
+
+bool usb_string_cache_save(HANDLE h_string_cache, char const * p_path);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Retrieves the default cache file path (see cache_path_get()).
+
+ \param[out] p_path - Receives the path.
+ \param[in] path_size - Size of p_path.
+
+ \return Indicates if the path fit.
+
+ */
+/* ************************************************************************** */
+
+bool usb_string_cache_get_default_path(char * p_path, size_t path_size);
+
+/* ************************************************************************** */
+/*!
+ \ingroup usb_string_cache
+
+ \brief Destroys a string cache.
+
+ \param[in] h_string_cache - A handle to the string cache.
+
+ */
+/* ************************************************************************** */
+
+void usb_string_cache_destroy(HANDLE h_string_cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_STRING_CACHE_H_ */
@@ -70,6 +70,9 @@ typedef struct _msg_handler_context_t
 	// Parameters which may be accessed by the callback
 	win_proc_msg_context_t params;
 
+	// The message only window
+	HWND hWnd;
+
 } msg_handler_context_t, *p_msg_handler_context_t;
 
 // Local declarations
@@ -81,10 +84,14 @@ static INT_PTR WINAPI win_proc_callback(HWND hWnd, UINT message, WPARAM wParam,
 
 static bool default_msg_handler_callback(p_win_proc_msg_context_t p_context);
 
+static HWND create_window(HINSTANCE hInstance,
+		p_msg_handler_context_t p_context, msg_handler_callback_t callback,
+		void *p_callback_arg);
+
 // Define a default handler structure to use
 static msg_handler_context_t default_handler =
 { default_msg_handler_callback,
-{ NULL, 0, NULL } };
+{ NULL, 0, NULL }, NULL };
 
 // Implementation
 
@@ -211,11 +218,10 @@ static bool default_msg_handler_callback(p_win_proc_msg_context_t p_context)
 	return FALSE;
 }
 
-void win_msg_hdlr_start(HINSTANCE hInstance, msg_handler_callback_t callback,
+static HWND create_window(HINSTANCE hInstance,
+		p_msg_handler_context_t p_context, msg_handler_callback_t callback,
 		void *p_callback_arg)
 {
-	HWND hWnd;
-	msg_handler_context_t context;
 	ATOM result;
 	WNDCLASS wnd_class =
 	{ };
@@ -223,21 +229,21 @@ void win_msg_hdlr_start(HINSTANCE hInstance, msg_handler_callback_t callback,
 	// Load parameters
 	if (callback == NULL)
 	{
-		context.callback = default_msg_handler_callback;
+		p_context->callback = default_msg_handler_callback;
 	}
 	else
 	{
-		context.callback = callback;
+		p_context->callback = callback;
 	}
 
 	// Initialize caller inputs
-	context.params.p_callback_arg = p_callback_arg;
+	p_context->params.p_callback_arg = p_callback_arg;
 
 	// Initialize msg handler elements
-	context.params.msg_count = 0;
+	p_context->params.msg_count = 0;
 
 	// Initialize pointer to p_winapi_proc_args
-	context.params.p_winapi_proc_args = NULL;
+	p_context->params.p_winapi_proc_args = NULL;
 
 	// Define a simple window-less class
 	wnd_class.hInstance = (HINSTANCE) (GetModuleHandle(0));
@@ -249,11 +255,11 @@ void win_msg_hdlr_start(HINSTANCE hInstance, msg_handler_callback_t callback,
 	if (!result)
 	{
 		print_err(result, "RegisterClass");
-		return;
+		return (NULL);
 	}
 
 	// Create a Message Only "Window"
-	hWnd = CreateWindow(
+	p_context->hWnd = CreateWindow(
 			WINDOWLESS_CLASS_NAME,
 			NULL,
 			0,
@@ -261,12 +267,26 @@ void win_msg_hdlr_start(HINSTANCE hInstance, msg_handler_callback_t callback,
 			0, 0,
 			HWND_MESSAGE, NULL,
 			hInstance,
-			(LPVOID)&context
+			(LPVOID)p_context
 	);
 
-	if (NULL == hWnd)
+	if (NULL == p_context->hWnd)
 	{
 		print_errno("CreateWindow");
+	}
+
+	return (p_context->hWnd);
+}
+
+void win_msg_hdlr_start(HINSTANCE hInstance, msg_handler_callback_t callback,
+		void *p_callback_arg)
+{
+	HWND hWnd;
+	msg_handler_context_t context;
+
+	hWnd = create_window(hInstance, &context, callback, p_callback_arg);
+	if (NULL == hWnd)
+	{
 		return;
 	}
 
@@ -276,3 +296,60 @@ void win_msg_hdlr_start(HINSTANCE hInstance, msg_handler_callback_t callback,
 	return;
 }
 
+HANDLE win_msg_hdlr_create(HINSTANCE hInstance,
+		msg_handler_callback_t callback, void *p_callback_arg)
+{
+	p_msg_handler_context_t p_context;
+
+	p_context = (p_msg_handler_context_t) malloc(sizeof(msg_handler_context_t));
+	if (NULL == p_context)
+	{
+		return (NULL);
+	}
+
+	if (NULL == create_window(hInstance, p_context, callback, p_callback_arg))
+	{
+		free(p_context);
+		return (NULL);
+	}
+
+	return ((HANDLE) p_context);
+}
+
+bool win_msg_hdlr_dispatch(void)
+{
+	MSG msg;
+
+	// Only handle what is queued, the caller does the waiting
+	while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+	{
+		if (WM_QUIT == msg.message)
+		{
+			return (false);
+		}
+
+		TranslateMessage(&msg);
+		DispatchMessage(&msg);
+	}
+
+	return (true);
+}
+
+void win_msg_hdlr_destroy(HANDLE h_msg_hdlr)
+{
+	p_msg_handler_context_t p_context = (p_msg_handler_context_t) h_msg_hdlr;
+
+	if (NULL == p_context)
+	{
+		return;
+	}
+
+	// Let the callback see the window close then destroy it
+	SendMessage(p_context->hWnd, WM_CLOSE, 0, 0);
+	win_msg_hdlr_dispatch();
+
+	free(p_context);
+
+	return;
+}
+
@@ -87,6 +87,31 @@ typedef bool(*msg_handler_callback_t)(p_win_proc_msg_context_t p_contect);
 void win_msg_hdlr_start(HINSTANCE hInstance, msg_handler_callback_t callback,
 		void *p_callback_arg);
 
+/*!
+ \brief Creates the message only window without pumping its messages.
+
+ The caller waits for QS_ALLINPUT (e.g. MsgWaitForMultipleObjects()) along with
+ its own handles and calls win_msg_hdlr_dispatch() when messages are queued.
+
+ */
+
+HANDLE win_msg_hdlr_create(HINSTANCE hInstance,
+		msg_handler_callback_t callback, void *p_callback_arg);
+
+/*!
+ \brief Dispatches the queued messages, returns false once WM_QUIT is seen.
+
+ */
+
+bool win_msg_hdlr_dispatch(void);
+
+/*!
+ \brief Closes and destroys the window created by win_msg_hdlr_create().
+
+ */
+
+void win_msg_hdlr_destroy(HANDLE h_msg_hdlr);
+
 #ifdef __cplusplus
 }
 #endif